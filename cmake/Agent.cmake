@@ -346,6 +346,8 @@ add_library(core
   fboss/agent/RouteUpdateLogger.cpp
   fboss/agent/RouteUpdateLoggingPrefixTracker.cpp
   fboss/agent/PacketStreamHandler.cpp
+  fboss/agent/StateObserverNotifier.cpp
+  fboss/agent/StateUpdateTracer.cpp
   fboss/agent/StaticL2ForNeighborObserver.cpp
   fboss/agent/StaticL2ForNeighborUpdater.cpp
   fboss/agent/StaticL2ForNeighborSwSwitchUpdater.cpp
@@ -458,6 +460,7 @@ set(core_libs
   hw_switch_thrift_client_table
   file_based_warmboot_utils
   validate_state_update
+  thrift_cow_visitors
 )
 
 target_link_libraries(core ${core_libs})
@@ -696,6 +699,7 @@ target_link_libraries(multiswitch_service
 )
 
 add_library(route_update_wrapper
+  fboss/agent/RouteUpdateCoalescer.cpp
   fboss/agent/RouteUpdateWrapper.cpp
 )
 
@@ -852,6 +856,7 @@ add_library(sw_switch_warmboot_helper
 target_link_libraries(sw_switch_warmboot_helper
   agent_features
   async_logger
+  common_file_utils
   fboss_error
   hw_asic_table
   state
@@ -860,6 +865,7 @@ target_link_libraries(sw_switch_warmboot_helper
   warm_boot_file_utils
   file_based_warmboot_utils
   thrift_based_warmboot_utils
+  standalone_rib
 )
 
 add_library(sw_agent_initializer
@@ -60,6 +60,10 @@ add_library(hw_resource_stats_publisher
   fboss/agent/hw/HwResourceStatsPublisher.cpp
 )
 
+add_library(hw_stats_collection_scheduler
+  fboss/agent/hw/HwStatsCollectionScheduler.cpp
+)
+
 add_library(prbs_stats_entry
   fboss/agent/hw/common/PrbsStatsEntry.h
 )
@@ -75,6 +79,11 @@ target_link_libraries(hw_switch_warmboot_helper
   state
 )
 
+target_link_libraries(hw_stats_collection_scheduler
+  fb303::fb303
+  Folly::folly
+)
+
 target_link_libraries(hw_switch_fb303_stats
   stats
   fb303::fb303
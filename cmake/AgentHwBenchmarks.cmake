@@ -598,3 +598,14 @@ BUILD_HW_BENCHMARK_LIBS(voq_route_competing_remote_neighbor_benchmark
     Folly::follybenchmark
   HW_DEPS voq_route_competing_remote_neighbor_benchmark_helper
 )
+
+BUILD_HW_BENCHMARK_LIBS(large_config_push_speed
+  SRCS fboss/agent/hw/benchmarks/HwLargeConfigPushBenchmark.cpp
+  DEPS
+    acl_test_utils
+    config_factory
+    mirror_test_utils
+    function_call_time_reporter
+    Folly::folly
+    Folly::follybenchmark
+)
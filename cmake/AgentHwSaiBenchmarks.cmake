@@ -46,6 +46,7 @@ list(APPEND SAI_BENCHMARKS rx_slow_path_arp_rate)
 list(APPEND SAI_BENCHMARKS system_scale_memory_benchmark)
 list(APPEND SAI_BENCHMARKS flowlet_stats_collection_speed)
 list(APPEND SAI_BENCHMARKS clear_interface_counters_phy_benchmark)
+list(APPEND SAI_BENCHMARKS large_config_push_speed)
 if (SAI_BRCM_IMPL OR BUILD_SAI_FAKE)
   list(APPEND SAI_BENCHMARKS init_and_exit_voq)
   list(APPEND SAI_BENCHMARKS init_and_exit_fabric)
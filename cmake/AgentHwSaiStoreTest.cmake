@@ -52,4 +52,21 @@ set_target_properties(store_test PROPERTIES COMPILE_FLAGS
 )
 
 gtest_discover_tests(store_test)
+
+add_executable(neighbor_store_benchmark
+    fboss/agent/hw/sai/store/tests/NeighborStoreBenchmark.cpp
+)
+
+target_link_libraries(neighbor_store_benchmark
+    sai_store
+    fake_sai
+    Folly::folly
+    Folly::follybenchmark
+)
+
+set_target_properties(neighbor_store_benchmark PROPERTIES COMPILE_FLAGS
+  "-DSAI_VER_MAJOR=${SAI_VER_MAJOR} \
+  -DSAI_VER_MINOR=${SAI_VER_MINOR}  \
+  -DSAI_VER_RELEASE=${SAI_VER_RELEASE}"
+)
 endif()
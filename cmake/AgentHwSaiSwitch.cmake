@@ -5,6 +5,7 @@
 
 set(SAI_SWITCH_SRC
   fboss/agent/hw/sai/switch/ConcurrentIndices.cpp
+  fboss/agent/hw/sai/switch/DeltaProcessorGraph.cpp
   fboss/agent/hw/sai/switch/SaiAclTableGroupManager.cpp
   fboss/agent/hw/sai/switch/SaiAclTableManager.cpp
   fboss/agent/hw/sai/switch/SaiArsManager.cpp
@@ -155,6 +156,7 @@ target_link_libraries(sai_switch
   hw_cpu_fb303_stats
   hw_port_fb303_stats
   hw_resource_stats_publisher
+  hw_stats_collection_scheduler
   hw_switch_warmboot_helper
   prbs_stats_entry
   mka_structs_cpp2
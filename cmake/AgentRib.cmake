@@ -6,8 +6,10 @@
 add_library(standalone_rib
   fboss/agent/rib/ConfigApplier.cpp
   fboss/agent/rib/MySidConfigUtils.cpp
+  fboss/agent/rib/NextHopDependencyIndex.cpp
   fboss/agent/rib/RibMySidUpdater.cpp
   fboss/agent/rib/RibRouteWeightNormalizer.cpp
+  fboss/agent/rib/RibWarmbootFile.cpp
   fboss/agent/rib/RouteUpdater.cpp
   fboss/agent/rib/RoutingInformationBase.cpp
   fboss/agent/rib/VrfRouteTable.cpp
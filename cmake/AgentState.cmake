@@ -94,6 +94,7 @@ add_library(state
   fboss/agent/state/Route.cpp
   fboss/agent/state/RouteNextHop.cpp
   fboss/agent/state/RouteNextHopEntry.cpp
+  fboss/agent/state/RouteNextHopSetPool.cpp
   fboss/agent/state/RouteNextHopsMulti.cpp
   fboss/agent/state/RouteTypes.cpp
   fboss/agent/state/SflowCollector.cpp
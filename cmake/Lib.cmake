@@ -4,8 +4,10 @@
 # cmake/FooBar.cmake
 
 add_library(radix_tree
+  fboss/lib/LpmSnapshot.h
   fboss/lib/RadixTree.h
   fboss/lib/RadixTree-inl.h
+  fboss/lib/RadixTreeSlabAllocator.h
 )
 
 target_link_libraries(radix_tree
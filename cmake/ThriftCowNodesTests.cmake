@@ -15,6 +15,7 @@ add_fbthrift_cpp_library(
 )
 
 add_executable(thrift_node_tests
+  fboss/thrift_cow/nodes/tests/PersistentSortedMapTests.cpp
   fboss/thrift_cow/nodes/tests/ThriftStructNodeTests.cpp
 )
 
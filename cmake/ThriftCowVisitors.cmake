@@ -34,6 +34,7 @@ add_library(
   fboss/thrift_cow/visitors/DeltaVisitor.h
   fboss/thrift_cow/visitors/ExtendedPathVisitor.h
   fboss/thrift_cow/visitors/ExtendedPathVisitor.h
+  fboss/thrift_cow/visitors/MemoryVisitor.h
   fboss/thrift_cow/visitors/PathVisitor.h
   fboss/thrift_cow/visitors/RecurseVisitor.h
   fboss/thrift_cow/visitors/VisitorUtils.h
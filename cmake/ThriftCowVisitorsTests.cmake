@@ -17,6 +17,7 @@ target_link_libraries(thrift_cow_visitor_test_utils
 
 add_executable(thrift_cow_visitor_tests
   fboss/thrift_cow/visitors/tests/DeltaVisitorTests.cpp
+  fboss/thrift_cow/visitors/tests/MemoryVisitorTests.cpp
   fboss/thrift_cow/visitors/tests/PathVisitorTests.cpp
   fboss/thrift_cow/visitors/tests/RecurseVisitorTests.cpp
 )
@@ -46,6 +46,7 @@ target_link_libraries(fsdb_server
   restart_time_tracker
   Folly::folly
   thrift_service_utils
+  thrift_cow_nodes
 )
 
 add_executable(fsdb
@@ -14,6 +14,10 @@ class AclNexthopHandler : public StateObserver {
   ~AclNexthopHandler() override;
 
   void stateUpdated(const StateDelta& delta) override;
+  // Only schedules a state update when it needs to
+  bool isThreadSafe() const override {
+    return true;
+  }
   void resolveActionNexthops(MatchAction& action);
 
  private:
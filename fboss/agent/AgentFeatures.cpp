@@ -592,6 +592,18 @@ DEFINE_string(
     "thrift_switch_state",
     "File for dumping switch state in serialized thrift format on exit");
 
+DEFINE_bool(
+    rib_warmboot_file,
+    false,
+    "On graceful exit, stream the RIB warm boot state route by route to "
+    "rib_warmboot_state_file instead of the thrift switch state file");
+
+DEFINE_string(
+    rib_warmboot_state_file,
+    "rib_warmboot_state",
+    "File in the warm boot directory holding the streamed RIB warm boot "
+    "state");
+
 DEFINE_bool(
     qsfp_port_manager_mode,
     false,
@@ -627,6 +639,59 @@ DEFINE_bool(
     false,
     "Enable bulk programming of ECMP members");
 
+DEFINE_bool(
+    enable_bulk_route_programming,
+    false,
+    "Program the routes of a state delta with bulk SAI calls, falling back "
+    "to one call per route on adapters without bulk route support");
+
+DEFINE_bool(
+    enable_bulk_neighbor_programming,
+    false,
+    "Program the neighbors of a state delta with bulk SAI calls, falling "
+    "back to one call per neighbor on adapters without bulk neighbor support");
+
+DEFINE_bool(
+    enable_bulk_fdb_programming,
+    false,
+    "Program the FDB entries of a state delta with bulk SAI calls, falling "
+    "back to one call per entry on adapters without bulk FDB support");
+
+DEFINE_bool(
+    enable_bulk_stats_collection,
+    false,
+    "Read the stats of ports, queues and router interfaces with bulk SAI "
+    "calls, falling back to one call per object on adapters without bulk "
+    "stats support");
+
+DEFINE_bool(
+    enable_sharded_stats_collection,
+    false,
+    "Collect each class of hw stats (ports, system ports, cpu, buffers ...) "
+    "on its own thread, with an interval that adapts to the cost of the "
+    "collection and to whether its counters are changing");
+
+DEFINE_int32(
+    stats_collection_max_backoff_factor,
+    8,
+    "With sharded stats collection, the factor by which a stats class may "
+    "back off from --update_stats_interval_s");
+
+DEFINE_int32(
+    stats_collection_max_duty_cycle_pct,
+    25,
+    "With sharded stats collection, the max percentage of time a stats "
+    "class may spend collecting before its interval is backed off. 0 "
+    "disables the cost based back off");
+
+DEFINE_string(
+    sai_api_lock_domains,
+    "",
+    "SAI APIs to serialize separately from the others, as "
+    "<domain>:<api>,<api>;<domain>:<api>, e.g. \"stats:port,queue\". Only "
+    "list APIs the vendor SDK can run concurrently. By default, all SAI APIs "
+    "share a single lock. Ignored when the SAI replayer is enabled");
+
 DEFINE_int32(
     pbr_acl_priority,
     50000,
@@ -167,12 +167,22 @@ DECLARE_bool(montblanc_gtsw_yolo);
 DECLARE_bool(montblanc_precoding);
 DECLARE_bool(can_warm_boot);
 DECLARE_string(thrift_switch_state_file);
+DECLARE_bool(rib_warmboot_file);
+DECLARE_string(rib_warmboot_state_file);
 DECLARE_bool(qsfp_port_manager_mode);
 DECLARE_bool(verify_fib_nexthop_id_consistency);
 DECLARE_bool(enforce_single_nbr_mac_per_intf);
 DECLARE_int32(max_tx_packets);
 DECLARE_bool(enable_acl_table_redirect_action);
 DECLARE_bool(enable_bulk_create_ecmp_members);
+DECLARE_bool(enable_bulk_route_programming);
+DECLARE_bool(enable_bulk_neighbor_programming);
+DECLARE_bool(enable_bulk_fdb_programming);
+DECLARE_bool(enable_bulk_stats_collection);
+DECLARE_bool(enable_sharded_stats_collection);
+DECLARE_int32(stats_collection_max_backoff_factor);
+DECLARE_int32(stats_collection_max_duty_cycle_pct);
+DECLARE_string(sai_api_lock_domains);
 DECLARE_int32(pbr_acl_priority);
 DECLARE_bool(enable_pfc_priority_to_pg_map);
 DECLARE_bool(enable_port_cl72_retry);
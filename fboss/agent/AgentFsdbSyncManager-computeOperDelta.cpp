@@ -12,6 +12,8 @@ fsdb::computeOperDelta<thrift_cow::ThriftStructNode<fsdb::AgentData>>(
     const std::shared_ptr<thrift_cow::ThriftStructNode<fsdb::AgentData>>&,
     const std::shared_ptr<thrift_cow::ThriftStructNode<fsdb::AgentData>>&,
     const std::vector<std::string>&,
+    bool,
+    folly::Executor*,
     bool);
 
 } // namespace facebook::fboss
@@ -50,6 +50,8 @@ fsdb::computeOperDelta<thrift_cow::ThriftStructNode<fsdb::AgentData>>(
     const std::shared_ptr<thrift_cow::ThriftStructNode<fsdb::AgentData>>&,
     const std::shared_ptr<thrift_cow::ThriftStructNode<fsdb::AgentData>>&,
     const std::vector<std::string>&,
+    bool,
+    folly::Executor*,
     bool);
 
 AgentFsdbSyncManager::AgentFsdbSyncManager(
@@ -59,7 +61,9 @@ AgentFsdbSyncManager::AgentFsdbSyncManager(
           kAgentPath.tokens(),
           false /* isStats */,
           getPubType(),
-          "agent" /* clientCounterPrefix */) {}
+          "agent" /* clientCounterPrefix */) {
+  setOperDeltaExecutor(operDeltaExecutor());
+}
 
 AgentFsdbSyncManager::AgentFsdbSyncManager()
     : fsdb::FsdbSyncManager<fsdb::AgentData, true /* EnablePatchAPIs */>(
@@ -67,7 +71,9 @@ AgentFsdbSyncManager::AgentFsdbSyncManager()
           kAgentPath.tokens(),
           false /* isStats */,
           getPubType(),
-          "agent" /* clientCounterPrefix */) {}
+          "agent" /* clientCounterPrefix */) {
+  setOperDeltaExecutor(operDeltaExecutor());
+}
 
 void AgentFsdbSyncManager::stateUpdated(const StateDelta& delta) {
   if (!FLAGS_agent_fsdb_sync) {
@@ -123,12 +123,28 @@ void logBootHistory(
 std::pair<std::shared_ptr<SwitchState>, std::unique_ptr<RoutingInformationBase>>
 reconstructStateAndRib(
     std::optional<state::WarmbootState> warmBootState,
-    bool hasL3) {
+    bool hasL3,
+    const std::optional<std::string>& ribWarmBootStateFile) {
   std::unique_ptr<RoutingInformationBase> rib{};
   std::shared_ptr<SwitchState> state{nullptr};
   if (warmBootState.has_value()) {
     /* warm boot: reconstruct from warm boot state */
     state = SwitchState::fromThrift(*(warmBootState->swSwitchState()));
+    if (ribWarmBootStateFile.has_value() &&
+        warmBootState->routeTables()->empty()) {
+      /*
+       * RIB was streamed to its own file on exit. Were route tables saved
+       * in the warm boot state too, e.g. by an older agent, the file is
+       * stale and gets ignored.
+       */
+      XLOG(DBG2) << "Loading RIB from " << *ribWarmBootStateFile;
+      rib = RoutingInformationBase::fromWarmBootStateFile(
+          *ribWarmBootStateFile,
+          state->getFibsInfoMap(),
+          state->getLabelForwardingInformationBase(),
+          state->getMySids());
+      return std::make_pair(state, std::move(rib));
+    }
     rib = RoutingInformationBase::fromThrift(
         *(warmBootState->routeTables()),
         state->getFibsInfoMap(),
@@ -87,8 +87,13 @@ void logBootHistory(
  * Reconstructs SwitchState and RoutingInformationBase from warmboot state.
  * If warmBootState is present, reconstructs from saved state.
  * Otherwise, creates cold boot state with optional default VRF.
+ * ribWarmBootStateFile, when set, is a RIB warm boot file to stream the RIB
+ * from, used only if warmBootState carries no route tables of its own.
  */
 std::pair<std::shared_ptr<SwitchState>, std::unique_ptr<RoutingInformationBase>>
-reconstructStateAndRib(std::optional<state::WarmbootState> wbState, bool hasL3);
+reconstructStateAndRib(
+    std::optional<state::WarmbootState> wbState,
+    bool hasL3,
+    const std::optional<std::string>& ribWarmBootStateFile = std::nullopt);
 
 } // namespace facebook::fboss
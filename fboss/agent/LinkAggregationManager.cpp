@@ -461,7 +461,9 @@ void LinkAggregationManager::enableForwardingAndSetPartnerState(
       portID, aggPortID, AggregatePort::Forwarding::ENABLED, partnerState);
 
   sw_->updateStateNoCoalescing(
-      "AggregatePort ForwardingAndPartnerState", std::move(enableFwdStateFn));
+      "AggregatePort ForwardingAndPartnerState",
+      std::move(enableFwdStateFn),
+      StateUpdate::Priority::CRITICAL);
 }
 
 void LinkAggregationManager::disableForwardingAndSetPartnerState(
@@ -474,7 +476,9 @@ void LinkAggregationManager::disableForwardingAndSetPartnerState(
       portID, aggPortID, AggregatePort::Forwarding::DISABLED, partnerState);
 
   sw_->updateStateNoCoalescing(
-      "AggregatePort ForwardingAndPartnerState", std::move(disableFwdStateFn));
+      "AggregatePort ForwardingAndPartnerState",
+      std::move(disableFwdStateFn),
+      StateUpdate::Priority::CRITICAL);
 }
 
 void LinkAggregationManager::recordLacpTimeout() {
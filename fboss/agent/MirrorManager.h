@@ -16,6 +16,10 @@ class MirrorManager : public StateObserver {
   ~MirrorManager() override;
 
   void stateUpdated(const StateDelta& delta) override;
+  // Only schedules a state update when it needs to
+  bool isThreadSafe() const override {
+    return true;
+  }
 
  private:
   SwSwitch* sw_;
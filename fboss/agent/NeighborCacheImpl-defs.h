@@ -143,7 +143,9 @@ bool NeighborCacheImpl<NTable>::programEntry(Entry* entry) {
           folly::to<std::string>(
               "add neighbor with hw protection failure ",
               entry->getFields().ip),
-          std::move(updateFn));
+          std::move(updateFn),
+          std::nullopt,
+          StateUpdate::Priority::CRITICAL);
     } catch (const FbossHwUpdateError& e) {
       XLOG(ERR)
           << "Failed to program neighbor entry with hw failure protection "
@@ -154,7 +156,8 @@ bool NeighborCacheImpl<NTable>::programEntry(Entry* entry) {
   } else {
     sw_->updateState(
         folly::to<std::string>("add neighbor ", entry->getFields().ip),
-        std::move(updateFn));
+        std::move(updateFn),
+        StateUpdate::Priority::CRITICAL);
   }
   return true;
 }
@@ -390,7 +393,9 @@ bool NeighborCacheImpl<NTable>::programPendingEntry(
           folly::to<std::string>(
               "add pending entry with hw failure protection ",
               entry->getFields().ip),
-          std::move(updateFn));
+          std::move(updateFn),
+          std::nullopt,
+          StateUpdate::Priority::CRITICAL);
     } catch (const FbossHwUpdateError& e) {
       XLOG(ERR)
           << "Failed to program pending neighbor entry with hw failure protection "
@@ -401,7 +406,8 @@ bool NeighborCacheImpl<NTable>::programPendingEntry(
   } else {
     sw_->updateStateNoCoalescing(
         folly::to<std::string>("add pending entry ", entry->getFields().ip),
-        std::move(updateFn));
+        std::move(updateFn),
+        StateUpdate::Priority::CRITICAL);
   }
   return true;
 }
@@ -690,7 +696,8 @@ void NeighborCacheImpl<NTable>::updateEntryClassID(
             "NeighborCache configure lookup classID: ",
             classIDStr,
             " for " + ip.str()),
-        std::move(updateClassIDFn));
+        std::move(updateClassIDFn),
+        StateUpdate::Priority::CRITICAL);
   }
 }
 
@@ -844,16 +851,24 @@ void NeighborCacheImpl<NTable>::flushEntry(AddressType ip, bool* flushed) {
       try {
         sw_->updateStateWithHwFailureProtection(
             "flush neighbor entry with hw failure protection",
-            std::move(updateFn));
+            std::move(updateFn),
+            std::nullopt,
+            StateUpdate::Priority::CRITICAL);
       } catch (const FbossHwUpdateError& e) {
         XLOG(ERR) << "Failed to program flush neighbor entry: " << e.what();
         sw_->stats()->neighborTableUpdateFailure();
       }
     } else {
-      sw_->updateStateBlocking("flush neighbor entry", std::move(updateFn));
+      sw_->updateStateBlocking(
+          "flush neighbor entry",
+          std::move(updateFn),
+          StateUpdate::Priority::CRITICAL);
     }
   } else {
-    sw_->updateState("remove neighbor entry: " + ip.str(), std::move(updateFn));
+    sw_->updateState(
+        "remove neighbor entry: " + ip.str(),
+        std::move(updateFn),
+        StateUpdate::Priority::CRITICAL);
   }
 }
 
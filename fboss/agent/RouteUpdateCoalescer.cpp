@@ -0,0 +1,157 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/RouteUpdateCoalescer.h"
+
+#include "fboss/agent/AddressUtil.h"
+
+#include <folly/logging/xlog.h>
+
+#include <exception>
+#include <thread>
+
+namespace facebook::fboss {
+
+namespace {
+folly::CIDRNetwork toNetwork(const IpPrefix& prefix) {
+  auto len = static_cast<uint8_t>(*prefix.prefixLength());
+  return {network::toIPAddress(*prefix.ip()).mask(len), len};
+}
+} // namespace
+
+RouteUpdateCoalescer::RouteUpdateCoalescer(
+    std::chrono::microseconds window,
+    ProgramFn programFn)
+    : window_(window), programFn_(std::move(programFn)) {}
+
+std::chrono::microseconds RouteUpdateCoalescer::addRoutes(
+    RouterID vrf,
+    ClientID client,
+    const std::vector<UnicastRoute>& routes) {
+  return submit(vrf, client, [&routes](PendingBatch& batch) {
+    for (const auto& route : routes) {
+      batch.updates[toNetwork(*route.dest())] = route;
+    }
+  });
+}
+
+std::chrono::microseconds RouteUpdateCoalescer::delRoutes(
+    RouterID vrf,
+    ClientID client,
+    const std::vector<IpPrefix>& toDel) {
+  return submit(vrf, client, [&toDel](PendingBatch& batch) {
+    for (const auto& prefix : toDel) {
+      batch.updates[toNetwork(prefix)] = prefix;
+    }
+  });
+}
+
+template <typename MergeFn>
+std::chrono::microseconds RouteUpdateCoalescer::submit(
+    RouterID vrf,
+    ClientID client,
+    MergeFn merge) {
+  auto submitted = std::chrono::steady_clock::now();
+  Key key{vrf, client};
+  std::shared_ptr<PendingBatch> batch;
+  std::future<void> done;
+  bool opened = false;
+  {
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    auto& pending = pending_[key];
+    if (!pending) {
+      pending = std::make_shared<PendingBatch>();
+      opened = true;
+    }
+    batch = pending;
+    merge(*batch);
+    batch->waiters.emplace_back();
+    done = batch->waiters.back().get_future();
+  }
+  if (opened) {
+    // Calls arriving while we sleep join the batch
+    std::this_thread::sleep_for(window_);
+    programIfPending(key, batch);
+  }
+  // Rethrows the batch's programming error, if any
+  done.get();
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      batch->programStart - submitted);
+}
+
+void RouteUpdateCoalescer::flush(RouterID vrf, ClientID client) {
+  Key key{vrf, client};
+  // A batch of the client may be out of pending_ but still programming.
+  // Taking programMutex_ first waits it out, so that nothing of the client
+  // gets programmed after we return.
+  std::lock_guard<std::mutex> programLock(programMutex_);
+  std::shared_ptr<PendingBatch> batch;
+  {
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    auto it = pending_.find(key);
+    if (it == pending_.end()) {
+      return;
+    }
+    batch = it->second;
+  }
+  programIfPendingLocked(key, batch);
+}
+
+void RouteUpdateCoalescer::programIfPending(
+    const Key& key,
+    const std::shared_ptr<PendingBatch>& batch) {
+  std::lock_guard<std::mutex> programLock(programMutex_);
+  programIfPendingLocked(key, batch);
+}
+
+void RouteUpdateCoalescer::programIfPendingLocked(
+    const Key& key,
+    const std::shared_ptr<PendingBatch>& batch) {
+  Batch toProgram{key.first, key.second};
+  {
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    auto it = pending_.find(key);
+    if (it == pending_.end() || it->second != batch) {
+      // Already programmed by a flush
+      return;
+    }
+    pending_.erase(it);
+  }
+  // Out of pending_, no call can join the batch anymore
+  for (auto& [_, update] : batch->updates) {
+    if (auto route = std::get_if<UnicastRoute>(&update)) {
+      toProgram.toAdd.push_back(std::move(*route));
+    } else {
+      toProgram.toDel.push_back(std::move(std::get<IpPrefix>(update)));
+    }
+  }
+  toProgram.numCalls = batch->waiters.size();
+  XLOG(DBG3) << "Programming coalesced route update of client "
+             << static_cast<int>(toProgram.client) << " in vrf "
+             << toProgram.vrf << ": " << toProgram.numCalls << " calls, "
+             << toProgram.toAdd.size() << " adds, " << toProgram.toDel.size()
+             << " deletes";
+  batch->programStart = std::chrono::steady_clock::now();
+  std::exception_ptr error;
+  try {
+    programFn_(toProgram);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  for (auto& waiter : batch->waiters) {
+    if (error) {
+      waiter.set_exception(error);
+    } else {
+      waiter.set_value();
+    }
+  }
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include <folly/IPAddress.h>
+#include "fboss/agent/if/gen-cpp2/ctrl_types.h"
+#include "fboss/agent/types.h"
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * Merges bursts of route adds and deletes of a client in a VRF into one
+ * RIB update.
+ *
+ * The first call of a (VRF, client) opens a batch and waits out the
+ * coalescing window, the calls that arrive in the meantime join the batch.
+ * Once the window is over the batch is programmed as a single update, in
+ * which the last add or delete of each prefix wins, and all calls in it
+ * return together. If programming fails, every call of the batch throws
+ * the error, as the update is applied or rolled back as a whole.
+ *
+ * Batches are programmed in the order they were opened in.
+ */
+class RouteUpdateCoalescer {
+ public:
+  struct Batch {
+    RouterID vrf;
+    ClientID client;
+    std::vector<UnicastRoute> toAdd;
+    std::vector<IpPrefix> toDel;
+    // Number of calls merged into the batch
+    size_t numCalls{0};
+  };
+  using ProgramFn = std::function<void(const Batch&)>;
+
+  RouteUpdateCoalescer(std::chrono::microseconds window, ProgramFn programFn);
+
+  /*
+   * Block until the routes are programmed as part of a batch. Returns how
+   * long the call waited for its batch to be programmed, i.e. the latency
+   * added by coalescing.
+   */
+  std::chrono::microseconds addRoutes(
+      RouterID vrf,
+      ClientID client,
+      const std::vector<UnicastRoute>& routes);
+  std::chrono::microseconds
+  delRoutes(RouterID vrf, ClientID client, const std::vector<IpPrefix>& toDel);
+
+  /*
+   * Program a pending batch of the client right away, e.g. before a
+   * syncFib of the client, so that it can't be applied on top of the sync.
+   * Also waits for a batch of the client already being programmed.
+   */
+  void flush(RouterID vrf, ClientID client);
+
+ private:
+  using Key = std::pair<RouterID, ClientID>;
+  struct PendingBatch {
+    // Last update of each prefix, a route to add or a prefix to delete
+    std::map<folly::CIDRNetwork, std::variant<UnicastRoute, IpPrefix>>
+        updates;
+    std::vector<std::promise<void>> waiters;
+    std::chrono::steady_clock::time_point programStart;
+  };
+
+  template <typename MergeFn>
+  std::chrono::microseconds
+  submit(RouterID vrf, ClientID client, MergeFn merge);
+  // Take the batch out of pending_ and program it, unless already done
+  void programIfPending(
+      const Key& key,
+      const std::shared_ptr<PendingBatch>& batch);
+  // Same, with programMutex_ held
+  void programIfPendingLocked(
+      const Key& key,
+      const std::shared_ptr<PendingBatch>& batch);
+
+  const std::chrono::microseconds window_;
+  const ProgramFn programFn_;
+  // Held while taking a batch out of pending_ and programming it, so that
+  // batches of a client get programmed in order
+  std::mutex programMutex_;
+  std::mutex pendingMutex_;
+  std::unordered_map<Key, std::shared_ptr<PendingBatch>> pending_;
+};
+
+} // namespace facebook::fboss
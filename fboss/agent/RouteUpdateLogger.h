@@ -162,6 +162,11 @@ class RouteUpdateLogger : public StateObserver {
   ~RouteUpdateLogger() override;
 
   void stateUpdated(const StateDelta& delta) override;
+  // Only reads the delta. The trackers are synchronized as thrift threads
+  // already change them while updates are logged.
+  bool isThreadSafe() const override {
+    return true;
+  }
   void startLoggingForPrefix(const RouteUpdateLoggingInstance& req);
   void stopLoggingForPrefix(
       const folly::IPAddress& network,
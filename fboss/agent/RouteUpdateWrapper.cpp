@@ -162,7 +162,8 @@ void RouteUpdateWrapper::programStandAloneRib(const SyncFibFor& syncFibFor) {
         configRoutes_->staticMplsRoutesToCpu,
         configRoutes_->staticMySids,
         *ribToSwitchStateFunc_,
-        ribToSwitchStateCookie_);
+        ribToSwitchStateCookie_,
+        multiVrfRibToSwitchStateFunc_);
   }
   if (!remoteLoopbackIntfRouteToAdd_.empty() ||
       !remoteLoopbackIntfRouteToDel_.empty()) {
@@ -171,22 +172,34 @@ void RouteUpdateWrapper::programStandAloneRib(const SyncFibFor& syncFibFor) {
         remoteLoopbackIntfRouteToAdd_,
         remoteLoopbackIntfRouteToDel_,
         *ribToSwitchStateFunc_,
-        ribToSwitchStateCookie_);
+        ribToSwitchStateCookie_,
+        multiVrfRibToSwitchStateFunc_);
   }
+  // Updates of different VRFs get resolved concurrently with
+  // --rib_vrf_update_threads
+  std::vector<RoutingInformationBase::VrfClientUpdate> vrfClientUpdates;
+  vrfClientUpdates.reserve(ribRoutesToAddDel_.size());
   for (const auto& [ridClientId, addDelRoutes] : ribRoutesToAddDel_) {
-    auto stats = getRib()->update(
-        resolver_,
-        ridClientId.first,
-        ridClientId.second,
-        clientIdToAdminDistance(ridClientId.second),
-        addDelRoutes.toAdd,
-        addDelRoutes.toDel,
-        syncFibFor.find(ridClientId) != syncFibFor.end(),
-        "RIB update",
-        *ribToSwitchStateFunc_,
-        ribToSwitchStateCookie_);
-    printStats(stats);
-    updateStats(stats);
+    vrfClientUpdates.push_back(
+        {ridClientId.first,
+         ridClientId.second,
+         clientIdToAdminDistance(ridClientId.second),
+         &addDelRoutes.toAdd,
+         &addDelRoutes.toDel,
+         syncFibFor.find(ridClientId) != syncFibFor.end()});
+  }
+  if (!vrfClientUpdates.empty()) {
+    for (const auto& stats : getRib()->update(
+             resolver_,
+             vrfClientUpdates,
+             "RIB update",
+             *ribToSwitchStateFunc_,
+             multiVrfRibToSwitchStateFunc_,
+             ribToSwitchStateCookie_,
+             pipelinedRibToSwitchStateFunc_)) {
+      printStats(stats);
+      updateStats(stats);
+    }
   }
   // update MPLS routes
   for (const auto& [ridClientId, addDelRoutes] : ribMplsRoutesToAddDel_) {
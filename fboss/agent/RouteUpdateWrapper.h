@@ -136,11 +136,16 @@ class RouteUpdateWrapper {
       const SwitchIdScopeResolver* resolver,
       RoutingInformationBase* rib,
       std::optional<RibToSwitchStateFunction> ribToSwitchStateFunc,
-      void* ribToSwitchStateCookie)
+      void* ribToSwitchStateCookie,
+      MultiVrfRibToSwitchStateFunction multiVrfRibToSwitchStateFunc = {},
+      PipelinedRibToSwitchStateFunction pipelinedRibToSwitchStateFunc = {})
       : resolver_(resolver),
         rib_(rib),
         ribToSwitchStateFunc_(ribToSwitchStateFunc),
-        ribToSwitchStateCookie_(ribToSwitchStateCookie) {
+        ribToSwitchStateCookie_(ribToSwitchStateCookie),
+        multiVrfRibToSwitchStateFunc_(std::move(multiVrfRibToSwitchStateFunc)),
+        pipelinedRibToSwitchStateFunc_(
+            std::move(pipelinedRibToSwitchStateFunc)) {
     CHECK(rib_ && ribToSwitchStateFunc_ && ribToSwitchStateCookie_);
   }
 
@@ -156,6 +161,11 @@ class RouteUpdateWrapper {
   RoutingInformationBase* rib_{nullptr};
   std::optional<RibToSwitchStateFunction> ribToSwitchStateFunc_;
   void* ribToSwitchStateCookie_{nullptr};
+  // Programs updates spanning VRFs in one go, if set. See
+  // --rib_vrf_update_threads
+  MultiVrfRibToSwitchStateFunction multiVrfRibToSwitchStateFunc_;
+  // Programs unicast route updates pipelined, if set. See --rib_fib_pipeline
+  PipelinedRibToSwitchStateFunction pipelinedRibToSwitchStateFunc_;
   std::unique_ptr<ConfigRoutes> configRoutes_{nullptr};
 };
 } // namespace facebook::fboss
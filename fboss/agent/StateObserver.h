@@ -13,12 +13,34 @@
 
 #include "fboss/agent/state/StateDelta.h"
 
+#include <string>
+#include <vector>
+
 namespace facebook::fboss {
 
 class StateObserver : public boost::noncopyable {
  public:
   virtual ~StateObserver() {}
   virtual void stateUpdated(const StateDelta& delta) = 0;
+
+  /*
+   * Whether stateUpdated() may run off the update thread, concurrently with
+   * other observers. Such observers get notified on the state observer pool
+   * (see --state_observer_threads), alongside the observers they don't
+   * depend on.
+   */
+  virtual bool isThreadSafe() const {
+    return false;
+  }
+
+  /*
+   * Names, as registered with SwSwitch, of the observers that must be done
+   * with an update before this one gets notified of it. Observers not
+   * registered are ignored. Queried once, on registration.
+   */
+  virtual std::vector<std::string> getDependencies() const {
+    return {};
+  }
 };
 
 } // namespace facebook::fboss
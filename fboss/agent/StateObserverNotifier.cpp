@@ -0,0 +1,171 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/StateObserverNotifier.h"
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/StateObserver.h"
+
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <folly/futures/Future.h>
+#include <folly/logging/xlog.h>
+
+DEFINE_int32(
+    state_observer_threads,
+    0,
+    "Threads notifying thread safe state observers (e.g. "
+    "RouteUpdateLogger, SwitchStatsObserver) concurrently with the other "
+    "observers. 0 notifies all of them on the update thread.");
+
+namespace facebook::fboss {
+
+StateObserverNotifier::StateObserverNotifier(
+    uint32_t numThreads,
+    LatencyFn latencyFn)
+    : latencyFn_(std::move(latencyFn)) {
+  if (numThreads > 0) {
+    executor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+        numThreads,
+        std::make_shared<folly::NamedThreadFactory>("StateObserver"));
+  }
+}
+
+StateObserverNotifier::~StateObserverNotifier() {
+  if (executor_) {
+    executor_->join();
+  }
+}
+
+void StateObserverNotifier::add(
+    StateObserver* observer,
+    const std::string& name) {
+  if (contains(observer)) {
+    throw FbossError("State observer add failed: ", name, " already exists");
+  }
+  observers_.emplace(observer, Observer{name, observer->getDependencies()});
+  try {
+    waves_ = computeWaves();
+  } catch (const FbossError&) {
+    observers_.erase(observer);
+    throw;
+  }
+}
+
+void StateObserverNotifier::remove(StateObserver* observer) {
+  if (!observers_.erase(observer)) {
+    throw FbossError("State observer remove failed: observer does not exist");
+  }
+  waves_ = computeWaves();
+}
+
+bool StateObserverNotifier::contains(StateObserver* observer) const {
+  return observers_.find(observer) != observers_.end();
+}
+
+std::vector<StateObserverNotifier::Wave> StateObserverNotifier::computeWaves()
+    const {
+  std::multimap<std::string, StateObserver*> byName;
+  for (const auto& [observer, info] : observers_) {
+    byName.emplace(info.name, observer);
+  }
+  std::map<StateObserver*, std::vector<StateObserver*>> dependents;
+  std::map<StateObserver*, size_t> numDependencies;
+  std::vector<StateObserver*> wave;
+  for (const auto& [observer, info] : observers_) {
+    for (const auto& dependency : info.dependencies) {
+      auto [begin, end] = byName.equal_range(dependency);
+      for (auto it = begin; it != end; ++it) {
+        if (it->second != observer) {
+          dependents[it->second].push_back(observer);
+          ++numDependencies[observer];
+        }
+      }
+    }
+    if (!numDependencies[observer]) {
+      wave.push_back(observer);
+    }
+  }
+  std::vector<Wave> waves;
+  size_t numScheduled = 0;
+  while (!wave.empty()) {
+    std::vector<StateObserver*> nextWave;
+    auto& entries = waves.emplace_back();
+    for (auto* observer : wave) {
+      entries.push_back({observer, observers_.at(observer).name});
+      for (auto* dependent : dependents[observer]) {
+        if (!--numDependencies[dependent]) {
+          nextWave.push_back(dependent);
+        }
+      }
+    }
+    numScheduled += wave.size();
+    wave = std::move(nextWave);
+  }
+  if (numScheduled != observers_.size()) {
+    throw FbossError("State observer dependencies form a cycle");
+  }
+  return waves;
+}
+
+void StateObserverNotifier::notify(const StateDelta& delta) {
+  // Observers may (un)register observers while being notified
+  auto waves = waves_;
+  for (const auto& wave : waves) {
+    std::vector<folly::Future<folly::Unit>> futures;
+    // A lone observer has nothing to overlap with, skip the thread hop
+    if (executor_ && wave.size() > 1) {
+      for (const auto& entry : wave) {
+        if (entry.observer->isThreadSafe()) {
+          futures.push_back(folly::via(executor_.get(), [&, this] {
+            notifyOne(entry, delta);
+          }));
+        }
+      }
+    }
+    for (const auto& entry : wave) {
+      if (futures.empty() || !entry.observer->isThreadSafe()) {
+        notifyOne(entry, delta);
+      }
+    }
+    // The next wave may depend on any of this one
+    folly::collectAll(std::move(futures)).wait();
+  }
+}
+
+void StateObserverNotifier::notifyOne(
+    const WaveEntry& entry,
+    const StateDelta& delta) const {
+  auto start = std::chrono::steady_clock::now();
+  try {
+    entry.observer->stateUpdated(delta);
+  } catch (const std::exception& ex) {
+    // TODO: Figure out the best way to handle errors here.
+    XLOG(FATAL) << "error notifying " << entry.name
+                << " of update: " << folly::exceptionStr(ex);
+  }
+  if (latencyFn_) {
+    latencyFn_(
+        entry.name,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start));
+  }
+}
+
+std::vector<std::vector<std::string>> StateObserverNotifier::getWaves() const {
+  std::vector<std::vector<std::string>> waves;
+  for (const auto& wave : waves_) {
+    auto& names = waves.emplace_back();
+    for (const auto& entry : wave) {
+      names.push_back(entry.name);
+    }
+  }
+  return waves;
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,92 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <gflags/gflags.h>
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+DECLARE_int32(state_observer_threads);
+
+namespace facebook::fboss {
+
+class StateDelta;
+class StateObserver;
+
+/*
+ * Notifies the StateObservers registered with SwSwitch of state updates.
+ *
+ * Observers are notified in waves: an observer is in the wave after the
+ * last wave holding one of its dependencies (see
+ * StateObserver::getDependencies()), and a wave only starts once the
+ * previous one is done. Within a wave, thread safe observers run on a pool
+ * of numThreads threads while the others run one after another on the
+ * calling thread. Without threads every observer runs on the calling thread.
+ *
+ * Observers used to be notified in no particular order, so none of them
+ * declares dependencies today and they all end up in a single wave. Of the
+ * thread safe ones, RouteUpdateLogger and SwitchStatsObserver walk the
+ * changed routes and neighbor tables; the rest only schedule state updates.
+ * Observers not marked thread safe, including the expensive
+ * LinkAggregationManager, NeighborUpdater, LookupClassUpdater and
+ * DsfSubscriber, still run serially on the calling thread, which bounds
+ * what the pool can save.
+ *
+ * Not thread safe itself, SwSwitch only uses it from the update thread.
+ */
+class StateObserverNotifier {
+ public:
+  // Told how long each observer took to process an update. May be called
+  // from the pool threads.
+  using LatencyFn =
+      std::function<void(const std::string& name, std::chrono::microseconds)>;
+
+  StateObserverNotifier(uint32_t numThreads, LatencyFn latencyFn);
+  ~StateObserverNotifier();
+
+  // Throws FbossError if the observer is already registered or its
+  // dependencies form a cycle
+  void add(StateObserver* observer, const std::string& name);
+  // Throws FbossError if the observer isn't registered
+  void remove(StateObserver* observer);
+  bool contains(StateObserver* observer) const;
+
+  void notify(const StateDelta& delta);
+
+  // Observers in the order of their waves, for tests
+  std::vector<std::vector<std::string>> getWaves() const;
+
+ private:
+  struct Observer {
+    std::string name;
+    std::vector<std::string> dependencies;
+  };
+  struct WaveEntry {
+    StateObserver* observer;
+    std::string name;
+  };
+  using Wave = std::vector<WaveEntry>;
+
+  std::vector<Wave> computeWaves() const;
+  void notifyOne(const WaveEntry& entry, const StateDelta& delta) const;
+
+  std::map<StateObserver*, Observer> observers_;
+  std::vector<Wave> waves_;
+  LatencyFn latencyFn_;
+  std::unique_ptr<folly::CPUThreadPoolExecutor> executor_;
+};
+
+} // namespace facebook::fboss
@@ -0,0 +1,138 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/StateUpdateTracer.h"
+
+#include "fboss/agent/SwitchStats.h"
+
+#include <folly/String.h>
+
+#include <cctype>
+
+DEFINE_int32(
+    state_update_trace_history,
+    1000,
+    "Number of state update latency traces kept for getStateUpdateTraces");
+
+namespace facebook::fboss {
+
+namespace {
+constexpr auto kMaxCounterKeys = 256;
+constexpr auto kOtherCounterKey = "other";
+
+// Addresses, prefixes, port names and IDs, e.g. "10.0.0.1", "fe80::1",
+// "02:00:00:00:00:01", "eth1/2/1", "42"
+bool isObjectId(folly::StringPiece word) {
+  if (word.empty()) {
+    return false;
+  }
+  if (std::isdigit(static_cast<unsigned char>(word.front()))) {
+    return true;
+  }
+  return word.find(':') != folly::StringPiece::npos ||
+      word.find('/') != folly::StringPiece::npos ||
+      word.find('.') != folly::StringPiece::npos;
+}
+} // namespace
+
+void StateUpdateTracer::record(
+    const std::vector<UpdateTimes>& updates,
+    const BatchTimes& batch,
+    SwitchStats* stats) {
+  auto batchTime = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - batch.start);
+  std::vector<StateUpdateTrace> traces;
+  traces.reserve(updates.size());
+  for (const auto& update : updates) {
+    auto total = update.queueWait + batchTime;
+    auto& trace = traces.emplace_back();
+    trace.name() = update.name;
+    trace.enqueuedAtMs() =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            update.enqueued.time_since_epoch())
+            .count();
+    trace.queueWaitUs() = update.queueWait.count();
+    trace.applyUpdateUs() = update.applyUpdate.count();
+    trace.validationUs() = batch.validation.count();
+    trace.hwProgrammingUs() = batch.hwProgramming.count();
+    trace.stateObserversUs() = batch.stateObservers.count();
+    trace.fsdbSyncUs() = batch.fsdbSync.count();
+    trace.totalUs() = total.count();
+    trace.batchSize() = static_cast<int32_t>(updates.size());
+    trace.failed() = update.failed;
+
+    auto key = getCounterKey(update.name);
+    stats->stateUpdateStageTime(key, "queue_wait", update.queueWait);
+    stats->stateUpdateStageTime(key, "apply_update", update.applyUpdate);
+    stats->stateUpdateStageTime(key, "validation", batch.validation);
+    stats->stateUpdateStageTime(key, "hw_programming", batch.hwProgramming);
+    stats->stateUpdateStageTime(key, "state_observers", batch.stateObservers);
+    stats->stateUpdateStageTime(key, "fsdb_sync", batch.fsdbSync);
+    stats->stateUpdateStageTime(key, "total", total);
+  }
+  traces_.withWLock([&](auto& lockedTraces) {
+    for (auto& trace : traces) {
+      lockedTraces.push_back(std::move(trace));
+    }
+    while (lockedTraces.size() > maxTraces_) {
+      lockedTraces.pop_front();
+    }
+  });
+}
+
+std::vector<StateUpdateTrace> StateUpdateTracer::getTraces(
+    size_t count) const {
+  auto lockedTraces = traces_.rlock();
+  count = std::min(count, lockedTraces->size());
+  return {lockedTraces->rbegin(), lockedTraces->rbegin() + count};
+}
+
+std::string StateUpdateTracer::getCounterKey(const std::string& name) {
+  std::vector<folly::StringPiece> words;
+  folly::split(' ', name, words, true /* ignoreEmpty */);
+  std::string key;
+  for (auto word : words) {
+    // "<name>: <object>", the rest is the object updated
+    bool last = word.endsWith(':');
+    if (last) {
+      word.pop_back();
+    }
+    if (isObjectId(word)) {
+      break;
+    }
+    for (auto c : word) {
+      if (std::isalnum(static_cast<unsigned char>(c))) {
+        key.push_back(std::tolower(static_cast<unsigned char>(c)));
+      } else if (!key.empty() && key.back() != '_') {
+        key.push_back('_');
+      }
+    }
+    if (last) {
+      break;
+    }
+    if (!key.empty() && key.back() != '_') {
+      key.push_back('_');
+    }
+  }
+  while (!key.empty() && key.back() == '_') {
+    key.pop_back();
+  }
+  if (key.empty()) {
+    return kOtherCounterKey;
+  }
+  if (counterKeys_.find(key) == counterKeys_.end()) {
+    if (counterKeys_.size() >= kMaxCounterKeys) {
+      return kOtherCounterKey;
+    }
+    counterKeys_.insert(key);
+  }
+  return key;
+}
+
+} // namespace facebook::fboss
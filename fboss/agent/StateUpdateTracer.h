@@ -0,0 +1,84 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/if/gen-cpp2/ctrl_types.h"
+
+#include <folly/Synchronized.h>
+#include <gflags/gflags.h>
+
+#include <chrono>
+#include <deque>
+#include <set>
+#include <string>
+#include <vector>
+
+DECLARE_int32(state_update_trace_history);
+
+namespace facebook::fboss {
+
+class SwitchStats;
+
+/*
+ * Keeps per stage latency traces of the last state updates applied by
+ * SwSwitch and exports them as histograms, per update name and stage.
+ *
+ * SwSwitch applies updates in batches of coalesced updates. Queue wait and
+ * the update function are timed per update, while the stages after that
+ * are run once per batch and get attributed to every update of the batch.
+ */
+class StateUpdateTracer {
+ public:
+  struct UpdateTimes {
+    std::string name;
+    std::chrono::system_clock::time_point enqueued;
+    std::chrono::microseconds queueWait{0};
+    std::chrono::microseconds applyUpdate{0};
+    bool failed{false};
+  };
+  struct BatchTimes {
+    std::chrono::steady_clock::time_point start;
+    std::chrono::microseconds validation{0};
+    std::chrono::microseconds hwProgramming{0};
+    std::chrono::microseconds stateObservers{0};
+    std::chrono::microseconds fsdbSync{0};
+  };
+
+  explicit StateUpdateTracer(size_t maxTraces) : maxTraces_(maxTraces) {}
+
+  /*
+   * Record the updates of a batch, in the order they were applied in, once
+   * the batch is done. Only called from the update thread.
+   */
+  void record(
+      const std::vector<UpdateTimes>& updates,
+      const BatchTimes& batch,
+      SwitchStats* stats);
+
+  // The last count traces, most recent first
+  std::vector<StateUpdateTrace> getTraces(size_t count) const;
+
+  /*
+   * Counter friendly form of an update name. Names often end with the
+   * object updated, e.g. "add neighbor <ip>" or "updateOrAdd static MAC:
+   * <neighbor>", so everything from the first address, port name or ID, or
+   * after a ": ", is dropped. Names past the first few hundred are counted
+   * as "other".
+   */
+  std::string getCounterKey(const std::string& name);
+
+ private:
+  const size_t maxTraces_;
+  folly::Synchronized<std::deque<StateUpdateTrace>> traces_;
+  // Only accessed from the update thread
+  std::set<std::string> counterKeys_;
+};
+
+} // namespace facebook::fboss
@@ -102,6 +102,7 @@
 #include "fboss/lib/phy/gen-cpp2/phy_types.h"
 #include "fboss/lib/platforms/PlatformProductInfo.h"
 #include "fboss/lib/restart_tracker/RestartTimeTracker.h"
+#include "fboss/thrift_cow/visitors/MemoryVisitor.h"
 #include "fboss/util/Logging.h"
 
 #include <boost/functional/hash.hpp>
@@ -111,6 +112,7 @@
 #include <folly/MacAddress.h>
 #include <folly/MapUtil.h>
 #include <folly/SocketAddress.h>
+#include <folly/ScopeGuard.h>
 #include <folly/String.h>
 #include <folly/logging/xlog.h>
 #include <folly/system/ThreadName.h>
@@ -119,6 +121,7 @@
 #include <thrift/lib/cpp2/async/RequestChannel.h>
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
 #include <exception>
@@ -183,6 +186,23 @@ DEFINE_bool(rx_sw_priority, false, "Enable rx packet prioritization");
 
 DEFINE_int32(rx_pkt_thread_timeout, 100, "Rx packet thread timeout (ms)");
 
+DEFINE_bool(
+    state_update_priority_scheduling,
+    false,
+    "Apply pending state updates by priority rather than in queuing order");
+
+DEFINE_int32(
+    state_update_max_delay_ms,
+    1000,
+    "Deadline given to state updates queued without one, so that a steady "
+    "stream of higher priority updates can't starve them. 0 for none");
+
+DEFINE_int32(
+    state_memory_stats_interval_s,
+    300,
+    "Interval at which to export the estimated memory held by the switch "
+    "state to fb303 (s). 0 to disable");
+
 using namespace facebook::fboss;
 namespace {
 
@@ -274,6 +294,16 @@ std::string getDrainThresholdStr(
   }
 }
 
+facebook::fboss::StateMemoryUsageEntry toStateMemoryUsageEntry(
+    const facebook::fboss::thrift_cow::MemoryUsageEntry& usage) {
+  facebook::fboss::StateMemoryUsageEntry entry;
+  entry.bytes() = usage.bytes;
+  entry.uniqueBytes() = usage.uniqueBytes;
+  entry.nodes() = usage.nodes;
+  entry.uniqueNodes() = usage.uniqueNodes;
+  return entry;
+}
+
 void accumulateCounterStats(
     facebook::fboss::HwSwitchCounterStats& accumulated,
     const facebook::fboss::HwSwitchCounterStats& toAdd) {
@@ -474,6 +504,13 @@ SwSwitch::SwSwitch(
       supportsAddRemovePort_(supportsAddRemovePort),
       platformProductInfo_(
           std::make_unique<PlatformProductInfo>(FLAGS_fruid_filepath)),
+      stateObservers_(new StateObserverNotifier(
+          FLAGS_state_observer_threads,
+          [this](const std::string& name, std::chrono::microseconds time) {
+            stats()->stateObserverNotifyTime(name, time);
+          })),
+      stateUpdateTracer_(
+          new StateUpdateTracer(FLAGS_state_update_trace_history)),
       pktObservers_(new PacketObservers()),
       l2LearnEventObservers_(new L2LearnEventObservers()),
       arp_(new ArpHandler(this)),
@@ -898,8 +935,11 @@ state::SwitchState SwSwitch::updateOverrideEcmpSwitchingMode(
 state::WarmbootState SwSwitch::gracefulExitState() const {
   state::WarmbootState thriftSwitchState;
   // For RIB we employ a optmization to serialize only unresolved routes
-  // and recover others from FIB
-  thriftSwitchState.routeTables() = rib_->warmBootState();
+  // and recover others from FIB. With rib_warmboot_file they are streamed
+  // to a file of their own instead, see storeRibWarmBootState
+  if (!FLAGS_rib_warmboot_file) {
+    thriftSwitchState.routeTables() = rib_->warmBootState();
+  }
   *thriftSwitchState.swSwitchState() = getAppliedState()->toThrift();
   if (FLAGS_update_route_with_dlb_type) {
     updateOverrideEcmpSwitchingMode(&thriftSwitchState);
@@ -936,6 +976,13 @@ void SwSwitch::gracefulExit() {
                  << duration_cast<duration<float>>(
                         switchStateToThriftDone - stopThreadsAndHandlersDone)
                         .count();
+      if (!swSwitchWarmbootHelper_->storeRibWarmBootState(*rib_)) {
+        thriftSwitchState.routeTables() = rib_->warmBootState();
+      }
+      XLOG(DBG2) << "[Exit] RIB warm boot file "
+                 << duration_cast<duration<float>>(
+                        steady_clock::now() - switchStateToThriftDone)
+                        .count();
     });
     // Cleanup if we ever initialized
     stopHwSwitchHandler();
@@ -1119,6 +1166,7 @@ void SwSwitch::updateStats() {
     }
   };
   updateRouteStats();
+  updateStateMemoryStats();
   updatePortInfo();
   updateLldpStats();
   updateTeFlowStats();
@@ -1227,6 +1275,53 @@ void SwSwitch::updateRouteStats() {
   fb303::fbData->setCounter(SwitchStats::kCounterPrefix + "routes.v6", v6Count);
 }
 
+StateMemoryUsage SwSwitch::getStateMemoryUsage(size_t pathDepth) const {
+  StateMemoryUsage result;
+  auto state = getState();
+  if (!state) {
+    return result;
+  }
+  auto usage = thrift_cow::MemoryAccountant(pathDepth).account(state);
+  result.total() = toStateMemoryUsageEntry(usage.total);
+  for (const auto& [path, entry] : usage.byPath) {
+    result.byPath()[path] = toStateMemoryUsageEntry(entry);
+  }
+  for (const auto& [type, entry] : usage.byType) {
+    result.byType()[type] = toStateMemoryUsageEntry(entry);
+  }
+  return result;
+}
+
+void SwSwitch::updateStateMemoryStats() {
+  if (FLAGS_state_memory_stats_interval_s <= 0) {
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+  if (stateMemoryStatsUpdatedAt_ &&
+      now - *stateMemoryStatsUpdatedAt_ <
+          std::chrono::seconds(FLAGS_state_memory_stats_interval_s)) {
+    return;
+  }
+  stateMemoryStatsUpdatedAt_ = now;
+  auto state = getState();
+  if (!state) {
+    return;
+  }
+  if (!stateMemoryAccountant_) {
+    // top level paths only
+    stateMemoryAccountant_ = std::make_unique<thrift_cow::MemoryAccountant>(1);
+  }
+  // only walks the nodes of the state changed since the previous pass
+  auto usage = stateMemoryAccountant_->accountUpdate(state);
+  const auto prefix = SwitchStats::kCounterPrefix + "state_memory.";
+  fb303::fbData->setCounter(prefix + "bytes", usage.total.bytes);
+  fb303::fbData->setCounter(prefix + "nodes", usage.total.nodes);
+  for (const auto& [path, entry] : usage.byPath) {
+    // paths start with "/"
+    fb303::fbData->setCounter(prefix + path.substr(1) + ".bytes", entry.bytes);
+  }
+}
+
 void SwSwitch::updateTeFlowStats() {
   // updateTeFlowStats() could be called before we are getting the first state
   auto state = getState();
@@ -1442,13 +1537,16 @@ std::shared_ptr<SwitchState> SwSwitch::preInit(SwitchFlags flags) {
 
   multiHwSwitchHandler_->start();
   std::optional<state::WarmbootState> wbState{};
+  std::optional<std::string> ribWarmBootStateFile{};
   if (bootType_ == BootType::WARM_BOOT) {
     wbState = swSwitchWarmbootHelper_->getWarmBootState();
+    ribWarmBootStateFile = swSwitchWarmbootHelper_->getRibWarmBootStateFile();
   }
   restart_time::init(
       agentDirUtil_->getWarmBootDir(), bootType_ == BootType::WARM_BOOT);
 
-  auto [state, rib] = reconstructStateAndRib(wbState, scopeResolver_->hasL3());
+  auto [state, rib] = reconstructStateAndRib(
+      wbState, scopeResolver_->hasL3(), ribWarmBootStateFile);
   rib_ = std::move(rib);
 
   if (bootType_ != BootType::WARM_BOOT) {
@@ -1739,26 +1837,22 @@ void SwSwitch::unregisterStateObserver(StateObserver* observer) {
 
 bool SwSwitch::stateObserverRegistered(StateObserver* observer) {
   DCHECK(updateEventBase_.isInEventBaseThread());
-  return stateObservers_.find(observer) != stateObservers_.end();
+  return stateObservers_->contains(observer);
 }
 
 void SwSwitch::removeStateObserver(StateObserver* observer) {
   DCHECK(updateEventBase_.isInEventBaseThread());
-  auto nErased = stateObservers_.erase(observer);
-  if (!nErased) {
-    throw FbossError("State observer remove failed: observer does not exist");
-  }
+  stateObservers_->remove(observer);
 }
 
 void SwSwitch::addStateObserver(StateObserver* observer, const string& name) {
   DCHECK(updateEventBase_.isInEventBaseThread());
-  if (stateObserverRegistered(observer)) {
-    throw FbossError("State observer add failed: ", name, " already exists");
-  }
-  stateObservers_.emplace(observer, name);
+  stateObservers_->add(observer, name);
 }
 
-void SwSwitch::notifyStateObservers(const StateDelta& delta) {
+void SwSwitch::notifyStateObservers(
+    const StateDelta& delta,
+    StateUpdateTracer::BatchTimes* batchTimes) {
   CHECK(updateEventBase_.inRunningEventBaseThread());
   if (isExiting()) {
     // Make sure the SwSwitch is not already being destroyed
@@ -1768,17 +1862,18 @@ void SwSwitch::notifyStateObservers(const StateDelta& delta) {
   // lookup in rx path.
   updateAddrToLocalIntf(delta);
 
-  for (const auto& observerName : stateObservers_) {
-    try {
-      auto observer = observerName.first;
-      observer->stateUpdated(delta);
-    } catch (const std::exception& ex) {
-      // TODO: Figure out the best way to handle errors here.
-      XLOG(FATAL) << "error notifying " << observerName.second
-                  << " of update: " << folly::exceptionStr(ex);
-    }
-  }
+  auto start = std::chrono::steady_clock::now();
+  stateObservers_->notify(delta);
+  auto observersDone = std::chrono::steady_clock::now();
   runFsdbSyncFunction([&delta](auto& syncer) { syncer->stateUpdated(delta); });
+  if (batchTimes) {
+    batchTimes->stateObservers =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            observersDone - start);
+    batchTimes->fsdbSync =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - observersDone);
+  }
 }
 
 std::vector<StateDelta> SwSwitch::reconstructStateFromErmAndShelManager(
@@ -1812,9 +1907,31 @@ bool SwSwitch::updateState(unique_ptr<StateUpdate> update) {
                << " since exit already started";
     return false;
   }
+  update->enqueueTime_ = std::chrono::steady_clock::now();
+  update->enqueueWallTime_ = std::chrono::system_clock::now();
+  if (!update->getDeadline() && FLAGS_state_update_max_delay_ms > 0) {
+    update->setDeadline(
+        update->enqueueTime_ +
+        std::chrono::milliseconds(FLAGS_state_update_max_delay_ms));
+  }
+  auto priority = FLAGS_state_update_priority_scheduling
+      ? update->getPriority()
+      : StateUpdate::Priority::NORMAL;
   {
     std::unique_lock guard(pendingUpdatesLock_);
-    pendingUpdates_.push_back(*update.release());
+    auto& pendingUpdates = pendingUpdates_[static_cast<int>(priority)];
+    // Updates ahead in the list get applied first, so they inherit an
+    // earlier deadline. This keeps deadlines in order within a list.
+    if (const auto& deadline = update->getDeadline()) {
+      for (auto iter = pendingUpdates.rbegin(); iter != pendingUpdates.rend();
+           ++iter) {
+        if (iter->getDeadline() && *iter->getDeadline() <= *deadline) {
+          break;
+        }
+        iter->setDeadline(*deadline);
+      }
+    }
+    pendingUpdates.push_back(*update.release());
   }
 
   // Signal the update thread that updates are pending.
@@ -1824,41 +1941,97 @@ bool SwSwitch::updateState(unique_ptr<StateUpdate> update) {
   return true;
 }
 
-bool SwSwitch::updateState(StringPiece name, StateUpdateFn fn) {
+bool SwSwitch::updateState(
+    StringPiece name,
+    StateUpdateFn fn,
+    StateUpdate::Priority priority) {
   auto update = make_unique<FunctionStateUpdate>(name, std::move(fn));
+  update->setPriority(priority);
   return updateState(std::move(update));
 }
 
-void SwSwitch::updateStateNoCoalescing(StringPiece name, StateUpdateFn fn) {
+void SwSwitch::updateStateNoCoalescing(
+    StringPiece name,
+    StateUpdateFn fn,
+    StateUpdate::Priority priority) {
   auto update = make_unique<FunctionStateUpdate>(
       name,
       std::move(fn),
       static_cast<int>(StateUpdate::BehaviorFlags::NON_COALESCING));
+  update->setPriority(priority);
   updateState(std::move(update));
 }
 
-void SwSwitch::updateStateBlocking(folly::StringPiece name, StateUpdateFn fn) {
+void SwSwitch::updateStateBlocking(
+    folly::StringPiece name,
+    StateUpdateFn fn,
+    StateUpdate::Priority priority) {
   auto behaviorFlags = static_cast<int>(StateUpdate::BehaviorFlags::NONE);
-  updateStateBlockingImpl(name, fn, behaviorFlags, std::nullopt);
+  updateStateBlockingImpl(name, fn, behaviorFlags, std::nullopt, priority);
 }
 
 void SwSwitch::updateStateWithHwFailureProtection(
     folly::StringPiece name,
     StateUpdateFn fn,
-    std::optional<StateDeltaApplication> deltaApplicationBehavior) {
+    std::optional<StateDeltaApplication> deltaApplicationBehavior,
+    StateUpdate::Priority priority) {
   int stateUpdateBehavior =
       static_cast<int>(StateUpdate::BehaviorFlags::NON_COALESCING) |
       static_cast<int>(StateUpdate::BehaviorFlags::HW_FAILURE_PROTECTION);
 
   updateStateBlockingImpl(
-      name, fn, stateUpdateBehavior, deltaApplicationBehavior);
+      name, fn, stateUpdateBehavior, deltaApplicationBehavior, priority);
+}
+
+std::shared_future<std::shared_ptr<SwitchState>>
+SwSwitch::updateStateWithHwFailureProtectionPipelined(
+    folly::StringPiece name,
+    StateUpdateFn fn,
+    const std::shared_ptr<StateUpdatePipeline>& pipeline,
+    std::optional<StateDeltaApplication> deltaApplicationBehavior,
+    StateUpdate::Priority priority) {
+  int stateUpdateBehavior =
+      static_cast<int>(StateUpdate::BehaviorFlags::NON_COALESCING) |
+      static_cast<int>(StateUpdate::BehaviorFlags::HW_FAILURE_PROTECTION);
+
+  auto prepared = std::make_shared<BlockingUpdateResult>();
+  auto update = make_unique<PipelinedStateUpdate>(
+      name,
+      [name = name.str(), fn = std::move(fn), pipeline](
+          const std::shared_ptr<SwitchState>& in) {
+        if (pipeline->failed) {
+          throw FbossHwUpdateError(
+              in,
+              in,
+              "Update : ",
+              name,
+              " dropped, an earlier update of its pipeline failed");
+        }
+        return fn(in);
+      },
+      prepared,
+      pipeline,
+      [this] { return getState(); },
+      stateUpdateBehavior,
+      std::move(deltaApplicationBehavior));
+  update->setPriority(priority);
+  auto appliedState = update->getAppliedState();
+  if (!updateState(std::move(update))) {
+    // Update dropped, e.g. as we are exiting
+    std::promise<std::shared_ptr<SwitchState>> dropped;
+    dropped.set_value(getState());
+    return dropped.get_future().share();
+  }
+  prepared->wait();
+  return appliedState;
 }
 
 void SwSwitch::updateStateBlockingImpl(
     folly::StringPiece name,
     StateUpdateFn fn,
     int stateUpdateBehavior,
-    std::optional<StateDeltaApplication> deltaApplicationBehavior) {
+    std::optional<StateDeltaApplication> deltaApplicationBehavior,
+    StateUpdate::Priority priority) {
   auto result = std::make_shared<BlockingUpdateResult>();
   auto update = make_unique<BlockingStateUpdate>(
       name,
@@ -1866,6 +2039,7 @@ void SwSwitch::updateStateBlockingImpl(
       result,
       stateUpdateBehavior,
       std::move(deltaApplicationBehavior));
+  update->setPriority(priority);
   if (updateState(std::move(update))) {
     result->wait();
   }
@@ -1886,14 +2060,16 @@ void SwSwitch::handlePendingUpdates() {
   auto pendingUpdateQueueLength = 0;
   {
     std::unique_lock guard(pendingUpdatesLock_);
-    // When deciding how many elements to pull off the pendingUpdates_
+    // When deciding how many elements to pull off the pendingUpdates
     // list, we pull as many as we can, subject to the following conditions
+    // - Updates are pulled off a single priority's list
     // - Non coalescing updates are executed by themselves
-    auto iter = pendingUpdates_.begin();
-    while (iter != pendingUpdates_.end()) {
+    auto& pendingUpdates = getNextPendingUpdates();
+    auto iter = pendingUpdates.begin();
+    while (iter != pendingUpdates.end()) {
       StateUpdate* update = &(*iter);
       if (update->isNonCoalescing()) {
-        if (iter == pendingUpdates_.begin()) {
+        if (iter == pendingUpdates.begin()) {
           // First update is non coalescing, splice it onto the updates list
           // and apply transaction by itself
           ++iter;
@@ -1907,8 +2083,8 @@ void SwSwitch::handlePendingUpdates() {
       ++iter;
     }
     updates.splice(
-        updates.begin(), pendingUpdates_, pendingUpdates_.begin(), iter);
-    pendingUpdateQueueLength = pendingUpdates_.size();
+        updates.begin(), pendingUpdates, pendingUpdates.begin(), iter);
+    pendingUpdateQueueLength = getNumPendingUpdates();
   }
   stats()->pendingStateUpdateCount(pendingUpdateQueueLength);
 
@@ -1940,6 +2116,14 @@ void SwSwitch::handlePendingUpdates() {
   // a valid switch state
   DCHECK(getState());
 
+  // Trace the updates once the batch is done, however it ends
+  StateUpdateTracer::BatchTimes batchTimes;
+  batchTimes.start = std::chrono::steady_clock::now();
+  std::vector<StateUpdateTracer::UpdateTimes> updateTimes;
+  SCOPE_EXIT {
+    stateUpdateTracer_->record(updateTimes, batchTimes, stats());
+  };
+
   // Call all of the update functions to prepare the new SwitchState
   auto oldAppliedState = getState();
   // We start with the old state, and apply state updates one at a time.
@@ -1949,6 +2133,15 @@ void SwSwitch::handlePendingUpdates() {
     StateUpdate* update = &(*iter);
     ++iter;
 
+    auto& times = updateTimes.emplace_back();
+    times.name = update->getName();
+    times.enqueued = update->enqueueWallTime_;
+    times.queueWait = std::chrono::duration_cast<std::chrono::microseconds>(
+        batchTimes.start - update->enqueueTime_);
+    if (update->getDeadline() && *update->getDeadline() < batchTimes.start) {
+      stats()->stateUpdateDeadlineMissed();
+    }
+    auto applyStart = std::chrono::steady_clock::now();
     shared_ptr<SwitchState> intermediateState;
     XLOG(DBG2) << "preparing state update " << update->getName()
                << "; # Pending updates " << pendingUpdateQueueLength;
@@ -1960,7 +2153,10 @@ void SwSwitch::handlePendingUpdates() {
       // won't call it's onSuccess() function later.
       update->onError(ex);
       delete update;
+      times.failed = true;
     }
+    times.applyUpdate = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - applyStart);
     // We have applied the update to software switch state, so call success
     // on the update.
     if (intermediateState) {
@@ -1980,13 +2176,22 @@ void SwSwitch::handlePendingUpdates() {
   if (newDesiredState != oldAppliedState) {
     auto isTransaction = updates.begin()->hwFailureProtected() &&
         multiHwSwitchHandler_->transactionsSupported();
+    auto pruneEqualContents = std::any_of(
+        updates.begin(), updates.end(), [](const StateUpdate& update) {
+          return update.pruneEqualContents();
+        });
     // There was some change during these state updates
     std::tie(newAppliedState, newDesiredState) = applyUpdate(
         oldAppliedState,
         newDesiredState,
         isTransaction,
-        deltaApplicationBehavior);
+        deltaApplicationBehavior,
+        &batchTimes,
+        pruneEqualContents);
     if (newDesiredState != newAppliedState) {
+      for (auto& times : updateTimes) {
+        times.failed = true;
+      }
       /*
        * Send newAppliedState to EcmpResourceManager and Shel Manager to
        * reconstruct its data structures from. In case of platforms where we
@@ -2057,6 +2262,41 @@ void SwSwitch::handlePendingUpdates() {
   }
 }
 
+SwSwitch::StateUpdateList& SwSwitch::getNextPendingUpdates() {
+  auto now = std::chrono::steady_clock::now();
+  StateUpdateList* expired = nullptr;
+  std::chrono::steady_clock::time_point earliestDeadline;
+  for (auto& pendingUpdates : pendingUpdates_) {
+    // Deadlines are in order within a list, the front has the earliest
+    if (pendingUpdates.empty()) {
+      continue;
+    }
+    const auto& deadline = pendingUpdates.front().getDeadline();
+    if (deadline && *deadline <= now &&
+        (!expired || *deadline < earliestDeadline)) {
+      expired = &pendingUpdates;
+      earliestDeadline = *deadline;
+    }
+  }
+  if (expired) {
+    return *expired;
+  }
+  for (auto& pendingUpdates : pendingUpdates_) {
+    if (!pendingUpdates.empty()) {
+      return pendingUpdates;
+    }
+  }
+  return pendingUpdates_.front();
+}
+
+size_t SwSwitch::getNumPendingUpdates() const {
+  size_t numPendingUpdates = 0;
+  for (const auto& pendingUpdates : pendingUpdates_) {
+    numPendingUpdates += pendingUpdates.size();
+  }
+  return numPendingUpdates;
+}
+
 void SwSwitch::updatePtpTcCounter() {
   // update fb303 counter to reflect current state of PTP
   // should be invoked post update
@@ -2112,7 +2352,9 @@ SwSwitch::applyUpdate(
     const shared_ptr<SwitchState>& oldState,
     const shared_ptr<SwitchState>& newState,
     bool isTransaction,
-    const std::optional<StateDeltaApplication>& deltaApplicationBehavior) {
+    const std::optional<StateDeltaApplication>& deltaApplicationBehavior,
+    StateUpdateTracer::BatchTimes* batchTimes,
+    bool pruneEqualContents) {
   // Check that we are starting from what has been already applied
   DCHECK_EQ(oldState, getAppliedState());
   auto newDesiredState = newState;
@@ -2165,6 +2407,12 @@ SwSwitch::applyUpdate(
     return std::make_pair(oldState, newDesiredState);
   }
 
+  if (pruneEqualContents) {
+    for (auto& delta : deltas) {
+      delta.setPruneEqualContents(true);
+    }
+  }
+
   // Log state deltas that are sent to HwSwitch
   if (stateDeltaLogger_ && FLAGS_enable_state_delta_logging) {
     stateDeltaLogger_->logStateDeltas(
@@ -2173,6 +2421,13 @@ SwSwitch::applyUpdate(
 
   std::shared_ptr<SwitchState> newAppliedState;
 
+  auto hwProgrammingStart = std::chrono::steady_clock::now();
+  if (batchTimes) {
+    batchTimes->validation =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            hwProgrammingStart - start);
+  }
+
   // Inform the HwSwitch of the change.
   //
   // Note that at this point we have already updated the state pointer and
@@ -2205,10 +2460,16 @@ SwSwitch::applyUpdate(
     XLOG(FATAL) << "encountered a fatal error: " << folly::exceptionStr(ex);
   }
 
+  if (batchTimes) {
+    batchTimes->hwProgramming =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - hwProgrammingStart);
+  }
+
   setStateInternal(newAppliedState);
 
   // Notifies all observers of the current state update.
-  notifyStateObservers(StateDelta(oldState, newAppliedState));
+  notifyStateObservers(StateDelta(oldState, newAppliedState), batchTimes);
 
   // Notifies resource accountant of new applied state.
   stateUpdateValidator_->stateChanged(
@@ -2609,10 +2870,14 @@ void SwSwitch::linkStateChanged(
   // link off the prod) can get through quicker.
   if (portType == cfg::PortType::FABRIC_PORT) {
     updateState(
-        "Fabric Port OperState (UP/DOWN) Update", std::move(updateOperStateFn));
+        "Fabric Port OperState (UP/DOWN) Update",
+        std::move(updateOperStateFn),
+        StateUpdate::Priority::CRITICAL);
   } else {
     updateStateNoCoalescing(
-        "Port OperState (UP/DOWN) Update", std::move(updateOperStateFn));
+        "Port OperState (UP/DOWN) Update",
+        std::move(updateOperStateFn),
+        StateUpdate::Priority::CRITICAL);
     if (!up && aggPortId.has_value()) {
       XLOG(DBG2) << "set neighbor caches pending for trunk port "
                  << aggPortId.value();
@@ -3309,7 +3574,7 @@ void SwSwitch::stopThreads() {
     handlePendingUpdates();
     {
       std::unique_lock guard(pendingUpdatesLock_);
-      updatesDrained = pendingUpdates_.empty();
+      updatesDrained = getNumPendingUpdates() == 0;
     }
   } while (!updatesDrained);
 }
@@ -3771,7 +4036,9 @@ void SwSwitch::applyConfigImpl(
   // us.
   auto routeUpdater = getRouteUpdater();
   auto oldConfig = getConfig();
-  updateStateBlocking(
+  // applying config rebuilds the nodes it covers, most of them equal to the
+  // ones they replace
+  updateStateBlockingImpl(
       reason,
       [&](const shared_ptr<SwitchState>& state) -> shared_ptr<SwitchState> {
         auto originalState = state;
@@ -3796,7 +4063,9 @@ void SwSwitch::applyConfigImpl(
           return nullptr;
         }
         return newState;
-      });
+      },
+      static_cast<int>(StateUpdate::BehaviorFlags::PRUNE_EQUAL_CONTENTS),
+      std::nullopt /* deltaApplicationBehavior */);
   if (FLAGS_enable_ecmp_resource_manager) {
     // Since config update can also update ecmp overrides - in
     // case of config changing ecmp switching mode. Sync these
@@ -3912,6 +4181,7 @@ std::shared_ptr<Route<AddressT>> SwSwitch::longestMatch(
     std::shared_ptr<SwitchState> state,
     const AddressT& address,
     RouterID vrf) {
+  // served from the RIB's LPM snapshots with --rib_lpm_snapshot
   return findLongestMatchRoute(getRib(), vrf, address, state);
 }
 
@@ -15,6 +15,8 @@
 #include "fboss/agent/MultiHwSwitchHandler.h"
 #include "fboss/agent/MultiSwitchFb303Stats.h"
 #include "fboss/agent/PacketObserver.h"
+#include "fboss/agent/StateObserverNotifier.h"
+#include "fboss/agent/StateUpdateTracer.h"
 #include "fboss/agent/StateDeltaLogger.h"
 #include "fboss/agent/SwRxPacket.h"
 #include "fboss/agent/SwSwitchRouteUpdateWrapper.h"
@@ -48,14 +50,18 @@
 #include <folly/coro/BoundedQueue.h>
 #endif
 
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <thread>
 #include <type_traits>
 
 DECLARE_bool(rx_sw_priority);
+DECLARE_bool(state_update_priority_scheduling);
+DECLARE_int32(state_update_max_delay_ms);
 
 namespace facebook::fboss {
 
@@ -83,6 +89,7 @@ class NeighborUpdater;
 class PacketLogger;
 class RouteUpdateLogger;
 class StateObserver;
+struct StateUpdatePipeline;
 class TunManager;
 class MirrorManager;
 class TamManager;
@@ -127,6 +134,10 @@ namespace fsdb {
 enum class FsdbSubscriptionState;
 }
 
+namespace thrift_cow {
+class MemoryAccountant;
+}
+
 enum class SwitchFlags : int {
   DEFAULT = 0,
   ENABLE_TUN = 1,
@@ -342,8 +353,14 @@ class SwSwitch : public HwSwitchCallback {
    * send a single update notification to the HwSwitch and other update
    * subscribers.  Therefore the StateUpdateFn may be called with an
    * unpublished SwitchState in some cases.
+   *
+   * Updates of a higher priority may get applied ahead of updates queued
+   * before them, see StateUpdate::Priority.
    */
-  bool updateState(folly::StringPiece name, StateUpdateFn fn);
+  bool updateState(
+      folly::StringPiece name,
+      StateUpdateFn fn,
+      StateUpdate::Priority priority = StateUpdate::Priority::NORMAL);
 
   /**
    * Schedule an update to the switch state.
@@ -357,7 +374,10 @@ class SwSwitch : public HwSwitchCallback {
    * but can be used when there is an update that MUST be seen by the hw
    * implementation, even if the inverse update is immediately applied.
    */
-  void updateStateNoCoalescing(folly::StringPiece name, StateUpdateFn fn);
+  void updateStateNoCoalescing(
+      folly::StringPiece name,
+      StateUpdateFn fn,
+      StateUpdate::Priority priority = StateUpdate::Priority::NORMAL);
 
   /*
    * A version of updateState() that doesn't return until the update has been
@@ -367,7 +387,10 @@ class SwSwitch : public HwSwitchCallback {
    * current thread until the operation completes.
    *
    */
-  void updateStateBlocking(folly::StringPiece name, StateUpdateFn fn);
+  void updateStateBlocking(
+      folly::StringPiece name,
+      StateUpdateFn fn,
+      StateUpdate::Priority priority = StateUpdate::Priority::NORMAL);
 
   /*
    * A version of updateState() that reports back failures in applying state
@@ -385,7 +408,25 @@ class SwSwitch : public HwSwitchCallback {
       folly::StringPiece name,
       StateUpdateFn fn,
       std::optional<StateDeltaApplication> deltaApplicationBehavior =
-          std::nullopt);
+          std::nullopt,
+      StateUpdate::Priority priority = StateUpdate::Priority::NORMAL);
+
+  /*
+   * Pipelined version of updateStateWithHwFailureProtection(), returning as
+   * soon as fn computed the new state rather than once it is applied to Hw.
+   * Errors of fn are thrown right away, the returned future gets the
+   * applied state, or FbossHwUpdateError if applying to Hw failed. Once an
+   * update of the pipeline failed to apply, the updates queued behind it
+   * fail with FbossHwUpdateError without getting applied.
+   */
+  std::shared_future<std::shared_ptr<SwitchState>>
+  updateStateWithHwFailureProtectionPipelined(
+      folly::StringPiece name,
+      StateUpdateFn fn,
+      const std::shared_ptr<StateUpdatePipeline>& pipeline,
+      std::optional<StateDeltaApplication> deltaApplicationBehavior =
+          std::nullopt,
+      StateUpdate::Priority priority = StateUpdate::Priority::NORMAL);
 
   /**
    * Apply config from the config file (specified in 'config' flag).
@@ -792,6 +833,19 @@ class SwSwitch : public HwSwitchCallback {
     return routeUpdateLogger_.get();
   }
 
+  /*
+   * Get the latency traces of the last state updates
+   */
+  const StateUpdateTracer* getStateUpdateTracer() const {
+    return stateUpdateTracer_.get();
+  }
+
+  /*
+   * Estimated memory held by the current state, by node type and by path,
+   * for the paths at most pathDepth levels deep
+   */
+  StateMemoryUsage getStateMemoryUsage(size_t pathDepth) const;
+
   LinkAggregationManager* getLagManager() {
     return lagManager_.get();
   }
@@ -1064,7 +1118,8 @@ class SwSwitch : public HwSwitchCallback {
       folly::StringPiece name,
       StateUpdateFn fn,
       int stateUpdateBehavior,
-      std::optional<StateDeltaApplication> deltaApplicationBehavior);
+      std::optional<StateDeltaApplication> deltaApplicationBehavior,
+      StateUpdate::Priority priority = StateUpdate::Priority::NORMAL);
 
   /*
    * Applied state corresponds to what was successfully applied
@@ -1089,6 +1144,7 @@ class SwSwitch : public HwSwitchCallback {
 
   void updatePortInfo();
   void updateRouteStats();
+  void updateStateMemoryStats();
   void updateTeFlowStats();
   void updateFlowletStats();
   void updateFabricLinkMonitoringStats();
@@ -1106,12 +1162,22 @@ class SwSwitch : public HwSwitchCallback {
   void updatePtpTcCounter();
   static void handlePendingUpdatesHelper(SwSwitch* sw);
   void handlePendingUpdates();
+  /*
+   * The queue of the pending updates to apply next: the one whose front
+   * update is the furthest past its deadline, if any, else the highest
+   * priority one.
+   * Must be called with pendingUpdatesLock_ held.
+   */
+  StateUpdateList& getNextPendingUpdates();
+  size_t getNumPendingUpdates() const;
   std::pair<std::shared_ptr<SwitchState>, std::shared_ptr<SwitchState>>
   applyUpdate(
       const std::shared_ptr<SwitchState>& oldState,
       const std::shared_ptr<SwitchState>& newState,
       bool isTransaction,
-      const std::optional<StateDeltaApplication>& deltaApplicationBehavior);
+      const std::optional<StateDeltaApplication>& deltaApplicationBehavior,
+      StateUpdateTracer::BatchTimes* batchTimes = nullptr,
+      bool pruneEqualContents = false);
 
   void startThreads();
   void stopThreads();
@@ -1137,7 +1203,9 @@ class SwSwitch : public HwSwitchCallback {
   /*
    * Notifies all the observers that a state update occurred.
    */
-  void notifyStateObservers(const StateDelta& delta);
+  void notifyStateObservers(
+      const StateDelta& delta,
+      StateUpdateTracer::BatchTimes* batchTimes = nullptr);
 
   /*
    * Reconstruct state modifier from initial switch state.
@@ -1274,10 +1342,10 @@ class SwSwitch : public HwSwitchCallback {
   std::unique_ptr<TunManager> tunMgr_;
 
   /*
-   * A list of pending state updates to be applied.
+   * The lists of pending state updates to be applied, one per priority.
    */
   folly::SpinLock pendingUpdatesLock_;
-  StateUpdateList pendingUpdates_;
+  std::array<StateUpdateList, StateUpdate::kNumPriorities> pendingUpdates_;
 
   /*
    * The current switch state represented as :  appliedState,
@@ -1367,7 +1435,9 @@ class SwSwitch : public HwSwitchCallback {
    * be accessed/modified from the update thread. This removes the need for
    * locking when we access the container during a state update.
    */
-  std::map<StateObserver*, std::string> stateObservers_;
+  std::unique_ptr<StateObserverNotifier> stateObservers_;
+  // Only recorded into from the update thread
+  std::unique_ptr<StateUpdateTracer> stateUpdateTracer_;
   std::unique_ptr<PacketObservers> pktObservers_;
   std::unique_ptr<L2LearnEventObservers> l2LearnEventObservers_;
 
@@ -1426,6 +1496,10 @@ class SwSwitch : public HwSwitchCallback {
   folly::Synchronized<ConfigAppliedInfo> configAppliedInfo_;
   std::optional<std::chrono::time_point<std::chrono::steady_clock>>
       publishedStatsToFsdbAt_;
+  std::optional<std::chrono::time_point<std::chrono::steady_clock>>
+      stateMemoryStatsUpdatedAt_;
+  // accounts successive states incrementally, see updateStateMemoryStats()
+  std::unique_ptr<thrift_cow::MemoryAccountant> stateMemoryAccountant_;
   std::unique_ptr<MultiSwitchPacketStreamMap> packetStreamMap_;
   std::unique_ptr<SwSwitchWarmBootHelper> swSwitchWarmbootHelper_;
   std::unique_ptr<HwSwitchThriftClientTable> hwSwitchThriftClientTable_;
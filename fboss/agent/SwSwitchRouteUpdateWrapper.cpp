@@ -17,12 +17,45 @@
 #include "fboss/agent/rib/RibToSwitchStateUpdater.h"
 #include "fboss/agent/rib/RouteUpdater.h"
 
+#include "fboss/agent/state/StateUpdateHelpers.h"
 #include "fboss/agent/state/SwitchState.h"
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace facebook::fboss {
 
+namespace {
+template <typename... UpdaterArgs>
+StateDelta updateSwitchState(
+    void* cookie,
+    const std::optional<StateDeltaApplication>& deltaApplicationBehavior,
+    UpdaterArgs&&... updaterArgs) {
+  folly::Synchronized<facebook::fboss::RibToSwitchStateUpdater>
+      ribToSwitchStateUpdater(
+          std::in_place, std::forward<UpdaterArgs>(updaterArgs)...);
+
+  auto wRibToSwitchStateUpdater = ribToSwitchStateUpdater.wlock();
+  auto sw = static_cast<facebook::fboss::SwSwitch*>(cookie);
+
+  sw->updateStateWithHwFailureProtection(
+      "update fib",
+      [&wRibToSwitchStateUpdater](const std::shared_ptr<SwitchState>& in) {
+        return (*wRibToSwitchStateUpdater)(in);
+      },
+      deltaApplicationBehavior,
+      StateUpdate::Priority::BULK);
+
+  auto lastDelta = wRibToSwitchStateUpdater->getLastDelta();
+  // Fib update could get cancelled - e.g. when SwSwitch already started its
+  // exit. In that case last delta will be empty. Account for this case
+  auto oldState =
+      lastDelta ? lastDelta->oldState() : std::make_shared<SwitchState>();
+  return StateDelta(oldState, sw->getState());
+}
+} // namespace
+
 RibToSwitchStateFunction createRibToSwitchStateFunction(
     const std::optional<StateDeltaApplication>& deltaApplicationBehavior) {
   return [deltaApplicationBehavior](
@@ -34,33 +67,74 @@ RibToSwitchStateFunction createRibToSwitchStateFunction(
              const NextHopIDManager* nextHopIDManager,
              const MySidTable& mySidTable,
              void* cookie) -> StateDelta {
-    folly::Synchronized<facebook::fboss::RibToSwitchStateUpdater>
-        ribToSwitchStateUpdater(
-            std::in_place,
-            resolver,
-            vrf,
-            v4NetworkToRoute,
-            v6NetworkToRoute,
-            labelToRoute,
-            nextHopIDManager,
-            mySidTable);
-
-    auto wRibToSwitchStateUpdater = ribToSwitchStateUpdater.wlock();
+    return updateSwitchState(
+        cookie,
+        deltaApplicationBehavior,
+        resolver,
+        vrf,
+        v4NetworkToRoute,
+        v6NetworkToRoute,
+        labelToRoute,
+        nextHopIDManager,
+        mySidTable);
+  };
+}
+
+MultiVrfRibToSwitchStateFunction createMultiVrfRibToSwitchStateFunction(
+    const std::optional<StateDeltaApplication>& deltaApplicationBehavior) {
+  return [deltaApplicationBehavior](
+             const facebook::fboss::SwitchIdScopeResolver* resolver,
+             const std::vector<VrfNetworkToRouteMaps>& vrfRouteMaps,
+             const NextHopIDManager* nextHopIDManager,
+             const MySidTable& mySidTable,
+             void* cookie) -> StateDelta {
+    return updateSwitchState(
+        cookie,
+        deltaApplicationBehavior,
+        resolver,
+        vrfRouteMaps,
+        nextHopIDManager,
+        mySidTable);
+  };
+}
+
+PipelinedRibToSwitchStateFunction createPipelinedRibToSwitchStateFunction(
+    const std::optional<StateDeltaApplication>& deltaApplicationBehavior) {
+  return [deltaApplicationBehavior](
+             const facebook::fboss::SwitchIdScopeResolver* resolver,
+             facebook::fboss::RouterID vrf,
+             const facebook::fboss::IPv4NetworkToRouteMap& v4NetworkToRoute,
+             const facebook::fboss::IPv6NetworkToRouteMap& v6NetworkToRoute,
+             const facebook::fboss::LabelToRouteMap& labelToRoute,
+             const NextHopIDManager* nextHopIDManager,
+             const MySidTable& mySidTable,
+             const std::shared_ptr<StateUpdatePipeline>& pipeline,
+             void* cookie) -> PipelinedFibUpdate {
+    RibToSwitchStateUpdater ribToSwitchStateUpdater(
+        resolver,
+        vrf,
+        v4NetworkToRoute,
+        v6NetworkToRoute,
+        labelToRoute,
+        nextHopIDManager,
+        mySidTable);
     auto sw = static_cast<facebook::fboss::SwSwitch*>(cookie);
 
-    sw->updateStateWithHwFailureProtection(
+    // Returns once the updater ran, so it may live on our stack
+    auto appliedState = sw->updateStateWithHwFailureProtectionPipelined(
         "update fib",
-        [&wRibToSwitchStateUpdater](const std::shared_ptr<SwitchState>& in) {
-          return (*wRibToSwitchStateUpdater)(in);
+        [&ribToSwitchStateUpdater](const std::shared_ptr<SwitchState>& in) {
+          return ribToSwitchStateUpdater(in);
         },
-        deltaApplicationBehavior);
+        pipeline,
+        deltaApplicationBehavior,
+        StateUpdate::Priority::BULK);
 
-    auto lastDelta = wRibToSwitchStateUpdater->getLastDelta();
-    // Fib update could get cancelled - e.g. when SwSwitch already started its
-    // exit. In that case last delta will be empty. Account for this case
+    auto lastDelta = ribToSwitchStateUpdater.getLastDelta();
+    // As in updateSwitchState(), the update could get cancelled
     auto oldState =
         lastDelta ? lastDelta->oldState() : std::make_shared<SwitchState>();
-    return StateDelta(oldState, sw->getState());
+    return {std::move(oldState), std::move(appliedState)};
   };
 }
 
@@ -73,7 +147,12 @@ SwSwitchRouteUpdateWrapper::SwSwitchRouteUpdateWrapper(
           rib,
           rib ? createRibToSwitchStateFunction(deltaApplicationBehavior)
               : std::optional<RibToSwitchStateFunction>(),
-          rib ? sw : nullptr),
+          rib ? sw : nullptr,
+          rib ? createMultiVrfRibToSwitchStateFunction(deltaApplicationBehavior)
+              : MultiVrfRibToSwitchStateFunction(),
+          rib ? createPipelinedRibToSwitchStateFunction(
+                    deltaApplicationBehavior)
+              : PipelinedRibToSwitchStateFunction()),
       sw_(sw) {}
 
 void SwSwitchRouteUpdateWrapper::updateStats(
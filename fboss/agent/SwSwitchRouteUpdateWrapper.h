@@ -22,6 +22,14 @@ RibToSwitchStateFunction createRibToSwitchStateFunction(
     const std::optional<StateDeltaApplication>& deltaApplicationBehavior =
         std::nullopt);
 
+MultiVrfRibToSwitchStateFunction createMultiVrfRibToSwitchStateFunction(
+    const std::optional<StateDeltaApplication>& deltaApplicationBehavior =
+        std::nullopt);
+
+PipelinedRibToSwitchStateFunction createPipelinedRibToSwitchStateFunction(
+    const std::optional<StateDeltaApplication>& deltaApplicationBehavior =
+        std::nullopt);
+
 class SwSwitchRouteUpdateWrapper : public RouteUpdateWrapper {
  public:
   explicit SwSwitchRouteUpdateWrapper(
@@ -14,6 +14,7 @@
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/rib/RoutingInformationBase.h"
 #include "fboss/agent/state/SwitchState.h"
+#include "fboss/lib/CommonFileUtils.h"
 #include "fboss/lib/WarmBootFileUtils.h"
 
 namespace facebook::fboss {
@@ -108,6 +109,41 @@ std::string SwSwitchWarmBootHelper::warmBootThriftSwitchStateFile() const {
       warmBootDir_, "/", FLAGS_thrift_switch_state_file);
 }
 
+bool SwSwitchWarmBootHelper::storeRibWarmBootState(
+    const RoutingInformationBase& rib) {
+  auto ribStateFile = warmBootRibStateFile();
+  if (!asicCanWarmBoot_ || !FLAGS_rib_warmboot_file) {
+    removeFile(ribStateFile);
+    return true;
+  }
+  try {
+    rib.writeWarmBootStateFile(ribStateFile);
+  } catch (const std::exception& ex) {
+    XLOG(ERR) << "Failed to write RIB warm boot state to " << ribStateFile
+              << ": " << ex.what();
+    removeFile(ribStateFile);
+    return false;
+  }
+  return true;
+}
+
+std::optional<std::string> SwSwitchWarmBootHelper::getRibWarmBootStateFile()
+    const {
+  if (recoveredStateFromHW_.has_value()) {
+    return std::nullopt;
+  }
+  auto ribStateFile = warmBootRibStateFile();
+  if (!checkFileExists(ribStateFile)) {
+    return std::nullopt;
+  }
+  return ribStateFile;
+}
+
+std::string SwSwitchWarmBootHelper::warmBootRibStateFile() const {
+  return folly::to<std::string>(
+      warmBootDir_, "/", FLAGS_rib_warmboot_state_file);
+}
+
 void SwSwitchWarmBootHelper::setCanWarmBoot() {
   auto warmBootFlagPath = directoryUtil_->getSwSwitchCanWarmBootFile();
   WarmBootFileUtils::setCanWarmBoot(warmBootFlagPath);
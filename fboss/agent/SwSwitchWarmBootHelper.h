@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <optional>
 #include <string>
 
 #include "fboss/agent/gen-cpp2/switch_state_types.h"
@@ -25,6 +26,17 @@ class SwSwitchWarmBootHelper {
   void storeWarmBootState(const state::WarmbootState& switchStateThrift);
   state::WarmbootState getWarmBootState() const;
   std::string warmBootThriftSwitchStateFile() const;
+  /*
+   * With rib_warmboot_file set, RIB warm boot state is streamed to a file
+   * of its own rather than going in the WarmbootState thrift. Otherwise
+   * any such file left from an earlier exit is removed, so that it can't
+   * be picked up by the next warm boot. Returns false if the file was due
+   * but could not be written, the RIB then has to go in the thrift.
+   */
+  bool storeRibWarmBootState(const RoutingInformationBase& rib);
+  // Streamed RIB warm boot state to warm boot from, if any
+  std::optional<std::string> getRibWarmBootStateFile() const;
+  std::string warmBootRibStateFile() const;
   const std::string& warmBootDir() const {
     return warmBootDir_;
   }
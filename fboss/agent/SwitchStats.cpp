@@ -144,6 +144,24 @@ SwitchStats::SwitchStats(ThreadLocalStatsMap* map, int numSwitches)
           kCounterPrefix + "rib_route_programming_time.us",
           facebook::fb303::ExportTypeConsts::kCountAvg,
           facebook::fb303::QuantileConsts::kP50_P95_P99_P100),
+      routeUpdateCoalesceBatchSize_(
+          kCounterPrefix + "route_update_coalesce_batch_size",
+          facebook::fb303::ExportTypeConsts::kCountAvg,
+          facebook::fb303::QuantileConsts::kP50_P95_P99_P100),
+      routeUpdateCoalesceDelayUs_(
+          kCounterPrefix + "route_update_coalesce_delay.us",
+          facebook::fb303::ExportTypeConsts::kCountAvg,
+          facebook::fb303::QuantileConsts::kP50_P95_P99_P100),
+      // key param is state observer name
+      stateObserverNotifyTimeUs_(
+          kCounterPrefix + "state_observer.{}.notify_time.us",
+          facebook::fb303::ExportTypeConsts::kCountAvg,
+          facebook::fb303::QuantileConsts::kP50_P95_P99_P100),
+      // key params are update name and stage
+      stateUpdateStageTimeUs_(
+          kCounterPrefix + "state_update.{}.{}.us",
+          facebook::fb303::ExportTypeConsts::kCountAvg,
+          facebook::fb303::QuantileConsts::kP50_P95_P99_P100),
       thriftRequestCompletionTimeMs_(
           kCounterPrefix + "thrift_request_completion_time.ms",
           facebook::fb303::ExportTypeConsts::kCountAvg,
@@ -305,6 +323,11 @@ SwitchStats::SwitchStats(ThreadLocalStatsMap* map, int numSwitches)
           0,
           10000,
           AVG),
+      stateUpdateDeadlineMissed_(
+          map,
+          kCounterPrefix + "state_update.deadline_missed",
+          SUM,
+          RATE),
       linkStateChange_(map, kCounterPrefix + "link_state.flap", SUM),
       linkFault_(map, kCounterPrefix + "link_fault", SUM),
       linkActiveStateChange_(
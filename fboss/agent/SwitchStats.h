@@ -291,6 +291,27 @@ class SwitchStats : public boost::noncopyable, public ThriftCallDurationLogger {
     ribRouteProgrammingTimeUs_.addValue(us.count());
   }
 
+  void routeUpdateCoalesceBatchSize(size_t numCalls) {
+    routeUpdateCoalesceBatchSize_.addValue(numCalls);
+  }
+
+  void routeUpdateCoalesceDelayUs(std::chrono::microseconds us) {
+    routeUpdateCoalesceDelayUs_.addValue(us.count());
+  }
+
+  void stateObserverNotifyTime(
+      std::string_view observer,
+      std::chrono::microseconds us) {
+    stateObserverNotifyTimeUs_.addValue(us.count(), observer);
+  }
+
+  void stateUpdateStageTime(
+      std::string_view update,
+      std::string_view stage,
+      std::chrono::microseconds us) {
+    stateUpdateStageTimeUs_.addValue(us.count(), update, stage);
+  }
+
   void cpuLatencyUs(double latencyUs) {
     cpuLatencyUs_.addValue(latencyUs);
   }
@@ -363,6 +384,10 @@ class SwitchStats : public boost::noncopyable, public ThriftCallDurationLogger {
     pendingStateUpdateCount_.addValue(value);
   }
 
+  void stateUpdateDeadlineMissed() {
+    stateUpdateDeadlineMissed_.addValue(1);
+  }
+
   void thriftRequestCompletionTimeMs(std::chrono::milliseconds ms) override {
     thriftRequestCompletionTimeMs_.addValue(ms.count());
   }
@@ -1028,6 +1053,28 @@ class SwitchStats : public boost::noncopyable, public ThriftCallDurationLogger {
    */
   fb303::detail::QuantileStatWrapper ribRouteProgrammingTimeUs_;
 
+  /**
+   * Histogram for number of route update calls coalesced into one RIB update
+   */
+  fb303::detail::QuantileStatWrapper routeUpdateCoalesceBatchSize_;
+
+  /**
+   * Histogram for latency added to route updates by coalescing (microseconds)
+   */
+  fb303::detail::QuantileStatWrapper routeUpdateCoalesceDelayUs_;
+
+  /**
+   * Histogram for time taken by each state observer to process a state
+   * update (microseconds), keyed by observer name
+   */
+  fb303::detail::DynamicQuantileStatWrapper<1> stateObserverNotifyTimeUs_;
+
+  /**
+   * Histogram for time spent by state updates in each stage of the update
+   * thread (microseconds), keyed by update name and stage
+   */
+  fb303::detail::DynamicQuantileStatWrapper<2> stateUpdateStageTimeUs_;
+
   /**
    * Histogram for time used for thrift request completion time (milliseconds)
    */
@@ -1115,6 +1162,11 @@ class SwitchStats : public boost::noncopyable, public ThriftCallDurationLogger {
    */
   TLHistogram pendingStateUpdateCount_;
 
+  /**
+   * Number of state updates applied after their deadline
+   */
+  TLTimeseries stateUpdateDeadlineMissed_;
+
   /**
    * Link state up/down change count
    */
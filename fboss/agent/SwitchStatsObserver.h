@@ -13,6 +13,10 @@ class SwitchStatsObserver : public StateObserver {
   explicit SwitchStatsObserver(SwSwitch* sw);
   ~SwitchStatsObserver() override;
   void stateUpdated(const StateDelta& delta) override;
+  // Only reads the delta and bumps thread local counters
+  bool isThreadSafe() const override {
+    return true;
+  }
 
  private:
   template <typename NTableT>
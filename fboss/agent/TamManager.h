@@ -41,6 +41,10 @@ class TamManager : public StateObserver {
   TamManager& operator=(TamManager&&) = delete;
 
   void stateUpdated(const StateDelta& delta) override;
+  // Only schedules a state update when it needs to
+  bool isThreadSafe() const override {
+    return true;
+  }
 
  private:
   SwSwitch* sw_;
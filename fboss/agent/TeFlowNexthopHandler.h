@@ -14,6 +14,10 @@ class TeFlowNexthopHandler : public StateObserver {
   ~TeFlowNexthopHandler() override;
 
   void stateUpdated(const StateDelta& delta) override;
+  // Only schedules a state update when it needs to
+  bool isThreadSafe() const override {
+    return true;
+  }
 
  private:
   std::shared_ptr<SwitchState> handleUpdate(
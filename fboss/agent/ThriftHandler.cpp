@@ -25,6 +25,7 @@
 #include "fboss/agent/LinkAggregationManager.h"
 #include "fboss/agent/LldpManager.h"
 #include "fboss/agent/NeighborUpdater.h"
+#include "fboss/agent/RouteUpdateCoalescer.h"
 #include "fboss/agent/RouteUpdateLogger.h"
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/SwSwitchMySidUpdater.h"
@@ -116,6 +117,12 @@ DEFINE_bool(
     false, // false => Prevents such mutations in prod
     "Allow mutations of running switch state by external thrift calls");
 
+DEFINE_int32(
+    route_update_coalesce_window_us,
+    0,
+    "If set, addUnicastRoutes and deleteUnicastRoutes calls of a client "
+    "arriving within this many microseconds are merged into one RIB update");
+
 DECLARE_bool(enable_acl_table_group);
 
 namespace facebook::fboss {
@@ -792,7 +799,25 @@ std::optional<std::string> getDefaultSrv6TunnelId(
 
 namespace facebook::fboss {
 
-ThriftHandler::ThriftHandler(SwSwitch* sw) : FacebookBase2("FBOSS"), sw_(sw) {}
+ThriftHandler::ThriftHandler(SwSwitch* sw) : FacebookBase2("FBOSS"), sw_(sw) {
+  if (FLAGS_route_update_coalesce_window_us > 0) {
+    routeUpdateCoalescer_ = std::make_unique<RouteUpdateCoalescer>(
+        std::chrono::microseconds(FLAGS_route_update_coalesce_window_us),
+        [this](const RouteUpdateCoalescer::Batch& batch) {
+          sw_->stats()->routeUpdateCoalesceBatchSize(batch.numCalls);
+          auto updater = sw_->getRouteUpdater();
+          for (const auto& route : batch.toAdd) {
+            updater.addRoute(batch.vrf, batch.client, route);
+          }
+          for (const auto& prefix : batch.toDel) {
+            updater.delRoute(batch.vrf, prefix, batch.client);
+          }
+          updater.program();
+        });
+  }
+}
+
+ThriftHandler::~ThriftHandler() = default;
 
 fb_status ThriftHandler::getStatus() {
   if (sw_->isExiting()) {
@@ -899,15 +924,25 @@ void ThriftHandler::deleteUnicastRoutesInVrf(
   auto log = LOG_THRIFT_CALL_WITH_STATS(DBG1, sw_->stats(), clientName);
   ensureNotFabric(__func__);
 
-  auto updater = sw_->getRouteUpdater();
   auto routerID = RouterID(vrf);
   auto clientID = ClientID(client);
-  for (const auto& prefix : *prefixes) {
-    updater.delRoute(routerID, prefix, clientID);
-  }
   // count the number of times we attempt to update the FIB
   sw_->stats()->routeProgrammingUpdateAttempts();
 
+  if (routeUpdateCoalescer_) {
+    try {
+      sw_->stats()->routeUpdateCoalesceDelayUs(
+          routeUpdateCoalescer_->delRoutes(routerID, clientID, *prefixes));
+    } catch (const FbossHwUpdateError& ex) {
+      sw_->stats()->routeProgrammingUpdateFailures();
+      translateToFibError(ex);
+    }
+    return;
+  }
+  auto updater = sw_->getRouteUpdater();
+  for (const auto& prefix : *prefixes) {
+    updater.delRoute(routerID, prefix, clientID);
+  }
   try {
     updater.program();
   } catch (const FbossHwUpdateError& ex) {
@@ -976,7 +1011,6 @@ void ThriftHandler::updateUnicastRoutesImpl(
     const std::unique_ptr<std::vector<UnicastRoute>>& routes,
     const std::string& updType,
     bool sync) {
-  auto updater = sw_->getRouteUpdater();
   auto routerID = RouterID(vrf);
   auto clientID = ClientID(client);
   auto defaultSrv6TunnelId = getDefaultSrv6TunnelId(sw_->getConfig());
@@ -994,6 +1028,26 @@ void ThriftHandler::updateUnicastRoutesImpl(
             NamedRouteDestination::Type::nextHopGroup) {
       route.counterID() = *route.namedRouteDestination()->nextHopGroup_ref();
     }
+  }
+  // count the number of times we attempt to update the FIB
+  sw_->stats()->routeProgrammingUpdateAttempts();
+
+  if (routeUpdateCoalescer_) {
+    if (!sync) {
+      try {
+        sw_->stats()->routeUpdateCoalesceDelayUs(
+            routeUpdateCoalescer_->addRoutes(routerID, clientID, *routes));
+      } catch (const FbossHwUpdateError& ex) {
+        sw_->stats()->routeProgrammingUpdateFailures();
+        translateToFibError(ex);
+      }
+      return;
+    }
+    // Earlier updates of the client must not land on top of the sync
+    routeUpdateCoalescer_->flush(routerID, clientID);
+  }
+  auto updater = sw_->getRouteUpdater();
+  for (const auto& route : *routes) {
     updater.addRoute(routerID, clientID, route);
   }
   RouteUpdateWrapper::SyncFibFor syncFibs;
@@ -1001,8 +1055,6 @@ void ThriftHandler::updateUnicastRoutesImpl(
   if (sync) {
     syncFibs.insert({routerID, clientID});
   }
-  // count the number of times we attempt to update the FIB
-  sw_->stats()->routeProgrammingUpdateAttempts();
 
   try {
     updater.program(
@@ -2414,6 +2466,27 @@ void ThriftHandler::getMplsRouteUpdateLoggingTrackedLabels(
   }
 }
 
+void ThriftHandler::getStateUpdateTraces(
+    std::vector<StateUpdateTrace>& traces,
+    int32_t count) {
+  auto log = LOG_THRIFT_CALL_WITH_STATS(DBG1, sw_->stats());
+  if (count < 0) {
+    throw FbossError("Invalid state update trace count: ", count);
+  }
+  traces = sw_->getStateUpdateTracer()->getTraces(count);
+}
+
+void ThriftHandler::getSwitchStateMemoryUsage(
+    StateMemoryUsage& usage,
+    int32_t pathDepth) {
+  auto log = LOG_THRIFT_CALL_WITH_STATS(DBG1, sw_->stats());
+  ensureConfigured(__func__);
+  if (pathDepth < 0) {
+    throw FbossError("Invalid switch state path depth: ", pathDepth);
+  }
+  usage = sw_->getStateMemoryUsage(pathDepth);
+}
+
 void ThriftHandler::sendPkt(
     int32_t port,
     int32_t vlan,
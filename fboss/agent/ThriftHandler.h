@@ -38,6 +38,7 @@ class Vlan;
 class SwitchState;
 class AclEntry;
 class LinkNeighbor;
+class RouteUpdateCoalescer;
 
 class ThriftHandler : virtual public FbossCtrlSvIf,
                       public fb303::FacebookBase2 {
@@ -53,6 +54,7 @@ class ThriftHandler : virtual public FbossCtrlSvIf,
   using BinaryAddresses = std::vector<BinaryAddress>;
 
   explicit ThriftHandler(SwSwitch* sw);
+  ~ThriftHandler() override;
 
   fb303::cpp2::fb_status getStatus() override;
 
@@ -313,6 +315,13 @@ class ThriftHandler : virtual public FbossCtrlSvIf,
   void getMplsRouteUpdateLoggingTrackedLabels(
       std::vector<MplsRouteUpdateLoggingInfo>& infos) override;
 
+  void getStateUpdateTraces(
+      std::vector<StateUpdateTrace>& traces,
+      int32_t count) override;
+
+  void getSwitchStateMemoryUsage(StateMemoryUsage& usage, int32_t pathDepth)
+      override;
+
   void getRouteCounterBytes(
       std::map<std::string, std::int64_t>& routeCounters,
       std::unique_ptr<std::vector<std::string>> counters) override;
@@ -572,6 +581,8 @@ class ThriftHandler : virtual public FbossCtrlSvIf,
   apache::thrift::SSLPolicy sslPolicy_;
 
   std::unordered_set<uint16_t> syncedFibClients_;
+  // Set with --route_update_coalesce_window_us
+  std::unique_ptr<RouteUpdateCoalescer> routeUpdateCoalescer_;
 };
 
 } // namespace facebook::fboss
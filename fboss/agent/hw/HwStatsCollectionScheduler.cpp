@@ -0,0 +1,178 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/HwStatsCollectionScheduler.h"
+
+#include <fb303/ServiceData.h>
+#include <fb303/ThreadCachedServiceData.h>
+#include <fmt/format.h>
+#include <folly/ExceptionString.h>
+#include <folly/logging/xlog.h>
+#include <folly/system/ThreadName.h>
+
+#include <algorithm>
+
+namespace facebook::fboss {
+
+namespace {
+constexpr auto kMinStatsCollectionInterval = std::chrono::milliseconds(1);
+} // namespace
+
+std::chrono::milliseconds nextStatsCollectionInterval(
+    std::chrono::milliseconds current,
+    std::chrono::milliseconds baseInterval,
+    std::chrono::milliseconds maxInterval,
+    std::chrono::microseconds duration,
+    bool changed,
+    uint32_t maxDutyCyclePct) {
+  maxInterval = std::max(maxInterval, baseInterval);
+  // Counters that are changing are collected at the base interval, idle
+  // ones back off exponentially.
+  auto next = changed ? baseInterval : std::min(current * 2, maxInterval);
+  if (maxDutyCyclePct > 0) {
+    auto costBound = std::chrono::duration_cast<std::chrono::milliseconds>(
+        duration * 100 / maxDutyCyclePct);
+    next = std::max(next, costBound);
+  }
+  return std::clamp(next, baseInterval, maxInterval);
+}
+
+HwStatsCollectionScheduler::HwStatsCollectionScheduler(
+    uint32_t maxBackoffFactor,
+    uint32_t maxDutyCyclePct,
+    std::optional<std::string> statsPrefix)
+    : maxBackoffFactor_(std::max<uint32_t>(maxBackoffFactor, 1)),
+      maxDutyCyclePct_(std::min<uint32_t>(maxDutyCyclePct, 100)),
+      statsPrefix_(std::move(statsPrefix)) {}
+
+HwStatsCollectionScheduler::~HwStatsCollectionScheduler() {
+  stop();
+}
+
+void HwStatsCollectionScheduler::addStatsClass(
+    const std::string& name,
+    std::chrono::milliseconds baseInterval,
+    CollectFn collect) {
+  CHECK(!running_) << "Cannot add stats class " << name
+                   << " to a running scheduler";
+  auto statsClass = std::make_unique<StatsClass>();
+  statsClass->name = name;
+  statsClass->baseInterval =
+      std::max(baseInterval, kMinStatsCollectionInterval);
+  statsClass->maxInterval = statsClass->baseInterval * maxBackoffFactor_;
+  statsClass->collect = std::move(collect);
+  statsClass->intervalMs = statsClass->baseInterval.count();
+  auto durationKey = getCounterName(*statsClass, "duration_us");
+  fb303::ThreadCachedServiceData::get()->addStatExportType(
+      durationKey, fb303::AVG);
+  fb303::ThreadCachedServiceData::get()->addStatExportType(
+      durationKey, fb303::MAX);
+  statsClasses_.push_back(std::move(statsClass));
+}
+
+void HwStatsCollectionScheduler::start() {
+  if (running_) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(stopMutex_);
+    stopRequested_ = false;
+  }
+  for (auto& statsClass : statsClasses_) {
+    statsClass->thread = std::make_unique<std::thread>(
+        [this, statsClass = statsClass.get()] { runStatsClass(*statsClass); });
+  }
+  running_ = true;
+  XLOG(DBG2) << "Started " << statsClasses_.size()
+             << " hw stats collection threads";
+}
+
+void HwStatsCollectionScheduler::stop() {
+  if (!running_) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(stopMutex_);
+    stopRequested_ = true;
+  }
+  stopCv_.notify_all();
+  for (auto& statsClass : statsClasses_) {
+    statsClass->thread->join();
+    statsClass->thread.reset();
+  }
+  running_ = false;
+  XLOG(DBG2) << "Stopped hw stats collection threads";
+}
+
+std::optional<std::chrono::milliseconds>
+HwStatsCollectionScheduler::getInterval(const std::string& name) const {
+  for (const auto& statsClass : statsClasses_) {
+    if (statsClass->name == name) {
+      return std::chrono::milliseconds(statsClass->intervalMs.load());
+    }
+  }
+  return std::nullopt;
+}
+
+void HwStatsCollectionScheduler::runStatsClass(StatsClass& statsClass) {
+  folly::setThreadName(fmt::format("HwStats.{}", statsClass.name));
+  while (true) {
+    collectOnce(statsClass);
+    std::unique_lock<std::mutex> lock(stopMutex_);
+    if (stopCv_.wait_for(
+            lock,
+            std::chrono::milliseconds(statsClass.intervalMs.load()),
+            [this] { return stopRequested_; })) {
+      return;
+    }
+  }
+}
+
+void HwStatsCollectionScheduler::collectOnce(StatsClass& statsClass) {
+  auto begin = std::chrono::steady_clock::now();
+  // A failed collection is retried at the base interval
+  bool changed = true;
+  try {
+    auto digest = statsClass.collect();
+    changed = !digest.has_value() || digest != statsClass.lastDigest;
+    statsClass.lastDigest = digest;
+  } catch (const std::exception& ex) {
+    XLOG(ERR) << "Error collecting " << statsClass.name << " hw stats "
+              << folly::exceptionStr(ex);
+    fb303::ThreadCachedServiceData::get()->addStatValue(
+        getCounterName(statsClass, "failures"), 1, fb303::SUM);
+  }
+  auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - begin);
+  auto next = nextStatsCollectionInterval(
+      std::chrono::milliseconds(statsClass.intervalMs.load()),
+      statsClass.baseInterval,
+      statsClass.maxInterval,
+      duration,
+      changed,
+      maxDutyCyclePct_);
+  statsClass.intervalMs = next.count();
+  fb303::ThreadCachedServiceData::get()->addStatValue(
+      getCounterName(statsClass, "duration_us"), duration.count());
+  fb303::fbData->setCounter(
+      getCounterName(statsClass, "interval_ms"), next.count());
+}
+
+std::string HwStatsCollectionScheduler::getCounterName(
+    const StatsClass& statsClass,
+    const std::string& suffix) const {
+  return fmt::format(
+      "{}hw_stats_collection.{}.{}",
+      statsPrefix_.value_or(""),
+      statsClass.name,
+      suffix);
+}
+
+} // namespace facebook::fboss
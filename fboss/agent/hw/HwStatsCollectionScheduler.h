@@ -0,0 +1,112 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * Next collection interval of a stats class, given its current interval and
+ * the outcome of the collection that just finished.
+ *
+ * A class whose counters changed is collected at its base interval again. A
+ * class whose counters did not change backs off exponentially, up to
+ * maxInterval. Independent of that, the interval never drops below
+ * duration * 100 / maxDutyCyclePct, so a class whose collection gets more
+ * expensive is scheduled less often instead of monopolizing the SDK.
+ */
+std::chrono::milliseconds nextStatsCollectionInterval(
+    std::chrono::milliseconds current,
+    std::chrono::milliseconds baseInterval,
+    std::chrono::milliseconds maxInterval,
+    std::chrono::microseconds duration,
+    bool changed,
+    uint32_t maxDutyCyclePct);
+
+/*
+ * Collects classes of hw stats (ports, system ports, cpu, buffers ...) on
+ * one thread per class, so that a slow class does not stall the others.
+ * Each class is rescheduled with nextStatsCollectionInterval() after every
+ * run and publishes its collection duration and current interval as
+ *   <prefix>hw_stats_collection.<class>.duration_us
+ *   <prefix>hw_stats_collection.<class>.interval_ms
+ */
+class HwStatsCollectionScheduler {
+ public:
+  /*
+   * Collects the stats of a class. Returns a digest of the collected
+   * counters (e.g. sum of bytes), which is compared against the one of the
+   * previous run to tell whether counters are changing. std::nullopt means
+   * the class has no cheap digest and is treated as always changing.
+   */
+  using CollectFn = std::function<std::optional<uint64_t>()>;
+
+  /*
+   * Classes back off to at most maxBackoffFactor times their base interval.
+   */
+  HwStatsCollectionScheduler(
+      uint32_t maxBackoffFactor,
+      uint32_t maxDutyCyclePct,
+      std::optional<std::string> statsPrefix = std::nullopt);
+  ~HwStatsCollectionScheduler();
+
+  void addStatsClass(
+      const std::string& name,
+      std::chrono::milliseconds baseInterval,
+      CollectFn collect);
+
+  void start();
+  void stop();
+
+  bool isRunning() const {
+    return running_;
+  }
+  std::optional<std::chrono::milliseconds> getInterval(
+      const std::string& name) const;
+
+ private:
+  struct StatsClass {
+    std::string name;
+    std::chrono::milliseconds baseInterval;
+    std::chrono::milliseconds maxInterval;
+    CollectFn collect;
+    std::atomic<std::chrono::milliseconds::rep> intervalMs;
+    std::optional<uint64_t> lastDigest;
+    std::unique_ptr<std::thread> thread;
+  };
+
+  void runStatsClass(StatsClass& statsClass);
+  void collectOnce(StatsClass& statsClass);
+  std::string getCounterName(
+      const StatsClass& statsClass,
+      const std::string& suffix) const;
+
+  const uint32_t maxBackoffFactor_;
+  const uint32_t maxDutyCyclePct_;
+  const std::optional<std::string> statsPrefix_;
+  std::vector<std::unique_ptr<StatsClass>> statsClasses_;
+  std::atomic<bool> running_{false};
+  std::mutex stopMutex_;
+  std::condition_variable stopCv_;
+  bool stopRequested_{false};
+};
+
+} // namespace facebook::fboss
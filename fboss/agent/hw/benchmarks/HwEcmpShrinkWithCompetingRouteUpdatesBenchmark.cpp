@@ -16,10 +16,12 @@
 #include "fboss/agent/test/RouteScaleGenerators.h"
 #include "fboss/lib/FunctionCallTimeReporter.h"
 
+#include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/SwSwitchRouteUpdateWrapper.h"
 
 #include <folly/Benchmark.h>
 #include <folly/IPAddress.h>
+#include <gflags/gflags.h>
 
 #include <thread>
 
@@ -27,7 +29,10 @@ namespace facebook::fboss {
 
 using utility::getEcmpSizeInHw;
 
-BENCHMARK(HwEcmpGroupShrinkWithCompetingRouteUpdates) {
+namespace {
+void runEcmpShrinkWithCompetingRouteUpdates(bool prioritizeUpdates) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_state_update_priority_scheduling = prioritizeUpdates;
   folly::BenchmarkSuspender suspender;
   constexpr int kEcmpWidth = 4;
   std::unique_ptr<AgentEnsemble> ensemble{};
@@ -111,5 +116,19 @@ BENCHMARK(HwEcmpGroupShrinkWithCompetingRouteUpdates) {
   }
   t.join();
 }
+} // namespace
+
+BENCHMARK(HwEcmpGroupShrinkWithCompetingRouteUpdates) {
+  runEcmpShrinkWithCompetingRouteUpdates(true /* prioritizeUpdates */);
+}
+
+/*
+ * Baseline with state updates applied in queuing order, so that the port
+ * down and neighbor updates shrinking the group wait behind queued route
+ * updates.
+ */
+BENCHMARK(HwEcmpGroupShrinkWithCompetingRouteUpdatesFifo) {
+  runEcmpShrinkWithCompetingRouteUpdates(false /* prioritizeUpdates */);
+}
 
 } // namespace facebook::fboss
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/test/AgentEnsemble.h"
+#include "fboss/agent/test/utils/AclTestUtils.h"
+#include "fboss/agent/test/utils/ConfigUtils.h"
+#include "fboss/agent/test/utils/MirrorTestUtils.h"
+#include "fboss/lib/FunctionCallTimeReporter.h"
+
+#include <folly/Benchmark.h>
+#include <folly/Conv.h>
+#include <folly/IPAddress.h>
+#include <gflags/gflags.h>
+
+namespace facebook::fboss {
+
+/*
+ * Cold boot and config push with a config touching several independent
+ * switch state maps at scale (ACLs, mirrors), with the deltas of these maps
+ * processed one after another or concurrently (see
+ * --sai_delta_processing_threads).
+ */
+namespace {
+constexpr auto kNumAcls = 1000;
+
+cfg::SwitchConfig largeConfig(const AgentEnsemble& ensemble) {
+  auto config = utility::onePortPerInterfaceConfig(
+      ensemble.getSw(), ensemble.masterLogicalPortIds());
+  utility::addMirrorConfig<folly::IPAddressV6>(
+      &config, ensemble, utility::kIngressSpan, false /* truncate */);
+  utility::addMirrorConfig<folly::IPAddressV6>(
+      &config, ensemble, utility::kIngressErspan, false /* truncate */);
+  for (auto i = 0; i < kNumAcls; ++i) {
+    cfg::AclEntry acl;
+    acl.name() = folly::to<std::string>("acl", i);
+    acl.actionType() = cfg::AclActionType::PERMIT;
+    acl.dstIp() = folly::to<std::string>("2401:db00:", i, "::/64");
+    utility::addAcl(&config, acl, cfg::AclStage::INGRESS);
+  }
+  return config;
+}
+
+void setDeltaProcessingThreads(bool parallel) {
+  // Set by name, the flag belongs to the SAI switch implementation
+  gflags::SetCommandLineOption(
+      "sai_delta_processing_threads", parallel ? "4" : "0");
+}
+
+void runColdBootBenchmark(bool parallel) {
+  gflags::FlagSaver flagSaver;
+  setDeltaProcessingThreads(parallel);
+  folly::BenchmarkSuspender suspender;
+  std::unique_ptr<AgentEnsemble> ensemble{};
+  {
+    ScopedCallTimer timeIt;
+    suspender.dismiss();
+    ensemble = createAgentEnsemble(
+        [](const AgentEnsemble& ensemble) { return largeConfig(ensemble); },
+        false /*disableLinkStateToggler*/);
+    suspender.rehire();
+  }
+}
+
+void runConfigPushBenchmark(bool parallel) {
+  gflags::FlagSaver flagSaver;
+  setDeltaProcessingThreads(parallel);
+  folly::BenchmarkSuspender suspender;
+  AgentEnsembleSwitchConfigFn initialConfigFn =
+      [](const AgentEnsemble& ensemble) {
+        return utility::onePortPerInterfaceConfig(
+            ensemble.getSw(), ensemble.masterLogicalPortIds());
+      };
+  auto ensemble =
+      createAgentEnsemble(initialConfigFn, false /*disableLinkStateToggler*/);
+  auto config = largeConfig(*ensemble);
+  {
+    ScopedCallTimer timeIt;
+    suspender.dismiss();
+    ensemble->applyNewConfig(config);
+    suspender.rehire();
+  }
+}
+} // namespace
+
+BENCHMARK(HwColdBootLargeConfig) {
+  runColdBootBenchmark(false /* parallel */);
+}
+
+BENCHMARK(HwColdBootLargeConfigParallelDeltas) {
+  runColdBootBenchmark(true /* parallel */);
+}
+
+BENCHMARK(HwLargeConfigPush) {
+  runConfigPushBenchmark(false /* parallel */);
+}
+
+BENCHMARK(HwLargeConfigPushParallelDeltas) {
+  runConfigPushBenchmark(true /* parallel */);
+}
+
+} // namespace facebook::fboss
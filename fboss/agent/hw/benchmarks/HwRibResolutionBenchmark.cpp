@@ -12,13 +12,20 @@
 #include "fboss/agent/hw/test/ConfigFactory.h"
 #include "fboss/agent/hw/test/HwSwitchEnsembleFactory.h"
 #include "fboss/agent/rib/FibUpdateHelpers.h"
+#include "fboss/agent/rib/ForwardingInformationBaseUpdater.h"
+#include "fboss/agent/rib/RouteUpdater.h"
 #include "fboss/agent/rib/RoutingInformationBase.h"
 #include "fboss/agent/test/RouteGeneratorTestUtils.h"
 #include "fboss/agent/test/RouteScaleGenerators.h"
 
 #include "fboss/agent/benchmarks/AgentBenchmarks.h"
 
+#include <fmt/format.h>
 #include <folly/Benchmark.h>
+#include <gflags/gflags.h>
+
+#include <thread>
+#include <vector>
 
 namespace facebook::fboss {
 
@@ -69,4 +76,229 @@ BENCHMARK(RibResolutionBenchmark) {
   suspender.rehire();
 }
 
+namespace {
+/*
+ * Resolve the full route scale into a standalone RIB, then time withdrawing
+ * and re-announcing numChurnRoutes of those routes. With incremental route
+ * resolution, the cost should track the churn size rather than the route
+ * table size. FIBs are built incrementally in both variants, so a full FIB
+ * rebuild per update doesn't hide the difference in resolution cost.
+ */
+void ribChurnResolutionBenchmark(
+    size_t numChurnRoutes,
+    bool incrementalResolution) {
+  folly::BenchmarkSuspender suspender;
+  gflags::FlagSaver flagSaver;
+  FLAGS_incremental_route_resolution = incrementalResolution;
+  FLAGS_incremental_fib_update = true;
+  AgentEnsembleSwitchConfigFn initialConfigFn =
+      [](const AgentEnsemble& ensemble) {
+        return utility::onePortPerInterfaceConfig(
+            ensemble.getSw(), ensemble.masterLogicalPortIds());
+      };
+  auto ensemble =
+      createAgentEnsemble(initialConfigFn, false /*disableLinkStateToggler*/);
+
+  utility::THAlpmRouteScaleGenerator gen(
+      ensemble->getSw()->getState(),
+      ensemble->getSw()->needL2EntryForNeighbor());
+  const auto& routeChunks = gen.getThriftRoutes();
+  auto rib = RoutingInformationBase::fromThrift(
+      ensemble->getSw()->getRib()->toThrift(),
+      ensemble->getProgrammedState()->getFibsInfoMap(),
+      nullptr,
+      nullptr);
+  auto switchState = ensemble->getProgrammedState();
+  auto resolver = ensemble->getSw()->getScopeResolver();
+  auto updateRib = [&](const std::vector<UnicastRoute>& toAdd,
+                       const std::vector<IpPrefix>& toDel,
+                       folly::StringPiece updateType) {
+    rib->update(
+        resolver,
+        RouterID(0),
+        ClientID::BGPD,
+        AdminDistance::EBGP,
+        toAdd,
+        toDel,
+        false,
+        updateType,
+        ribToSwitchStateUpdate,
+        static_cast<void*>(&switchState));
+  };
+  std::vector<UnicastRoute> churnRoutes;
+  std::vector<IpPrefix> churnPrefixes;
+  for (const auto& routeChunk : routeChunks) {
+    updateRib(routeChunk, {}, "resolution only");
+    for (const auto& route : routeChunk) {
+      if (churnRoutes.size() < numChurnRoutes) {
+        churnRoutes.push_back(route);
+        churnPrefixes.push_back(*route.dest());
+      }
+    }
+  }
+  CHECK_EQ(churnRoutes.size(), numChurnRoutes);
+
+  suspender.dismiss();
+  updateRib({}, churnPrefixes, "churn withdraw");
+  updateRib(churnRoutes, {}, "churn announce");
+  suspender.rehire();
+}
+
+/*
+ * Time applying a config with numVrfs VRFs, each with its own interface
+ * route and kStaticRoutesPerVrf static routes recursively resolving through
+ * it. With numThreads > 1 the VRFs are resolved and their FIBs built
+ * concurrently, so the time should stay roughly flat as VRFs are added
+ * (up to the thread count).
+ */
+void ribMultiVrfReconfigureBenchmark(int numVrfs, int numThreads) {
+  constexpr auto kStaticRoutesPerVrf = 20000;
+  folly::BenchmarkSuspender suspender;
+  gflags::FlagSaver flagSaver;
+  FLAGS_rib_vrf_update_threads = numThreads;
+  // NextHopIDManager is shared by all VRFs, resolution is only done
+  // concurrently without it
+  FLAGS_enable_nexthop_id_manager = false;
+  AgentEnsembleSwitchConfigFn initialConfigFn =
+      [](const AgentEnsemble& ensemble) {
+        return utility::onePortPerInterfaceConfig(
+            ensemble.getSw(), ensemble.masterLogicalPortIds());
+      };
+  auto ensemble =
+      createAgentEnsemble(initialConfigFn, false /*disableLinkStateToggler*/);
+
+  RoutingInformationBase::RouterIDAndNetworkToInterfaceRoutes interfaceRoutes;
+  std::vector<cfg::StaticRouteWithNextHops> staticRoutes;
+  for (auto vrf = 0; vrf < numVrfs; ++vrf) {
+    auto intfNetwork = folly::IPAddress::createNetwork(
+        fmt::format("2400:{:x}::/64", vrf), -1, false);
+    interfaceRoutes[RouterID(vrf)].emplace(
+        intfNetwork,
+        std::make_pair(
+            InterfaceID(1),
+            folly::IPAddress(fmt::format("2400:{:x}::1", vrf))));
+    for (auto i = 0; i < kStaticRoutesPerVrf; ++i) {
+      cfg::StaticRouteWithNextHops route;
+      route.routerID() = vrf;
+      route.prefix() = fmt::format("2600:{:x}:{:x}::/64", vrf, i);
+      route.nexthops() = {fmt::format("2400:{:x}::10", vrf)};
+      staticRoutes.push_back(std::move(route));
+    }
+  }
+  RoutingInformationBase rib;
+  auto switchState = ensemble->getProgrammedState();
+  suspender.dismiss();
+  rib.reconfigure(
+      ensemble->getSw()->getScopeResolver(),
+      interfaceRoutes,
+      staticRoutes,
+      {} /* staticRoutesToNull */,
+      {} /* staticRoutesToCpu */,
+      {} /* staticIp2MplsRoutes */,
+      {} /* staticMplsRoutesWithNextHops */,
+      {} /* staticMplsRoutesToNull */,
+      {} /* staticMplsRoutesToCpu */,
+      {} /* staticMySids */,
+      ribToSwitchStateUpdate,
+      static_cast<void*>(&switchState),
+      multiVrfRibToSwitchStateUpdate);
+  suspender.rehire();
+}
+
+/*
+ * Time programming the full route scale from kNumThreads threads, each
+ * with its own share of the route chunks. With --rib_fib_pipeline the RIB
+ * thread resolves the next chunk while the FIB of the previous one is being
+ * programmed to HW, rather than the two alternating, so the pipelined
+ * benchmark should take less time than the serial one.
+ */
+void ribFibPipelineBenchmark(bool pipelined) {
+  constexpr auto kNumThreads = 4;
+  folly::BenchmarkSuspender suspender;
+  gflags::FlagSaver flagSaver;
+  FLAGS_rib_fib_pipeline = pipelined;
+  AgentEnsembleSwitchConfigFn initialConfigFn =
+      [](const AgentEnsemble& ensemble) {
+        return utility::onePortPerInterfaceConfig(
+            ensemble.getSw(), ensemble.masterLogicalPortIds());
+      };
+  auto ensemble =
+      createAgentEnsemble(initialConfigFn, false /*disableLinkStateToggler*/);
+
+  utility::THAlpmRouteScaleGenerator gen(
+      ensemble->getSw()->getState(),
+      ensemble->getSw()->needL2EntryForNeighbor());
+  const auto& routeChunks = gen.getThriftRoutes();
+  std::vector<utility::RouteDistributionGenerator::ThriftRouteChunks>
+      threadRouteChunks(kNumThreads);
+  for (size_t i = 0; i < routeChunks.size(); ++i) {
+    threadRouteChunks[i % kNumThreads].push_back(routeChunks[i]);
+  }
+
+  suspender.dismiss();
+  std::vector<std::thread> threads;
+  for (const auto& chunks : threadRouteChunks) {
+    threads.emplace_back([&ensemble, &chunks]() {
+      ensemble->programRoutes(RouterID(0), ClientID::BGPD, chunks);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  suspender.rehire();
+}
+} // namespace
+
+BENCHMARK(RibChurn10RoutesFullResolutionBenchmark) {
+  ribChurnResolutionBenchmark(10, false /* incrementalResolution */);
+}
+
+BENCHMARK(RibChurn10RoutesIncrementalResolutionBenchmark) {
+  ribChurnResolutionBenchmark(10, true /* incrementalResolution */);
+}
+
+BENCHMARK(RibChurn1kRoutesFullResolutionBenchmark) {
+  ribChurnResolutionBenchmark(1000, false /* incrementalResolution */);
+}
+
+BENCHMARK(RibChurn1kRoutesIncrementalResolutionBenchmark) {
+  ribChurnResolutionBenchmark(1000, true /* incrementalResolution */);
+}
+
+BENCHMARK(RibChurn10kRoutesFullResolutionBenchmark) {
+  ribChurnResolutionBenchmark(10000, false /* incrementalResolution */);
+}
+
+BENCHMARK(RibChurn10kRoutesIncrementalResolutionBenchmark) {
+  ribChurnResolutionBenchmark(10000, true /* incrementalResolution */);
+}
+
+BENCHMARK(RibFibSerialBenchmark) {
+  ribFibPipelineBenchmark(false /* pipelined */);
+}
+
+BENCHMARK(RibFibPipelinedBenchmark) {
+  ribFibPipelineBenchmark(true /* pipelined */);
+}
+
+BENCHMARK(RibReconfigure1VrfBenchmark) {
+  ribMultiVrfReconfigureBenchmark(1, 0 /* numThreads */);
+}
+
+BENCHMARK(RibReconfigure4VrfsSerialBenchmark) {
+  ribMultiVrfReconfigureBenchmark(4, 0 /* numThreads */);
+}
+
+BENCHMARK(RibReconfigure4VrfsParallelBenchmark) {
+  ribMultiVrfReconfigureBenchmark(4, 4 /* numThreads */);
+}
+
+BENCHMARK(RibReconfigure8VrfsSerialBenchmark) {
+  ribMultiVrfReconfigureBenchmark(8, 0 /* numThreads */);
+}
+
+BENCHMARK(RibReconfigure8VrfsParallelBenchmark) {
+  ribMultiVrfReconfigureBenchmark(8, 8 /* numThreads */);
+}
+
 } // namespace facebook::fboss
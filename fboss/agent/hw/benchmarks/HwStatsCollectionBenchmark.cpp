@@ -12,12 +12,12 @@
 
 namespace facebook::fboss {
 
-BENCHMARK(HwStatsCollection) {
-  runStatsCollectionBenchmark(false /* alwaysCollectVoqStats */);
+BENCHMARK_COUNTERS(HwStatsCollection, counters) {
+  runStatsCollectionBenchmark(counters, false /* alwaysCollectVoqStats */);
 }
 
-BENCHMARK(HwVoqStatsCollection) {
-  runStatsCollectionBenchmark(true /* alwaysCollectVoqStats */);
+BENCHMARK_COUNTERS(HwVoqStatsCollection, counters) {
+  runStatsCollectionBenchmark(counters, true /* alwaysCollectVoqStats */);
 }
 
 } // namespace facebook::fboss
@@ -27,10 +27,15 @@
 #include <folly/Benchmark.h>
 #include <folly/IPAddress.h>
 
+#include <algorithm>
+#include <chrono>
+
 namespace facebook::fboss {
 
 /*
  * Collect stats 10K times (100 time for VOQ) and benchmark that.
+ * The average and maximum time of a collection cycle are reported as
+ * counters.
  * Using a fixed number rather than letting framework
  * pick a N for internal iteration, since
  * - We want a large enough number to notice any memory bloat
@@ -41,7 +46,9 @@ namespace facebook::fboss {
  *   iteration (by letting it pick number of iterations), and calculating
  *   cost of a single iterations does not seem to have more fidelity
  */
-inline void runStatsCollectionBenchmark(bool alwaysCollectVoqStats = false) {
+inline void runStatsCollectionBenchmark(
+    folly::UserCounters& counters,
+    bool alwaysCollectVoqStats = false) {
   folly::BenchmarkSuspender suspender;
   std::unique_ptr<AgentEnsemble> ensemble{};
   // maximum 48 master logical ports (taken from wedge400) to get
@@ -169,11 +176,25 @@ inline void runStatsCollectionBenchmark(bool alwaysCollectVoqStats = false) {
     updater.program();
   }
 
+  std::chrono::steady_clock::duration totalCycleTime{0};
+  std::chrono::steady_clock::duration maxCycleTime{0};
   suspender.dismiss();
   for (auto i = 0; i < iterations; ++i) {
+    auto start = std::chrono::steady_clock::now();
     ensemble->getSw()->updateStats();
+    auto cycleTime = std::chrono::steady_clock::now() - start;
+    totalCycleTime += cycleTime;
+    maxCycleTime = std::max(maxCycleTime, cycleTime);
   }
   suspender.rehire();
+  // time of a single stats collection cycle
+  counters["avg_cycle_time_us"] = folly::UserMetric(
+      std::chrono::duration_cast<std::chrono::microseconds>(totalCycleTime)
+          .count() /
+      iterations);
+  counters["max_cycle_time_us"] = folly::UserMetric(
+      std::chrono::duration_cast<std::chrono::microseconds>(maxCycleTime)
+          .count());
 }
 
 } // namespace facebook::fboss
@@ -131,6 +131,51 @@ class FdbApi : public SaiApi<FdbApi> {
       const sai_attribute_t* attr) const {
     return api_->set_fdb_entry_attribute(fdbEntry.entry(), attr);
   }
+  sai_status_t _bulkCreateEntries(
+      size_t objectCount,
+      const sai_fdb_entry_t* fdbEntries,
+      const uint32_t* attrCount,
+      const sai_attribute_t** attrs,
+      sai_status_t* retStatus) const {
+    if (!api_->create_fdb_entries) {
+      return SAI_STATUS_NOT_IMPLEMENTED;
+    }
+    return api_->create_fdb_entries(
+        objectCount,
+        fdbEntries,
+        attrCount,
+        attrs,
+        SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR,
+        retStatus);
+  }
+  sai_status_t _bulkRemoveEntries(
+      size_t objectCount,
+      const sai_fdb_entry_t* fdbEntries,
+      sai_status_t* retStatus) const {
+    if (!api_->remove_fdb_entries) {
+      return SAI_STATUS_NOT_IMPLEMENTED;
+    }
+    return api_->remove_fdb_entries(
+        objectCount,
+        fdbEntries,
+        SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR,
+        retStatus);
+  }
+  sai_status_t _bulkSetEntriesAttribute(
+      size_t objectCount,
+      const sai_fdb_entry_t* fdbEntries,
+      const sai_attribute_t* attrs,
+      sai_status_t* retStatus) const {
+    if (!api_->set_fdb_entries_attribute) {
+      return SAI_STATUS_NOT_IMPLEMENTED;
+    }
+    return api_->set_fdb_entries_attribute(
+        objectCount,
+        fdbEntries,
+        attrs,
+        SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR,
+        retStatus);
+  }
 
   sai_fdb_api_t* api_;
   friend class SaiApi<FdbApi>;
@@ -155,6 +155,63 @@ class NeighborApi : public SaiApi<NeighborApi> {
       const sai_attribute_t* attr) const {
     return api_->set_neighbor_entry_attribute(neighborEntry.entry(), attr);
   }
+  sai_status_t _bulkCreateEntries(
+      size_t objectCount,
+      const sai_neighbor_entry_t* neighborEntries,
+      const uint32_t* attrCount,
+      const sai_attribute_t** attrs,
+      sai_status_t* retStatus) const {
+#if SAI_API_VERSION >= SAI_VERSION(1, 11, 0)
+    if (!api_->create_neighbor_entries) {
+      return SAI_STATUS_NOT_IMPLEMENTED;
+    }
+    return api_->create_neighbor_entries(
+        objectCount,
+        neighborEntries,
+        attrCount,
+        attrs,
+        SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR,
+        retStatus);
+#else
+    return SAI_STATUS_NOT_IMPLEMENTED;
+#endif
+  }
+  sai_status_t _bulkRemoveEntries(
+      size_t objectCount,
+      const sai_neighbor_entry_t* neighborEntries,
+      sai_status_t* retStatus) const {
+#if SAI_API_VERSION >= SAI_VERSION(1, 11, 0)
+    if (!api_->remove_neighbor_entries) {
+      return SAI_STATUS_NOT_IMPLEMENTED;
+    }
+    return api_->remove_neighbor_entries(
+        objectCount,
+        neighborEntries,
+        SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR,
+        retStatus);
+#else
+    return SAI_STATUS_NOT_IMPLEMENTED;
+#endif
+  }
+  sai_status_t _bulkSetEntriesAttribute(
+      size_t objectCount,
+      const sai_neighbor_entry_t* neighborEntries,
+      const sai_attribute_t* attrs,
+      sai_status_t* retStatus) const {
+#if SAI_API_VERSION >= SAI_VERSION(1, 11, 0)
+    if (!api_->set_neighbor_entries_attribute) {
+      return SAI_STATUS_NOT_IMPLEMENTED;
+    }
+    return api_->set_neighbor_entries_attribute(
+        objectCount,
+        neighborEntries,
+        attrs,
+        SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR,
+        retStatus);
+#else
+    return SAI_STATUS_NOT_IMPLEMENTED;
+#endif
+  }
 
   sai_neighbor_api_t* api_;
   friend class SaiApi<NeighborApi>;
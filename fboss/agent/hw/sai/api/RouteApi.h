@@ -142,6 +142,51 @@ class RouteApi : public SaiApi<RouteApi> {
       const sai_attribute_t* attr) const {
     return api_->set_route_entry_attribute(routeEntry.entry(), attr);
   }
+  sai_status_t _bulkCreateEntries(
+      size_t objectCount,
+      const sai_route_entry_t* routeEntries,
+      const uint32_t* attrCount,
+      const sai_attribute_t** attrs,
+      sai_status_t* retStatus) const {
+    if (!api_->create_route_entries) {
+      return SAI_STATUS_NOT_IMPLEMENTED;
+    }
+    return api_->create_route_entries(
+        objectCount,
+        routeEntries,
+        attrCount,
+        attrs,
+        SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR,
+        retStatus);
+  }
+  sai_status_t _bulkRemoveEntries(
+      size_t objectCount,
+      const sai_route_entry_t* routeEntries,
+      sai_status_t* retStatus) const {
+    if (!api_->remove_route_entries) {
+      return SAI_STATUS_NOT_IMPLEMENTED;
+    }
+    return api_->remove_route_entries(
+        objectCount,
+        routeEntries,
+        SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR,
+        retStatus);
+  }
+  sai_status_t _bulkSetEntriesAttribute(
+      size_t objectCount,
+      const sai_route_entry_t* routeEntries,
+      const sai_attribute_t* attrs,
+      sai_status_t* retStatus) const {
+    if (!api_->set_route_entries_attribute) {
+      return SAI_STATUS_NOT_IMPLEMENTED;
+    }
+    return api_->set_route_entries_attribute(
+        objectCount,
+        routeEntries,
+        attrs,
+        SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR,
+        retStatus);
+  }
 
   sai_route_api_t* api_;
   friend class SaiApi<RouteApi>;
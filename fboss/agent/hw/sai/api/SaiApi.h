@@ -80,7 +80,7 @@ class SaiApi {
           "Attempting create SAI obj with {}, while hw writes are not expected",
           createAttributes);
     }
-    auto g{SaiApiLock::getInstance()->lock()};
+    auto g{SaiApiLock::getInstance()->lock(apiType())};
     sai_status_t status;
     {
       TIME_CALL;
@@ -119,7 +119,7 @@ class SaiApi {
           "Attempting create SAI obj with {}, while hw writes are not expected",
           createAttributes);
     }
-    auto g{SaiApiLock::getInstance()->lock()};
+    auto g{SaiApiLock::getInstance()->lock(apiType())};
     sai_status_t status;
     {
       TIME_CALL;
@@ -151,7 +151,7 @@ class SaiApi {
           "Attempting to remove SAI obj {} while hw writes are not expected",
           key);
     }
-    auto g{SaiApiLock::getInstance()->lock()};
+    auto g{SaiApiLock::getInstance()->lock(apiType())};
     sai_status_t status;
     {
       TIME_CALL;
@@ -177,7 +177,7 @@ class SaiApi {
   typename std::remove_reference_t<AttrT>::ValueType getAttribute(
       const AdapterKeyT& key,
       AttrT&& attr) const {
-    auto g{SaiApiLock::getInstance()->lock()};
+    auto g{SaiApiLock::getInstance()->lock(apiType())};
     sai_status_t status;
     {
       TIME_CALL;
@@ -320,7 +320,7 @@ class SaiApi {
     // to retrieve txReadyStatusChange. However, this can be enhanced in the
     // future.
 
-    auto g{SaiApiLock::getInstance()->lock()};
+    auto g{SaiApiLock::getInstance()->lock(apiType())};
 
     // We only support querying 1 attr per SAI Object today
     constexpr auto kMaxNumAttrsPerObject = 1;
@@ -423,7 +423,7 @@ class SaiApi {
   }
   template <typename AdapterKeyT, SaiAttributeType AttrT>
   void setAttribute(const AdapterKeyT& key, const AttrT& attr) const {
-    auto g{SaiApiLock::getInstance()->lock()};
+    auto g{SaiApiLock::getInstance()->lock(apiType())};
     setAttributeUnlocked(key, attr);
   }
 
@@ -486,7 +486,7 @@ class SaiApi {
   void bulkSetAttributes(
       std::vector<AdapterKeyT>& adapterKeys,
       std::vector<AttrT>& attributes) const {
-    auto g{SaiApiLock::getInstance()->lock()};
+    auto g{SaiApiLock::getInstance()->lock(apiType())};
     return bulkSetAttributesUnlocked(adapterKeys, attributes);
   }
 
@@ -532,7 +532,7 @@ class SaiApi {
     for (const auto& saiAttributeTs : saiAttributeTsVec) {
       saiAttributeTsVecPtr.emplace_back(saiAttributeTs.data());
     }
-    auto g{SaiApiLock::getInstance()->lock()};
+    auto g{SaiApiLock::getInstance()->lock(apiType())};
     {
       TIME_CALL;
       status = impl()._bulkCreate(
@@ -574,7 +574,7 @@ class SaiApi {
           "Attempting to remove SAI obj {} while hw writes are not expected",
           keys[0]);
     }
-    auto g{SaiApiLock::getInstance()->lock()};
+    auto g{SaiApiLock::getInstance()->lock(apiType())};
     sai_status_t status;
     sai_status_t retStatus[keys.size()];
     {
@@ -591,12 +591,166 @@ class SaiApi {
     }
   }
 
+  /*
+   * Bulk create, remove and set of entry struct objects (routes,
+   * neighbors...), stopping at the first failed entry. Unlike the bulk
+   * operations above, failed entries don't throw: the status of each entry
+   * is returned instead, SAI_STATUS_NOT_EXECUTED for the entries after a
+   * failed one, so that callers can commit the entries programmed. Only a
+   * failure of the call as a whole throws, e.g. SAI_STATUS_NOT_IMPLEMENTED
+   * from adapters without bulk support.
+   */
+  template <EntryStructSaiObject SaiObjectTraits>
+    requires SaiObjectForApi<SaiObjectTraits, ApiT>
+  std::vector<sai_status_t> bulkCreateEntries(
+      const std::vector<typename SaiObjectTraits::AdapterKey>& entries,
+      const std::vector<typename SaiObjectTraits::CreateAttributes>&
+          createAttributes) const {
+    CHECK_EQ(entries.size(), createAttributes.size());
+    if (entries.empty() || UNLIKELY(skipHwWrites())) {
+      return std::vector<sai_status_t>(entries.size(), SAI_STATUS_SUCCESS);
+    }
+    if (UNLIKELY(failHwWrites())) {
+      XLOGF(
+          FATAL,
+          "Attempting bulk create SAI obj {}, while hw writes are blocked",
+          entries[0]);
+    }
+    if (UNLIKELY(logFailHwWrites())) {
+      XLOGF(
+          WARNING,
+          "Attempting bulk create SAI obj {}, while hw writes are not expected",
+          entries[0]);
+    }
+    auto rawEntries = rawEntriesOf(entries);
+    std::vector<std::vector<sai_attribute_t>> saiAttributeTsVec;
+    std::vector<const sai_attribute_t*> saiAttributeTsVecPtr;
+    std::vector<uint32_t> attrCount;
+    saiAttributeTsVec.reserve(createAttributes.size());
+    saiAttributeTsVecPtr.reserve(createAttributes.size());
+    attrCount.reserve(createAttributes.size());
+    for (const auto& attributes : createAttributes) {
+      saiAttributeTsVec.emplace_back(saiAttrs(attributes));
+      saiAttributeTsVecPtr.emplace_back(saiAttributeTsVec.back().data());
+      attrCount.emplace_back(saiAttributeTsVec.back().size());
+    }
+    std::vector<sai_status_t> retStatus(
+        entries.size(), SAI_STATUS_NOT_EXECUTED);
+    auto g{SaiApiLock::getInstance()->lock(apiType())};
+    sai_status_t status;
+    {
+      TIME_CALL;
+      status = impl()._bulkCreateEntries(
+          rawEntries.size(),
+          rawEntries.data(),
+          attrCount.data(),
+          saiAttributeTsVecPtr.data(),
+          retStatus.data());
+    }
+    checkBulkEntriesStatus(status, retStatus, "Failed to bulk create");
+    for (auto idx = 0; idx < entries.size(); idx++) {
+      if (retStatus[idx] == SAI_STATUS_SUCCESS) {
+        XLOGF(
+            DBG5,
+            "bulk created SAI object: {}: {}",
+            entries[idx],
+            createAttributes[idx]);
+      }
+    }
+    return retStatus;
+  }
+
+  template <typename AdapterKeyT>
+    requires IsSaiEntryStruct<AdapterKeyT>::value
+  std::vector<sai_status_t> bulkRemoveEntries(
+      const std::vector<AdapterKeyT>& entries) const {
+    if (entries.empty() || UNLIKELY(skipHwWrites())) {
+      return std::vector<sai_status_t>(entries.size(), SAI_STATUS_SUCCESS);
+    }
+    if (UNLIKELY(failHwWrites())) {
+      XLOGF(
+          FATAL,
+          "Attempting to remove SAI obj {} while hw writes are blocked",
+          entries[0]);
+    }
+    if (UNLIKELY(logFailHwWrites())) {
+      XLOGF(
+          WARNING,
+          "Attempting to remove SAI obj {} while hw writes are not expected",
+          entries[0]);
+    }
+    auto rawEntries = rawEntriesOf(entries);
+    std::vector<sai_status_t> retStatus(
+        entries.size(), SAI_STATUS_NOT_EXECUTED);
+    auto g{SaiApiLock::getInstance()->lock(apiType())};
+    sai_status_t status;
+    {
+      TIME_CALL;
+      status = impl()._bulkRemoveEntries(
+          rawEntries.size(), rawEntries.data(), retStatus.data());
+    }
+    checkBulkEntriesStatus(status, retStatus, "Failed to bulk remove");
+    for (auto idx = 0; idx < entries.size(); idx++) {
+      if (retStatus[idx] == SAI_STATUS_SUCCESS) {
+        XLOGF(DBG5, "bulk removed SAI obj {}", entries[idx]);
+      }
+    }
+    return retStatus;
+  }
+
+  template <typename AdapterKeyT, SaiAttributeType AttrT>
+    requires IsSaiEntryStruct<AdapterKeyT>::value
+  std::vector<sai_status_t> bulkSetEntriesAttribute(
+      const std::vector<AdapterKeyT>& entries,
+      const std::vector<AttrT>& attributes) const {
+    CHECK_EQ(entries.size(), attributes.size());
+    if (entries.empty() || UNLIKELY(skipHwWrites())) {
+      return std::vector<sai_status_t>(entries.size(), SAI_STATUS_SUCCESS);
+    }
+    if (UNLIKELY(failHwWrites())) {
+      XLOG(
+          FATAL,
+          "Attempting bulk set SAI attributes while hw writes are blocked");
+    }
+    if (UNLIKELY(logFailHwWrites())) {
+      XLOG(
+          WARNING,
+          "Attempting bulk set SAI attributes while hw writes are not expected");
+    }
+    auto rawEntries = rawEntriesOf(entries);
+    std::vector<sai_attribute_t> attrs;
+    attrs.reserve(attributes.size());
+    for (const auto& attr : attributes) {
+      attrs.emplace_back(*saiAttr(attr));
+    }
+    std::vector<sai_status_t> retStatus(
+        entries.size(), SAI_STATUS_NOT_EXECUTED);
+    auto g{SaiApiLock::getInstance()->lock(apiType())};
+    sai_status_t status;
+    {
+      TIME_CALL;
+      status = impl()._bulkSetEntriesAttribute(
+          rawEntries.size(), rawEntries.data(), attrs.data(), retStatus.data());
+    }
+    checkBulkEntriesStatus(status, retStatus, "Failed to bulk set attribute");
+    for (auto idx = 0; idx < entries.size(); idx++) {
+      if (retStatus[idx] == SAI_STATUS_SUCCESS) {
+        XLOGF(
+            DBG5,
+            "bulk set SAI attribute of {} to {}",
+            entries[idx],
+            attributes[idx]);
+      }
+    }
+    return retStatus;
+  }
+
   template <SaiObjectWithStats SaiObjectTraits>
   std::vector<uint64_t> getStats(
       const typename SaiObjectTraits::AdapterKey& key,
       const std::vector<sai_stat_id_t>& counterIds,
       sai_stats_mode_t mode) const {
-    auto g{SaiApiLock::getInstance()->lock()};
+    auto g{SaiApiLock::getInstance()->lock(apiType())};
     return getStatsImpl<SaiObjectTraits>(
         key, counterIds.data(), counterIds.size(), mode);
   }
@@ -604,7 +758,7 @@ class SaiApi {
   std::vector<uint64_t> getStats(
       const typename SaiObjectTraits::AdapterKey& key,
       sai_stats_mode_t mode) const {
-    auto g{SaiApiLock::getInstance()->lock()};
+    auto g{SaiApiLock::getInstance()->lock(apiType())};
     XLOGF(DBG6, "got SAI stats for {}", key);
     return mode == SAI_STATS_MODE_READ
         ? getStatsImpl<SaiObjectTraits>(
@@ -619,16 +773,71 @@ class SaiApi {
               mode);
   }
 
+  /*
+   * Reads the same counters of several objects with a single
+   * sai_bulk_object_get_stats call. counters holds the counters of each
+   * object in turn, and statuses the status of each object. Returns
+   * SAI_STATUS_NOT_IMPLEMENTED or SAI_STATUS_NOT_SUPPORTED, without reading
+   * anything, if the adapter can't read stats in bulk. Other failures of
+   * individual objects are only reported in statuses.
+   */
+  template <SaiObjectWithStats SaiObjectTraits>
+    requires ObjectIdSaiObject<SaiObjectTraits>
+  sai_status_t bulkGetStats(
+      sai_object_id_t switchId,
+      const std::vector<typename SaiObjectTraits::AdapterKey>& keys,
+      const std::vector<sai_stat_id_t>& counterIds,
+      sai_stats_mode_t mode,
+      std::vector<uint64_t>& counters,
+      std::vector<sai_status_t>& statuses) const {
+#if SAI_API_VERSION >= SAI_VERSION(1, 11, 0)
+    auto g{SaiApiLock::getInstance()->lock(apiType())};
+    std::vector<sai_object_key_t> objectKeys(keys.size());
+    for (auto idx = 0; idx < keys.size(); idx++) {
+      objectKeys[idx].key.object_id = keys[idx];
+    }
+    counters.assign(keys.size() * counterIds.size(), 0);
+    statuses.assign(keys.size(), SAI_STATUS_NOT_EXECUTED);
+    sai_status_t status;
+    {
+      TIME_CALL;
+      status = sai_bulk_object_get_stats(
+          switchId,
+          SaiObjectTraits::ObjectType,
+          keys.size(),
+          objectKeys.data(),
+          counterIds.size(),
+          counterIds.data(),
+          mode,
+          statuses.data(),
+          counters.data());
+    }
+    if (status == SAI_STATUS_NOT_IMPLEMENTED ||
+        status == SAI_STATUS_NOT_SUPPORTED) {
+      return status;
+    }
+    checkBulkEntriesStatus(status, statuses, "Failed to bulk get stats");
+    XLOGF(
+        DBG6,
+        "bulk got SAI stats for {} objects of type {}",
+        keys.size(),
+        saiObjectTypeToString(SaiObjectTraits::ObjectType));
+    return status;
+#else
+    return SAI_STATUS_NOT_IMPLEMENTED;
+#endif
+  }
+
   template <SaiObjectWithStats SaiObjectTraits>
   void clearStats(
       const typename SaiObjectTraits::AdapterKey& key,
       const std::vector<sai_stat_id_t>& counterIds) const {
-    auto g{SaiApiLock::getInstance()->lock()};
+    auto g{SaiApiLock::getInstance()->lock(apiType())};
     clearStatsImpl<SaiObjectTraits>(key, counterIds.data(), counterIds.size());
   }
   template <SaiObjectWithStats SaiObjectTraits>
   void clearStats(const typename SaiObjectTraits::AdapterKey& key) const {
-    auto g{SaiApiLock::getInstance()->lock()};
+    auto g{SaiApiLock::getInstance()->lock(apiType())};
     clearStatsImpl<SaiObjectTraits>(
         key,
         SaiObjectTraits::CounterIdsToRead.data(),
@@ -652,6 +861,34 @@ class SaiApi {
   bool logFailHwWrites() const {
     return getHwWriteBehavior() == HwWriteBehavior::LOG_FAIL;
   }
+  template <typename AdapterKeyT>
+  static auto rawEntriesOf(const std::vector<AdapterKeyT>& entries) {
+    using RawEntryT =
+        std::remove_cvref_t<decltype(*std::declval<AdapterKeyT>().entry())>;
+    std::vector<RawEntryT> rawEntries;
+    rawEntries.reserve(entries.size());
+    for (const auto& entry : entries) {
+      rawEntries.push_back(*entry.entry());
+    }
+    return rawEntries;
+  }
+  // A bulk call failing some entries fails as a whole, with the status of
+  // each entry in retStatus. Throw only if no entry was attempted.
+  void checkBulkEntriesStatus(
+      sai_status_t status,
+      const std::vector<sai_status_t>& retStatus,
+      const char* msg) const {
+    if (status == SAI_STATUS_SUCCESS) {
+      return;
+    }
+    bool attempted = std::any_of(
+        retStatus.begin(), retStatus.end(), [](sai_status_t entryStatus) {
+          return entryStatus != SAI_STATUS_NOT_EXECUTED;
+        });
+    if (!attempted) {
+      saiApiCheckError(status, apiType(), msg);
+    }
+  }
   template <typename SaiObjectTraits>
   std::vector<uint64_t> getStatsImpl(
       const typename SaiObjectTraits::AdapterKey& key,
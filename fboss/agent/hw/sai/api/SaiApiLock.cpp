@@ -10,7 +10,14 @@
 
 #include "fboss/agent/hw/sai/api/SaiApiLock.h"
 
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/hw/sai/api/LoggingUtil.h"
+
 #include <folly/Singleton.h>
+#include <folly/String.h>
+#include <folly/logging/xlog.h>
+
+#include <chrono>
 #include <mutex>
 
 namespace {
@@ -24,4 +31,111 @@ std::shared_ptr<SaiApiLock> SaiApiLock::getInstance() {
   return saiApiLockSingleton.try_get();
 }
 
+void SaiApiLock::ScopedApiLock::lock() {
+  domain.acquisitions.fetch_add(1, std::memory_order_relaxed);
+  if (domain.mutex.try_lock()) {
+    return;
+  }
+  auto begin = std::chrono::steady_clock::now();
+  domain.mutex.lock();
+  auto waited = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - begin);
+  domain.contentions.fetch_add(1, std::memory_order_relaxed);
+  domain.waitUsecs.fetch_add(waited.count(), std::memory_order_relaxed);
+}
+
+SaiApiLock::SaiApiLock() {
+  setLockDomains({});
+}
+
+void SaiApiLock::setLockDomains(const std::vector<SaiApiLockDomain>& domains) {
+  if (serializeAllApisReason_ && !domains.empty()) {
+    XLOG(WARNING) << "Ignoring SAI api lock domains, all SAI apis are "
+                  << "serialized: " << *serializeAllApisReason_;
+    setLockDomains({});
+    return;
+  }
+  std::vector<std::unique_ptr<Domain>> newDomains;
+  newDomains.push_back(std::make_unique<Domain>(kDefaultDomainName));
+  std::vector<size_t> api2DomainIndex(SAI_API_MAX, 0);
+  for (const auto& domain : domains) {
+    if (domain.name == kDefaultDomainName) {
+      throw FbossError("SAI api lock domain name is reserved: ", domain.name);
+    }
+    auto index = newDomains.size();
+    newDomains.push_back(std::make_unique<Domain>(domain.name));
+    for (auto api : domain.apis) {
+      if (api >= api2DomainIndex.size()) {
+        api2DomainIndex.resize(api + 1, 0);
+      }
+      if (api2DomainIndex[api] != 0) {
+        throw FbossError(
+            "SAI api ",
+            saiApiTypeToString(api),
+            " is in more than one lock domain");
+      }
+      api2DomainIndex[api] = index;
+    }
+    XLOG(DBG2) << "SAI api lock domain " << domain.name << " with "
+               << domain.apis.size() << " apis";
+  }
+  domains_ = std::move(newDomains);
+  api2DomainIndex_ = std::move(api2DomainIndex);
+}
+
+void SaiApiLock::serializeAllApis(const std::string& reason) {
+  XLOG(INFO) << "Serializing all SAI apis: " << reason;
+  serializeAllApisReason_ = reason;
+  if (domains_.size() > 1) {
+    setLockDomains({});
+  }
+}
+
+size_t SaiApiLock::getDomainIndex(sai_api_t api) const {
+  return api < api2DomainIndex_.size() ? api2DomainIndex_[api] : 0;
+}
+
+std::vector<SaiApiLockDomain> SaiApiLock::parseLockDomains(
+    const std::string& domains) {
+  std::vector<SaiApiLockDomain> lockDomains;
+  std::vector<std::string> domainSpecs;
+  folly::split(';', domains, domainSpecs, true /* ignoreEmpty */);
+  for (const auto& domainSpec : domainSpecs) {
+    std::string name, apis;
+    if (!folly::split(':', domainSpec, name, apis) || name.empty()) {
+      throw FbossError("Invalid SAI api lock domain: ", domainSpec);
+    }
+    SaiApiLockDomain lockDomain{name, {}};
+    std::vector<std::string> apiNames;
+    folly::split(',', apis, apiNames, true /* ignoreEmpty */);
+    for (const auto& apiName : apiNames) {
+      bool found = false;
+      for (int api = SAI_API_UNSPECIFIED + 1; api < SAI_API_MAX; ++api) {
+        if (saiApiTypeToString(static_cast<sai_api_t>(api)) == apiName) {
+          lockDomain.apis.insert(static_cast<sai_api_t>(api));
+          found = true;
+          break;
+        }
+      }
+      if (!found) {
+        throw FbossError("Unknown SAI api ", apiName, " in lock domain ", name);
+      }
+    }
+    lockDomains.push_back(std::move(lockDomain));
+  }
+  return lockDomains;
+}
+
+std::vector<SaiApiLockDomainStats> SaiApiLock::getDomainStats() const {
+  std::vector<SaiApiLockDomainStats> stats;
+  for (const auto& domain : domains_) {
+    stats.push_back(
+        {domain->name,
+         domain->acquisitions.load(std::memory_order_relaxed),
+         domain->contentions.load(std::memory_order_relaxed),
+         domain->waitUsecs.load(std::memory_order_relaxed)});
+  }
+  return stats;
+}
+
 } // namespace facebook::fboss
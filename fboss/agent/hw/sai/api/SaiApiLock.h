@@ -9,38 +9,112 @@
  */
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <sai.h>
+}
 
 namespace facebook::fboss {
 
+/*
+ * SAI APIs that are serialized with each other, but not with the APIs of
+ * other lock domains. Only APIs that the vendor SDK guarantees to be safe to
+ * call concurrently with all the others should be split off into a domain.
+ */
+struct SaiApiLockDomain {
+  std::string name;
+  std::set<sai_api_t> apis;
+};
+
+/*
+ * Time spent waiting on a lock domain, accumulated since the domain was
+ * created.
+ */
+struct SaiApiLockDomainStats {
+  std::string name;
+  uint64_t acquisitions{0};
+  uint64_t contentions{0};
+  uint64_t waitUsecs{0};
+};
+
 class SaiApiLock {
+  struct Domain {
+    explicit Domain(std::string name) : name(std::move(name)) {}
+    const std::string name;
+    std::mutex mutex;
+    std::atomic<uint64_t> acquisitions{0};
+    std::atomic<uint64_t> contentions{0};
+    std::atomic<uint64_t> waitUsecs{0};
+  };
+
   struct ScopedApiLock {
-    ScopedApiLock(std::mutex& m, bool noopLock) : mutex(m), noopLock(noopLock) {
+    ScopedApiLock(Domain& d, bool noopLock) : domain(d), noopLock(noopLock) {
       if (!noopLock) {
-        mutex.lock();
+        lock();
       }
     }
     ~ScopedApiLock() {
       if (!noopLock) {
-        mutex.unlock();
+        domain.mutex.unlock();
       }
     }
-    std::mutex& mutex;
+    void lock();
+    Domain& domain;
     bool noopLock{false};
   };
 
  public:
+  // Domain of all the SAI APIs not assigned to a domain of their own
+  static constexpr auto kDefaultDomainName = "default";
+
+  SaiApiLock();
+
   static std::shared_ptr<SaiApiLock> getInstance();
   void setAdaptorIsThreadSafe(bool isThreadSafe) {
     adaptorIsThreadSafe_ = isThreadSafe;
   }
+  /*
+   * Replaces the lock domains. Must be called before any SAI API is used,
+   * e.g. when the SAI APIs are queried.
+   */
+  void setLockDomains(const std::vector<SaiApiLockDomain>& domains);
+  /*
+   * Serializes all SAI APIs on the default domain from now on, dropping
+   * any domains set before and ignoring those set after. For users of SAI
+   * that rely on calls not running concurrently, e.g. the SAI replayer.
+   * Like setLockDomains(), must be called before any SAI API is used.
+   */
+  void serializeAllApis(const std::string& reason);
+  /*
+   * Parses lock domains from "<domain>:<api>,<api>;<domain>:<api>", with
+   * the API names of saiApiTypeToString(), e.g. "stats:port,queue;rx:hostif"
+   */
+  static std::vector<SaiApiLockDomain> parseLockDomains(
+      const std::string& domains);
+
   ScopedApiLock lock() const {
-    return {mutex_, adaptorIsThreadSafe_};
+    return {*domains_[0], adaptorIsThreadSafe_};
   }
+  ScopedApiLock lock(sai_api_t api) const {
+    return {*domains_[getDomainIndex(api)], adaptorIsThreadSafe_};
+  }
+  std::vector<SaiApiLockDomainStats> getDomainStats() const;
 
  private:
+  size_t getDomainIndex(sai_api_t api) const;
+
   bool adaptorIsThreadSafe_{false};
-  mutable std::mutex mutex_;
+  std::optional<std::string> serializeAllApisReason_;
+  // Index 0 is the default domain
+  std::vector<std::unique_ptr<Domain>> domains_;
+  std::vector<size_t> api2DomainIndex_;
 };
 } // namespace facebook::fboss
@@ -358,14 +358,14 @@ void SwitchApi::registerSwitchEventCallback(
     eventAttr.value.u32list.list = events.data();
 
     {
-      auto g{SaiApiLock::getInstance()->lock()};
+      auto g{SaiApiLock::getInstance()->lock(ApiType)};
       auto rv = _setAttribute(id, &eventAttr);
       saiLogError(rv, ApiType, "Unable to register parity error switch events");
     }
 
     {
       // Register switch event callback function
-      auto g{SaiApiLock::getInstance()->lock()};
+      auto g{SaiApiLock::getInstance()->lock(ApiType)};
       auto rv = _setAttribute(id, &attr);
       saiLogError(
           rv, ApiType, "Unable to register parity error switch event callback");
@@ -375,14 +375,14 @@ void SwitchApi::registerSwitchEventCallback(
     // First, unregister callback, then unregister events.
 
     {
-      auto g{SaiApiLock::getInstance()->lock()};
+      auto g{SaiApiLock::getInstance()->lock(ApiType)};
       // First unregister callback function
       auto rv = _setAttribute(id, &attr);
       saiLogError(rv, ApiType, "Unable to unregister TAM event callback");
     }
 
     {
-      auto g{SaiApiLock::getInstance()->lock()};
+      auto g{SaiApiLock::getInstance()->lock(ApiType)};
       // Then unregister switch events
       eventAttr.value.u32list.count = 0;
       auto rv = _setAttribute(id, &eventAttr);
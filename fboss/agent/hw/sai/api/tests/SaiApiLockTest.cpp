@@ -0,0 +1,142 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/sai/api/SaiApiLock.h"
+#include "fboss/agent/FbossError.h"
+
+#include <folly/synchronization/Baton.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace facebook::fboss;
+
+namespace {
+SaiApiLockDomainStats getDomainStats(
+    const SaiApiLock& apiLock,
+    const std::string& name) {
+  for (const auto& stats : apiLock.getDomainStats()) {
+    if (stats.name == name) {
+      return stats;
+    }
+  }
+  throw FbossError("No SAI api lock domain ", name);
+}
+} // namespace
+
+TEST(SaiApiLockTest, defaultDomain) {
+  SaiApiLock apiLock;
+  {
+    auto g{apiLock.lock(SAI_API_PORT)};
+  }
+  {
+    auto g{apiLock.lock()};
+  }
+  auto domainStats = apiLock.getDomainStats();
+  ASSERT_EQ(1, domainStats.size());
+  EXPECT_EQ(SaiApiLock::kDefaultDomainName, domainStats[0].name);
+  EXPECT_EQ(2, domainStats[0].acquisitions);
+  EXPECT_EQ(0, domainStats[0].contentions);
+}
+
+TEST(SaiApiLockTest, separateDomains) {
+  SaiApiLock apiLock;
+  apiLock.setLockDomains({{"stats", {SAI_API_PORT, SAI_API_QUEUE}}});
+  {
+    // Apis of different domains don't serialize with each other
+    auto statsLock{apiLock.lock(SAI_API_PORT)};
+    auto routeLock{apiLock.lock(SAI_API_ROUTE)};
+  }
+  {
+    auto g{apiLock.lock(SAI_API_QUEUE)};
+  }
+  EXPECT_EQ(2, getDomainStats(apiLock, "stats").acquisitions);
+  EXPECT_EQ(
+      1, getDomainStats(apiLock, SaiApiLock::kDefaultDomainName).acquisitions);
+}
+
+TEST(SaiApiLockTest, contention) {
+  SaiApiLock apiLock;
+  apiLock.setLockDomains({{"stats", {SAI_API_PORT}}});
+  folly::Baton<> locked;
+  std::unique_ptr<std::thread> waiter;
+  {
+    auto g{apiLock.lock(SAI_API_PORT)};
+    waiter = std::make_unique<std::thread>([&]() {
+      locked.post();
+      auto waiterLock{apiLock.lock(SAI_API_PORT)};
+    });
+    locked.wait();
+    // Give the waiter time to block on the domain
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  waiter->join();
+  auto stats = getDomainStats(apiLock, "stats");
+  EXPECT_EQ(2, stats.acquisitions);
+  EXPECT_EQ(1, stats.contentions);
+  EXPECT_GT(stats.waitUsecs, 0);
+  EXPECT_EQ(
+      0, getDomainStats(apiLock, SaiApiLock::kDefaultDomainName).contentions);
+}
+
+TEST(SaiApiLockTest, threadSafeAdaptor) {
+  SaiApiLock apiLock;
+  apiLock.setAdaptorIsThreadSafe(true);
+  {
+    auto g{apiLock.lock(SAI_API_PORT)};
+    auto g2{apiLock.lock(SAI_API_PORT)};
+  }
+  EXPECT_EQ(
+      0, getDomainStats(apiLock, SaiApiLock::kDefaultDomainName).acquisitions);
+}
+
+TEST(SaiApiLockTest, serializeAllApis) {
+  SaiApiLock apiLock;
+  apiLock.setLockDomains({{"stats", {SAI_API_PORT}}});
+  apiLock.serializeAllApis("test");
+  EXPECT_EQ(1, apiLock.getDomainStats().size());
+  // Domains set afterwards are ignored too
+  apiLock.setLockDomains({{"stats", {SAI_API_PORT}}});
+  {
+    auto g{apiLock.lock(SAI_API_PORT)};
+  }
+  auto domainStats = apiLock.getDomainStats();
+  ASSERT_EQ(1, domainStats.size());
+  EXPECT_EQ(SaiApiLock::kDefaultDomainName, domainStats[0].name);
+  EXPECT_EQ(1, domainStats[0].acquisitions);
+}
+
+TEST(SaiApiLockTest, invalidDomains) {
+  SaiApiLock apiLock;
+  EXPECT_THROW(
+      apiLock.setLockDomains(
+          {{"stats", {SAI_API_PORT}}, {"rx", {SAI_API_PORT}}}),
+      FbossError);
+  EXPECT_THROW(
+      apiLock.setLockDomains(
+          {{SaiApiLock::kDefaultDomainName, {SAI_API_PORT}}}),
+      FbossError);
+}
+
+TEST(SaiApiLockTest, parseDomains) {
+  EXPECT_TRUE(SaiApiLock::parseLockDomains("").empty());
+  auto domains = SaiApiLock::parseLockDomains("stats:port,queue;rx:hostif");
+  ASSERT_EQ(2, domains.size());
+  EXPECT_EQ("stats", domains[0].name);
+  EXPECT_EQ(
+      std::set<sai_api_t>({SAI_API_PORT, SAI_API_QUEUE}), domains[0].apis);
+  EXPECT_EQ("rx", domains[1].name);
+  EXPECT_EQ(std::set<sai_api_t>({SAI_API_HOSTIF}), domains[1].apis);
+
+  EXPECT_THROW(SaiApiLock::parseLockDomains("stats"), FbossError);
+  EXPECT_THROW(SaiApiLock::parseLockDomains(":port"), FbossError);
+  EXPECT_THROW(SaiApiLock::parseLockDomains("stats:bogus"), FbossError);
+}
@@ -124,4 +124,30 @@ class FakeManagerWithMembers : public FakeManager<sai_object_id_t, GroupT> {
   std::unordered_map<sai_object_id_t, sai_object_id_t> memberToGroupMap_;
 };
 
+/*
+ * Runs fn on each entry of a bulk call, following the semantics of its
+ * error mode. Used to implement bulk calls on top of their single object
+ * counterparts.
+ */
+template <typename Fn>
+sai_status_t fakeBulkEntriesFn(
+    uint32_t objectCount,
+    sai_bulk_op_error_mode_t mode,
+    sai_status_t* objectStatuses,
+    Fn&& fn) {
+  auto rv = SAI_STATUS_SUCCESS;
+  for (uint32_t i = 0; i < objectCount; ++i) {
+    if (rv != SAI_STATUS_SUCCESS &&
+        mode == SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR) {
+      objectStatuses[i] = SAI_STATUS_NOT_EXECUTED;
+      continue;
+    }
+    objectStatuses[i] = fn(i);
+    if (objectStatuses[i] != SAI_STATUS_SUCCESS) {
+      rv = SAI_STATUS_FAILURE;
+    }
+  }
+  return rv;
+}
+
 } // namespace facebook::fboss
@@ -145,3 +145,16 @@ sai_status_t sai_object_type_get_availability(
     uint32_t attr_count,
     const sai_attribute_t* attr_list,
     uint64_t* count);
+
+#if SAI_API_VERSION >= SAI_VERSION(1, 11, 0)
+sai_status_t sai_bulk_object_get_stats(
+    sai_object_id_t switch_id,
+    sai_object_type_t object_type,
+    uint32_t object_count,
+    const sai_object_key_t* object_key,
+    uint32_t number_of_counters,
+    const sai_stat_id_t* counter_ids,
+    sai_stats_mode_t mode,
+    sai_status_t* object_statuses,
+    uint64_t* counters);
+#endif
@@ -665,3 +665,55 @@ sai_status_t sai_get_object_key(
   }
   return SAI_STATUS_SUCCESS;
 }
+
+#if SAI_API_VERSION >= SAI_VERSION(1, 11, 0)
+/*
+ * Fake sai has no dataplane, so like the per object stats fns, reads all
+ * stats as 0, for the object types whose stats are collected in bulk.
+ */
+sai_status_t sai_bulk_object_get_stats(
+    sai_object_id_t /* switch_id */,
+    sai_object_type_t object_type,
+    uint32_t object_count,
+    const sai_object_key_t* object_key,
+    uint32_t number_of_counters,
+    const sai_stat_id_t* /* counter_ids */,
+    sai_stats_mode_t /* mode */,
+    sai_status_t* object_statuses,
+    uint64_t* counters) {
+  auto fs = facebook::fboss::FakeSai::getInstance();
+  auto exists = [&fs, object_type](sai_object_id_t id) {
+    switch (object_type) {
+      case SAI_OBJECT_TYPE_PORT:
+        return fs->portManager.exists(id);
+      case SAI_OBJECT_TYPE_QUEUE:
+        return fs->queueManager.exists(id);
+      case SAI_OBJECT_TYPE_ROUTER_INTERFACE:
+        return fs->routeInterfaceManager.exists(id);
+      default:
+        return false;
+    }
+  };
+  switch (object_type) {
+    case SAI_OBJECT_TYPE_PORT:
+    case SAI_OBJECT_TYPE_QUEUE:
+    case SAI_OBJECT_TYPE_ROUTER_INTERFACE:
+      break;
+    default:
+      return SAI_STATUS_NOT_SUPPORTED;
+  }
+  return facebook::fboss::fakeBulkEntriesFn(
+      object_count,
+      SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR,
+      object_statuses,
+      [&](uint32_t idx) {
+        if (!exists(object_key[idx].key.object_id)) {
+          return SAI_STATUS_INVALID_OBJECT_ID;
+        }
+        for (auto i = 0; i < number_of_counters; ++i) {
+          counters[idx * number_of_counters + i] = 0;
+        }
+        return SAI_STATUS_SUCCESS;
+      });
+}
+#endif
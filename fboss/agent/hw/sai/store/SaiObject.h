@@ -461,9 +461,16 @@ class SaiObject {
     if constexpr (IsObjectPublisher<SaiObjectTraits>::value) {
       notifyBeforeDestroy();
     }
-    if (isOwnedByAdapter() || skipRemove_) {
-      return;
+    if (removesFromHardware()) {
+      removeFromHardware();
     }
+  }
+
+  bool removesFromHardware() const {
+    return !isOwnedByAdapter() && !skipRemove_;
+  }
+
+  void removeFromHardware() {
     if constexpr (!IsSaiObjectOwnedByAdapter<SaiObjectTraits>::value) {
       auto& api = SaiApiTable::getInstance()
                       ->getApi<typename SaiObjectTraits::SaiApiT>();
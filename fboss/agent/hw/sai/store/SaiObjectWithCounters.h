@@ -15,7 +15,11 @@
 #include "fboss/lib/RefMap.h"
 #include "fboss/lib/TupleUtils.h"
 
+#include <algorithm>
+#include <atomic>
+#include <iterator>
 #include <variant>
+#include <vector>
 
 namespace facebook::fboss {
 
@@ -63,6 +67,56 @@ class SaiObjectWithCounters : public SaiObject<SaiObjectTraits> {
     fillInStats(counterIds.data(), counters);
   }
 
+  /*
+   * Reads counterIds of several objects with one bulk SAI call, as
+   * updateStats(counterIds, mode) would for each object. Objects failing the
+   * bulk read are read again one at a time, which throws as a single read
+   * would. Once the adapter turns out not to support bulk stats for this
+   * object type, objects are always read one at a time.
+   */
+  template <typename T = SaiObjectTraits>
+  static void bulkUpdateStats(
+      sai_object_id_t switchId,
+      const std::vector<SaiObjectWithCounters*>& objects,
+      const std::vector<sai_stat_id_t>& counterIds,
+      sai_stats_mode_t mode) {
+    static_assert(SaiObjectHasStats<T>::value, "invalid traits for the api");
+    if (objects.size() > 1 && !counterIds.empty() && bulkStatsSupported_) {
+      std::vector<typename T::AdapterKey> keys;
+      keys.reserve(objects.size());
+      for (auto* object : objects) {
+        keys.push_back(object->adapterKey());
+      }
+      auto& api = SaiApiTable::getInstance()->getApi<typename T::SaiApiT>();
+      std::vector<uint64_t> counters;
+      std::vector<sai_status_t> statuses;
+      auto status = api.template bulkGetStats<T>(
+          switchId, keys, counterIds, mode, counters, statuses);
+      if (status != SAI_STATUS_NOT_IMPLEMENTED &&
+          status != SAI_STATUS_NOT_SUPPORTED) {
+        for (auto idx = 0; idx < objects.size(); idx++) {
+          if (statuses[idx] == SAI_STATUS_SUCCESS) {
+            objects[idx]->fillInStats(
+                counterIds.data(),
+                counters.data() + idx * counterIds.size(),
+                counterIds.size());
+          } else {
+            objects[idx]->updateStats(counterIds, mode);
+          }
+        }
+        return;
+      }
+      XLOGF(
+          WARNING,
+          "bulk stats not supported for {}, reading stats one object at a time",
+          saiObjectTypeToString(T::ObjectType));
+      bulkStatsSupported_ = false;
+    }
+    for (auto* object : objects) {
+      object->updateStats(counterIds, mode);
+    }
+  }
+
   template <typename T = SaiObjectTraits>
   const StatsMap getStats() const {
     static_assert(SaiObjectHasStats<T>::value, "invalid traits for the api");
@@ -100,11 +154,84 @@ class SaiObjectWithCounters : public SaiObject<SaiObjectTraits> {
   void fillInStats(
       const sai_stat_id_t* ids,
       const std::vector<uint64_t>& counters) {
-    for (auto i = 0; i < counters.size(); ++i) {
+    fillInStats(ids, counters.data(), counters.size());
+  }
+  void fillInStats(
+      const sai_stat_id_t* ids,
+      const uint64_t* counters,
+      size_t numCounters) {
+    for (auto i = 0; i < numCounters; ++i) {
       counterId2Value_[ids[i]] = counters[i];
     }
   }
   StatsMap counterId2Value_;
+  // cleared once the adapter fails bulk stats reads as unsupported
+  static inline std::atomic<bool> bulkStatsSupported_{true};
+};
+
+/*
+ * Collects the stats reads of several objects, to run them with one bulk
+ * read per counter list and mode, rather than one read per object. Without
+ * bulk, runs the reads one at a time, in the order they were added.
+ */
+template <typename SaiObjectTraits>
+class SaiObjectStatsReader {
+ public:
+  using ObjectType = SaiObjectWithCounters<SaiObjectTraits>;
+
+  SaiObjectStatsReader(sai_object_id_t switchId, bool bulk)
+      : switchId_(switchId), bulk_(bulk) {}
+
+  // counterIds must outlive the reader
+  void add(
+      ObjectType* object,
+      const std::vector<sai_stat_id_t>& counterIds,
+      sai_stats_mode_t mode) {
+    reads_.push_back({object, &counterIds, mode});
+  }
+
+  void read() {
+    if (!bulk_) {
+      for (const auto& read : reads_) {
+        read.object->updateStats(*read.counterIds, read.mode);
+      }
+      return;
+    }
+    // objects of each counter list and mode, in the order first added
+    std::vector<Group> groups;
+    for (const auto& read : reads_) {
+      auto it = std::find_if(
+          groups.begin(), groups.end(), [&read](const Group& group) {
+            return group.mode == read.mode &&
+                (group.counterIds == read.counterIds ||
+                 *group.counterIds == *read.counterIds);
+          });
+      if (it == groups.end()) {
+        groups.push_back({read.counterIds, read.mode, {}});
+        it = std::prev(groups.end());
+      }
+      it->objects.push_back(read.object);
+    }
+    for (const auto& group : groups) {
+      ObjectType::bulkUpdateStats(
+          switchId_, group.objects, *group.counterIds, group.mode);
+    }
+  }
+
+ private:
+  struct Read {
+    ObjectType* object;
+    const std::vector<sai_stat_id_t>* counterIds;
+    sai_stats_mode_t mode;
+  };
+  struct Group {
+    const std::vector<sai_stat_id_t>* counterIds;
+    sai_stats_mode_t mode;
+    std::vector<ObjectType*> objects;
+  };
+  sai_object_id_t switchId_;
+  bool bulk_;
+  std::vector<Read> reads_;
 };
 
 } // namespace facebook::fboss
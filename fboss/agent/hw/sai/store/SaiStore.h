@@ -31,6 +31,8 @@
 #include <optional>
 #include <sstream>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 extern "C" {
 #include <sai.h>
@@ -74,6 +76,20 @@ struct AdapterHostKeyWarmbootRecoverable<SaiWredTraits> : std::false_type {};
 
 #endif
 
+namespace detail {
+// Attribute passed to bulk set calls for an attribute of CreateAttributes
+template <typename AttrT>
+struct BulkSetAttr {
+  using type = AttrT;
+  static constexpr bool kOptional = false;
+};
+template <typename AttrT>
+struct BulkSetAttr<std::optional<AttrT>> {
+  using type = AttrT;
+  static constexpr bool kOptional = true;
+};
+} // namespace detail
+
 /*
  * SaiObjectStore is the critical component of SaiStore,
  * it provides the needed operations on a single type of SaiObject
@@ -347,6 +363,120 @@ class SaiObjectStore {
     }
   }
 
+  /*
+   * Bulk counterpart of setObject() for entry struct objects (routes,
+   * neighbors...). Missing objects are created with bulk creates, and each
+   * attribute changed on existing objects is set with bulk sets, in
+   * attribute order. Objects fail independently: statuses gets the SAI
+   * status of each object, and the objects failing to program are returned
+   * as nullptr. A failed existing object may have had some of its
+   * attributes set. Adapters without bulk support get one call per object
+   * instead.
+   */
+  template <EntryStructSaiObject T = SaiObjectTraits>
+  std::vector<std::shared_ptr<ObjectType>> bulkSetObjects(
+      const std::vector<typename T::AdapterHostKey>& adapterHostKeys,
+      const std::vector<typename T::CreateAttributes>& attributes,
+      std::vector<sai_status_t>& statuses,
+      bool notify = true) {
+    static_assert(
+        std::is_same_v<typename PublisherKey<T>::custom_type, std::monostate>,
+        "method not available for objects with publisher attributes of custom types");
+    return bulkSetObjectsImpl<T>(
+        adapterHostKeys, attributes, statuses, notify, nullptr);
+  }
+
+  template <EntryStructSaiObject T = SaiObjectTraits>
+  std::vector<std::shared_ptr<ObjectType>> bulkSetObjects(
+      const std::vector<typename T::AdapterHostKey>& adapterHostKeys,
+      const std::vector<typename T::CreateAttributes>& attributes,
+      const std::vector<typename PublisherKey<T>::custom_type>& publisherKeys,
+      std::vector<sai_status_t>& statuses,
+      bool notify = true) {
+    static_assert(
+        !std::is_same_v<typename PublisherKey<T>::custom_type, std::monostate>,
+        "method available only for objects with publisher attributes of custom types");
+    CHECK_EQ(adapterHostKeys.size(), publisherKeys.size());
+    return bulkSetObjectsImpl<T>(
+        adapterHostKeys, attributes, statuses, notify, &publisherKeys);
+  }
+
+  /*
+   * Removes entry struct objects with bulk removes, instead of one remove
+   * per object as their last reference goes. Subscribers of the objects are
+   * notified first, as they would be by single removes. Objects failing the
+   * bulk remove are removed again one at a time, which throws as a single
+   * remove would. Owners must drop the objects right after, as they are
+   * released once removed.
+   */
+  template <EntryStructSaiObject T = SaiObjectTraits>
+  void bulkRemoveObjects(
+      const std::vector<std::shared_ptr<ObjectType>>& objects) {
+    if (objects.empty() || !bulkEntriesSupported_) {
+      return;
+    }
+    std::vector<std::shared_ptr<ObjectType>> removedObjects;
+    std::vector<typename T::AdapterKey> adapterKeys;
+    removedObjects.reserve(objects.size());
+    adapterKeys.reserve(objects.size());
+    for (const auto& object : objects) {
+      // objects owned by the adapter, or skipping removal, only notify
+      // their subscribers as they go
+      if (object->removesFromHardware()) {
+        removedObjects.push_back(object);
+        adapterKeys.push_back(object->adapterKey());
+      }
+    }
+    if (removedObjects.empty()) {
+      return;
+    }
+    if constexpr (IsObjectPublisher<SaiObjectTraits>::value) {
+      for (const auto& object : removedObjects) {
+        object->notifyBeforeDestroy();
+      }
+    }
+    auto& api =
+        SaiApiTable::getInstance()->getApi<typename SaiObjectTraits::SaiApiT>();
+    std::vector<sai_status_t> statuses(removedObjects.size());
+    try {
+      bulkForEach(
+          adapterKeys.size(),
+          statuses,
+          [&](size_t begin) {
+            return api.bulkRemoveEntries(std::vector<typename T::AdapterKey>(
+                adapterKeys.begin() + begin, adapterKeys.end()));
+          });
+    } catch (const SaiApiError& e) {
+      if (e.getSaiStatus() != SAI_STATUS_NOT_IMPLEMENTED &&
+          e.getSaiStatus() != SAI_STATUS_NOT_SUPPORTED) {
+        throw;
+      }
+      XLOGF(
+          WARNING,
+          "Bulk removal of {} objects not supported, "
+          "removing objects one at a time",
+          objectTypeName());
+      bulkEntriesSupported_ = false;
+      statuses.assign(removedObjects.size(), SAI_STATUS_NOT_EXECUTED);
+    }
+    for (auto idx = 0; idx < removedObjects.size(); idx++) {
+      auto& object = removedObjects[idx];
+      if (statuses[idx] != SAI_STATUS_SUCCESS) {
+        if (statuses[idx] != SAI_STATUS_NOT_EXECUTED) {
+          XLOGF(
+              ERR,
+              "SaiStore failed to bulk remove {} object {}: {}",
+              objectTypeName(),
+              adapterKeys[idx],
+              saiStatusToString(statuses[idx]));
+        }
+        object->removeFromHardware();
+      }
+      // removed and notified already, nothing left to do on destruction
+      object->release();
+    }
+  }
+
   std::shared_ptr<ObjectType> get(
       const typename SaiObjectTraits::AdapterHostKey& adapterHostKey) {
     XLOGF(DBG5, "SaiStore get object {}", adapterHostKey);
@@ -531,6 +661,80 @@ class SaiObjectStore {
     }
   }
 
+  template <EntryStructSaiObject T = SaiObjectTraits>
+  std::vector<std::shared_ptr<ObjectType>> bulkSetObjectsImpl(
+      const std::vector<typename T::AdapterHostKey>& adapterHostKeys,
+      const std::vector<typename T::CreateAttributes>& attributes,
+      std::vector<sai_status_t>& statuses,
+      bool notify,
+      const std::vector<typename PublisherKey<T>::custom_type>*
+          publisherKeys) {
+    CHECK_EQ(adapterHostKeys.size(), attributes.size());
+    std::vector<std::shared_ptr<ObjectType>> objs(adapterHostKeys.size());
+    std::vector<bool> created(adapterHostKeys.size(), false);
+    statuses.assign(adapterHostKeys.size(), SAI_STATUS_SUCCESS);
+    if (bulkEntriesSupported_) {
+      try {
+        bulkProgram(adapterHostKeys, attributes, objs, created, statuses);
+      } catch (const SaiApiError& e) {
+        if (e.getSaiStatus() != SAI_STATUS_NOT_IMPLEMENTED &&
+            e.getSaiStatus() != SAI_STATUS_NOT_SUPPORTED) {
+          throw;
+        }
+        XLOGF(
+            WARNING,
+            "Bulk programming of {} objects not supported, "
+            "programming objects one at a time",
+            objectTypeName());
+        bulkEntriesSupported_ = false;
+      }
+    }
+    if (!bulkEntriesSupported_) {
+      // objects bulk created before the fallback are found, and only
+      // programmed again if needed
+      statuses.assign(adapterHostKeys.size(), SAI_STATUS_SUCCESS);
+      for (auto idx = 0; idx < adapterHostKeys.size(); idx++) {
+        try {
+          auto [object, programmed] =
+              program(adapterHostKeys[idx], attributes[idx]);
+          objs[idx] = object;
+          created[idx] = created[idx] || programmed;
+        } catch (const SaiApiError& e) {
+          statuses[idx] = e.getSaiStatus();
+        }
+      }
+    }
+    for (auto idx = 0; idx < adapterHostKeys.size(); idx++) {
+      if (statuses[idx] != SAI_STATUS_SUCCESS) {
+        XLOGF(
+            ERR,
+            "SaiStore failed to bulk set {} object {}: {}",
+            objectTypeName(),
+            adapterHostKeys[idx],
+            saiStatusToString(statuses[idx]));
+        objs[idx].reset();
+        continue;
+      }
+      auto iter = warmBootHandles_.find(adapterHostKeys[idx]);
+      if (iter != warmBootHandles_.end()) {
+        warmBootHandles_.erase(iter);
+        created[idx] = true;
+      }
+      if (notify && created[idx]) {
+        if constexpr (IsObjectPublisher<SaiObjectTraits>::value) {
+          if constexpr (!std::is_same_v<
+                            typename PublisherKey<T>::custom_type,
+                            std::monostate>) {
+            objs[idx]->setCustomPublisherKey((*publisherKeys)[idx]);
+          }
+          objs[idx]->notifyAfterCreate(objs[idx]);
+        }
+      }
+      XLOGF(DBG5, "SaiStore bulk set object {}", *objs[idx]);
+    }
+    return objs;
+  }
+
   std::pair<std::shared_ptr<ObjectType>, bool> program(
       const typename SaiObjectTraits::AdapterHostKey& adapterHostKey,
       const typename SaiObjectTraits::CreateAttributes& attributes) {
@@ -553,6 +757,159 @@ class SaiObjectStore {
     return std::make_pair(ins.first, notify);
   }
 
+  /*
+   * Calls bulkFn(begin) for the entries from begin to count, and again for
+   * the entries left unattempted by a bulk call stopping at a failed entry,
+   * until every entry got a status.
+   */
+  template <typename BulkFn>
+  static void bulkForEach(
+      size_t count,
+      std::vector<sai_status_t>& statuses,
+      BulkFn&& bulkFn) {
+    size_t begin = 0;
+    while (begin < count) {
+      auto bulkStatuses = bulkFn(begin);
+      size_t attempted = 0;
+      while (attempted < bulkStatuses.size() &&
+             bulkStatuses[attempted] != SAI_STATUS_NOT_EXECUTED) {
+        statuses[begin + attempted] = bulkStatuses[attempted];
+        attempted++;
+      }
+      if (attempted == 0) {
+        // adapter attempted nothing, don't call it again for the same entry
+        statuses[begin] = SAI_STATUS_FAILURE;
+        attempted = 1;
+      }
+      begin += attempted;
+    }
+  }
+
+  template <EntryStructSaiObject T = SaiObjectTraits>
+  void bulkProgram(
+      const std::vector<typename T::AdapterHostKey>& adapterHostKeys,
+      const std::vector<typename T::CreateAttributes>& attributes,
+      std::vector<std::shared_ptr<ObjectType>>& objs,
+      std::vector<bool>& created,
+      std::vector<sai_status_t>& statuses) {
+    auto& api =
+        SaiApiTable::getInstance()->getApi<typename SaiObjectTraits::SaiApiT>();
+    std::vector<typename T::AdapterKey> createKeys;
+    std::vector<typename T::CreateAttributes> createAttributes;
+    std::vector<size_t> createIndices;
+    std::vector<size_t> existingIndices;
+    for (auto idx = 0; idx < adapterHostKeys.size(); idx++) {
+      if (auto existingObj = objects_.ref(adapterHostKeys[idx])) {
+        objs[idx] = existingObj;
+        existingIndices.push_back(idx);
+      } else {
+        createKeys.push_back(adapterHostKeys[idx]);
+        createAttributes.push_back(attributes[idx]);
+        createIndices.push_back(idx);
+      }
+    }
+    std::vector<sai_status_t> createStatuses(createIndices.size());
+    bulkForEach(createIndices.size(), createStatuses, [&](size_t begin) {
+      return api.template bulkCreateEntries<T>(
+          std::vector<typename T::AdapterKey>(
+              createKeys.begin() + begin, createKeys.end()),
+          std::vector<typename T::CreateAttributes>(
+              createAttributes.begin() + begin, createAttributes.end()));
+    });
+    for (auto i = 0; i < createIndices.size(); i++) {
+      auto idx = createIndices[i];
+      statuses[idx] = createStatuses[i];
+      if (statuses[idx] == SAI_STATUS_SUCCESS) {
+        objs[idx] = objects_
+                        .refOrInsert(
+                            adapterHostKeys[idx],
+                            ObjectType(
+                                createKeys[i],
+                                adapterHostKeys[idx],
+                                createAttributes[i]),
+                            true /*force*/)
+                        .first;
+        created[idx] = true;
+      }
+    }
+    bulkSetChangedAttributes(
+        attributes,
+        objs,
+        existingIndices,
+        statuses,
+        std::make_index_sequence<
+            std::tuple_size_v<typename T::CreateAttributes>>());
+  }
+
+  template <size_t... AttrIndex>
+  void bulkSetChangedAttributes(
+      const std::vector<typename SaiObjectTraits::CreateAttributes>&
+          attributes,
+      const std::vector<std::shared_ptr<ObjectType>>& objs,
+      const std::vector<size_t>& existingIndices,
+      std::vector<sai_status_t>& statuses,
+      std::index_sequence<AttrIndex...>) {
+    (bulkSetChangedAttribute<AttrIndex>(
+         attributes, objs, existingIndices, statuses),
+     ...);
+  }
+
+  // Sets the attribute at AttrIndex of CreateAttributes on the objects it
+  // changed on, with one bulk set
+  template <size_t AttrIndex>
+  void bulkSetChangedAttribute(
+      const std::vector<typename SaiObjectTraits::CreateAttributes>&
+          attributes,
+      const std::vector<std::shared_ptr<ObjectType>>& objs,
+      const std::vector<size_t>& existingIndices,
+      std::vector<sai_status_t>& statuses) {
+    using AttrT = std::tuple_element_t<
+        AttrIndex,
+        typename SaiObjectTraits::CreateAttributes>;
+    using SetAttrT = typename detail::BulkSetAttr<AttrT>::type;
+    std::vector<size_t> changedIndices;
+    std::vector<typename SaiObjectTraits::AdapterKey> adapterKeys;
+    std::vector<SetAttrT> newAttrs;
+    for (auto idx : existingIndices) {
+      if (statuses[idx] != SAI_STATUS_SUCCESS) {
+        continue;
+      }
+      const auto& oldAttr = std::get<AttrIndex>(objs[idx]->attributes());
+      const auto& newAttr = std::get<AttrIndex>(attributes[idx]);
+      if (oldAttr == newAttr) {
+        continue;
+      }
+      if constexpr (!detail::BulkSetAttr<AttrT>::kOptional) {
+        newAttrs.push_back(newAttr);
+      } else if (newAttr) {
+        newAttrs.push_back(newAttr.value());
+      } else {
+        // unset optional attributes are not written to hardware
+        objs[idx]->checkAndSetAttribute(newAttr, true /* skipHwWrite */);
+        continue;
+      }
+      changedIndices.push_back(idx);
+      adapterKeys.push_back(objs[idx]->adapterKey());
+    }
+    auto& api =
+        SaiApiTable::getInstance()->getApi<typename SaiObjectTraits::SaiApiT>();
+    std::vector<sai_status_t> setStatuses(changedIndices.size());
+    bulkForEach(changedIndices.size(), setStatuses, [&](size_t begin) {
+      return api.bulkSetEntriesAttribute(
+          std::vector<typename SaiObjectTraits::AdapterKey>(
+              adapterKeys.begin() + begin, adapterKeys.end()),
+          std::vector<SetAttrT>(newAttrs.begin() + begin, newAttrs.end()));
+    });
+    for (auto i = 0; i < changedIndices.size(); i++) {
+      auto idx = changedIndices[i];
+      statuses[idx] = setStatuses[i];
+      if (statuses[idx] == SAI_STATUS_SUCCESS) {
+        objs[idx]->checkAndSetAttribute(
+            std::get<AttrIndex>(attributes[idx]), true /* skipHwWrite */);
+      }
+    }
+  }
+
   std::vector<typename SaiObjectTraits::AdapterKey> getAdapterKeys(
       const folly::dynamic* adapterKeysJson) const {
     return adapterKeysJson
@@ -580,6 +937,8 @@ class SaiObjectStore {
       typename SaiObjectTraits::AdapterHostKey,
       std::shared_ptr<ObjectType>>
       warmBootHandles_;
+  // cleared on the first bulk call the adapter doesn't support
+  bool bulkEntriesSupported_{true};
 };
 
 /*
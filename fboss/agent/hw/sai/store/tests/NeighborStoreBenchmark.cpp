@@ -0,0 +1,102 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/sai/api/NeighborApi.h"
+#include "fboss/agent/hw/sai/api/SaiApiTable.h"
+#include "fboss/agent/hw/sai/fake/FakeSai.h"
+#include "fboss/agent/hw/sai/store/SaiStore.h"
+
+#include <folly/Benchmark.h>
+#include <folly/IPAddressV6.h>
+#include <folly/init/Init.h>
+
+#include <memory>
+#include <vector>
+
+using namespace facebook::fboss;
+
+/*
+ * Programs and removes neighbors through the SaiStore on fake SAI, with
+ * single and bulk SAI calls, to measure the per call overhead that bulk
+ * programming saves in the agent.
+ */
+namespace {
+
+constexpr size_t kNumNeighbors = 64 * 1024;
+
+std::vector<SaiNeighborTraits::NeighborEntry> makeNeighborEntries() {
+  std::vector<SaiNeighborTraits::NeighborEntry> entries;
+  entries.reserve(kNumNeighbors);
+  auto base = folly::IPAddressV6("2401:db00::").toByteArray();
+  for (size_t i = 0; i < kNumNeighbors; ++i) {
+    auto bytes = base;
+    bytes[13] = (i >> 16) & 0xff;
+    bytes[14] = (i >> 8) & 0xff;
+    bytes[15] = i & 0xff;
+    auto ip = folly::IPAddressV6::fromBinary(
+        folly::ByteRange(bytes.data(), bytes.size()));
+    entries.emplace_back(0, 0, folly::IPAddress(ip));
+  }
+  return entries;
+}
+
+std::vector<SaiNeighborTraits::CreateAttributes> makeNeighborAttributes() {
+  folly::MacAddress dstMac{"02:00:00:00:00:01"};
+  return std::vector<SaiNeighborTraits::CreateAttributes>(
+      kNumNeighbors,
+      {dstMac, std::nullopt, std::nullopt, std::nullopt, std::nullopt});
+}
+
+void programNeighbors(bool bulk) {
+  std::unique_ptr<SaiStore> saiStore;
+  std::vector<SaiNeighborTraits::NeighborEntry> entries;
+  std::vector<SaiNeighborTraits::CreateAttributes> attributes;
+  BENCHMARK_SUSPEND {
+    FakeSai::getInstance();
+    auto saiApiTable = SaiApiTable::getInstance();
+    saiApiTable->queryApis(nullptr, saiApiTable->getFullApiList());
+    saiStore = std::make_unique<SaiStore>(0);
+    entries = makeNeighborEntries();
+    attributes = makeNeighborAttributes();
+  }
+  auto& store = saiStore->get<SaiNeighborTraits>();
+  std::vector<std::shared_ptr<SaiNeighbor>> neighbors;
+  if (bulk) {
+    std::vector<sai_status_t> statuses;
+    neighbors = store.bulkSetObjects(entries, attributes, statuses);
+    store.bulkRemoveObjects(neighbors);
+  } else {
+    neighbors.reserve(kNumNeighbors);
+    for (size_t i = 0; i < kNumNeighbors; ++i) {
+      neighbors.push_back(store.setObject(entries[i], attributes[i]));
+    }
+  }
+  neighbors.clear();
+  BENCHMARK_SUSPEND {
+    saiStore.reset();
+    FakeSai::clear();
+  }
+}
+
+} // namespace
+
+BENCHMARK(SingleNeighborProgramming) {
+  programNeighbors(false);
+}
+
+BENCHMARK_RELATIVE(BulkNeighborProgramming) {
+  programNeighbors(true);
+}
+
+int main(int argc, char** argv) {
+  folly::Init init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -187,3 +187,37 @@ TEST_F(SaiStoreTest, neighborPublisher) {
   EXPECT_TRUE(IsObjectPublisher<SaiNeighborTraits>::value);
   EXPECT_FALSE(IsObjectPublisher<SaiInSegTraits>::value);
 }
+
+TEST_F(SaiStoreTest, bulkSetAndRemoveNeighbors) {
+  auto& neighborApi = saiApiTable->neighborApi();
+  auto& store = saiStore->get<SaiNeighborTraits>();
+  SaiNeighborTraits::NeighborEntry n1(0, 0, folly::IPAddress{"10.10.10.1"});
+  SaiNeighborTraits::NeighborEntry n2(0, 0, folly::IPAddress{"42::1"});
+  folly::MacAddress dstMac1{"42:42:42:42:42:42"};
+  folly::MacAddress dstMac2{"42:42:42:42:42:43"};
+  auto existing = store.setObject(n1, createAttrs(dstMac2));
+  std::vector<SaiNeighborTraits::CreateAttributes> attributes{
+      createAttrs(dstMac1, 42), createAttrs(dstMac2)};
+
+  std::vector<sai_status_t> statuses;
+  auto neighbors = store.bulkSetObjects({n1, n2}, attributes, statuses);
+  ASSERT_EQ(neighbors.size(), 2);
+  EXPECT_EQ(statuses[0], SAI_STATUS_SUCCESS);
+  EXPECT_EQ(statuses[1], SAI_STATUS_SUCCESS);
+  // existing objects are updated in place
+  EXPECT_EQ(neighbors[0], existing);
+  EXPECT_EQ(neighbors[1], store.get(n2));
+  EXPECT_EQ(
+      neighborApi.getAttribute(n1, SaiNeighborTraits::Attributes::DstMac{}),
+      dstMac1);
+  EXPECT_EQ(
+      neighborApi.getAttribute(n2, SaiNeighborTraits::Attributes::DstMac{}),
+      dstMac2);
+
+  // removed neighbors are not removed again when released
+  store.bulkRemoveObjects(neighbors);
+  existing.reset();
+  neighbors.clear();
+  EXPECT_FALSE(store.get(n1));
+  EXPECT_FALSE(store.get(n2));
+}
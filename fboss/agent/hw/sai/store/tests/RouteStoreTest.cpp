@@ -242,3 +242,42 @@ TEST_F(SaiStoreTest, toStrV6Route) {
 
   verifyToStr<SaiRouteTraits>();
 }
+
+TEST_F(SaiStoreTest, bulkSetAndRemoveRoutes) {
+  auto& routeApi = saiApiTable->routeApi();
+  auto& store = saiStore->get<SaiRouteTraits>();
+  SaiRouteTraits::RouteEntry r1(0, 0, {folly::IPAddress{"10.10.10.1"}, 24});
+  SaiRouteTraits::RouteEntry r2(0, 0, {folly::IPAddress{"10.10.20.1"}, 24});
+  SaiRouteTraits::Attributes::PacketAction forward{SAI_PACKET_ACTION_FORWARD};
+#if SAI_API_VERSION >= SAI_VERSION(1, 10, 0)
+  auto existing = store.setObject(r1, {forward, 5, 42, std::nullopt});
+  std::vector<SaiRouteTraits::CreateAttributes> attributes{
+      {forward, 4, 42, std::nullopt}, {forward, 6, std::nullopt, std::nullopt}};
+#else
+  auto existing = store.setObject(r1, {forward, 5, 42});
+  std::vector<SaiRouteTraits::CreateAttributes> attributes{
+      {forward, 4, 42}, {forward, 6, std::nullopt}};
+#endif
+
+  std::vector<sai_status_t> statuses;
+  auto routes = store.bulkSetObjects({r1, r2}, attributes, statuses);
+  ASSERT_EQ(routes.size(), 2);
+  EXPECT_EQ(statuses[0], SAI_STATUS_SUCCESS);
+  EXPECT_EQ(statuses[1], SAI_STATUS_SUCCESS);
+  // existing objects are updated in place
+  EXPECT_EQ(routes[0], existing);
+  EXPECT_EQ(routes[1], store.get(r2));
+  EXPECT_EQ(routes[0]->attributes(), attributes[0]);
+  EXPECT_EQ(routes[1]->attributes(), attributes[1]);
+  EXPECT_EQ(
+      routeApi.getAttribute(r1, SaiRouteTraits::Attributes::NextHopId{}), 4);
+  EXPECT_EQ(
+      routeApi.getAttribute(r2, SaiRouteTraits::Attributes::NextHopId{}), 6);
+
+  // removed routes are not removed again when released
+  store.bulkRemoveObjects(routes);
+  existing.reset();
+  routes.clear();
+  EXPECT_FALSE(store.get(r1));
+  EXPECT_FALSE(store.get(r2));
+}
@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/sai/switch/DeltaProcessorGraph.h"
+
+#include "fboss/agent/FbossError.h"
+
+#include <folly/futures/Future.h>
+
+#include <algorithm>
+
+namespace facebook::fboss {
+
+DeltaProcessorGraph::ProcessorId DeltaProcessorGraph::add(
+    std::string name,
+    Processor processor,
+    std::vector<ProcessorId> dependencies) {
+  size_t wave = 0;
+  for (auto dependency : dependencies) {
+    if (dependency >= nodes_.size()) {
+      throw FbossError(
+          "Delta processor ",
+          name,
+          " depends on unknown processor ",
+          dependency);
+    }
+    wave = std::max(wave, nodes_[dependency].wave + 1);
+  }
+  nodes_.push_back({std::move(name), std::move(processor), wave});
+  return nodes_.size() - 1;
+}
+
+std::vector<std::vector<DeltaProcessorGraph::ProcessorId>>
+DeltaProcessorGraph::computeWaves() const {
+  std::vector<std::vector<ProcessorId>> waves;
+  for (ProcessorId id = 0; id < nodes_.size(); ++id) {
+    if (nodes_[id].wave >= waves.size()) {
+      waves.resize(nodes_[id].wave + 1);
+    }
+    waves[nodes_[id].wave].push_back(id);
+  }
+  return waves;
+}
+
+void DeltaProcessorGraph::run(folly::Executor* executor) const {
+  if (!executor) {
+    // Insertion order honors the dependencies as well
+    for (const auto& node : nodes_) {
+      node.processor();
+    }
+    return;
+  }
+  for (const auto& wave : computeWaves()) {
+    if (wave.size() == 1) {
+      nodes_[wave.front()].processor();
+      continue;
+    }
+    std::vector<folly::Future<folly::Unit>> futures;
+    futures.reserve(wave.size());
+    for (auto id : wave) {
+      futures.push_back(
+          folly::via(executor, [this, id] { nodes_[id].processor(); }));
+    }
+    // Wait for the whole wave before surfacing an error, so that no
+    // processor is still programming while the caller handles it
+    auto results = folly::collectAll(std::move(futures)).get();
+    for (auto& result : results) {
+      if (result.hasException()) {
+        result.exception().throw_exception();
+      }
+    }
+  }
+}
+
+std::vector<std::vector<std::string>> DeltaProcessorGraph::getWaves() const {
+  std::vector<std::vector<std::string>> waves;
+  for (const auto& wave : computeWaves()) {
+    auto& names = waves.emplace_back();
+    for (auto id : wave) {
+      names.push_back(nodes_[id].name);
+    }
+  }
+  return waves;
+}
+
+} // namespace facebook::fboss
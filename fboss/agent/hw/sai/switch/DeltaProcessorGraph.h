@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include <folly/Executor.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * Delta processors of a state update along with the processors each of them
+ * must run after.
+ *
+ * Processors run in waves: a processor is in the wave after the last wave
+ * holding one of its dependencies, and a wave only starts once the previous
+ * one is done. Given an executor, the processors of a wave run on it
+ * concurrently, otherwise all processors run on the calling thread in the
+ * order they were added in. Processors are expected to take the SaiSwitch
+ * lock themselves for each object they program.
+ *
+ * If processors throw, the waves after are skipped and run() rethrows the
+ * error of the first processor added that failed, once the rest of its wave
+ * is done.
+ */
+class DeltaProcessorGraph {
+ public:
+  using ProcessorId = size_t;
+  using Processor = std::function<void()>;
+
+  // Dependencies must be processors added earlier, which keeps the graph
+  // acyclic
+  ProcessorId add(
+      std::string name,
+      Processor processor,
+      std::vector<ProcessorId> dependencies = {});
+
+  void run(folly::Executor* executor) const;
+
+  // Processor names in the order of their waves, for tests
+  std::vector<std::vector<std::string>> getWaves() const;
+
+ private:
+  struct Node {
+    std::string name;
+    Processor processor;
+    size_t wave;
+  };
+
+  std::vector<std::vector<ProcessorId>> computeWaves() const;
+
+  std::vector<Node> nodes_;
+};
+
+} // namespace facebook::fboss
@@ -10,6 +10,7 @@
 
 #include "fboss/agent/hw/sai/switch/SaiFdbManager.h"
 
+#include "fboss/agent/AgentFeatures.h"
 #include "fboss/agent/hw/sai/api/SaiObjectApi.h"
 #include "fboss/agent/hw/sai/store/SaiStore.h"
 #include "fboss/agent/hw/sai/switch/ConcurrentIndices.h"
@@ -52,6 +53,12 @@ void ManagedFdbEntry::createObject(PublisherObjects objects) {
   SaiFdbTraits::CreateAttributes attributes{type_, bridgePortId, metadata_};
 
   auto fdbEntry = manager_->createSaiObject(entry, attributes, intfIDAndMac_);
+  if (fdbEntry) {
+    setFdbEntry(fdbEntry);
+  }
+}
+
+void ManagedFdbEntry::setFdbEntry(std::shared_ptr<SaiFdbEntry> fdbEntry) {
   // For FDB entry, on delete, Ignore error if entry was already removed from
   // HW. One scenario where this can occur is the following
   // - We learn a MAC and install it in HW
@@ -73,6 +80,7 @@ void ManagedFdbEntry::createObject(PublisherObjects objects) {
 void ManagedFdbEntry::removeObject(size_t, PublisherObjects) {
   XLOG(DBG2) << "ManagedFdbEntry::removeObject: " << toL2Entry().str();
   /* either interface is removed or bridge port is removed, delete fdb entry */
+  manager_->removePendingSaiObject(intfIDAndMac_);
   this->resetObject();
 }
 
@@ -221,6 +229,12 @@ void SaiFdbManager::removeFdbEntry(
     XLOG(WARN) << "Attempted to remove non-existent FDB entry";
     return;
   }
+  if (batching_) {
+    pendingFdbEntries_.erase(key);
+    if (auto fdbEntry = fdbEntryItr->second->getFdbEntry()) {
+      pendingRemovals_.push_back(std::move(fdbEntry));
+    }
+  }
   auto portId = fdbEntryItr->second->getPortId();
   portToKeys_[portId].erase(key);
   if (portToKeys_[portId].empty()) {
@@ -426,6 +440,11 @@ std::shared_ptr<SaiFdbEntry> SaiFdbManager::createSaiObject(
     const typename SaiFdbTraits::AdapterHostKey& key,
     const typename SaiFdbTraits::CreateAttributes& attributes,
     const PublisherKey<SaiFdbTraits>::custom_type& publisherKey) {
+  if (batching_) {
+    pendingFdbEntries_.insert_or_assign(
+        publisherKey, PendingFdbEntry{key, attributes});
+    return nullptr;
+  }
   auto& store = saiStore_->get<SaiFdbTraits>();
   // For platform does not support pending l2 entry (no real hw learning),
   // agent should check the existence of fdb entry in sai adapter, and create
@@ -457,6 +476,81 @@ std::shared_ptr<SaiFdbEntry> SaiFdbManager::createSaiObject(
   return store.setObject(key, attributes, publisherKey);
 }
 
+void SaiFdbManager::removePendingSaiObject(
+    const PublisherKey<SaiFdbTraits>::custom_type& publisherKey) {
+  pendingFdbEntries_.erase(publisherKey);
+}
+
+void SaiFdbManager::startBatch() {
+  CHECK(pendingFdbEntries_.empty() && pendingRemovals_.empty());
+  batching_ = FLAGS_enable_bulk_fdb_programming &&
+      platform_->getAsic()->isSupported(HwAsic::Feature::PENDING_L2_ENTRY);
+}
+
+void SaiFdbManager::commitBatch() {
+  if (!batching_) {
+    return;
+  }
+  batching_ = false;
+  auto pendingFdbEntries = std::move(pendingFdbEntries_);
+  auto pendingRemovals = std::move(pendingRemovals_);
+  pendingFdbEntries_.clear();
+  pendingRemovals_.clear();
+  auto& store = saiStore_->get<SaiFdbTraits>();
+
+  // remove entries first, as an entry may be removed and added again
+  store.bulkRemoveObjects(pendingRemovals);
+  pendingRemovals.clear();
+
+  if (pendingFdbEntries.empty()) {
+    return;
+  }
+  std::vector<SaiFdbTraits::AdapterHostKey> entries;
+  std::vector<SaiFdbTraits::CreateAttributes> attributes;
+  std::vector<PublisherKey<SaiFdbTraits>::custom_type> publisherKeys;
+  entries.reserve(pendingFdbEntries.size());
+  attributes.reserve(pendingFdbEntries.size());
+  publisherKeys.reserve(pendingFdbEntries.size());
+  for (const auto& [publisherKey, pendingFdbEntry] : pendingFdbEntries) {
+    entries.push_back(pendingFdbEntry.entry);
+    attributes.push_back(pendingFdbEntry.attributes);
+    publisherKeys.push_back(publisherKey);
+  }
+  std::vector<sai_status_t> statuses;
+  auto fdbEntries =
+      store.bulkSetObjects(entries, attributes, publisherKeys, statuses);
+
+  std::optional<size_t> firstFailed;
+  size_t numFailed = 0;
+  for (auto idx = 0; idx < entries.size(); idx++) {
+    if (!fdbEntries[idx]) {
+      if (!firstFailed) {
+        firstFailed = idx;
+      }
+      numFailed++;
+      // failed to add, as an unbatched addFdbEntry() would
+      removeFdbEntry(
+          std::get<InterfaceID>(publisherKeys[idx]),
+          std::get<folly::MacAddress>(publisherKeys[idx]));
+      continue;
+    }
+    auto itr = managedFdbEntries_.find(publisherKeys[idx]);
+    CHECK(itr != managedFdbEntries_.end());
+    itr->second->setFdbEntry(fdbEntries[idx]);
+  }
+  if (firstFailed) {
+    throw FbossError(
+        "Failed to program ",
+        numFailed,
+        " of ",
+        entries.size(),
+        " fdb entries, first failed entry ",
+        entries[*firstFailed].toString(),
+        ": ",
+        saiStatusToString(statuses[*firstFailed]));
+  }
+}
+
 void SaiFdbManager::removeUnclaimedDynanicEntries() {
   auto l2LearningMode = managerTable_->bridgeManager().getL2LearningMode();
   if (l2LearningMode == cfg::L2LearningMode::SOFTWARE) {
@@ -71,6 +71,10 @@ class ManagedFdbEntry : public SaiObjectEventAggregateSubscriber<
 
   void createObject(PublisherObjects);
   void removeObject(size_t, PublisherObjects);
+  void setFdbEntry(std::shared_ptr<SaiFdbEntry> fdbEntry);
+  std::shared_ptr<SaiFdbEntry> getFdbEntry() const {
+    return getObject();
+  }
   SaiFdbTraits::FdbEntry makeFdbEntry(
       const SaiManagerTable* managerTable) const;
   void handleLinkDown();
@@ -127,10 +131,28 @@ class SaiFdbManager {
       const std::shared_ptr<MacEntry>& newEntry);
   std::vector<L2EntryThrift> getL2Entries(bool sdk = false) const;
   void handleLinkDown(SaiPortDescriptor portId);
+  // Returns nullptr during a batch, the entry is then programmed by
+  // commitBatch() and set on its ManagedFdbEntry
   std::shared_ptr<SaiFdbEntry> createSaiObject(
       const typename SaiFdbTraits::AdapterHostKey& key,
       const typename SaiFdbTraits::CreateAttributes& attributes,
       const PublisherKey<SaiFdbTraits>::custom_type& publisherKey);
+  void removePendingSaiObject(
+      const PublisherKey<SaiFdbTraits>::custom_type& publisherKey);
+
+  /*
+   * FDB entries created and removed between startBatch() and commitBatch()
+   * are programmed by commitBatch() with bulk SAI calls. Without
+   * enable_bulk_fdb_programming, or on ASICs without pending L2 entries
+   * (which check each entry in the adapter before creating it), entries are
+   * programmed as they are processed and commitBatch() does nothing.
+   *
+   * commitBatch() keeps the entries programmed successfully, and throws for
+   * the others once they are logged. Entries failing to be created are
+   * removed, as they are when failing to be added without batching.
+   */
+  void startBatch();
+  void commitBatch();
 
   void removeUnclaimedDynanicEntries();
 
@@ -154,6 +176,17 @@ class SaiFdbManager {
       SaiPortDescriptor,
       folly::F14FastSet<PublisherKey<SaiFdbTraits>::custom_type>>
       portToKeys_;
+
+  // entry creation queued by createSaiObject() during a batch
+  struct PendingFdbEntry {
+    SaiFdbTraits::AdapterHostKey entry;
+    SaiFdbTraits::CreateAttributes attributes;
+  };
+  bool batching_{false};
+  folly::F14FastMap<PublisherKey<SaiFdbTraits>::custom_type, PendingFdbEntry>
+      pendingFdbEntries_;
+  // entries removed during a batch, bulk removed by commitBatch()
+  std::vector<std::shared_ptr<SaiFdbEntry>> pendingRemovals_;
 };
 
 } // namespace facebook::fboss
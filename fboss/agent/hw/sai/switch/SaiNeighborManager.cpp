@@ -9,6 +9,7 @@
  */
 
 #include "fboss/agent/hw/sai/switch/SaiNeighborManager.h"
+#include "fboss/agent/AgentFeatures.h"
 #include "fboss/agent/hw/sai/api/NeighborApi.h"
 #include "fboss/agent/hw/sai/store/SaiStore.h"
 #include "fboss/agent/hw/sai/switch/SaiBridgeManager.h"
@@ -154,25 +155,111 @@ void SaiNeighborManager::removeNeighbor(
   }
   XLOG(DBG2) << "removeNeighbor " << swEntry->getIP();
   auto subscriberKey = saiEntryFromSwEntry(swEntry);
-  if (!neighbors_.contains(subscriberKey)) {
+  auto itr = neighbors_.find(subscriberKey);
+  if (itr == neighbors_.end()) {
     throw FbossError(
         "Attempted to remove non-existent neighbor: ", swEntry->getIP());
   }
-  neighbors_.erase(subscriberKey);
+  if (batching_) {
+    pendingNeighbors_.erase(subscriberKey);
+    if (auto neighbor = itr->second->getNeighbor()) {
+      pendingRemovals_.push_back(std::move(neighbor));
+    }
+  }
+  neighbors_.erase(itr);
   XLOG(DBG2) << "Remove Neighbor: " << swEntry->str();
 }
 
 void SaiNeighborManager::clear() {
+  batching_ = false;
+  pendingNeighbors_.clear();
+  pendingRemovals_.clear();
   neighbors_.clear();
 }
 
 std::shared_ptr<SaiNeighbor> SaiNeighborManager::createSaiObject(
     const SaiNeighborTraits::AdapterHostKey& key,
     const SaiNeighborTraits::CreateAttributes& attributes) {
+  if (batching_) {
+    pendingNeighbors_.insert_or_assign(key, attributes);
+    return nullptr;
+  }
   auto& store = saiStore_->get<SaiNeighborTraits>();
   return store.setObject(key, attributes);
 }
 
+void SaiNeighborManager::removePendingSaiObject(
+    const SaiNeighborTraits::AdapterHostKey& key) {
+  pendingNeighbors_.erase(key);
+}
+
+void SaiNeighborManager::startBatch() {
+  CHECK(pendingNeighbors_.empty() && pendingRemovals_.empty());
+  batching_ = FLAGS_enable_bulk_neighbor_programming;
+}
+
+void SaiNeighborManager::commitBatch() {
+  if (!batching_) {
+    return;
+  }
+  batching_ = false;
+  auto pendingNeighbors = std::move(pendingNeighbors_);
+  auto pendingRemovals = std::move(pendingRemovals_);
+  pendingNeighbors_.clear();
+  pendingRemovals_.clear();
+  auto& store = saiStore_->get<SaiNeighborTraits>();
+
+  // remove neighbors first, as a neighbor may be removed and added again.
+  // Their next hops are removed before them.
+  store.bulkRemoveObjects(pendingRemovals);
+  pendingRemovals.clear();
+
+  if (pendingNeighbors.empty()) {
+    return;
+  }
+  std::vector<SaiNeighborTraits::AdapterHostKey> entries;
+  std::vector<SaiNeighborTraits::CreateAttributes> attributes;
+  entries.reserve(pendingNeighbors.size());
+  attributes.reserve(pendingNeighbors.size());
+  for (const auto& [entry, pendingAttributes] : pendingNeighbors) {
+    entries.push_back(entry);
+    attributes.push_back(pendingAttributes);
+  }
+  std::vector<sai_status_t> statuses;
+  // next hops subscribed to the neighbors are created as they are notified
+  auto neighbors = store.bulkSetObjects(entries, attributes, statuses);
+
+  std::optional<size_t> firstFailed;
+  size_t numFailed = 0;
+  for (auto idx = 0; idx < entries.size(); idx++) {
+    auto itr = neighbors_.find(entries[idx]);
+    CHECK(itr != neighbors_.end());
+    if (!neighbors[idx]) {
+      if (!firstFailed) {
+        firstFailed = idx;
+      }
+      numFailed++;
+      if (itr->second->getRifType() != cfg::InterfaceType::VLAN) {
+        // failed to add, as an unbatched addNeighbor() would
+        neighbors_.erase(itr);
+      }
+      continue;
+    }
+    itr->second->setNeighbor(neighbors[idx]);
+  }
+  if (firstFailed) {
+    throw FbossError(
+        "Failed to program ",
+        numFailed,
+        " of ",
+        entries.size(),
+        " neighbors, first failed neighbor ",
+        entries[*firstFailed].toString(),
+        ": ",
+        saiStatusToString(statuses[*firstFailed]));
+  }
+}
+
 const SaiNeighborHandle* SaiNeighborManager::getNeighborHandle(
     const SaiNeighborTraits::NeighborEntry& saiEntry) const {
   return getNeighborHandleImpl(saiEntry);
@@ -288,8 +375,7 @@ PortRifNeighbor::PortRifNeighbor(
       encapIndex,
       isLocal,
       noHostRoute};
-  neighbor_ = manager_->createSaiObject(adapterHostKey, createAttributes);
-  handle_->neighbor = neighbor_.get();
+  setNeighbor(manager_->createSaiObject(adapterHostKey, createAttributes));
 }
 
 ManagedVlanRifNeighbor::ManagedVlanRifNeighbor(
@@ -329,10 +415,17 @@ void ManagedVlanRifNeighbor::createObject(PublisherObjects objects) {
       std::nullopt,
       std::nullopt,
       noHostRoute_};
+  handle_->fdbEntry = fdbEntry.get();
   auto object = manager_->createSaiObject(adapterHostKey, createAttributes);
-  this->setObject(object);
+  if (object) {
+    setNeighbor(object);
+  }
+}
+
+void ManagedVlanRifNeighbor::setNeighbor(
+    std::shared_ptr<SaiNeighbor> neighbor) {
+  this->setObject(neighbor);
   handle_->neighbor = getSaiObject();
-  handle_->fdbEntry = fdbEntry.get();
 
   XLOG(DBG2) << "ManagedNeigbhor::createObject: " << toString();
 }
@@ -340,6 +433,9 @@ void ManagedVlanRifNeighbor::createObject(PublisherObjects objects) {
 void ManagedVlanRifNeighbor::removeObject(size_t, PublisherObjects) {
   XLOG(DBG2) << "ManagedNeigbhor::removeObject: " << toString();
 
+  const auto& ip = std::get<folly::IPAddress>(intfIDAndIpAndMac_);
+  manager_->removePendingSaiObject(SaiNeighborTraits::NeighborEntry(
+      manager_->getSwitchSaiId(), getRouterInterfaceSaiId(), ip));
   this->resetObject();
   handle_->neighbor = nullptr;
   handle_->fdbEntry = nullptr;
@@ -396,6 +492,9 @@ void ManagedVlanRifNeighbor::handleLinkDown() {
 }
 
 void PortRifNeighbor::handleLinkDown() {
+  if (!neighbor_) {
+    return;
+  }
   XLOGF(
       DBG2,
       "neighbor {} notifying link down to subscribed next hops",
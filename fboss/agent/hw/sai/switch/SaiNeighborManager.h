@@ -23,6 +23,7 @@
 #include <fmt/format.h>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 namespace facebook::fboss {
 
@@ -64,6 +65,11 @@ class ManagedVlanRifNeighbor : public SaiObjectEventAggregateSubscriber<
   void removeObject(size_t index, PublisherObjects objects);
   void handleLinkDown();
 
+  void setNeighbor(std::shared_ptr<SaiNeighbor> neighbor);
+  std::shared_ptr<SaiNeighbor> getNeighbor() const {
+    return getObject();
+  }
+
   SaiNeighborHandle* getHandle() const {
     return handle_.get();
   }
@@ -105,6 +111,14 @@ class PortRifNeighbor {
 
   void handleLinkDown();
 
+  void setNeighbor(std::shared_ptr<SaiNeighbor> neighbor) {
+    neighbor_ = std::move(neighbor);
+    handle_->neighbor = neighbor_.get();
+  }
+  std::shared_ptr<SaiNeighbor> getNeighbor() const {
+    return neighbor_;
+  }
+
   SaiNeighborHandle* getHandle() const {
     return handle_.get();
   }
@@ -113,6 +127,9 @@ class PortRifNeighbor {
   }
 
   std::string toString() const {
+    if (!neighbor_) {
+      return "inactive port rif neighbor";
+    }
     return fmt::format("{}", neighbor_->attributes());
   }
   SaiPortDescriptor getSaiPortDesc() const {
@@ -151,6 +168,16 @@ class SaiNeighborEntry {
     std::visit([](auto& handle) { handle->handleLinkDown(); }, neighbor_);
   }
 
+  void setNeighbor(std::shared_ptr<SaiNeighbor> neighbor) {
+    std::visit(
+        [&neighbor](auto& handle) { handle->setNeighbor(std::move(neighbor)); },
+        neighbor_);
+  }
+  std::shared_ptr<SaiNeighbor> getNeighbor() const {
+    return std::visit(
+        [](auto& handle) { return handle->getNeighbor(); }, neighbor_);
+  }
+
   cfg::InterfaceType getRifType() const;
   SaiNeighborHandle* getHandle() const {
     return std::visit(
@@ -210,9 +237,26 @@ class SaiNeighborManager {
 
   void clear();
 
+  // Returns nullptr during a batch, the neighbor is then programmed by
+  // commitBatch() and set on its SaiNeighborEntry
   std::shared_ptr<SaiNeighbor> createSaiObject(
       const SaiNeighborTraits::AdapterHostKey& key,
       const SaiNeighborTraits::CreateAttributes& attributes);
+  void removePendingSaiObject(const SaiNeighborTraits::AdapterHostKey& key);
+
+  /*
+   * Neighbors created and removed between startBatch() and commitBatch()
+   * are programmed by commitBatch() with bulk SAI calls. Without
+   * enable_bulk_neighbor_programming, neighbors are programmed as they are
+   * processed, and commitBatch() does nothing.
+   *
+   * commitBatch() keeps the neighbors programmed successfully, and throws
+   * for the others once they are logged. Port RIF neighbors failing to be
+   * created are removed, as they are when failing to be added without
+   * batching, while VLAN RIF neighbors stay unresolved.
+   */
+  void startBatch();
+  void commitBatch();
 
   std::string listManagedObjects() const;
   SwitchSaiId getSwitchSaiId() const;
@@ -230,6 +274,14 @@ class SaiNeighborManager {
       SaiNeighborTraits::NeighborEntry,
       std::unique_ptr<SaiNeighborEntry>>
       neighbors_;
+  bool batching_{false};
+  // neighbor creation queued by createSaiObject() during a batch
+  folly::F14FastMap<
+      SaiNeighborTraits::NeighborEntry,
+      SaiNeighborTraits::CreateAttributes>
+      pendingNeighbors_;
+  // neighbors removed during a batch, bulk removed by commitBatch()
+  std::vector<std::shared_ptr<SaiNeighbor>> pendingRemovals_;
 };
 
 } // namespace facebook::fboss
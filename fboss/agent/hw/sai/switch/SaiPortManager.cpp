@@ -1449,6 +1449,7 @@ void SaiPortManager::setPortType(PortID port, cfg::PortType type) {
   port2PortType_[port] = type;
   // If Port type changed, supported stats need to be updated
   port2SupportedStats_.clear();
+  prefetchedStatsPorts_.erase(port);
   XLOG(DBG2) << " Port : " << port << " type set to : "
              << apache::thrift::TEnumTraits<cfg::PortType>::findName(type);
 }
@@ -1844,6 +1845,7 @@ void SaiPortManager::removePort(const std::shared_ptr<Port>& swPort) {
   handles_.erase(itr);
   portStats_.erase(swId);
   port2SupportedStats_.erase(swId);
+  prefetchedStatsPorts_.erase(swId);
   port2PortType_.erase(swId);
   port2ClmEnabled_.erase(swId);
   auto portAsicPrbsStatsItr = portAsicPrbsStats_.find(swId);
@@ -2760,8 +2762,10 @@ void SaiPortManager::updateStats(
     }
   };
   curPortStats.timestamp_() = now.count();
-  collectStats(
-      supportedStats(portId), SAI_STATS_MODE_READ, "basic port counters");
+  if (!prefetchedStatsPorts_.erase(portId)) {
+    collectStats(
+        supportedStats(portId), SAI_STATS_MODE_READ, "basic port counters");
+  }
 #if defined(BRCM_SAI_SDK_DNX_GTE_12_0)
   if (updateWatermarks &&
       platform_->getAsic()->isSupported(HwAsic::Feature::FAST_LLFC_COUNTER)) {
@@ -3102,6 +3106,33 @@ void SaiPortManager::updateStats(
   }
 }
 
+void SaiPortManager::prefetchStats(const std::vector<PortID>& portIds) {
+  prefetchedStatsPorts_.clear();
+  if (!FLAGS_enable_bulk_stats_collection) {
+    return;
+  }
+  SaiObjectStatsReader<SaiPortTraits> statsReader(
+      managerTable_->switchManager().getSwitchSaiId(), true /* bulk */);
+  for (auto portId : portIds) {
+    auto handlesItr = handles_.find(portId);
+    if (handlesItr == handles_.end() || !portStats_.contains(portId)) {
+      continue;
+    }
+    statsReader.add(
+        handlesItr->second->port.get(),
+        supportedStats(portId),
+        SAI_STATS_MODE_READ);
+    prefetchedStatsPorts_.insert(portId);
+  }
+  try {
+    statsReader.read();
+  } catch (const SaiApiError& e) {
+    // updateStats() reads and reports the counters of each port again
+    XLOG(ERR) << "Failed to bulk read basic port counters: " << e.what();
+    prefetchedStatsPorts_.clear();
+  }
+}
+
 const std::vector<sai_stat_id_t>& SaiPortManager::supportedStats(PortID port) {
   auto itr = port2SupportedStats_.find(port);
   if (itr != port2SupportedStats_.end()) {
@@ -245,6 +245,12 @@ class SaiPortManager {
       PortID portID,
       bool updateWatermarks = false,
       bool updateCableLengths = false);
+  /*
+   * With --enable_bulk_stats_collection, reads the basic counters of ports
+   * with bulk SAI calls, ahead of their updateStats() in the same stats
+   * cycle. updateStats() then skips reading them again.
+   */
+  void prefetchStats(const std::vector<PortID>& portIds);
 
   // Link up/down debounce retrigger counts are leaba READ_ONLY port attributes
   // (25.5.4210 / 26.2+). Compile-time SDK gate; the per-port read in
@@ -588,6 +594,8 @@ class SaiPortManager {
   std::unordered_map<PortID, cfg::PortType> port2PortType_;
   std::unordered_map<PortID, bool> port2ClmEnabled_;
   std::unordered_map<PortID, std::vector<sai_stat_id_t>> port2SupportedStats_;
+  // ports whose basic counters were read by prefetchStats()
+  folly::F14FastSet<PortID> prefetchedStatsPorts_;
   std::unordered_map<PortID, std::shared_ptr<Port>> pendingNewPorts_;
   bool hwLaneListIsPmdLaneList_;
   bool tcToQueueMapAllowedOnPort_;
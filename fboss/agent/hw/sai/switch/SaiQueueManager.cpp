@@ -12,6 +12,7 @@
 #include <fboss/agent/hw/sai/api/QueueApi.h>
 #include "fboss/agent/platforms/sai/SaiPlatform.h"
 
+#include "fboss/agent/AgentFeatures.h"
 #include "fboss/agent/PfcUtils.h"
 #include "fboss/agent/hw/sai/store/SaiStore.h"
 #include "fboss/agent/hw/sai/switch/SaiManagerTable.h"
@@ -595,6 +596,7 @@ void SaiQueueManager::updateStats(
   static std::vector<sai_stat_id_t> nonWatermarkStatsReadAndClear(
       SaiQueueTraits::NonWatermarkCounterIdsToReadAndClear.begin(),
       SaiQueueTraits::NonWatermarkCounterIdsToReadAndClear.end());
+  auto statsReader = makeStatsReader();
   for (auto queueHandle : queueHandles) {
     /*
      * The WRED_DROPPED_PACKETS counter is needed only for non-CPU
@@ -605,16 +607,23 @@ void SaiQueueManager::updateStats(
     auto queueType = SaiApiTable::getInstance()->queueApi().getAttribute(
         queueHandle->queue->adapterKey(), SaiQueueTraits::Attributes::Type{});
 
-    queueHandle->queue->updateStats(
+    statsReader.add(
+        queueHandle->queue.get(),
         supportedNonWatermarkCounterIdsRead(queueType, queueHandle),
         SAI_STATS_MODE_READ);
-    queueHandle->queue->updateStats(
-        nonWatermarkStatsReadAndClear, SAI_STATS_MODE_READ_AND_CLEAR);
+    statsReader.add(
+        queueHandle->queue.get(),
+        nonWatermarkStatsReadAndClear,
+        SAI_STATS_MODE_READ_AND_CLEAR);
     if (updateWatermarks) {
-      queueHandle->queue->updateStats(
+      statsReader.add(
+          queueHandle->queue.get(),
           supportedWatermarkCounterIdsReadAndClear(queueType),
           SAI_STATS_MODE_READ_AND_CLEAR);
     }
+  }
+  statsReader.read();
+  for (auto queueHandle : queueHandles) {
     const auto& counters = queueHandle->queue->getStats();
     auto queueId = SaiApiTable::getInstance()->queueApi().getAttribute(
         queueHandle->queue->adapterKey(), SaiQueueTraits::Attributes::Index{});
@@ -622,6 +631,13 @@ void SaiQueueManager::updateStats(
   }
 }
 
+SaiObjectStatsReader<SaiQueueTraits> SaiQueueManager::makeStatsReader()
+    const {
+  return SaiObjectStatsReader<SaiQueueTraits>(
+      managerTable_->switchManager().getSwitchSaiId(),
+      FLAGS_enable_bulk_stats_collection);
+}
+
 void SaiQueueManager::clearStats(
     const std::vector<SaiQueueHandle*>& queueHandles) {
   for (auto& queueHandle : queueHandles) {
@@ -656,20 +672,28 @@ void SaiQueueManager::updateStats(
   static std::vector<sai_stat_id_t> nonWatermarkStatsReadAndClear(
       SaiQueueTraits::VoqNonWatermarkCounterIdsToReadAndClear.begin(),
       SaiQueueTraits::VoqNonWatermarkCounterIdsToReadAndClear.end());
+  auto statsReader = makeStatsReader();
   for (auto queueHandle : queueHandles) {
     auto queueType = GET_ATTR(Queue, Type, queueHandle->queue->attributes());
     if (updateVoqStats) {
-      queueHandle->queue->updateStats(
+      statsReader.add(
+          queueHandle->queue.get(),
           supportedNonWatermarkCounterIdsRead(queueType, queueHandle),
           SAI_STATS_MODE_READ);
-      queueHandle->queue->updateStats(
-          nonWatermarkStatsReadAndClear, SAI_STATS_MODE_READ_AND_CLEAR);
+      statsReader.add(
+          queueHandle->queue.get(),
+          nonWatermarkStatsReadAndClear,
+          SAI_STATS_MODE_READ_AND_CLEAR);
     }
     if (updateWatermarks) {
-      queueHandle->queue->updateStats(
+      statsReader.add(
+          queueHandle->queue.get(),
           supportedVoqWatermarkCounterIdsReadAndClear(),
           SAI_STATS_MODE_READ_AND_CLEAR);
     }
+  }
+  statsReader.read();
+  for (auto queueHandle : queueHandles) {
     const auto& counters = queueHandle->queue->getStats();
     auto queueId = SaiApiTable::getInstance()->queueApi().getAttribute(
         queueHandle->queue->adapterKey(), SaiQueueTraits::Attributes::Index{});
@@ -114,6 +114,8 @@ class SaiQueueManager {
       const QueueSaiId& queueSaiId);
 
  private:
+  // reads queue stats in bulk with --enable_bulk_stats_collection
+  SaiObjectStatsReader<SaiQueueTraits> makeStatsReader() const;
   bool isVoqSwitchAndQueueHandleNotForVoq(SaiQueueHandle* queueHandle);
   const std::vector<sai_stat_id_t>& supportedNonWatermarkCounterIdsRead(
       int queueType,
@@ -552,6 +552,15 @@ void SaiRouteManager::addOrUpdateRoute(
 
     XLOG(DBG3) << "Route action DROP: " << newRoute->str();
   }
+  if (batching_) {
+    pendingRoutes_.push_back(PendingRoute{
+        entry,
+        attributes.value(),
+        nextHopHandle,
+        counterHandle,
+        !newRoute->isConnected()});
+    return;
+  }
   auto& store = saiStore_->get<SaiRouteTraits>();
   auto route = store.setObject(entry, attributes.value());
   routeHandle->route = route;
@@ -625,11 +634,15 @@ void SaiRouteManager::removeRoute(
   }
   XLOG(DBG3) << "Remove route: " << swRoute->str();
   SaiRouteTraits::RouteEntry entry = routeEntryFromSwRoute(routerId, swRoute);
-  size_t count = handles_.erase(entry);
-  if (!count) {
+  auto itr = handles_.find(entry);
+  if (itr == handles_.end()) {
     throw FbossError(
         "Failed to remove non-existent route to ", swRoute->prefix().str());
   }
+  if (batching_) {
+    pendingRemovals_.push_back(std::move(itr->second));
+  }
+  handles_.erase(itr);
   swRoutes_.erase(entry);
 }
 
@@ -666,10 +679,97 @@ SaiRouteHandle* SaiRouteManager::getRouteHandleImpl(
 }
 
 void SaiRouteManager::clear() {
+  batching_ = false;
+  pendingRoutes_.clear();
+  pendingRemovals_.clear();
   handles_.clear();
   swRoutes_.clear();
 }
 
+void SaiRouteManager::startBatch() {
+  CHECK(pendingRoutes_.empty() && pendingRemovals_.empty());
+  batching_ = FLAGS_enable_bulk_route_programming;
+}
+
+void SaiRouteManager::commitBatch() {
+  if (!batching_) {
+    return;
+  }
+  batching_ = false;
+  auto pendingRoutes = std::move(pendingRoutes_);
+  auto pendingRemovals = std::move(pendingRemovals_);
+  pendingRoutes_.clear();
+  pendingRemovals_.clear();
+  auto& store = saiStore_->get<SaiRouteTraits>();
+
+  // Remove routes before releasing their handles, which may release the
+  // next hop groups they pointed to
+  std::vector<std::shared_ptr<SaiRoute>> removedRoutes;
+  removedRoutes.reserve(pendingRemovals.size());
+  for (const auto& routeHandle : pendingRemovals) {
+    if (routeHandle->route) {
+      removedRoutes.push_back(routeHandle->route);
+    }
+  }
+  store.bulkRemoveObjects(removedRoutes);
+  removedRoutes.clear();
+  pendingRemovals.clear();
+
+  if (pendingRoutes.empty()) {
+    return;
+  }
+  std::vector<SaiRouteTraits::RouteEntry> entries;
+  std::vector<SaiRouteTraits::CreateAttributes> attributes;
+  entries.reserve(pendingRoutes.size());
+  attributes.reserve(pendingRoutes.size());
+  for (const auto& pendingRoute : pendingRoutes) {
+    entries.push_back(pendingRoute.entry);
+    attributes.push_back(pendingRoute.attributes);
+  }
+  std::vector<sai_status_t> statuses;
+  auto routes = store.bulkSetObjects(entries, attributes, statuses);
+
+  std::optional<size_t> firstFailed;
+  size_t numFailed = 0;
+  for (auto idx = 0; idx < pendingRoutes.size(); idx++) {
+    auto& pendingRoute = pendingRoutes[idx];
+    auto itr = handles_.find(pendingRoute.entry);
+    if (!routes[idx]) {
+      if (!firstFailed) {
+        firstFailed = idx;
+      }
+      numFailed++;
+      if (itr != handles_.end() && !itr->second->route) {
+        // failed to add, as an unbatched addRoute() would
+        handles_.erase(itr);
+        swRoutes_.erase(pendingRoute.entry);
+      }
+      continue;
+    }
+    if (itr == handles_.end()) {
+      continue;
+    }
+    auto* routeHandle = itr->second.get();
+    routeHandle->route = routes[idx];
+    routeHandle->nexthopHandle_ = std::move(pendingRoute.nextHopHandle);
+    routeHandle->counterHandle_ = std::move(pendingRoute.counterHandle);
+    if (pendingRoute.checkMetadata) {
+      checkMetadata(pendingRoute.entry);
+    }
+  }
+  if (firstFailed) {
+    throw FbossError(
+        "Failed to program ",
+        numFailed,
+        " of ",
+        pendingRoutes.size(),
+        " routes, first failed route ",
+        pendingRoutes[*firstFailed].entry.toString(),
+        ": ",
+        saiStatusToString(statuses[*firstFailed]));
+  }
+}
+
 std::shared_ptr<SaiObject<SaiRouteTraits>> SaiRouteManager::getRouteObject(
     SaiRouteTraits::AdapterHostKey routeKey) {
   return saiStore_->get<SaiRouteTraits>().get(routeKey);
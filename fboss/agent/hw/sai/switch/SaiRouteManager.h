@@ -22,6 +22,7 @@
 
 #include <memory>
 #include <mutex>
+#include <vector>
 
 DECLARE_bool(disable_valid_route_check);
 DECLARE_bool(classid_for_unresolved_routes);
@@ -151,6 +152,19 @@ class SaiRouteManager {
 
   void clear();
 
+  /*
+   * Route adds, changes and removals made between startBatch() and
+   * commitBatch() are queued, and programmed by commitBatch() with bulk SAI
+   * calls. Without enable_bulk_route_programming, routes are programmed as
+   * they are processed, and commitBatch() does nothing.
+   *
+   * commitBatch() keeps the routes programmed successfully, and throws for
+   * the others once they are logged. Routes failing to be added are not
+   * added, and routes failing to be changed keep their old next hops.
+   */
+  void startBatch();
+  void commitBatch();
+
   std::shared_ptr<SaiObject<SaiRouteTraits>> getRouteObject(
       SaiRouteTraits::AdapterHostKey routeKey);
 
@@ -191,12 +205,26 @@ class SaiRouteManager {
       const std::shared_ptr<Route<AddrT>>& oldRoute,
       std::optional<SaiRouteTraits::Attributes::CounterID>& counterID);
 
+  // route programming queued by addOrUpdateRoute() during a batch
+  struct PendingRoute {
+    SaiRouteTraits::RouteEntry entry;
+    SaiRouteTraits::CreateAttributes attributes;
+    SaiRouteHandle::NextHopHandle nextHopHandle;
+    std::shared_ptr<SaiCounterHandle> counterHandle;
+    bool checkMetadata;
+  };
+
   SaiStore* saiStore_;
   SaiManagerTable* managerTable_;
   const SaiPlatform* platform_;
   folly::F14FastMap<SaiRouteTraits::RouteEntry, std::unique_ptr<SaiRouteHandle>>
       handles_;
   SwitchStateRoutesMap swRoutes_;
+  bool batching_{false};
+  std::vector<PendingRoute> pendingRoutes_;
+  // handles of the routes removed during a batch, released once their routes
+  // are bulk removed
+  std::vector<std::unique_ptr<SaiRouteHandle>> pendingRemovals_;
 };
 
 } // namespace facebook::fboss
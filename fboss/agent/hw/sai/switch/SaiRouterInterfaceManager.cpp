@@ -11,6 +11,7 @@
 #include "fboss/agent/hw/sai/switch/SaiRouterInterfaceManager.h"
 
 #include <folly/logging/xlog.h>
+#include "fboss/agent/AgentFeatures.h"
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/hw/sai/store/SaiStore.h"
 #include "fboss/agent/hw/sai/switch/SaiManagerTable.h"
@@ -25,6 +26,22 @@
 namespace facebook::fboss {
 
 namespace {
+// Reads the counters SaiObjectWithCounters::updateStats() reads
+template <typename SaiObjectTraits>
+void addStatsReads(
+    SaiObjectStatsReader<SaiObjectTraits>& statsReader,
+    SaiObjectWithCounters<SaiObjectTraits>* rif) {
+  static const std::vector<sai_stat_id_t> kCounterIdsToRead(
+      SaiObjectTraits::CounterIdsToRead.begin(),
+      SaiObjectTraits::CounterIdsToRead.end());
+  static const std::vector<sai_stat_id_t> kCounterIdsToReadAndClear(
+      SaiObjectTraits::CounterIdsToReadAndClear.begin(),
+      SaiObjectTraits::CounterIdsToReadAndClear.end());
+  statsReader.add(rif, kCounterIdsToRead, SAI_STATS_MODE_READ);
+  statsReader.add(
+      rif, kCounterIdsToReadAndClear, SAI_STATS_MODE_READ_AND_CLEAR);
+}
+
 HwRouterInterfaceStats fillHwRouterInterfaceStats(
     const folly::F14FastMap<sai_stat_id_t, uint64_t>& stats) {
   HwRouterInterfaceStats rifStats{};
@@ -380,11 +397,29 @@ void SaiRouterInterfaceManager::updateStats() {
   auto now = std::chrono::duration_cast<std::chrono::seconds>(
       std::chrono::system_clock::now().time_since_epoch());
 
+  auto switchId = managerTable_->switchManager().getSwitchSaiId();
+  SaiObjectStatsReader<SaiVlanRouterInterfaceTraits> vlanRifStatsReader(
+      switchId, FLAGS_enable_bulk_stats_collection);
+  SaiObjectStatsReader<SaiPortRouterInterfaceTraits> portRifStatsReader(
+      switchId, FLAGS_enable_bulk_stats_collection);
   for (auto& [intfId, handle] : handles_) {
     std::visit(
-        [interfaceId = intfId, rifHandle = handle.get(), now, this](auto& rif) {
-          rif->updateStats();
+        [&](auto& rif) {
+          using RifT = std::remove_cvref_t<decltype(*rif)>;
+          if constexpr (std::is_same_v<RifT, SaiVlanRouterInterface>) {
+            addStatsReads(vlanRifStatsReader, rif.get());
+          } else {
+            addStatsReads(portRifStatsReader, rif.get());
+          }
+        },
+        handle->routerInterface);
+  }
+  vlanRifStatsReader.read();
+  portRifStatsReader.read();
 
+  for (auto& [intfId, handle] : handles_) {
+    std::visit(
+        [interfaceId = intfId, rifHandle = handle.get(), now, this](auto& rif) {
           if (auto it = rifStats_.find(interfaceId); it != rifStats_.end()) {
             it->second->updateStats(
                 fillHwRouterInterfaceStats(rif->getStats()), now);
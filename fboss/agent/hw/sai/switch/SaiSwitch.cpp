@@ -10,6 +10,7 @@
 
 #include "fboss/agent/hw/sai/switch/SaiSwitch.h"
 
+#include "fboss/agent/AgentFeatures.h"
 #include "fboss/agent/Constants.h"
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/FibHelpers.h"
@@ -19,6 +20,7 @@
 #include "fboss/agent/VoqUtils.h"
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
 #include "fboss/agent/hw/HwPortFb303Stats.h"
+#include "fboss/agent/hw/HwStatsCollectionScheduler.h"
 #include "fboss/agent/hw/HwSysPortFb303Stats.h"
 #include "fboss/agent/hw/gen-cpp2/hardware_stats_constants.h"
 #include "fboss/agent/hw/gen-cpp2/hardware_stats_types.h"
@@ -32,6 +34,7 @@
 #include "fboss/agent/hw/sai/api/Types.h"
 #include "fboss/agent/hw/sai/store/SaiStore.h"
 #include "fboss/agent/hw/sai/switch/ConcurrentIndices.h"
+#include "fboss/agent/hw/sai/switch/DeltaProcessorGraph.h"
 #include "fboss/agent/hw/sai/switch/SaiAclTableGroupManager.h"
 #include "fboss/agent/hw/sai/switch/SaiAclTableManager.h"
 #include "fboss/agent/hw/sai/switch/SaiArsManager.h"
@@ -88,11 +91,14 @@
 #include "fboss/lib/phy/PhyUtils.h"
 #include "fboss/lib/phy/gen-cpp2/phy_types.h"
 
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
 #include <folly/logging/xlog.h>
 
 #include <boost/range/combine.hpp>
 #include <chrono>
+#include <exception>
 #include <optional>
+#include <type_traits>
 
 extern "C" {
 #include <sai.h>
@@ -140,6 +146,13 @@ DEFINE_int32(
     360,
     "Interval for reading serdes stats");
 
+DEFINE_int32(
+    sai_delta_processing_threads,
+    0,
+    "Threads processing the deltas of independent switch state maps "
+    "concurrently during a state update. 0 processes them one after "
+    "another on the update thread.");
+
 namespace {
 /*
  * For the devices/SDK we use, the only events we should get (and process)
@@ -312,6 +325,17 @@ SaiSwitch::SaiSwitch(SaiPlatform* platform, uint32_t featuresDesired)
           std::make_unique<FabricConnectivityManager>()) {
   utilCreateDir(platform_->getDirectoryUtil()->getVolatileStateDir());
   utilCreateDir(platform_->getDirectoryUtil()->getPersistentStateDir());
+  if (FLAGS_sai_delta_processing_threads > 0) {
+    deltaProcessorExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+        FLAGS_sai_delta_processing_threads,
+        std::make_shared<folly::NamedThreadFactory>("SaiDeltaProcessor"));
+  }
+  if (FLAGS_enable_sharded_stats_collection) {
+    statsCollectionScheduler_ = std::make_unique<HwStatsCollectionScheduler>(
+        FLAGS_stats_collection_max_backoff_factor,
+        FLAGS_stats_collection_max_duty_cycle_pct,
+        platform_->getMultiSwitchStatsPrefix());
+  }
 }
 
 SaiSwitch::~SaiSwitch() {}
@@ -427,6 +451,12 @@ void SaiSwitch::unregisterCallbacks() noexcept {
 }
 
 void SaiSwitch::stopThreads() {
+  // Stats collection threads take saiSwitchMutex_, stop them with it
+  // released.
+  if (statsCollectionScheduler_) {
+    statsCollectionScheduler_->stop();
+  }
+
   // linkscan is turned off and the evb loop is set to break
   // just need to block until the last event is processed
   if (linkStateBottomHalfThread_) {
@@ -1007,6 +1037,62 @@ bool SaiSwitch::l2LearningModeChangeProhibited() const {
   return getSwitchRunState() >= l2LearningChangeProhibitedAfter;
 }
 
+template <typename LockPolicyT, typename ProcessFn>
+void SaiSwitch::processRoutesDeltaInBatch(
+    const LockPolicyT& lockPolicy,
+    ProcessFn&& processFn) {
+  auto& routeManager = managerTable_->routeManager();
+  routeManager.startBatch();
+  try {
+    processFn();
+  } catch (const std::exception&) {
+    // program the routes processed before the failure, as they would have
+    // been without batching
+    [[maybe_unused]] const auto& lock = lockPolicy.lock();
+    routeManager.commitBatch();
+    throw;
+  }
+  [[maybe_unused]] const auto& lock = lockPolicy.lock();
+  routeManager.commitBatch();
+}
+
+template <typename LockPolicyT, typename ProcessFn>
+void SaiSwitch::processNeighborsDeltaInBatch(
+    const LockPolicyT& lockPolicy,
+    ProcessFn&& processFn) {
+  auto& neighborManager = managerTable_->neighborManager();
+  auto& fdbManager = managerTable_->fdbManager();
+  neighborManager.startBatch();
+  fdbManager.startBatch();
+  // entries processed before a failure are programmed too, as they would
+  // have been without batching
+  std::exception_ptr error;
+  auto commitBatch = [&error](auto& manager) {
+    try {
+      manager.commitBatch();
+    } catch (const std::exception&) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  };
+  try {
+    processFn();
+  } catch (const std::exception&) {
+    error = std::current_exception();
+  }
+  [[maybe_unused]] const auto& lock = lockPolicy.lock();
+  // neighbors go before the fdb entries of their macs, as without batching.
+  // VLAN RIF neighbors resolved by new fdb entries are batched again.
+  commitBatch(neighborManager);
+  neighborManager.startBatch();
+  commitBatch(fdbManager);
+  commitBatch(neighborManager);
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
 template <typename LockPolicyT, typename AddrT>
 void SaiSwitch::processRemovedRoutesDelta(
     const RouterID& routerID,
@@ -1014,12 +1100,14 @@ void SaiSwitch::processRemovedRoutesDelta(
     const LockPolicyT& lockPolicy) {
   if (!getRollbackInProgress_()) {
     // Normal processing order
-    processRemovedDelta(
-        routesDelta,
-        managerTable_->routeManager(),
-        lockPolicy,
-        &SaiRouteManager::removeRoute<AddrT>,
-        routerID);
+    processRoutesDeltaInBatch(lockPolicy, [&]() {
+      processRemovedDelta(
+          routesDelta,
+          managerTable_->routeManager(),
+          lockPolicy,
+          &SaiRouteManager::removeRoute<AddrT>,
+          routerID);
+    });
   } else {
     processRemovedRoutesDeltaInReverse<LockPolicyT, AddrT>(
         routerID, routesDelta, lockPolicy);
@@ -1034,20 +1122,22 @@ void SaiSwitch::processChangedAndAddedRoutesDelta(
     const std::shared_ptr<SwitchState>& state) {
   if (!getRollbackInProgress_()) {
     // Normal processing order: changed first, then added
-    processChangedDelta(
-        routesDelta,
-        managerTable_->routeManager(),
-        lockPolicy,
-        &SaiRouteManager::changeRoute<AddrT>,
-        routerID,
-        state);
-    processAddedDelta(
-        routesDelta,
-        managerTable_->routeManager(),
-        lockPolicy,
-        &SaiRouteManager::addRoute<AddrT>,
-        routerID,
-        state);
+    processRoutesDeltaInBatch(lockPolicy, [&]() {
+      processChangedDelta(
+          routesDelta,
+          managerTable_->routeManager(),
+          lockPolicy,
+          &SaiRouteManager::changeRoute<AddrT>,
+          routerID,
+          state);
+      processAddedDelta(
+          routesDelta,
+          managerTable_->routeManager(),
+          lockPolicy,
+          &SaiRouteManager::addRoute<AddrT>,
+          routerID,
+          state);
+    });
   } else {
     processAddedRoutesDeltaInReverse<LockPolicyT, AddrT>(
         routerID, routesDelta, lockPolicy, state);
@@ -1164,47 +1254,49 @@ std::shared_ptr<SwitchState> SaiSwitch::stateChangedImplLocked(
     }
   }
 
-  for (const auto& vlanDelta : delta.getVlansDelta()) {
-    processRemovedDelta(
-        vlanDelta.getArpDelta(),
-        managerTable_->neighborManager(),
-        lockPolicy,
-        &SaiNeighborManager::removeNeighbor<ArpEntry>);
-
-    processRemovedDelta(
-        vlanDelta.getNdpDelta(),
-        managerTable_->neighborManager(),
-        lockPolicy,
-        &SaiNeighborManager::removeNeighbor<NdpEntry>);
+  processNeighborsDeltaInBatch(lockPolicy, [&]() {
+    for (const auto& vlanDelta : delta.getVlansDelta()) {
+      processRemovedDelta(
+          vlanDelta.getArpDelta(),
+          managerTable_->neighborManager(),
+          lockPolicy,
+          &SaiNeighborManager::removeNeighbor<ArpEntry>);
 
-    processRemovedDelta(
-        vlanDelta.getMacDelta(),
-        managerTable_->fdbManager(),
-        lockPolicy,
-        &SaiFdbManager::removeMac);
-  }
+      processRemovedDelta(
+          vlanDelta.getNdpDelta(),
+          managerTable_->neighborManager(),
+          lockPolicy,
+          &SaiNeighborManager::removeNeighbor<NdpEntry>);
 
-  // NOTE: Neighbor removals must be processed before changes/adds.
-  // IntfDeltaValidator depends on this ordering to detect transient
-  // multi-MAC states on PORT interfaces. See ValidateInterfaceDelta.cpp.
-  auto processRemovedNeighborDeltaForIntfs =
-      [this, &lockPolicy](const auto& intfsDelta) {
-        for (const auto& intfDelta : intfsDelta) {
-          processRemovedDelta(
-              intfDelta.getArpEntriesDelta(),
-              managerTable_->neighborManager(),
-              lockPolicy,
-              &SaiNeighborManager::removeNeighbor<ArpEntry>);
+      processRemovedDelta(
+          vlanDelta.getMacDelta(),
+          managerTable_->fdbManager(),
+          lockPolicy,
+          &SaiFdbManager::removeMac);
+    }
 
-          processRemovedDelta(
-              intfDelta.getNdpEntriesDelta(),
-              managerTable_->neighborManager(),
-              lockPolicy,
-              &SaiNeighborManager::removeNeighbor<NdpEntry>);
-        }
-      };
-  processRemovedNeighborDeltaForIntfs(delta.getIntfsDelta());
-  processRemovedNeighborDeltaForIntfs(delta.getRemoteIntfsDelta());
+    // NOTE: Neighbor removals must be processed before changes/adds.
+    // IntfDeltaValidator depends on this ordering to detect transient
+    // multi-MAC states on PORT interfaces. See ValidateInterfaceDelta.cpp.
+    auto processRemovedNeighborDeltaForIntfs =
+        [this, &lockPolicy](const auto& intfsDelta) {
+          for (const auto& intfDelta : intfsDelta) {
+            processRemovedDelta(
+                intfDelta.getArpEntriesDelta(),
+                managerTable_->neighborManager(),
+                lockPolicy,
+                &SaiNeighborManager::removeNeighbor<ArpEntry>);
+
+            processRemovedDelta(
+                intfDelta.getNdpEntriesDelta(),
+                managerTable_->neighborManager(),
+                lockPolicy,
+                &SaiNeighborManager::removeNeighbor<NdpEntry>);
+          }
+        };
+    processRemovedNeighborDeltaForIntfs(delta.getIntfsDelta());
+    processRemovedNeighborDeltaForIntfs(delta.getRemoteIntfsDelta());
+  });
 
   // Port RIFs are created based on system port - therefore during removal, both
   // local and remote RIFs should be removed before system port removal.
@@ -1423,8 +1515,10 @@ std::shared_ptr<SwitchState> SaiSwitch::stateChangedImplLocked(
               &SaiNeighborManager::addNeighbor<NdpEntry>);
         }
       };
-  processNeighborChangedAndAddedDeltaForIntfs(delta.getIntfsDelta());
-  processNeighborChangedAndAddedDeltaForIntfs(delta.getRemoteIntfsDelta());
+  processNeighborsDeltaInBatch(lockPolicy, [&]() {
+    processNeighborChangedAndAddedDeltaForIntfs(delta.getIntfsDelta());
+    processNeighborChangedAndAddedDeltaForIntfs(delta.getRemoteIntfsDelta());
+  });
 
   processAddedDelta(
       delta.getPortsDelta(),
@@ -1462,40 +1556,42 @@ std::shared_ptr<SwitchState> SaiSwitch::stateChangedImplLocked(
       lockPolicy,
       &SaiSystemPortManager::changeSystemPortShelPktDstEnable);
 
-  for (const auto& vlanDelta : delta.getVlansDelta()) {
-    processChangedDelta(
-        vlanDelta.getArpDelta(),
-        managerTable_->neighborManager(),
-        lockPolicy,
-        &SaiNeighborManager::changeNeighbor<ArpEntry>);
-    processAddedDelta(
-        vlanDelta.getArpDelta(),
-        managerTable_->neighborManager(),
-        lockPolicy,
-        &SaiNeighborManager::addNeighbor<ArpEntry>);
+  processNeighborsDeltaInBatch(lockPolicy, [&]() {
+    for (const auto& vlanDelta : delta.getVlansDelta()) {
+      processChangedDelta(
+          vlanDelta.getArpDelta(),
+          managerTable_->neighborManager(),
+          lockPolicy,
+          &SaiNeighborManager::changeNeighbor<ArpEntry>);
+      processAddedDelta(
+          vlanDelta.getArpDelta(),
+          managerTable_->neighborManager(),
+          lockPolicy,
+          &SaiNeighborManager::addNeighbor<ArpEntry>);
 
-    processChangedDelta(
-        vlanDelta.getNdpDelta(),
-        managerTable_->neighborManager(),
-        lockPolicy,
-        &SaiNeighborManager::changeNeighbor<NdpEntry>);
-    processAddedDelta(
-        vlanDelta.getNdpDelta(),
-        managerTable_->neighborManager(),
-        lockPolicy,
-        &SaiNeighborManager::addNeighbor<NdpEntry>);
+      processChangedDelta(
+          vlanDelta.getNdpDelta(),
+          managerTable_->neighborManager(),
+          lockPolicy,
+          &SaiNeighborManager::changeNeighbor<NdpEntry>);
+      processAddedDelta(
+          vlanDelta.getNdpDelta(),
+          managerTable_->neighborManager(),
+          lockPolicy,
+          &SaiNeighborManager::addNeighbor<NdpEntry>);
 
-    processChangedDelta(
-        vlanDelta.getMacDelta(),
-        managerTable_->fdbManager(),
-        lockPolicy,
-        &SaiFdbManager::changeMac);
-    processAddedDelta(
-        vlanDelta.getMacDelta(),
-        managerTable_->fdbManager(),
-        lockPolicy,
-        &SaiFdbManager::addMac);
-  }
+      processChangedDelta(
+          vlanDelta.getMacDelta(),
+          managerTable_->fdbManager(),
+          lockPolicy,
+          &SaiFdbManager::changeMac);
+      processAddedDelta(
+          vlanDelta.getMacDelta(),
+          managerTable_->fdbManager(),
+          lockPolicy,
+          &SaiFdbManager::addMac);
+    }
+  });
 
   processDelta(
       delta.getSrv6TunnelsDelta(),
@@ -1521,23 +1617,6 @@ std::shared_ptr<SwitchState> SaiSwitch::stateChangedImplLocked(
           delta.newState());
     }
   }
-  {
-    auto multiSwitchControlPlaneDelta = delta.getControlPlaneDelta();
-    [[maybe_unused]] const auto& lock = lockPolicy.lock();
-    managerTable_->hostifManager().processHostifDelta(
-        multiSwitchControlPlaneDelta);
-  }
-
-  if (platform_->getAsic()->isSupported(HwAsic::Feature::SAI_MPLS_INSEGMENT)) {
-    processDelta(
-        delta.getLabelForwardingInformationBaseDelta(),
-        managerTable_->inSegEntryManager(),
-        lockPolicy,
-        &SaiInSegEntryManager::processChangedInSegEntry,
-        &SaiInSegEntryManager::processAddedInSegEntry,
-        &SaiInSegEntryManager::processRemovedInSegEntry);
-  }
-
 #if SAI_API_VERSION >= SAI_VERSION(1, 12, 0)
   // UDF groups are processed prior to load balancer and ACL tables
   // Both require UDF groups to be created before referencing them
@@ -1553,36 +1632,71 @@ std::shared_ptr<SwitchState> SaiSwitch::stateChangedImplLocked(
       &SaiUdfManager::addUdfGroup);
 #endif
 
+  /*
+   * The processors below only depend on objects programmed above and on the
+   * processors they list, so independent ones may run concurrently. Each
+   * still takes the lock per object it programs.
+   */
+  DeltaProcessorGraph processors;
+  auto hostifProcessor = processors.add("hostif", [&] {
+    auto multiSwitchControlPlaneDelta = delta.getControlPlaneDelta();
+    [[maybe_unused]] const auto& lock = lockPolicy.lock();
+    managerTable_->hostifManager().processHostifDelta(
+        multiSwitchControlPlaneDelta);
+  });
+
+  if (platform_->getAsic()->isSupported(HwAsic::Feature::SAI_MPLS_INSEGMENT)) {
+    processors.add("inSegEntries", [&] {
+      processDelta(
+          delta.getLabelForwardingInformationBaseDelta(),
+          managerTable_->inSegEntryManager(),
+          lockPolicy,
+          &SaiInSegEntryManager::processChangedInSegEntry,
+          &SaiInSegEntryManager::processAddedInSegEntry,
+          &SaiInSegEntryManager::processRemovedInSegEntry);
+    });
+  }
+
+  processors.add("loadBalancers", [&] {
 #if SAI_API_VERSION >= SAI_VERSION(1, 12, 0)
-  if (platform_->getAsic()->isSupported(HwAsic::Feature::SAI_UDF_HASH)) {
-    // There're several constraints for load balancer and Udf objects.
-    // 1. Udf Match needs to be processed before Udf Group (create, remove and
-    // changed).
-    // 2. In the case of removing Udf group: load balancer needs to remove
-    // association with Udf Group.
-    // 3. In the case of creating load balancer: Udf group needs to be created
-    // first.
-    // 4. In the case of changing load balancer: a. new Udf group needs to be
-    // created, b. Load balancer starts to use new Udf group, c. Remove old
-    // Udf group.
-    processAddedDelta(
-        delta.getLoadBalancersDelta(),
-        managerTable_->switchManager(),
-        lockPolicy,
-        &SaiSwitchManager::addOrUpdateLoadBalancer);
-    // TODO(zecheng): Process Udf Match changed
-    // TODO(zecheng): Process Udf Group changed
-    processChangedDelta(
-        delta.getLoadBalancersDelta(),
-        managerTable_->switchManager(),
-        lockPolicy,
-        &SaiSwitchManager::changeLoadBalancer);
-    processRemovedDelta(
-        delta.getLoadBalancersDelta(),
-        managerTable_->switchManager(),
-        lockPolicy,
-        &SaiSwitchManager::removeLoadBalancer);
-  } else {
+    if (platform_->getAsic()->isSupported(HwAsic::Feature::SAI_UDF_HASH)) {
+      // There're several constraints for load balancer and Udf objects.
+      // 1. Udf Match needs to be processed before Udf Group (create, remove
+      // and changed).
+      // 2. In the case of removing Udf group: load balancer needs to remove
+      // association with Udf Group.
+      // 3. In the case of creating load balancer: Udf group needs to be
+      // created first.
+      // 4. In the case of changing load balancer: a. new Udf group needs to
+      // be created, b. Load balancer starts to use new Udf group, c. Remove
+      // old Udf group.
+      processAddedDelta(
+          delta.getLoadBalancersDelta(),
+          managerTable_->switchManager(),
+          lockPolicy,
+          &SaiSwitchManager::addOrUpdateLoadBalancer);
+      // TODO(zecheng): Process Udf Match changed
+      // TODO(zecheng): Process Udf Group changed
+      processChangedDelta(
+          delta.getLoadBalancersDelta(),
+          managerTable_->switchManager(),
+          lockPolicy,
+          &SaiSwitchManager::changeLoadBalancer);
+      processRemovedDelta(
+          delta.getLoadBalancersDelta(),
+          managerTable_->switchManager(),
+          lockPolicy,
+          &SaiSwitchManager::removeLoadBalancer);
+    } else {
+      processDelta(
+          delta.getLoadBalancersDelta(),
+          managerTable_->switchManager(),
+          lockPolicy,
+          &SaiSwitchManager::changeLoadBalancer,
+          &SaiSwitchManager::addOrUpdateLoadBalancer,
+          &SaiSwitchManager::removeLoadBalancer);
+    }
+#else
     processDelta(
         delta.getLoadBalancersDelta(),
         managerTable_->switchManager(),
@@ -1590,115 +1704,96 @@ std::shared_ptr<SwitchState> SaiSwitch::stateChangedImplLocked(
         &SaiSwitchManager::changeLoadBalancer,
         &SaiSwitchManager::addOrUpdateLoadBalancer,
         &SaiSwitchManager::removeLoadBalancer);
-  }
-#else
-  processDelta(
-      delta.getLoadBalancersDelta(),
-      managerTable_->switchManager(),
-      lockPolicy,
-      &SaiSwitchManager::changeLoadBalancer,
-      &SaiSwitchManager::addOrUpdateLoadBalancer,
-      &SaiSwitchManager::removeLoadBalancer);
 #endif
+  });
 
   /*
    * Add/update mirrors before processing ACL, as ACLs with action
    * INGRESS/EGRESS Mirror rely on the Mirror being created.
    */
-  processDelta(
-      delta.getMirrorsDelta(),
-      managerTable_->mirrorManager(),
-      lockPolicy,
-      &SaiMirrorManager::changeMirror,
-      &SaiMirrorManager::addNode,
-      &SaiMirrorManager::removeMirror);
+  auto mirrorProcessor = processors.add("mirrors", [&] {
+    processDelta(
+        delta.getMirrorsDelta(),
+        managerTable_->mirrorManager(),
+        lockPolicy,
+        &SaiMirrorManager::changeMirror,
+        &SaiMirrorManager::addNode,
+        &SaiMirrorManager::removeMirror);
+  });
 
-  processDelta(
-      delta.getMirrorOnDropReportsDelta(),
-      managerTable_->tamManager(),
-      lockPolicy,
-      &SaiTamManager::changeMirrorOnDropReport,
-      &SaiTamManager::addMirrorOnDropReport,
-      &SaiTamManager::removeMirrorOnDropReport);
+  processors.add(
+      "mirrorOnDropReports",
+      [&] {
+        processDelta(
+            delta.getMirrorOnDropReportsDelta(),
+            managerTable_->tamManager(),
+            lockPolicy,
+            &SaiTamManager::changeMirrorOnDropReport,
+            &SaiTamManager::addMirrorOnDropReport,
+            &SaiTamManager::removeMirrorOnDropReport);
+      },
+      {mirrorProcessor});
 
-  processDelta(
-      delta.getIpTunnelsDelta(),
-      managerTable_->tunnelManager(),
-      lockPolicy,
-      &SaiTunnelManager::changeTunnel,
-      &SaiTunnelManager::addTunnel,
-      &SaiTunnelManager::removeTunnel);
+  // ACLs may redirect to IP tunnels
+  auto ipTunnelProcessor = processors.add("ipTunnels", [&] {
+    processDelta(
+        delta.getIpTunnelsDelta(),
+        managerTable_->tunnelManager(),
+        lockPolicy,
+        &SaiTunnelManager::changeTunnel,
+        &SaiTunnelManager::addTunnel,
+        &SaiTunnelManager::removeTunnel);
+  });
 
 #if SAI_API_VERSION >= SAI_VERSION(1, 12, 0)
-  processDelta(
-      delta.getMySidsDelta(),
-      managerTable_->srv6MySidManager(),
-      lockPolicy,
-      &SaiSrv6MySidManager::changeMySidEntry,
-      &SaiSrv6MySidManager::addMySidEntry,
-      &SaiSrv6MySidManager::removeMySidEntry,
-      delta.newState());
-#endif
-
-#if defined(TAJO_SDK_VERSION_1_42_8)
-  FLAGS_enable_acl_table_group = false;
-#endif
-  if (FLAGS_enable_acl_table_group) {
+  processors.add("mySids", [&] {
     processDelta(
-        delta.getAclTableGroupsDelta(),
-        managerTable_->aclTableGroupManager(),
+        delta.getMySidsDelta(),
+        managerTable_->srv6MySidManager(),
         lockPolicy,
-        &SaiAclTableGroupManager::changedAclTableGroup,
-        &SaiAclTableGroupManager::addAclTableGroup,
-        &SaiAclTableGroupManager::removeAclTableGroup);
+        &SaiSrv6MySidManager::changeMySidEntry,
+        &SaiSrv6MySidManager::addMySidEntry,
+        &SaiSrv6MySidManager::removeMySidEntry,
+        delta.newState());
+  });
+#endif
 
-    if (delta.getAclTableGroupsDelta().getNew()) {
-      // Process delta for the entries of each table in the new state
-      for (const auto& [_, tableGroupMap] :
-           *delta.getAclTableGroupsDelta().getNew()) {
-        processAclTableGroupDelta(delta, *tableGroupMap, lockPolicy);
-      }
-    }
-  } else {
-    std::set<cfg::AclTableQualifier> oldRequiredQualifiers{};
-    std::set<cfg::AclTableQualifier> newRequiredQualifiers{};
-    if (delta.getAclsDelta().getOld()) {
-      oldRequiredQualifiers =
-          delta.getAclsDelta().getOld()->requiredQualifiers();
-    }
-    if (delta.getAclsDelta().getNew()) {
-      newRequiredQualifiers =
-          delta.getAclsDelta().getNew()->requiredQualifiers();
-    }
-    bool aclTableUpdateSupport = platform_->getAsic()->isSupported(
-        HwAsic::Feature::SAI_ACL_TABLE_UPDATE);
 #if defined(TAJO_SDK_VERSION_1_42_8)
-    aclTableUpdateSupport = false;
+  FLAGS_enable_acl_table_group = false;
 #endif
-    if (!oldRequiredQualifiers.empty() &&
-        oldRequiredQualifiers != newRequiredQualifiers &&
-        aclTableUpdateSupport &&
-        !managerTable_->aclTableManager()
-             .areQualifiersSupportedInDefaultAclTable(newRequiredQualifiers)) {
-      // qualifiers changed and default acl table doesn't support all of them,
-      // remove default acl table and add a new one. table removal should
-      // clear acl entries too
-      managerTable_->switchManager().resetIngressAcl();
-      managerTable_->aclTableManager().removeDefaultIngressAclTable();
-      managerTable_->aclTableManager().addDefaultIngressAclTable();
-      managerTable_->switchManager().setIngressAcl();
-    }
+  // ACLs copying to a CPU queue use the hostif user defined traps
+  processors.add(
+      "acls",
+      [&] {
+        if (FLAGS_enable_acl_table_group) {
+          processDelta(
+              delta.getAclTableGroupsDelta(),
+              managerTable_->aclTableGroupManager(),
+              lockPolicy,
+              &SaiAclTableGroupManager::changedAclTableGroup,
+              &SaiAclTableGroupManager::addAclTableGroup,
+              &SaiAclTableGroupManager::removeAclTableGroup);
+
+          if (delta.getAclTableGroupsDelta().getNew()) {
+            // Process delta for the entries of each table in the new state
+            for (const auto& [_, tableGroupMap] :
+                 *delta.getAclTableGroupsDelta().getNew()) {
+              processAclTableGroupDelta(delta, *tableGroupMap, lockPolicy);
+            }
+          }
+        } else {
+          processDefaultAclTableDelta(delta, lockPolicy);
+        }
+      },
+      {hostifProcessor, mirrorProcessor, ipTunnelProcessor});
 
-    processDelta(
-        delta.getAclsDelta(),
-        managerTable_->aclTableManager(),
-        lockPolicy,
-        &SaiAclTableManager::changedAclEntry,
-        &SaiAclTableManager::addAclEntry,
-        &SaiAclTableManager::removeAclEntry,
-        cfg::switch_config_constants::DEFAULT_INGRESS_ACL_TABLE(),
-        delta.newState());
+  folly::Executor* executor = nullptr;
+  // The coarse grained policy holds the lock for the whole update, so
+  // processors on other threads could never take it
+  if constexpr (std::is_same_v<LockPolicyT, FineGrainedLockPolicy>) {
+    executor = deltaProcessorExecutor_.get();
   }
+  processors.run(executor);
 
 #if SAI_API_VERSION >= SAI_VERSION(1, 12, 0)
   // ACLs are done processing. Remove UDF groups not required
@@ -5270,6 +5365,52 @@ void SaiSwitch::rollbackInTest(const StateDelta& delta) {
   setProgrammedState(delta.oldState());
 }
 
+template <typename LockPolicyT>
+void SaiSwitch::processDefaultAclTableDelta(
+    const StateDelta& delta,
+    const LockPolicyT& lockPolicy) {
+  std::set<cfg::AclTableQualifier> oldRequiredQualifiers{};
+  std::set<cfg::AclTableQualifier> newRequiredQualifiers{};
+  if (delta.getAclsDelta().getOld()) {
+    oldRequiredQualifiers = delta.getAclsDelta().getOld()->requiredQualifiers();
+  }
+  if (delta.getAclsDelta().getNew()) {
+    newRequiredQualifiers = delta.getAclsDelta().getNew()->requiredQualifiers();
+  }
+  bool aclTableUpdateSupport = platform_->getAsic()->isSupported(
+      HwAsic::Feature::SAI_ACL_TABLE_UPDATE);
+#if defined(TAJO_SDK_VERSION_1_42_8)
+  aclTableUpdateSupport = false;
+#endif
+  {
+    // Other delta processors may be running concurrently
+    [[maybe_unused]] const auto& lock = lockPolicy.lock();
+    if (!oldRequiredQualifiers.empty() &&
+        oldRequiredQualifiers != newRequiredQualifiers &&
+        aclTableUpdateSupport &&
+        !managerTable_->aclTableManager()
+             .areQualifiersSupportedInDefaultAclTable(newRequiredQualifiers)) {
+      // qualifiers changed and default acl table doesn't support all of
+      // them, remove default acl table and add a new one. table removal
+      // should clear acl entries too
+      managerTable_->switchManager().resetIngressAcl();
+      managerTable_->aclTableManager().removeDefaultIngressAclTable();
+      managerTable_->aclTableManager().addDefaultIngressAclTable();
+      managerTable_->switchManager().setIngressAcl();
+    }
+  }
+
+  processDelta(
+      delta.getAclsDelta(),
+      managerTable_->aclTableManager(),
+      lockPolicy,
+      &SaiAclTableManager::changedAclEntry,
+      &SaiAclTableManager::addAclEntry,
+      &SaiAclTableManager::removeAclEntry,
+      cfg::switch_config_constants::DEFAULT_INGRESS_ACL_TABLE(),
+      delta.newState());
+}
+
 template <typename LockPolicyT>
 void SaiSwitch::processAclTableGroupDelta(
     const StateDelta& delta,
@@ -27,6 +27,7 @@
 #include "fboss/agent/hw/sai/api/SaiVersion.h"
 
 #include <folly/concurrency/ConcurrentHashMap.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -35,10 +36,12 @@ DECLARE_int32(update_watermark_stats_interval_s);
 DECLARE_int32(update_voq_stats_interval_s);
 DECLARE_bool(force_recreate_acl_tables);
 DECLARE_bool(skip_stats_update_for_debug);
+DECLARE_int32(sai_delta_processing_threads);
 
 namespace facebook::fboss {
 
 struct ConcurrentIndices;
+class HwStatsCollectionScheduler;
 class SaiStore;
 class FineGrainedLockPolicy;
 /*
@@ -339,6 +342,37 @@ class SaiSwitch : public HwSwitch {
   std::vector<EcmpDetails> getAllEcmpDetails() const override;
 
   void updateStatsImpl() override;
+  /*
+   * Time of the last collection of the stats that are collected less often
+   * than every stats cycle, and whether they are due in the current cycle.
+   */
+  struct StatsUpdateTimes {
+    int64_t watermark{0};
+    int64_t voq{0};
+    int64_t cableLength{0};
+  };
+  struct StatsUpdates {
+    bool watermarks{false};
+    bool voqStats{false};
+    bool cableLengths{false};
+  };
+  static StatsUpdates getStatsUpdates(StatsUpdateTimes& times);
+  /*
+   * Classes of stats collected in updateStatsImpl(). With
+   * --enable_sharded_stats_collection each class is collected on its own
+   * thread by statsCollectionScheduler_ instead.
+   */
+  void updateFabricAndPortStats(bool updateWatermarks, bool updateCableLengths);
+  void updateSysPortStats(bool updateWatermarks, bool updateVoqStats);
+  void updateLagStats();
+  void updateCpuPortStats(bool updateWatermarks);
+  void updateBufferStats();
+  void updateSwitchStats(bool updateWatermarks);
+  void publishSaiApiLockStats() const;
+  uint64_t getPortStatsDigest() const;
+  uint64_t getSysPortStatsDigest() const;
+  uint64_t getCpuPortStatsDigest() const;
+  void startShardedStatsCollection();
   void reportAsymmetricTopology() const;
   void reportInterPortGroupCableSkew() const;
   template <typename LockPolicyT>
@@ -690,6 +724,11 @@ class SaiSwitch : public HwSwitch {
 
   void checkAndSetSdkDowngradeVersion() const;
 
+  template <typename LockPolicyT>
+  void processDefaultAclTableDelta(
+      const StateDelta& delta,
+      const LockPolicyT& lockPolicy);
+
   template <typename LockPolicyT>
   void processAclTableGroupDelta(
       const StateDelta& delta,
@@ -721,6 +760,20 @@ class SaiSwitch : public HwSwitch {
       std::optional<cfg::PfcWatchdogRecoveryAction> recoveryAction);
   void setPortOwnershipToAdapter();
 
+  // Runs processFn with route changes batched in the route manager, see
+  // SaiRouteManager::startBatch()
+  template <typename LockPolicyT, typename ProcessFn>
+  void processRoutesDeltaInBatch(
+      const LockPolicyT& lockPolicy,
+      ProcessFn&& processFn);
+
+  // Runs processFn with neighbor and fdb entry changes batched in their
+  // managers, see SaiNeighborManager::startBatch()
+  template <typename LockPolicyT, typename ProcessFn>
+  void processNeighborsDeltaInBatch(
+      const LockPolicyT& lockPolicy,
+      ProcessFn&& processFn);
+
   template <typename LockPolicyT, typename AddrT>
   void processRemovedRoutesDelta(
       const RouterID& routerID,
@@ -768,6 +821,9 @@ class SaiSwitch : public HwSwitch {
    */
   mutable std::mutex saiSwitchMutex_;
   std::unique_ptr<ConcurrentIndices> concurrentIndices_;
+  // Runs independent delta processors of a state update, see
+  // stateChangedImplLocked(). Null unless --sai_delta_processing_threads
+  std::unique_ptr<folly::CPUThreadPoolExecutor> deltaProcessorExecutor_;
 
   SaiPlatform* platform_;
   // Instead of using singleton for SaiStore, we assign one SaiStore to one
@@ -804,9 +860,8 @@ class SaiSwitch : public HwSwitch {
   HwResourceStats hwResourceStats_;
   std::atomic<SwitchRunState> runState_{SwitchRunState::UNINITIALIZED};
 
-  int64_t watermarkStatsUpdateTime_{0};
-  int64_t voqStatsUpdateTime_{0};
-  int64_t cableLengthStatsUpdateTime_{0};
+  StatsUpdateTimes statsUpdateTimes_;
+  std::once_flag shardedStatsCollectionStarted_;
   time_t lastSerdesParamsReadTime_{0};
   cfg::AsicType asicType_;
 
@@ -817,6 +872,9 @@ class SaiSwitch : public HwSwitch {
   folly::Synchronized<bool> txReadyStatusChangePending_{false};
   std::optional<uint32_t> asicRevision_;
   std::atomic<int16_t> hardResetNotificationReceived_{0};
+  // Declared last so that its threads are stopped before any state they
+  // collect from is destroyed
+  std::unique_ptr<HwStatsCollectionScheduler> statsCollectionScheduler_;
 };
 
 // Get the PacketType enum corresponding to SAI packet type
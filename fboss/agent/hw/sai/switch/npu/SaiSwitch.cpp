@@ -10,8 +10,13 @@
 
 #include "fboss/agent/hw/sai/switch/SaiSwitch.h"
 
+#include "fboss/agent/AgentFeatures.h"
 #include "fboss/agent/FabricConnectivityManager.h"
+#include "fboss/agent/hw/HwPortFb303Stats.h"
 #include "fboss/agent/hw/HwResourceStatsPublisher.h"
+#include "fboss/agent/hw/HwStatsCollectionScheduler.h"
+#include "fboss/agent/hw/HwSysPortFb303Stats.h"
+#include "fboss/agent/hw/sai/api/SaiApiLock.h"
 #include "fboss/agent/hw/sai/switch/ConcurrentIndices.h"
 #include "fboss/agent/hw/sai/switch/SaiAclTableManager.h"
 #include "fboss/agent/hw/sai/switch/SaiBufferManager.h"
@@ -25,40 +30,44 @@
 #include "fboss/agent/hw/sai/switch/SaiSystemPortManager.h"
 #include "fboss/agent/hw/sai/switch/SaiVendorSwitchManager.h"
 
+#include <fb303/ServiceData.h>
+
 DECLARE_int32(update_cable_length_stats_s);
 
 namespace facebook::fboss {
 
-void SaiSwitch::updateStatsImpl() {
-  if (FLAGS_skip_stats_update_for_debug) {
-    // Skip collecting any ASIC stats while debugs are in progress
-    return;
-  }
-
+SaiSwitch::StatsUpdates SaiSwitch::getStatsUpdates(StatsUpdateTimes& times) {
+  StatsUpdates updates;
   auto now =
       std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-  bool updateWatermarks = now - watermarkStatsUpdateTime_ >=
-      FLAGS_update_watermark_stats_interval_s;
-  if (updateWatermarks) {
-    watermarkStatsUpdateTime_ = now;
+  updates.watermarks =
+      now - times.watermark >= FLAGS_update_watermark_stats_interval_s;
+  if (updates.watermarks) {
+    times.watermark = now;
   }
 
   // Space out VOQ stats update and watermark as much as possible - to avoid
   // stats collection blocking normal updates.
   // Allow frequent collection in test scenario, where the interval is set to 0.
-  bool updateVoqStats = FLAGS_update_voq_stats_interval_s == 0 ||
-      (now - voqStatsUpdateTime_ >= FLAGS_update_voq_stats_interval_s &&
-       now - watermarkStatsUpdateTime_ >=
-           (FLAGS_update_voq_stats_interval_s / 2));
-  if (updateVoqStats) {
-    voqStatsUpdateTime_ = now;
+  updates.voqStats = FLAGS_update_voq_stats_interval_s == 0 ||
+      (now - times.voq >= FLAGS_update_voq_stats_interval_s &&
+       now - times.watermark >= (FLAGS_update_voq_stats_interval_s / 2));
+  if (updates.voqStats) {
+    times.voq = now;
   }
 
-  bool updateCableLengths =
-      now - cableLengthStatsUpdateTime_ >= FLAGS_update_cable_length_stats_s;
+  updates.cableLengths =
+      now - times.cableLength >= FLAGS_update_cable_length_stats_s;
+  if (updates.cableLengths) {
+    times.cableLength = now;
+  }
+  return updates;
+}
 
-  if (updateCableLengths) {
-    cableLengthStatsUpdateTime_ = now;
+void SaiSwitch::updateStatsImpl() {
+  if (FLAGS_skip_stats_update_for_debug) {
+    // Skip collecting any ASIC stats while debugs are in progress
+    return;
   }
 
   // Only the counter mutation is protected by switchReachabilityChangePending_.
@@ -84,6 +93,83 @@ void SaiSwitch::updateStatsImpl() {
         });
   }
 
+  if (statsCollectionScheduler_) {
+    // ASIC stats are collected by the stats class threads
+    std::call_once(shardedStatsCollectionStarted_, [this] {
+      startShardedStatsCollection();
+    });
+    return;
+  }
+
+  auto updates = getStatsUpdates(statsUpdateTimes_);
+  updateFabricAndPortStats(updates.watermarks, updates.cableLengths);
+  updateSysPortStats(updates.watermarks, updates.voqStats);
+  updateLagStats();
+  updateCpuPortStats(updates.watermarks);
+  updateBufferStats();
+  updateSwitchStats(updates.watermarks);
+}
+
+void SaiSwitch::startShardedStatsCollection() {
+  auto interval = std::chrono::milliseconds(
+      std::chrono::seconds(FLAGS_update_stats_interval_s));
+  // Each class runs on its own thread, so it keeps its own update times
+  statsCollectionScheduler_->addStatsClass(
+      "port",
+      interval,
+      [this, times = StatsUpdateTimes()]() mutable -> std::optional<uint64_t> {
+        auto updates = getStatsUpdates(times);
+        updateFabricAndPortStats(updates.watermarks, updates.cableLengths);
+        return getPortStatsDigest();
+      });
+  statsCollectionScheduler_->addStatsClass(
+      "sys_port",
+      interval,
+      [this, times = StatsUpdateTimes()]() mutable -> std::optional<uint64_t> {
+        auto updates = getStatsUpdates(times);
+        updateSysPortStats(updates.watermarks, updates.voqStats);
+        return getSysPortStatsDigest();
+      });
+  statsCollectionScheduler_->addStatsClass(
+      "lag", interval, [this]() -> std::optional<uint64_t> {
+        updateLagStats();
+        return std::nullopt;
+      });
+  statsCollectionScheduler_->addStatsClass(
+      "cpu",
+      interval,
+      [this, times = StatsUpdateTimes()]() mutable -> std::optional<uint64_t> {
+        updateCpuPortStats(getStatsUpdates(times).watermarks);
+        return getCpuPortStatsDigest();
+      });
+  statsCollectionScheduler_->addStatsClass(
+      "buffer", interval, [this]() -> std::optional<uint64_t> {
+        updateBufferStats();
+        return std::nullopt;
+      });
+  statsCollectionScheduler_->addStatsClass(
+      "switch",
+      interval,
+      [this, times = StatsUpdateTimes()]() mutable -> std::optional<uint64_t> {
+        updateSwitchStats(getStatsUpdates(times).watermarks);
+        return std::nullopt;
+      });
+  statsCollectionScheduler_->start();
+}
+
+void SaiSwitch::updateFabricAndPortStats(
+    bool updateWatermarks,
+    bool updateCableLengths) {
+  if (FLAGS_enable_bulk_stats_collection) {
+    std::vector<PortID> portIds;
+    for (const auto& [portSaiId, portInfo] :
+         concurrentIndices_->portSaiId2PortInfo) {
+      portIds.push_back(portInfo.portID);
+    }
+    std::lock_guard<std::mutex> locked(saiSwitchMutex_);
+    managerTable_->portManager().prefetchStats(portIds);
+  }
+
   int64_t missingCount = 0, mismatchCount = 0, bogusCount = 0;
   auto portsIter = concurrentIndices_->portSaiId2PortInfo.begin();
   std::map<PortID, multiswitch::FabricConnectivityDelta> connectivityDelta;
@@ -146,6 +232,19 @@ void SaiSwitch::updateStatsImpl() {
     }
   }
 
+  reportAsymmetricTopology();
+  reportInterPortGroupCableSkew();
+  if (!connectivityDelta.empty()) {
+    XLOG(DBG2)
+        << "Connectivity delta is not empty. Sending callback to SwSwitch";
+    linkConnectivityChangeBottomHalfEventBase_.runInFbossEventBaseThread(
+        [this, connectivityDelta = std::move(connectivityDelta)] {
+          linkConnectivityChanged(connectivityDelta);
+        });
+  }
+}
+
+void SaiSwitch::updateSysPortStats(bool updateWatermarks, bool updateVoqStats) {
   auto sysPortsIter = concurrentIndices_->sysPortIds.begin();
   while (sysPortsIter != concurrentIndices_->sysPortIds.end()) {
     {
@@ -155,6 +254,9 @@ void SaiSwitch::updateStatsImpl() {
     }
     ++sysPortsIter;
   }
+}
+
+void SaiSwitch::updateLagStats() {
   auto lagsIter = concurrentIndices_->aggregatePortIds.begin();
   while (lagsIter != concurrentIndices_->aggregatePortIds.end()) {
     {
@@ -163,6 +265,9 @@ void SaiSwitch::updateStatsImpl() {
     }
     ++lagsIter;
   }
+}
+
+void SaiSwitch::updateCpuPortStats(bool updateWatermarks) {
   if (platform_->getAsic()->isSupported(HwAsic::Feature::CPU_PORT)) {
     std::lock_guard<std::mutex> locked(saiSwitchMutex_);
     managerTable_->hostifManager().updateStats(
@@ -170,11 +275,14 @@ void SaiSwitch::updateStatsImpl() {
         getPlatform()->getAsic()->isSupported(
             HwAsic::Feature::CPU_QUEUE_WATERMARK_STATS));
   }
+}
 
-  {
-    std::lock_guard<std::mutex> locked(saiSwitchMutex_);
-    managerTable_->bufferManager().updateStats();
-  }
+void SaiSwitch::updateBufferStats() {
+  std::lock_guard<std::mutex> locked(saiSwitchMutex_);
+  managerTable_->bufferManager().updateStats();
+}
+
+void SaiSwitch::updateSwitchStats(bool updateWatermarks) {
   {
     std::lock_guard<std::mutex> locked(saiSwitchMutex_);
     HwResourceStatsPublisher(getPlatform()->getMultiSwitchStatsPrefix())
@@ -196,6 +304,7 @@ void SaiSwitch::updateStatsImpl() {
     std::lock_guard<std::mutex> locked(saiSwitchMutex_);
     managerTable_->routerInterfaceManager().updateStats();
   }
+  publishSaiApiLockStats();
   if (updateWatermarks &&
       platform_->getAsic()->isSupported(
           HwAsic::Feature::VENDOR_SWITCH_CONGESTION_MANAGEMENT_ERRORS)) {
@@ -203,16 +312,66 @@ void SaiSwitch::updateStatsImpl() {
     std::lock_guard<std::mutex> locked(saiSwitchMutex_);
     managerTable_->vendorSwitchManager().logCgmErrors();
   }
-  reportAsymmetricTopology();
-  reportInterPortGroupCableSkew();
-  if (!connectivityDelta.empty()) {
-    XLOG(DBG2)
-        << "Connectivity delta is not empty. Sending callback to SwSwitch";
-    linkConnectivityChangeBottomHalfEventBase_.runInFbossEventBaseThread(
-        [this, connectivityDelta = std::move(connectivityDelta)] {
-          linkConnectivityChanged(connectivityDelta);
-        });
+}
+
+void SaiSwitch::publishSaiApiLockStats() const {
+  auto prefix = getPlatform()->getMultiSwitchStatsPrefix().value_or("");
+  for (const auto& domainStats : SaiApiLock::getInstance()->getDomainStats()) {
+    auto counterPrefix =
+        fmt::format("{}sai_api_lock.{}.", prefix, domainStats.name);
+    fb303::fbData->setCounter(
+        counterPrefix + "acquisitions", domainStats.acquisitions);
+    fb303::fbData->setCounter(
+        counterPrefix + "contentions", domainStats.contentions);
+    fb303::fbData->setCounter(counterPrefix + "wait_us", domainStats.waitUsecs);
+  }
+}
+
+uint64_t SaiSwitch::getPortStatsDigest() const {
+  std::lock_guard<std::mutex> locked(saiSwitchMutex_);
+  uint64_t digest = 0;
+  for (const auto& [portId, portStats] :
+       managerTable_->portManager().getLastPortStats()) {
+    const auto& stats = portStats->portStats();
+    for (auto counter :
+         {*stats.inBytes_(),
+          *stats.outBytes_(),
+          *stats.inDiscards_(),
+          *stats.outDiscards_()}) {
+      digest += static_cast<uint64_t>(counter);
+    }
+  }
+  return digest;
+}
+
+uint64_t SaiSwitch::getSysPortStatsDigest() const {
+  std::lock_guard<std::mutex> locked(saiSwitchMutex_);
+  uint64_t digest = 0;
+  for (const auto& [portId, portStats] :
+       managerTable_->systemPortManager().getLastPortStats()) {
+    const auto& stats = portStats->portStats();
+    for (const auto& [queue, bytes] : *stats.queueOutBytes_()) {
+      digest += static_cast<uint64_t>(bytes);
+    }
+    for (const auto& [queue, bytes] : *stats.queueOutDiscardBytes_()) {
+      digest += static_cast<uint64_t>(bytes);
+    }
+  }
+  return digest;
+}
+
+uint64_t SaiSwitch::getCpuPortStatsDigest() const {
+  std::lock_guard<std::mutex> locked(saiSwitchMutex_);
+  auto stats = managerTable_->hostifManager().getCpuPortStats();
+  uint64_t digest = 0;
+  for (auto counter :
+       {*stats.inBytes_(),
+        *stats.inDiscards_(),
+        *stats.outBytes_(),
+        *stats.outDiscards_()}) {
+    digest += static_cast<uint64_t>(counter);
   }
+  return digest;
 }
 
 } // namespace facebook::fboss
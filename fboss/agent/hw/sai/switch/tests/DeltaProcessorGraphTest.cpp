@@ -0,0 +1,85 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/sai/switch/DeltaProcessorGraph.h"
+#include "fboss/agent/FbossError.h"
+
+#include <folly/Synchronized.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+using namespace facebook::fboss;
+
+namespace {
+class DeltaProcessorGraphTest : public ::testing::Test {
+ public:
+  DeltaProcessorGraph::ProcessorId add(
+      const std::string& name,
+      std::vector<DeltaProcessorGraph::ProcessorId> dependencies = {}) {
+    return graph.add(
+        name,
+        [this, name] { processed.wlock()->push_back(name); },
+        std::move(dependencies));
+  }
+
+  DeltaProcessorGraph graph;
+  folly::Synchronized<std::vector<std::string>> processed;
+  folly::CPUThreadPoolExecutor executor{4};
+};
+} // namespace
+
+TEST_F(DeltaProcessorGraphTest, waves) {
+  auto hostif = add("hostif");
+  auto mirrors = add("mirrors");
+  add("loadBalancers");
+  add("tam", {mirrors});
+  add("acls", {hostif, mirrors});
+  std::vector<std::vector<std::string>> expected{
+      {"hostif", "mirrors", "loadBalancers"}, {"tam", "acls"}};
+  EXPECT_EQ(expected, graph.getWaves());
+}
+
+TEST_F(DeltaProcessorGraphTest, sequentialRunKeepsInsertionOrder) {
+  auto mirrors = add("mirrors");
+  add("acls", {mirrors});
+  add("tunnels");
+  graph.run(nullptr);
+  std::vector<std::string> expected{"mirrors", "acls", "tunnels"};
+  EXPECT_EQ(expected, processed.copy());
+}
+
+TEST_F(DeltaProcessorGraphTest, concurrentRunHonorsDependencies) {
+  auto mirrors = add("mirrors");
+  add("tunnels");
+  add("acls", {mirrors});
+  graph.run(&executor);
+  auto order = processed.copy();
+  ASSERT_EQ(3, order.size());
+  EXPECT_EQ("acls", order.back());
+}
+
+TEST_F(DeltaProcessorGraphTest, unknownDependency) {
+  EXPECT_THROW(add("acls", {0}), FbossError);
+}
+
+TEST_F(DeltaProcessorGraphTest, errorSkipsLaterWaves) {
+  std::atomic<int> numRun{0};
+  auto failing =
+      graph.add("mirrors", [] { throw FbossError("mirror programming"); });
+  graph.add("tunnels", [&] { ++numRun; });
+  graph.add("acls", [&] { ++numRun; }, {failing});
+  EXPECT_THROW(graph.run(&executor), FbossError);
+  // The rest of the failing wave completes, the next wave doesn't start
+  EXPECT_EQ(1, numRun);
+}
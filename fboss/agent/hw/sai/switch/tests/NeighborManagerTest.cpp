@@ -7,6 +7,7 @@
  *  of patent rights can be found in the PATENTS file in the same directory.
  *
  */
+#include "fboss/agent/AgentFeatures.h"
 #include "fboss/agent/EncapIndexAllocator.h"
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/hw/sai/api/SaiApiTable.h"
@@ -18,6 +19,8 @@
 #include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/types.h"
 
+#include <gflags/gflags.h>
+
 using namespace facebook::fboss;
 class NeighborManagerTest : public ManagerTestBase {
  public:
@@ -219,6 +222,37 @@ TEST_F(NeighborManagerTest, removeResolvedPortRifNeighbor) {
   checkMissing(arpEntry);
 }
 
+TEST_F(NeighborManagerTest, batchedPortRifNeighborChanges) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_enable_bulk_neighbor_programming = true;
+  auto& neighborManager = saiManagerTable->neighborManager();
+  auto arpEntry = makeArpEntry(
+      intf0.id, h0, 42, 42, true, cfg::InterfaceType::SYSTEM_PORT);
+  auto saiEntry = neighborManager.saiEntryFromSwEntry(arpEntry);
+
+  neighborManager.startBatch();
+  neighborManager.addNeighbor(arpEntry);
+  // programmed once the batch is committed
+  ASSERT_TRUE(neighborManager.getNeighborHandle(saiEntry));
+  EXPECT_FALSE(neighborManager.getNeighborHandle(saiEntry)->neighbor);
+  neighborManager.commitBatch();
+  checkEntry(arpEntry, h0.mac, cfg::InterfaceType::SYSTEM_PORT, 42, 42);
+
+  // remove and add back the neighbor within a batch
+  auto arpEntryNew = makeArpEntry(
+      intf0.id, h0, 43, 42, true, cfg::InterfaceType::SYSTEM_PORT);
+  neighborManager.startBatch();
+  neighborManager.removeNeighbor(arpEntry);
+  neighborManager.addNeighbor(arpEntryNew);
+  neighborManager.commitBatch();
+  checkEntry(arpEntryNew, h0.mac, cfg::InterfaceType::SYSTEM_PORT, 43, 42);
+
+  neighborManager.startBatch();
+  neighborManager.removeNeighbor(arpEntryNew);
+  neighborManager.commitBatch();
+  checkMissing(arpEntryNew);
+}
+
 TEST_F(NeighborManagerTest, changeResolvedNeighbor) {
   auto arpEntry = resolveArp(intf0.id, h0);
   checkEntry(arpEntry, h0.mac);
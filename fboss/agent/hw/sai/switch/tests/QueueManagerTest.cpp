@@ -7,6 +7,7 @@
  *  of patent rights can be found in the PATENTS file in the same directory.
  *
  */
+#include "fboss/agent/AgentFeatures.h"
 #include "fboss/agent/hw/HwPortFb303Stats.h"
 #include "fboss/agent/hw/HwSysPortFb303Stats.h"
 #include "fboss/agent/hw/sai/store/SaiStore.h"
@@ -21,6 +22,7 @@
 #include <string>
 
 #include <fmt/format.h>
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
 using namespace facebook::fboss;
@@ -314,6 +316,24 @@ TEST_F(QueueManagerTest, addPortQueueAndCheckStats) {
       swPort->getName(), queueConfig, ExpectExport::EXPORT, portStat);
 }
 
+TEST_F(QueueManagerTest, addPortQueueAndCheckBulkStats) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_enable_bulk_stats_collection = true;
+  auto p0 = testInterfaces[0].remoteHosts[0].port;
+  std::shared_ptr<Port> swPort = makePort(p0);
+  auto newPort = swPort->clone();
+  std::vector<uint8_t> queueIds = {1, 2, 3, 4};
+  auto queueConfig = makeQueueConfig({queueIds});
+  newPort->resetPortQueues(queueConfig);
+  saiManagerTable->portManager().changePort(swPort, newPort);
+  saiManagerTable->portManager().prefetchStats({newPort->getID()});
+  saiManagerTable->portManager().updateStats(newPort->getID());
+  auto portStat =
+      saiManagerTable->portManager().getLastPortStat(swPort->getID());
+  checkCounterExportAndValue(
+      swPort->getName(), queueConfig, ExpectExport::EXPORT, portStat);
+}
+
 TEST_F(QueueManagerTest, checkSysPortVoqStats) {
   auto sysPort = firstSysPort();
   saiManagerTable->systemPortManager().updateStats(
@@ -327,6 +347,21 @@ TEST_F(QueueManagerTest, checkSysPortVoqStats) {
       portStat);
 }
 
+TEST_F(QueueManagerTest, checkSysPortBulkVoqStats) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_enable_bulk_stats_collection = true;
+  auto sysPort = firstSysPort();
+  saiManagerTable->systemPortManager().updateStats(
+      sysPort->getID(), true /* updateWatermarks */, true /* updateVoqStats */);
+  auto portStat =
+      saiManagerTable->systemPortManager().getLastPortStats(sysPort->getID());
+  checkCounterExportAndValue(
+      sysPort->getName(),
+      voqIds(sysPort->getID()),
+      ExpectExport::EXPORT,
+      portStat);
+}
+
 TEST_F(QueueManagerTest, changeSysPortAndCheckVoqStats) {
   auto sysPort = firstSysPort();
   auto newSysPort = sysPort->clone();
@@ -7,6 +7,7 @@
  *  of patent rights can be found in the PATENTS file in the same directory.
  *
  */
+#include "fboss/agent/AgentFeatures.h"
 #include "fboss/agent/HwSwitch.h"
 #include "fboss/agent/hw/sai/api/AddressUtil.h"
 #include "fboss/agent/hw/sai/switch/SaiFdbManager.h"
@@ -621,6 +622,53 @@ TEST_F(RouteManagerTest, updateRouteDifferentNextHops) {
   EXPECT_EQ(count, 4);
 }
 
+TEST_F(RouteManagerTest, batchedRouteChanges) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_enable_bulk_route_programming = true;
+  auto& routeManager = saiManagerTable->routeManager();
+  auto& routeApi = saiApiTable->routeApi();
+  tr2.nextHopInterfaces.push_back(testInterfaces.at(4));
+  tr2.nextHopInterfaces.push_back(testInterfaces.at(5));
+  auto r1 = makeRoute(tr1);
+  auto r2 = makeRoute(tr2);
+  auto entry1 = routeManager.routeEntryFromSwRoute(RouterID(0), r1);
+  auto entry2 = routeManager.routeEntryFromSwRoute(RouterID(0), r2);
+
+  routeManager.startBatch();
+  routeManager.addRoute<folly::IPAddressV4>(
+      r1, RouterID(0), getProgrammedState());
+  routeManager.addRoute<folly::IPAddressV4>(
+      r2, RouterID(0), getProgrammedState());
+  // programmed once the batch is committed
+  EXPECT_FALSE(routeManager.getRouteHandle(entry1)->route);
+  EXPECT_FALSE(routeManager.getRouteObject(entry2));
+  routeManager.commitBatch();
+  auto routeHandle1 = routeManager.getRouteHandle(entry1);
+  ASSERT_TRUE(routeHandle1->route);
+  EXPECT_EQ(routeHandle1->nextHopGroupHandle()->nextHopGroupSize(), 4);
+  EXPECT_EQ(
+      routeApi.getAttribute(entry1, SaiRouteTraits::Attributes::NextHopId{}),
+      routeHandle1->nextHopAdapterKey());
+  EXPECT_TRUE(routeManager.getRouteObject(entry2));
+
+  // move r1 to the next hops of r2, then remove r2
+  tr1.nextHopInterfaces = tr2.nextHopInterfaces;
+  auto r3 = makeRoute(tr1);
+  routeManager.startBatch();
+  routeManager.changeRoute<folly::IPAddressV4>(
+      r1, r3, RouterID(0), getProgrammedState());
+  routeManager.commitBatch();
+  routeManager.startBatch();
+  routeManager.removeRoute(r2, RouterID(0));
+  routeManager.commitBatch();
+  EXPECT_FALSE(routeManager.getRouteHandle(entry2));
+  EXPECT_FALSE(routeManager.getRouteObject(entry2));
+  EXPECT_EQ(routeHandle1->nextHopGroupHandle()->nextHopGroupSize(), 2);
+  EXPECT_EQ(
+      routeApi.getAttribute(entry1, SaiRouteTraits::Attributes::NextHopId{}),
+      routeHandle1->nextHopAdapterKey());
+}
+
 TEST_F(RouteManagerTest, updateCpuRoutetoNextHopRoute) {
   RouteFields<folly::IPAddressV4>::Prefix destination(
       tr1.destination.first.asV4(), tr1.destination.second);
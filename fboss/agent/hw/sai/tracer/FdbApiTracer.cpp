@@ -65,6 +65,59 @@ sai_status_t wrap_get_fdb_entry_attribute(
       fdb_entry, attr_count, attr_list);
 }
 
+// Bulk fdb calls are logged as the single calls of the entries
+// attempted, so that replaying a trace doesn't depend on bulk support
+sai_status_t wrap_create_fdb_entries(
+    uint32_t object_count,
+    const sai_fdb_entry_t* fdb_entry,
+    const uint32_t* attr_count,
+    const sai_attribute_t** attr_list,
+    sai_bulk_op_error_mode_t mode,
+    sai_status_t* object_statuses) {
+  auto rv = SaiTracer::getInstance()->fdbApi_->create_fdb_entries(
+      object_count, fdb_entry, attr_count, attr_list, mode, object_statuses);
+  for (uint32_t i = 0; i < object_count; ++i) {
+    if (object_statuses[i] != SAI_STATUS_NOT_EXECUTED) {
+      SaiTracer::getInstance()->logFdbEntryCreateFn(
+          &fdb_entry[i], attr_count[i], attr_list[i], object_statuses[i]);
+    }
+  }
+  return rv;
+}
+
+sai_status_t wrap_remove_fdb_entries(
+    uint32_t object_count,
+    const sai_fdb_entry_t* fdb_entry,
+    sai_bulk_op_error_mode_t mode,
+    sai_status_t* object_statuses) {
+  auto rv = SaiTracer::getInstance()->fdbApi_->remove_fdb_entries(
+      object_count, fdb_entry, mode, object_statuses);
+  for (uint32_t i = 0; i < object_count; ++i) {
+    if (object_statuses[i] != SAI_STATUS_NOT_EXECUTED) {
+      SaiTracer::getInstance()->logFdbEntryRemoveFn(
+          &fdb_entry[i], object_statuses[i]);
+    }
+  }
+  return rv;
+}
+
+sai_status_t wrap_set_fdb_entries_attribute(
+    uint32_t object_count,
+    const sai_fdb_entry_t* fdb_entry,
+    const sai_attribute_t* attr_list,
+    sai_bulk_op_error_mode_t mode,
+    sai_status_t* object_statuses) {
+  auto rv = SaiTracer::getInstance()->fdbApi_->set_fdb_entries_attribute(
+      object_count, fdb_entry, attr_list, mode, object_statuses);
+  for (uint32_t i = 0; i < object_count; ++i) {
+    if (object_statuses[i] != SAI_STATUS_NOT_EXECUTED) {
+      SaiTracer::getInstance()->logFdbEntrySetAttrFn(
+          &fdb_entry[i], &attr_list[i], object_statuses[i]);
+    }
+  }
+  return rv;
+}
+
 sai_fdb_api_t* wrappedFdbApi() {
   static sai_fdb_api_t fdbWrappers;
 
@@ -72,6 +125,16 @@ sai_fdb_api_t* wrappedFdbApi() {
   fdbWrappers.remove_fdb_entry = &wrap_remove_fdb_entry;
   fdbWrappers.set_fdb_entry_attribute = &wrap_set_fdb_entry_attribute;
   fdbWrappers.get_fdb_entry_attribute = &wrap_get_fdb_entry_attribute;
+  // only wrap the bulk calls the adapter implements, leaving them unset for
+  // callers to fall back to single calls otherwise
+  auto fdbApi = SaiTracer::getInstance()->fdbApi_;
+  fdbWrappers.create_fdb_entries =
+      fdbApi->create_fdb_entries ? &wrap_create_fdb_entries : nullptr;
+  fdbWrappers.remove_fdb_entries =
+      fdbApi->remove_fdb_entries ? &wrap_remove_fdb_entries : nullptr;
+  fdbWrappers.set_fdb_entries_attribute = fdbApi->set_fdb_entries_attribute
+      ? &wrap_set_fdb_entries_attribute
+      : nullptr;
 
   return &fdbWrappers;
 }
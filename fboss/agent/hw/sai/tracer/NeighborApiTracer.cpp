@@ -75,6 +75,70 @@ sai_status_t wrap_remove_all_neighbor_entries(sai_object_id_t switch_id) {
       switch_id);
 }
 
+#if SAI_API_VERSION >= SAI_VERSION(1, 11, 0)
+// Bulk neighbor calls are logged as the single calls of the entries
+// attempted, so that replaying a trace doesn't depend on bulk support
+sai_status_t wrap_create_neighbor_entries(
+    uint32_t object_count,
+    const sai_neighbor_entry_t* neighbor_entry,
+    const uint32_t* attr_count,
+    const sai_attribute_t** attr_list,
+    sai_bulk_op_error_mode_t mode,
+    sai_status_t* object_statuses) {
+  auto rv = SaiTracer::getInstance()->neighborApi_->create_neighbor_entries(
+      object_count,
+      neighbor_entry,
+      attr_count,
+      attr_list,
+      mode,
+      object_statuses);
+  for (uint32_t i = 0; i < object_count; ++i) {
+    if (object_statuses[i] != SAI_STATUS_NOT_EXECUTED) {
+      SaiTracer::getInstance()->logNeighborEntryCreateFn(
+          &neighbor_entry[i],
+          attr_count[i],
+          attr_list[i],
+          object_statuses[i]);
+    }
+  }
+  return rv;
+}
+
+sai_status_t wrap_remove_neighbor_entries(
+    uint32_t object_count,
+    const sai_neighbor_entry_t* neighbor_entry,
+    sai_bulk_op_error_mode_t mode,
+    sai_status_t* object_statuses) {
+  auto rv = SaiTracer::getInstance()->neighborApi_->remove_neighbor_entries(
+      object_count, neighbor_entry, mode, object_statuses);
+  for (uint32_t i = 0; i < object_count; ++i) {
+    if (object_statuses[i] != SAI_STATUS_NOT_EXECUTED) {
+      SaiTracer::getInstance()->logNeighborEntryRemoveFn(
+          &neighbor_entry[i], object_statuses[i]);
+    }
+  }
+  return rv;
+}
+
+sai_status_t wrap_set_neighbor_entries_attribute(
+    uint32_t object_count,
+    const sai_neighbor_entry_t* neighbor_entry,
+    const sai_attribute_t* attr_list,
+    sai_bulk_op_error_mode_t mode,
+    sai_status_t* object_statuses) {
+  auto rv =
+      SaiTracer::getInstance()->neighborApi_->set_neighbor_entries_attribute(
+          object_count, neighbor_entry, attr_list, mode, object_statuses);
+  for (uint32_t i = 0; i < object_count; ++i) {
+    if (object_statuses[i] != SAI_STATUS_NOT_EXECUTED) {
+      SaiTracer::getInstance()->logNeighborEntrySetAttrFn(
+          &neighbor_entry[i], &attr_list[i], object_statuses[i]);
+    }
+  }
+  return rv;
+}
+#endif
+
 sai_neighbor_api_t* wrappedNeighborApi() {
   static sai_neighbor_api_t neighborWrappers;
 
@@ -86,6 +150,21 @@ sai_neighbor_api_t* wrappedNeighborApi() {
       &wrap_get_neighbor_entry_attribute;
   neighborWrappers.remove_all_neighbor_entries =
       &wrap_remove_all_neighbor_entries;
+#if SAI_API_VERSION >= SAI_VERSION(1, 11, 0)
+  // only wrap the bulk calls the adapter implements, leaving them unset for
+  // callers to fall back to single calls otherwise
+  auto neighborApi = SaiTracer::getInstance()->neighborApi_;
+  neighborWrappers.create_neighbor_entries =
+      neighborApi->create_neighbor_entries ? &wrap_create_neighbor_entries
+                                           : nullptr;
+  neighborWrappers.remove_neighbor_entries =
+      neighborApi->remove_neighbor_entries ? &wrap_remove_neighbor_entries
+                                           : nullptr;
+  neighborWrappers.set_neighbor_entries_attribute =
+      neighborApi->set_neighbor_entries_attribute
+          ? &wrap_set_neighbor_entries_attribute
+          : nullptr;
+#endif
 
   return &neighborWrappers;
 }
@@ -78,6 +78,76 @@ sai_status_t wrap_get_route_entry_attribute(
       route_entry, attr_count, attr_list);
 }
 
+// Bulk route calls are logged as the single calls of the entries attempted,
+// so that replaying a trace doesn't depend on bulk support
+sai_status_t wrap_create_route_entries(
+    uint32_t object_count,
+    const sai_route_entry_t* route_entry,
+    const uint32_t* attr_count,
+    const sai_attribute_t** attr_list,
+    sai_bulk_op_error_mode_t mode,
+    sai_status_t* object_statuses) {
+  auto begin = FLAGS_enable_elapsed_time_log
+      ? std::chrono::system_clock::now()
+      : std::chrono::system_clock::time_point::min();
+  auto rv = SaiTracer::getInstance()->routeApi_->create_route_entries(
+      object_count, route_entry, attr_count, attr_list, mode, object_statuses);
+  for (uint32_t i = 0; i < object_count; ++i) {
+    if (object_statuses[i] == SAI_STATUS_NOT_EXECUTED) {
+      continue;
+    }
+    SaiTracer::getInstance()->logRouteEntryCreateFn(
+        &route_entry[i], attr_count[i], attr_list[i]);
+    SaiTracer::getInstance()->logPostInvocation(
+        object_statuses[i], SAI_NULL_OBJECT_ID, begin);
+  }
+  return rv;
+}
+
+sai_status_t wrap_remove_route_entries(
+    uint32_t object_count,
+    const sai_route_entry_t* route_entry,
+    sai_bulk_op_error_mode_t mode,
+    sai_status_t* object_statuses) {
+  auto begin = FLAGS_enable_elapsed_time_log
+      ? std::chrono::system_clock::now()
+      : std::chrono::system_clock::time_point::min();
+  auto rv = SaiTracer::getInstance()->routeApi_->remove_route_entries(
+      object_count, route_entry, mode, object_statuses);
+  for (uint32_t i = 0; i < object_count; ++i) {
+    if (object_statuses[i] == SAI_STATUS_NOT_EXECUTED) {
+      continue;
+    }
+    SaiTracer::getInstance()->logRouteEntryRemoveFn(&route_entry[i]);
+    SaiTracer::getInstance()->logPostInvocation(
+        object_statuses[i], SAI_NULL_OBJECT_ID, begin);
+  }
+  return rv;
+}
+
+sai_status_t wrap_set_route_entries_attribute(
+    uint32_t object_count,
+    const sai_route_entry_t* route_entry,
+    const sai_attribute_t* attr_list,
+    sai_bulk_op_error_mode_t mode,
+    sai_status_t* object_statuses) {
+  auto begin = FLAGS_enable_elapsed_time_log
+      ? std::chrono::system_clock::now()
+      : std::chrono::system_clock::time_point::min();
+  auto rv = SaiTracer::getInstance()->routeApi_->set_route_entries_attribute(
+      object_count, route_entry, attr_list, mode, object_statuses);
+  for (uint32_t i = 0; i < object_count; ++i) {
+    if (object_statuses[i] == SAI_STATUS_NOT_EXECUTED) {
+      continue;
+    }
+    SaiTracer::getInstance()->logRouteEntrySetAttrFn(
+        &route_entry[i], &attr_list[i]);
+    SaiTracer::getInstance()->logPostInvocation(
+        object_statuses[i], SAI_NULL_OBJECT_ID, begin);
+  }
+  return rv;
+}
+
 sai_route_api_t* wrappedRouteApi() {
   static sai_route_api_t routeWrappers;
 
@@ -85,6 +155,16 @@ sai_route_api_t* wrappedRouteApi() {
   routeWrappers.remove_route_entry = &wrap_remove_route_entry;
   routeWrappers.set_route_entry_attribute = &wrap_set_route_entry_attribute;
   routeWrappers.get_route_entry_attribute = &wrap_get_route_entry_attribute;
+  // only wrap the bulk calls the adapter implements, leaving them unset for
+  // callers to fall back to single calls otherwise
+  auto routeApi = SaiTracer::getInstance()->routeApi_;
+  routeWrappers.create_route_entries =
+      routeApi->create_route_entries ? &wrap_create_route_entries : nullptr;
+  routeWrappers.remove_route_entries =
+      routeApi->remove_route_entries ? &wrap_remove_route_entries : nullptr;
+  routeWrappers.set_route_entries_attribute =
+      routeApi->set_route_entries_attribute ? &wrap_set_route_entries_attribute
+                                            : nullptr;
 
   return &routeWrappers;
 }
@@ -15,6 +15,7 @@
 
 #include "fboss/agent/SysError.h"
 #include "fboss/agent/hw/sai/api/LoggingUtil.h"
+#include "fboss/agent/hw/sai/api/SaiApiLock.h"
 #include "fboss/agent/hw/sai/tracer/AclApiTracer.h"
 #include "fboss/agent/hw/sai/tracer/ArsApiTracer.h"
 #include "fboss/agent/hw/sai/tracer/ArsProfileApiTracer.h"
@@ -143,6 +144,14 @@ sai_status_t __real_sai_get_object_key(
 sai_status_t __wrap_sai_api_initialize(
     uint64_t flags,
     const sai_service_method_table_t* services) {
+  if (FLAGS_enable_replayer) {
+    // The trace is generated code replaying SAI calls one at a time, and
+    // the tracer state (variables_, numCalls_ ...) is shared across all SAI
+    // apis. Both rely on SAI calls not running concurrently.
+    if (auto apiLock = SaiApiLock::getInstance()) {
+      apiLock->serializeAllApis("SAI replayer is enabled");
+    }
+  }
   sai_status_t rv = __real_sai_api_initialize(flags, services);
 
   if (FLAGS_enable_replayer && services) {
@@ -0,0 +1,102 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/HwStatsCollectionScheduler.h"
+
+#include <fb303/ServiceData.h>
+#include <folly/synchronization/Baton.h>
+
+#include <gtest/gtest.h>
+
+using namespace facebook::fboss;
+using namespace facebook::fb303;
+using namespace std::chrono;
+
+namespace {
+constexpr auto kBase = milliseconds(1000);
+constexpr auto kMax = milliseconds(8000);
+constexpr uint32_t kDutyCyclePct = 25;
+} // namespace
+
+TEST(HwStatsCollectionSchedulerTest, changingCountersUseBaseInterval) {
+  EXPECT_EQ(
+      kBase,
+      nextStatsCollectionInterval(
+          milliseconds(4000),
+          kBase,
+          kMax,
+          microseconds(10),
+          true,
+          kDutyCyclePct));
+}
+
+TEST(HwStatsCollectionSchedulerTest, idleCountersBackOff) {
+  auto interval = kBase;
+  for (auto expected : {2000, 4000, 8000, 8000}) {
+    interval = nextStatsCollectionInterval(
+        interval, kBase, kMax, microseconds(10), false, kDutyCyclePct);
+    EXPECT_EQ(milliseconds(expected), interval);
+  }
+}
+
+TEST(HwStatsCollectionSchedulerTest, expensiveCollectionBacksOff) {
+  // 500ms collection at most 25% of the time
+  EXPECT_EQ(
+      milliseconds(2000),
+      nextStatsCollectionInterval(
+          kBase, kBase, kMax, milliseconds(500), true, kDutyCyclePct));
+  // Never beyond the max interval
+  EXPECT_EQ(
+      kMax,
+      nextStatsCollectionInterval(
+          kBase, kBase, kMax, milliseconds(5000), true, kDutyCyclePct));
+  // No cost bound
+  EXPECT_EQ(
+      kBase,
+      nextStatsCollectionInterval(
+          kBase, kBase, kMax, milliseconds(5000), true, 0));
+}
+
+TEST(HwStatsCollectionSchedulerTest, collectAndPublish) {
+  HwStatsCollectionScheduler scheduler(4, kDutyCyclePct, "test.");
+  folly::Baton<> fastCollected, slowCollected;
+  std::atomic<int> fastRuns{0}, slowRuns{0};
+  uint64_t fastCounter{0};
+  scheduler.addStatsClass(
+      "fast", milliseconds(1), [&]() -> std::optional<uint64_t> {
+        if (++fastRuns == 3) {
+          fastCollected.post();
+        }
+        return ++fastCounter;
+      });
+  scheduler.addStatsClass(
+      "idle", milliseconds(1), []() -> std::optional<uint64_t> { return 0; });
+  scheduler.addStatsClass(
+      "slow", milliseconds(1), [&]() -> std::optional<uint64_t> {
+        if (++slowRuns == 1) {
+          slowCollected.post();
+        }
+        throw std::runtime_error("slow stats failed");
+      });
+  scheduler.start();
+  EXPECT_TRUE(scheduler.isRunning());
+  // A failing class does not hold back the others
+  fastCollected.wait();
+  slowCollected.wait();
+  scheduler.stop();
+  EXPECT_FALSE(scheduler.isRunning());
+
+  auto fastInterval = scheduler.getInterval("fast");
+  ASSERT_TRUE(fastInterval.has_value());
+  EXPECT_LE(*fastInterval, milliseconds(4));
+  EXPECT_EQ(std::nullopt, scheduler.getInterval("unknown"));
+  EXPECT_TRUE(fbData->hasCounter("test.hw_stats_collection.fast.interval_ms"));
+  EXPECT_TRUE(fbData->hasCounter("test.hw_stats_collection.idle.interval_ms"));
+}
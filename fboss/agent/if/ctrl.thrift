@@ -639,6 +639,49 @@ struct MplsRouteUpdateLoggingInfo {
   2: string identifier;
 }
 
+/*
+ * Time a state update spent in each stage of the update thread. Updates
+ * coalesced into one batch share the batch stages, i.e. validation,
+ * hwProgramming, stateObservers and fsdbSync.
+ */
+struct StateUpdateTrace {
+  1: string name;
+  // When the update was queued, ms since epoch
+  2: i64 enqueuedAtMs;
+  3: i64 queueWaitUs;
+  4: i64 applyUpdateUs;
+  5: i64 validationUs;
+  6: i64 hwProgrammingUs;
+  7: i64 stateObserversUs;
+  8: i64 fsdbSyncUs;
+  // From being queued to the end of its batch
+  9: i64 totalUs;
+  // Number of updates in the batch, including this one
+  10: i32 batchSize;
+  // The update function threw, or the batch failed to apply to HW
+  11: bool failed;
+}
+
+/*
+ * Estimated memory held by switch state nodes. bytes and nodes count whole
+ * subtrees, uniqueBytes and uniqueNodes leave out the subtrees shared with
+ * the parts of the state accounted before.
+ */
+struct StateMemoryUsageEntry {
+  1: i64 bytes;
+  2: i64 uniqueBytes;
+  3: i64 nodes;
+  4: i64 uniqueNodes;
+}
+
+struct StateMemoryUsage {
+  1: StateMemoryUsageEntry total;
+  // Subtrees by path, e.g. "/portMaps" or "/portMaps/id=0"
+  2: map<string, StateMemoryUsageEntry> byPath;
+  // Unique nodes by node type
+  3: map<string, StateMemoryUsageEntry> byType;
+}
+
 /*
  * Information about an LLDP neighbor
  */
@@ -1376,6 +1419,22 @@ service FbossCtrl extends phy.FbossCommonPhyCtrl {
   void stopLoggingAnyMplsRouteUpdates(1: string identifier);
   list<MplsRouteUpdateLoggingInfo> getMplsRouteUpdateLoggingTrackedLabels();
 
+  /*
+   * Latency traces of the last count state updates, most recent first
+   */
+  list<StateUpdateTrace> getStateUpdateTraces(1: i32 count) throws (
+    1: fboss.FbossBaseError error,
+  );
+
+  /*
+   * Estimated memory held by the current switch state, by node type and by
+   * path, for the paths at most pathDepth levels deep. Shared subtrees are
+   * counted once.
+   */
+  StateMemoryUsage getSwitchStateMemoryUsage(1: i32 pathDepth) throws (
+    1: fboss.FbossBaseError error,
+  );
+
   void keepalive();
 
   i32 getIdleTimeout() throws (1: fboss.FbossBaseError error);
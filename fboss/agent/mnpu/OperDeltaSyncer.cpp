@@ -153,6 +153,8 @@ fsdb::OperDelta OperDeltaSyncer::processFullOperDelta(
   for (const auto& operDelta : *stateOperDelta.operDeltas()) {
     auto currentStateDelta = StateDelta(oldState, operDelta);
     deltas.emplace_back(prevState, currentStateDelta.newState());
+    // the full state is rebuilt, compare the nodes by their content hashes
+    deltas.back().primeContentHashes();
     oldState = deltas.back().newState();
     prevState = deltas.back().newState();
   }
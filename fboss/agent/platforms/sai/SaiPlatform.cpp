@@ -315,6 +315,7 @@ void SaiPlatform::initSaiProfileValues() {
 
 void SaiPlatform::initImpl(uint32_t hwFeaturesDesired) {
   initSaiProfileValues();
+  SaiApiLock::getInstance()->setLockDomains(getSaiApiLockDomains());
   SaiApiTable::getInstance()->queryApis(
       getServiceMethodTable(), getSupportedApiList());
   saiSwitch_ = std::make_unique<SaiSwitch>(this, hwFeaturesDesired);
@@ -1063,6 +1064,10 @@ const std::set<sai_api_t>& SaiPlatform::getSupportedApiList() const {
   return getDefaultSwitchAsicSupportedApis();
 }
 
+std::vector<SaiApiLockDomain> SaiPlatform::getSaiApiLockDomains() const {
+  return SaiApiLock::parseLockDomains(FLAGS_sai_api_lock_domains);
+}
+
 void SaiPlatform::stateChanged(const StateDelta& delta) {
   updatePorts(delta);
 }
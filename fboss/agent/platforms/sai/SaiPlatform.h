@@ -17,6 +17,7 @@
 #include "fboss/agent/platforms/tests/utils/TestPlatformTypes.h"
 #include "fboss/lib/platforms/PlatformProductInfo.h"
 
+#include "fboss/agent/hw/sai/api/SaiApiLock.h"
 #include "fboss/agent/hw/sai/api/SaiVersion.h"
 #include "fboss/agent/hw/sai/api/SwitchApi.h"
 #include "fboss/agent/hw/sai/api/Types.h"
@@ -126,6 +127,14 @@ class SaiPlatform : public Platform, public StateObserver {
   const std::set<sai_api_t>& getDefaultPhyAsicSupportedApis() const;
   virtual const std::set<sai_api_t>& getSupportedApiList() const;
 
+  /*
+   * SAI APIs that the vendor SDK of this platform can run concurrently
+   * with the rest, each serialized only by the lock of its domain. By
+   * default, all SAI APIs are serialized by a single lock unless
+   * --sai_api_lock_domains says otherwise.
+   */
+  virtual std::vector<SaiApiLockDomain> getSaiApiLockDomains() const;
+
   virtual const std::unordered_map<std::string, std::string>
   getSaiProfileVendorExtensionValues() const {
     return std::unordered_map<std::string, std::string>();
@@ -43,6 +43,24 @@ StateDelta ribToSwitchStateUpdate(
   return StateDelta(lastDelta->oldState(), *switchState);
 }
 
+StateDelta multiVrfRibToSwitchStateUpdate(
+    const SwitchIdScopeResolver* resolver,
+    const std::vector<VrfNetworkToRouteMaps>& vrfRouteMaps,
+    const NextHopIDManager* nextHopIDManager,
+    const MySidTable& mySidTable,
+    void* cookie) {
+  RibToSwitchStateUpdater ribToSwitchStateUpdater(
+      resolver, vrfRouteMaps, nextHopIDManager, mySidTable);
+
+  auto switchState =
+      static_cast<std::shared_ptr<facebook::fboss::SwitchState>*>(cookie);
+  *switchState = ribToSwitchStateUpdater(*switchState);
+  (*switchState)->publish();
+  auto lastDelta = ribToSwitchStateUpdater.getLastDelta();
+  CHECK(lastDelta.has_value());
+  return StateDelta(lastDelta->oldState(), *switchState);
+}
+
 StateDelta noopFibUpdate(
     const SwitchIdScopeResolver* /*resolver*/,
     facebook::fboss::RouterID /*vrf*/,
@@ -16,6 +16,7 @@
 #include "fboss/agent/state/StateDelta.h"
 
 #include <memory>
+#include <vector>
 
 namespace facebook::fboss {
 
@@ -32,6 +33,13 @@ StateDelta ribToSwitchStateUpdate(
     const MySidTable& mySidTable,
     void* cookie);
 
+StateDelta multiVrfRibToSwitchStateUpdate(
+    const SwitchIdScopeResolver* resolver,
+    const std::vector<VrfNetworkToRouteMaps>& vrfRouteMaps,
+    const NextHopIDManager* nextHopIDManager,
+    const MySidTable& mySidTable,
+    void* cookie);
+
 StateDelta noopFibUpdate(
     const SwitchIdScopeResolver* resolver,
     RouterID vrf,
@@ -22,9 +22,16 @@
 #include "fboss/agent/state/SwitchState.h"
 
 #include <algorithm>
+#include <optional>
 
 #include <folly/logging/xlog.h>
 
+DEFINE_bool(
+    incremental_fib_update,
+    false,
+    "Build the FIBs of a VRF from the prefixes whose routes changed since "
+    "the previous FIB build, rather than from a walk of the whole RIB");
+
 namespace facebook::fboss {
 
 ForwardingInformationBaseUpdater::ForwardingInformationBaseUpdater(
@@ -33,11 +40,38 @@ ForwardingInformationBaseUpdater::ForwardingInformationBaseUpdater(
     const IPv4NetworkToRouteMap& v4NetworkToRoute,
     const IPv6NetworkToRouteMap& v6NetworkToRoute,
     const LabelToRouteMap& labelToRoute)
-    : resolver_(resolver),
-      vrf_(vrf),
-      v4NetworkToRoute_(v4NetworkToRoute),
-      v6NetworkToRoute_(v6NetworkToRoute),
-      labelToRoute_(labelToRoute) {}
+    : ForwardingInformationBaseUpdater(
+          resolver,
+          {{vrf, &v4NetworkToRoute, &v6NetworkToRoute, &labelToRoute}}) {}
+
+ForwardingInformationBaseUpdater::ForwardingInformationBaseUpdater(
+    const SwitchIdScopeResolver* resolver,
+    std::vector<VrfNetworkToRouteMaps> vrfRouteMaps)
+    : resolver_(resolver), vrfRouteMaps_(std::move(vrfRouteMaps)) {}
+
+std::shared_ptr<ForwardingInformationBaseContainer>
+ForwardingInformationBaseUpdater::getOrCreateFibContainer(
+    RouterID vrf,
+    std::shared_ptr<SwitchState>* state) const {
+  auto fibContainer = (*state)->getFibsInfoMap()->getFibContainerIf(vrf);
+  if (fibContainer) {
+    return fibContainer;
+  }
+  auto fibInfoMap = (*state)->getFibsInfoMap()->modify(state);
+
+  fibContainer = std::make_shared<ForwardingInformationBaseContainer>(vrf);
+
+  auto scope = resolver_->scope(fibContainer);
+  auto fibInfo = fibInfoMap->getFibInfo(scope);
+  if (!fibInfo) {
+    fibInfo = std::make_shared<FibInfo>();
+    fibInfoMap->addNode(scope.matcherString(), fibInfo);
+  }
+
+  // Update the container through FibInfo
+  fibInfo->updateFibContainer(fibContainer, state);
+  return fibContainer;
+}
 
 std::shared_ptr<SwitchState> ForwardingInformationBaseUpdater::operator()(
     const std::shared_ptr<SwitchState>& state) {
@@ -48,66 +82,139 @@ std::shared_ptr<SwitchState> ForwardingInformationBaseUpdater::operator()(
   // than on its two children (namely ForwardingInformationBaseV4 and
   // ForwardingInformationBaseV6) in succession.
   // Unlike the coupled RIB implementation, we need only update the
-  // SwitchState for a single VRF.
+  // SwitchState for the VRFs we were handed.
   std::shared_ptr<SwitchState> nextState(state);
 
-  auto previousFibContainer =
-      nextState->getFibsInfoMap()->getFibContainerIf(vrf_);
-  if (!previousFibContainer) {
-    auto fibInfoMap = nextState->getFibsInfoMap()->modify(&nextState);
-
-    previousFibContainer =
-        std::make_shared<ForwardingInformationBaseContainer>(vrf_);
+  std::vector<std::shared_ptr<ForwardingInformationBaseContainer>>
+      previousFibContainers;
+  previousFibContainers.reserve(vrfRouteMaps_.size());
+  for (const auto& vrfRouteMaps : vrfRouteMaps_) {
+    previousFibContainers.push_back(
+        getOrCreateFibContainer(vrfRouteMaps.vrf, &nextState));
+    CHECK(previousFibContainers.back());
+  }
 
-    auto scope = resolver_->scope(previousFibContainer);
-    auto fibInfo = fibInfoMap->getFibInfo(scope);
-    if (!fibInfo) {
-      fibInfo = std::make_shared<FibInfo>();
-      fibInfoMap->addNode(scope.matcherString(), fibInfo);
+  // Building a FIB only reads the RIB and the previous FIB, so each VRF and
+  // address family is built independently. Task 2i builds the v4 FIB of
+  // VRF i and task 2i + 1 its v6 FIB.
+  std::vector<std::shared_ptr<ForwardingInformationBaseV4>> newFibsV4(
+      vrfRouteMaps_.size());
+  std::vector<std::shared_ptr<ForwardingInformationBaseV6>> newFibsV6(
+      vrfRouteMaps_.size());
+  runRibVrfUpdateTasks(2 * vrfRouteMaps_.size(), [&](size_t task) {
+    auto idx = task / 2;
+    if (task % 2 == 0) {
+      newFibsV4[idx] = createUpdatedFib(
+          *vrfRouteMaps_[idx].v4NetworkToRoute,
+          previousFibContainers[idx]->getFibV4());
+    } else {
+      newFibsV6[idx] = createUpdatedFib(
+          *vrfRouteMaps_[idx].v6NetworkToRoute,
+          previousFibContainers[idx]->getFibV6());
     }
+  });
 
-    // Update the container through FibInfo
-    fibInfo->updateFibContainer(previousFibContainer, &nextState);
-  }
-  CHECK(previousFibContainer);
+  for (size_t idx = 0; idx < vrfRouteMaps_.size(); ++idx) {
+    // The label FIB is shared by all VRFs, so build it against the state
+    // left by the previous VRF, as separate per VRF updates would
+    auto newLabelFib = createUpdatedLabelFib(
+        *vrfRouteMaps_[idx].labelToRoute,
+        nextState->getLabelForwardingInformationBase());
 
-  auto newFibV4 = createUpdatedFib(
-      v4NetworkToRoute_, previousFibContainer->getFibV4(), nextState);
+    if (!newFibsV4[idx] && !newFibsV6[idx] && !newLabelFib) {
+      // nextState may still differ from state if we inserted a new VRF above
+      continue;
+    }
+    auto nextFibContainer = previousFibContainers[idx]->modify(&nextState);
 
-  auto newFibV6 = createUpdatedFib(
-      v6NetworkToRoute_, previousFibContainer->getFibV6(), nextState);
+    if (newFibsV4[idx]) {
+      nextFibContainer->ref<switch_state_tags::fibV4>() =
+          std::move(newFibsV4[idx]);
+    }
 
-  auto newLabelFib = createUpdatedLabelFib(
-      labelToRoute_, state->getLabelForwardingInformationBase());
+    if (newFibsV6[idx]) {
+      nextFibContainer->ref<switch_state_tags::fibV6>() =
+          std::move(newFibsV6[idx]);
+    }
 
-  if (!newFibV4 && !newFibV6 && !newLabelFib) {
-    // return nextState in case we modified state above to insert new VRF
-    return nextState;
+    if (newLabelFib) {
+      nextState->resetLabelForwardingInformationBase(newLabelFib);
+    }
   }
-  auto nextFibContainer = previousFibContainer->modify(&nextState);
 
-  if (newFibV4) {
-    nextFibContainer->ref<switch_state_tags::fibV4>() = std::move(newFibV4);
-  }
+  return nextState;
+}
 
-  if (newFibV6) {
-    nextFibContainer->ref<switch_state_tags::fibV6>() = std::move(newFibV6);
+template <typename AddressT>
+std::shared_ptr<typename facebook::fboss::ForwardingInformationBase<AddressT>>
+ForwardingInformationBaseUpdater::createUpdatedFib(
+    const facebook::fboss::NetworkToRouteMap<AddressT>& rib,
+    const std::shared_ptr<facebook::fboss::ForwardingInformationBase<AddressT>>&
+        fib) {
+  std::optional<std::vector<RoutePrefix<AddressT>>> changedPrefixes;
+  if (FLAGS_incremental_fib_update) {
+    changedPrefixes = rib.getFibChangesSince(fib);
   }
+  auto updatedFib = changedPrefixes
+      ? createIncrementallyUpdatedFib(rib, fib, *changedPrefixes)
+      : createUpdatedFibFromRib(rib, fib);
+  // The next build can start from the FIB built here
+  rib.recordFibBuild(updatedFib ? updatedFib : fib);
+  return updatedFib;
+}
 
-  if (newLabelFib) {
-    nextState->resetLabelForwardingInformationBase(newLabelFib);
+template <typename AddressT>
+std::shared_ptr<typename facebook::fboss::ForwardingInformationBase<AddressT>>
+ForwardingInformationBaseUpdater::createIncrementallyUpdatedFib(
+    const facebook::fboss::NetworkToRouteMap<AddressT>& rib,
+    const std::shared_ptr<facebook::fboss::ForwardingInformationBase<AddressT>>&
+        fib,
+    const std::vector<RoutePrefix<AddressT>>& changedPrefixes) {
+  // fib was built from the RIB as it was before these prefixes changed, no
+  // other FIB entry can differ
+  std::shared_ptr<ForwardingInformationBase<AddressT>> updatedFib;
+  for (const auto& prefix : changedPrefixes) {
+    auto key = prefix.str();
+    auto fibRoute = fib->getNodeIf(key);
+    std::shared_ptr<Route<AddressT>> ribRoute;
+    auto ritr = rib.exactMatch(prefix.network(), prefix.mask());
+    // The recursive resolution algorithm considers a next-hop TO_CPU or
+    // DROP to be resolved.
+    if (ritr != rib.end() && ritr->value()->isResolved()) {
+      ribRoute = ritr->value();
+    }
+    if (fibRoute == ribRoute ||
+        (fibRoute && ribRoute && fibRoute->isSame(ribRoute.get()))) {
+      // Pointer or contents are same
+      continue;
+    }
+    if (!updatedFib) {
+      updatedFib = fib->clone();
+    }
+    if (!ribRoute) {
+      // Deleted or no longer resolved
+      updatedFib->removeNode(key);
+      continue;
+    }
+    CHECK(ribRoute->isPublished());
+    if (fibRoute) {
+      updatedFib->updateNode(key, ribRoute);
+    } else {
+      updatedFib->addNode(key, ribRoute);
+    }
   }
-
-  return nextState;
+  XLOG(DBG3) << "Incremental FIB update: " << changedPrefixes.size()
+             << " changed prefixes, FIB " << (updatedFib ? "" : "not ")
+             << "updated";
+  return updatedFib;
 }
 
 template <typename AddressT>
 std::shared_ptr<typename facebook::fboss::ForwardingInformationBase<AddressT>>
-ForwardingInformationBaseUpdater::createUpdatedFib(
+ForwardingInformationBaseUpdater::createUpdatedFibFromRib(
     const facebook::fboss::NetworkToRouteMap<AddressT>& rib,
     const std::shared_ptr<facebook::fboss::ForwardingInformationBase<AddressT>>&
-        fib,
-    std::shared_ptr<SwitchState>& state) {
+        fib) {
   typename facebook::fboss::ForwardingInformationBase<
       AddressT>::Base::NodeContainer updatedFib;
 
@@ -16,10 +16,16 @@
 #include "fboss/agent/state/RouteTypes.h"
 #include "fboss/agent/types.h"
 
+#include <gflags/gflags.h>
+
 #include <memory>
+#include <vector>
+
+DECLARE_bool(incremental_fib_update);
 
 namespace facebook::fboss {
 
+class ForwardingInformationBaseContainer;
 class SwitchState;
 class SwitchIdScopeResolver;
 
@@ -32,31 +38,56 @@ class ForwardingInformationBaseUpdater {
       const IPv6NetworkToRouteMap& v6NetworkToRoute,
       const LabelToRouteMap& labelToRoute);
 
+  /*
+   * Update the FIBs of several VRFs in one pass. FIBs are built on the RIB
+   * VRF update worker pool (see --rib_vrf_update_threads) when there is one,
+   * and then applied to the SwitchState in the order given.
+   */
+  ForwardingInformationBaseUpdater(
+      const SwitchIdScopeResolver* resolver,
+      std::vector<VrfNetworkToRouteMaps> vrfRouteMaps);
+
   std::shared_ptr<SwitchState> operator()(
       const std::shared_ptr<SwitchState>& state);
 
  private:
   /*
-   * Return updated FIB on change, null otherwise
+   * Return updated FIB on change, null otherwise. Only the prefixes the RIB
+   * logged as changed since fib got built are looked at, if it has such a
+   * log (see NetworkToRouteMap::getFibChangesSince()), the whole RIB
+   * otherwise.
    */
   template <typename AddressT>
   std::shared_ptr<typename facebook::fboss::ForwardingInformationBase<AddressT>>
   createUpdatedFib(
+      const facebook::fboss::NetworkToRouteMap<AddressT>& rib,
+      const std::shared_ptr<
+          facebook::fboss::ForwardingInformationBase<AddressT>>& fib);
+  template <typename AddressT>
+  std::shared_ptr<typename facebook::fboss::ForwardingInformationBase<AddressT>>
+  createIncrementallyUpdatedFib(
       const facebook::fboss::NetworkToRouteMap<AddressT>& rib,
       const std::shared_ptr<
           facebook::fboss::ForwardingInformationBase<AddressT>>& fib,
-      std::shared_ptr<SwitchState>& state);
+      const std::vector<RoutePrefix<AddressT>>& changedPrefixes);
+  template <typename AddressT>
+  std::shared_ptr<typename facebook::fboss::ForwardingInformationBase<AddressT>>
+  createUpdatedFibFromRib(
+      const facebook::fboss::NetworkToRouteMap<AddressT>& rib,
+      const std::shared_ptr<
+          facebook::fboss::ForwardingInformationBase<AddressT>>& fib);
   std::shared_ptr<facebook::fboss::MultiLabelForwardingInformationBase>
   createUpdatedLabelFib(
       const facebook::fboss::NetworkToRouteMap<LabelID>& rib,
       std::shared_ptr<facebook::fboss::MultiLabelForwardingInformationBase>
           fib);
 
+  std::shared_ptr<ForwardingInformationBaseContainer> getOrCreateFibContainer(
+      RouterID vrf,
+      std::shared_ptr<SwitchState>* state) const;
+
   const SwitchIdScopeResolver* resolver_;
-  RouterID vrf_;
-  const IPv4NetworkToRouteMap& v4NetworkToRoute_;
-  const IPv6NetworkToRouteMap& v6NetworkToRoute_;
-  const LabelToRouteMap& labelToRoute_;
+  std::vector<VrfNetworkToRouteMaps> vrfRouteMaps_;
 };
 
 } // namespace facebook::fboss
@@ -12,12 +12,16 @@
 #include "fboss/agent/state/Route.h"
 #include "fboss/agent/types.h"
 #include "fboss/lib/RadixTree.h"
+#include "fboss/lib/RadixTreeSlabAllocator.h"
 
 #include <folly/IPAddress.h>
+#include <folly/Synchronized.h>
 #include <folly/json/dynamic.h>
 #include <gflags/gflags.h>
 
+#include <map>
 #include <memory>
+#include <optional>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -26,6 +30,9 @@ DECLARE_bool(enable_nexthop_id_manager);
 
 namespace facebook::fboss {
 
+template <typename AddrT>
+class ForwardingInformationBase;
+
 template <typename AddressT>
 struct NetworkToRouteMapThriftType {
   using KeyType = std::
@@ -37,20 +44,32 @@ struct NetworkToRouteMapThriftType {
   using type = std::map<KeyType, ValueType>;
 };
 
+template <typename AddressT>
+using RouteRadixTreeNode = facebook::network::
+    RadixTreeNode<AddressT, std::shared_ptr<Route<AddressT>>>;
+
+// Route trees hold up to millions of nodes, allocate them from slabs
+template <typename AddressT>
+using RouteRadixTree = facebook::network::RadixTree<
+    AddressT,
+    std::shared_ptr<Route<AddressT>>,
+    facebook::network::
+        RadixTreeTraits<AddressT, std::shared_ptr<Route<AddressT>>>,
+    facebook::network::RadixTreeSlabAllocator<RouteRadixTreeNode<AddressT>>>;
+
 template <typename AddressT>
 class NetworkToRouteMap
     : public std::conditional_t<
           std::is_same_v<LabelID, AddressT>,
           std::unordered_map<LabelID, std::shared_ptr<Route<LabelID>>>,
-          facebook::network::
-              RadixTree<AddressT, std::shared_ptr<Route<AddressT>>>> {
+          RouteRadixTree<AddressT>> {
   static constexpr auto kRoutes = "routes";
 
  public:
   using Base = std::conditional_t<
       std::is_same_v<LabelID, AddressT>,
       std::unordered_map<LabelID, std::shared_ptr<Route<LabelID>>>,
-      facebook::network::RadixTree<AddressT, std::shared_ptr<Route<AddressT>>>>;
+      RouteRadixTree<AddressT>>;
   using Base::Base;
   /* implicit */ NetworkToRouteMap(Base&& radixTree)
       : Base(std::move(radixTree)) {}
@@ -59,11 +78,12 @@ class NetworkToRouteMap
   using Iterator = std::conditional_t<
       std::is_same_v<LabelID, AddressT>,
       std::unordered_map<LabelID, std::shared_ptr<Route<LabelID>>>::iterator,
-      typename facebook::network::
-          RadixTree<AddressT, std::shared_ptr<Route<AddressT>>>::Iterator>;
+      typename RouteRadixTree<AddressT>::Iterator>;
   using ThriftType = typename NetworkToRouteMapThriftType<AddressT>::type;
   using RouteFilter =
       std::function<bool(const std::shared_ptr<Route<AddressT>>&)>;
+  using Prefix = typename Route<AddressT>::Prefix;
+  using Fib = ForwardingInformationBase<AddressT>;
 
   std::pair<Iterator, bool> insert(
       typename Route<AddressT>::Prefix key,
@@ -87,6 +107,60 @@ class NetworkToRouteMap
     forAll([](auto& ritr) { ritr.value()->publish(); });
   }
 
+  /*
+   * Log of the prefixes whose route changed, so that a FIB build only has to
+   * revisit those changed since the FIB it starts from was built. Entries
+   * carry the generation they were logged at.
+   *
+   * Builds run under the RIB read lock and only record which FIB they built
+   * at which generation (recordFibBuild()). The log itself only changes
+   * under the RIB write lock: restartFibChanges() drops what the last
+   * recorded build already covers. A build starting from any FIB but the
+   * last recorded one (e.g. one rolled back to) walks the whole map.
+   * Changing routes without logging them requires invalidateFibChanges().
+   */
+  void logFibChange(const Prefix& prefix) {
+    fibChanges_[prefix] = ++fibChangesGeneration_;
+  }
+  void invalidateFibChanges() {
+    fibChangesInvalidatedAt_ = ++fibChangesGeneration_;
+    fibChanges_.clear();
+    *lastFibBuild_.wlock() = std::nullopt;
+  }
+  void restartFibChanges() {
+    auto lastFibBuild = lastFibBuild_.copy();
+    if (!lastFibBuild) {
+      return;
+    }
+    for (auto it = fibChanges_.begin(); it != fibChanges_.end();) {
+      if (it->second <= lastFibBuild->generation) {
+        it = fibChanges_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  // Prefixes changed since fib was built, nullopt if the log doesn't hold
+  std::optional<std::vector<Prefix>> getFibChangesSince(
+      const std::shared_ptr<Fib>& fib) const {
+    auto lastFibBuild = lastFibBuild_.copy();
+    if (!lastFibBuild || lastFibBuild->fib.lock() != fib ||
+        lastFibBuild->generation < fibChangesInvalidatedAt_) {
+      return std::nullopt;
+    }
+    std::vector<Prefix> changed;
+    for (const auto& [prefix, generation] : fibChanges_) {
+      if (generation > lastFibBuild->generation) {
+        changed.push_back(prefix);
+      }
+    }
+    return changed;
+  }
+  // fib was just built from the map as it is now, callable concurrently
+  void recordFibBuild(const std::shared_ptr<Fib>& fib) const {
+    *lastFibBuild_.wlock() = FibBuild{fib, fibChangesGeneration_};
+  }
+
   ThriftType toThrift() const {
     return toFilteredThrift([](const auto&) { return true; });
   }
@@ -118,36 +192,62 @@ class NetworkToRouteMap
   static NetworkToRouteMap<AddressT> fromThrift(const ThriftType& routes) {
     NetworkToRouteMap<AddressT> networkToRouteMap;
     for (auto& obj : routes) {
-      auto route = std::make_shared<Route<AddressT>>(obj.second);
-      // TODO: remove once enable_nexthop_id_manager is permanently on.
-      // Flag-OFF means no IDs can be stamped, so any ID here is stale
-      // from a prior flag-ON era. Wipe before a flag-OFF runtime sees it.
-      if (!FLAGS_enable_nexthop_id_manager) {
-        std::vector<std::pair<ClientID, RouteNextHopEntry>> updates;
-        std::optional<NextHopSetID> nullId;
-        for (const auto& [clientId, entry] :
-             std::as_const(route->getEntryForClients())) {
-          if (entry->getClientNextHopSetID().has_value()) {
-            RouteNextHopEntry newEntry(entry->toThrift());
-            newEntry.setClientNextHopSetID(nullId);
-            updates.emplace_back(clientId, std::move(newEntry));
-          }
-        }
-        for (auto& [clientId, newEntry] : updates) {
-          route->update(clientId, newEntry);
-        }
-      }
+      auto route = routeFromThrift(obj.second);
       auto key = route->prefix();
       networkToRouteMap.insert(key, route);
     }
     return networkToRouteMap;
   }
+
+  // Route as restored from warm boot state
+  static std::shared_ptr<RouteT> routeFromThrift(
+      const typename ThriftType::mapped_type& obj) {
+    auto route = std::make_shared<RouteT>(obj);
+    // TODO: remove once enable_nexthop_id_manager is permanently on.
+    // Flag-OFF means no IDs can be stamped, so any ID here is stale
+    // from a prior flag-ON era. Wipe before a flag-OFF runtime sees it.
+    if (!FLAGS_enable_nexthop_id_manager) {
+      std::vector<std::pair<ClientID, RouteNextHopEntry>> updates;
+      std::optional<NextHopSetID> nullId;
+      for (const auto& [clientId, entry] :
+           std::as_const(route->getEntryForClients())) {
+        if (entry->getClientNextHopSetID().has_value()) {
+          RouteNextHopEntry newEntry(entry->toThrift());
+          newEntry.setClientNextHopSetID(nullId);
+          updates.emplace_back(clientId, std::move(newEntry));
+        }
+      }
+      for (auto& [clientId, newEntry] : updates) {
+        route->update(clientId, newEntry);
+      }
+    }
+    return route;
+  }
+
+ private:
+  struct FibBuild {
+    std::weak_ptr<Fib> fib;
+    uint64_t generation{0};
+  };
+  std::map<Prefix, uint64_t> fibChanges_;
+  uint64_t fibChangesGeneration_{0};
+  uint64_t fibChangesInvalidatedAt_{0};
+  // Builds record themselves under the RIB read lock, hence synchronized
+  mutable folly::Synchronized<std::optional<FibBuild>> lastFibBuild_;
 };
 
 using IPv4NetworkToRouteMap = NetworkToRouteMap<folly::IPAddressV4>;
 using IPv6NetworkToRouteMap = NetworkToRouteMap<folly::IPAddressV6>;
 using LabelToRouteMap = NetworkToRouteMap<LabelID>;
 
+// Route maps of a single VRF, as handed to a FIB update spanning VRFs
+struct VrfNetworkToRouteMaps {
+  RouterID vrf;
+  const IPv4NetworkToRouteMap* v4NetworkToRoute;
+  const IPv6NetworkToRouteMap* v6NetworkToRoute;
+  const LabelToRouteMap* labelToRoute;
+};
+
 template <typename AddrT>
 std::shared_ptr<Route<AddrT>>& value(
     typename NetworkToRouteMap<AddrT>::Iterator& iter) {
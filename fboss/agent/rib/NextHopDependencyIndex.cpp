@@ -0,0 +1,140 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/rib/NextHopDependencyIndex.h"
+
+#include <algorithm>
+
+namespace facebook::fboss {
+
+namespace {
+// Highest address inside network/mask
+folly::IPAddressV4 lastAddressInSubnet(
+    const folly::IPAddressV4& network,
+    uint8_t mask) {
+  uint32_t hostBits = mask == 0 ? 0xffffffff : ((1u << (32 - mask)) - 1);
+  return folly::IPAddressV4::fromLongHBO(network.toLongHBO() | hostBits);
+}
+
+folly::IPAddressV6 lastAddressInSubnet(
+    const folly::IPAddressV6& network,
+    uint8_t mask) {
+  auto bytes = network.toByteArray();
+  for (int bit = mask; bit < 128; ++bit) {
+    bytes[bit / 8] |= (0x80 >> (bit % 8));
+  }
+  return folly::IPAddressV6(bytes);
+}
+
+template <typename AddrT, typename NextHopToSets>
+void collectNextHopSets(
+    const NextHopToSets& nexthopToSets,
+    const AddrT& addr,
+    uint8_t mask,
+    std::set<const NextHopDependencyIndex::NextHopAddresses*>& sets) {
+  auto network = addr.mask(mask);
+  auto last = lastAddressInSubnet(network, mask);
+  for (auto it = nexthopToSets.lower_bound(network);
+       it != nexthopToSets.end() && it->first <= last;
+       ++it) {
+    sets.insert(it->second.begin(), it->second.end());
+  }
+}
+} // namespace
+
+void NextHopDependencyIndex::invalidate() {
+  routeToNextHops_.clear();
+  nextHopsToRoutes_.clear();
+  v4NextHopToSets_.clear();
+  v6NextHopToSets_.clear();
+  valid_ = false;
+}
+
+void NextHopDependencyIndex::setNextHops(
+    const RouteKey& route,
+    NextHopAddresses nexthops) {
+  std::sort(nexthops.begin(), nexthops.end());
+  nexthops.erase(std::unique(nexthops.begin(), nexthops.end()), nexthops.end());
+  auto routeItr = routeToNextHops_.find(route);
+  if (routeItr != routeToNextHops_.end() && *routeItr->second == nexthops) {
+    return;
+  }
+  removeRoute(route);
+  if (nexthops.empty()) {
+    return;
+  }
+  auto [setItr, inserted] = nextHopsToRoutes_.try_emplace(std::move(nexthops));
+  setItr->second.insert(route);
+  const auto* nexthopSet = &setItr->first;
+  routeToNextHops_.emplace(route, nexthopSet);
+  if (!inserted) {
+    return;
+  }
+  for (const auto& nexthop : *nexthopSet) {
+    if (nexthop.isV4()) {
+      v4NextHopToSets_[nexthop.asV4()].insert(nexthopSet);
+    } else {
+      v6NextHopToSets_[nexthop.asV6()].insert(nexthopSet);
+    }
+  }
+}
+
+void NextHopDependencyIndex::removeRoute(const RouteKey& route) {
+  auto routeItr = routeToNextHops_.find(route);
+  if (routeItr == routeToNextHops_.end()) {
+    return;
+  }
+  const auto* nexthopSet = routeItr->second;
+  routeToNextHops_.erase(routeItr);
+  auto setItr = nextHopsToRoutes_.find(*nexthopSet);
+  CHECK(setItr != nextHopsToRoutes_.end());
+  setItr->second.erase(route);
+  if (setItr->second.empty()) {
+    removeNextHopSet(setItr->first);
+    nextHopsToRoutes_.erase(setItr);
+  }
+}
+
+void NextHopDependencyIndex::removeNextHopSet(
+    const NextHopAddresses& nexthops) {
+  auto removeFrom = [&nexthops](auto& nexthopToSets, const auto& addr) {
+    auto it = nexthopToSets.find(addr);
+    if (it == nexthopToSets.end()) {
+      return;
+    }
+    it->second.erase(&nexthops);
+    if (it->second.empty()) {
+      nexthopToSets.erase(it);
+    }
+  };
+  for (const auto& nexthop : nexthops) {
+    if (nexthop.isV4()) {
+      removeFrom(v4NextHopToSets_, nexthop.asV4());
+    } else {
+      removeFrom(v6NextHopToSets_, nexthop.asV6());
+    }
+  }
+}
+
+std::set<const NextHopDependencyIndex::NextHopAddresses*>
+NextHopDependencyIndex::getNextHopSetsInSubnet(
+    const folly::CIDRNetwork& prefix) const {
+  std::set<const NextHopAddresses*> sets;
+  if (prefix.first.isV4()) {
+    collectNextHopSets(
+        v4NextHopToSets_, prefix.first.asV4(), prefix.second, sets);
+  } else {
+    collectNextHopSets(
+        v6NextHopToSets_, prefix.first.asV6(), prefix.second, sets);
+  }
+  return sets;
+}
+
+} // namespace facebook::fboss
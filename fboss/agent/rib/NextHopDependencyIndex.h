@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include "fboss/agent/types.h"
+
+#include <folly/IPAddress.h>
+#include <glog/logging.h>
+
+#include <map>
+#include <set>
+#include <variant>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * Reverse index from next hop address to the routes that need a longest
+ * prefix match on that address to get resolved.
+ *
+ * RibRouteUpdater uses this to find the routes whose resolution may change
+ * when a prefix is added, deleted or modified, so that it re-resolves only
+ * those instead of walking the whole route table.
+ *
+ * At scale, most routes share a handful of distinct next hop address sets
+ * (e.g. the BGP ECMP groups), so the index stores each distinct set once
+ * and maps sets (not individual addresses) to the routes using them. This
+ * keeps memory proportional to routes + distinct sets rather than
+ * routes * ECMP width.
+ *
+ * The index is only meaningful while every mutation to the route tables it
+ * describes goes through RibRouteUpdater. Code that rebuilds or otherwise
+ * modifies the route tables behind the updater's back (warm boot, rollback,
+ * config application) must invalidate() it. The next update then does a
+ * full resolution and rebuilds the index from scratch.
+ */
+class NextHopDependencyIndex {
+ public:
+  // A route depending on next hops: an IP prefix or an MPLS label
+  using RouteKey = std::variant<folly::CIDRNetwork, LabelID>;
+  using NextHopAddresses = std::vector<folly::IPAddress>;
+
+  bool isValid() const {
+    return valid_;
+  }
+  void markValid() {
+    valid_ = true;
+  }
+  // Drop all dependencies and mark the index as not tracking the route
+  // tables any more
+  void invalidate();
+
+  /*
+   * Record the next hop addresses `route` resolves through, replacing
+   * whatever was recorded for it before. An empty set of next hops removes
+   * the route from the index.
+   */
+  void setNextHops(const RouteKey& route, NextHopAddresses nexthops);
+  void removeRoute(const RouteKey& route);
+
+  /*
+   * Invoke fn(RouteKey) for every route having at least one next hop
+   * covered by `prefix`. These are the routes whose longest prefix match
+   * may land on (or move off) `prefix`.
+   */
+  template <typename Fn>
+  void forEachDependent(const folly::CIDRNetwork& prefix, const Fn& fn) const {
+    for (const auto* nexthops : getNextHopSetsInSubnet(prefix)) {
+      auto it = nextHopsToRoutes_.find(*nexthops);
+      DCHECK(it != nextHopsToRoutes_.end());
+      for (const auto& route : it->second) {
+        fn(route);
+      }
+    }
+  }
+
+  size_t numRoutes() const {
+    return routeToNextHops_.size();
+  }
+  size_t numNextHopSets() const {
+    return nextHopsToRoutes_.size();
+  }
+
+ private:
+  std::set<const NextHopAddresses*> getNextHopSetsInSubnet(
+      const folly::CIDRNetwork& prefix) const;
+  void removeNextHopSet(const NextHopAddresses& nexthops);
+
+  // Distinct next hop sets and the routes using them. Map nodes are stable,
+  // so the other members refer to the keys here by pointer.
+  std::map<NextHopAddresses, std::set<RouteKey>> nextHopsToRoutes_;
+  std::map<RouteKey, const NextHopAddresses*> routeToNextHops_;
+  std::map<folly::IPAddressV4, std::set<const NextHopAddresses*>>
+      v4NextHopToSets_;
+  std::map<folly::IPAddressV6, std::set<const NextHopAddresses*>>
+      v6NextHopToSets_;
+  bool valid_{false};
+};
+
+} // namespace facebook::fboss
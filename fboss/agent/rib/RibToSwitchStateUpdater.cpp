@@ -34,6 +34,17 @@ RibToSwitchStateUpdater::RibToSwitchStateUpdater(
       mySidUpdater_(resolver, mySidTable),
       nhopStateUpdater_(nextHopIDManager) {}
 
+RibToSwitchStateUpdater::RibToSwitchStateUpdater(
+    const SwitchIdScopeResolver* resolver,
+    std::vector<VrfNetworkToRouteMaps> vrfRouteMaps,
+    const NextHopIDManager* nextHopIDManager,
+    const MySidTable& mySidTable,
+    int actions)
+    : actions_(actions),
+      fibUpdater_(resolver, std::move(vrfRouteMaps)),
+      mySidUpdater_(resolver, mySidTable),
+      nhopStateUpdater_(nextHopIDManager) {}
+
 std::shared_ptr<SwitchState> RibToSwitchStateUpdater::operator()(
     const std::shared_ptr<SwitchState>& state) {
   auto nextState = state;
@@ -17,6 +17,7 @@
 
 #include <memory>
 #include <optional>
+#include <vector>
 
 namespace facebook::fboss {
 
@@ -46,6 +47,14 @@ class RibToSwitchStateUpdater {
       const MySidTable& mySidTable,
       int actions = UPDATE_FIB | UPDATE_MYSID);
 
+  // Update the FIBs of several VRFs in one go
+  RibToSwitchStateUpdater(
+      const SwitchIdScopeResolver* resolver,
+      std::vector<VrfNetworkToRouteMaps> vrfRouteMaps,
+      const NextHopIDManager* nextHopIDManager,
+      const MySidTable& mySidTable,
+      int actions = UPDATE_FIB | UPDATE_MYSID);
+
   std::shared_ptr<SwitchState> operator()(
       const std::shared_ptr<SwitchState>& state);
 
@@ -0,0 +1,311 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/rib/RibWarmbootFile.h"
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/rib/NetworkToRouteMap.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <folly/Exception.h>
+#include <folly/FileUtil.h>
+#include <folly/hash/Checksum.h>
+#include <folly/lang/Bits.h>
+#include <folly/logging/xlog.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+#include <cstring>
+#include <limits>
+
+DEFINE_bool(
+    rib_warmboot_file_mmap,
+    true,
+    "Memory map the RIB warm boot file when loading it, rather than reading "
+    "it a chunk at a time");
+
+namespace facebook::fboss {
+
+namespace {
+
+using RecordType = RibWarmbootFile::RecordType;
+
+constexpr size_t kHeaderSize = sizeof(uint64_t) + sizeof(uint32_t);
+constexpr size_t kChunkHeaderSize = 2 * sizeof(uint32_t);
+constexpr size_t kRecordHeaderSize = sizeof(uint8_t) + sizeof(uint32_t);
+
+template <typename T>
+void appendLE(std::string& out, T v) {
+  T le = folly::Endian::little<T>(v);
+  out.append(reinterpret_cast<const char*>(&le), sizeof(le));
+}
+
+template <typename T>
+T pullLE(folly::ByteRange& range) {
+  T le;
+  std::memcpy(&le, range.data(), sizeof(le));
+  range.advance(sizeof(le));
+  return folly::Endian::little<T>(le);
+}
+
+template <typename ThriftT>
+ThriftT deserialize(folly::ByteRange body) {
+  ThriftT obj;
+  apache::thrift::CompactSerializer::deserialize(body, obj);
+  return obj;
+}
+
+} // namespace
+
+RibWarmbootFileWriter::RibWarmbootFileWriter(
+    std::string path,
+    size_t chunkSize)
+    : path_(std::move(path)),
+      tmpPath_(path_ + ".tmp"),
+      chunkSize_(chunkSize),
+      file_(tmpPath_, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) {
+  chunk_.reserve(chunkSize_ + kChunkHeaderSize);
+  std::string header;
+  appendLE(header, RibWarmbootFile::kMagic);
+  appendLE(header, RibWarmbootFile::kVersion);
+  writeFully(header);
+}
+
+RibWarmbootFileWriter::~RibWarmbootFileWriter() {
+  if (!finished_) {
+    // Abandoned half way, e.g. on an exception, leave nothing behind
+    file_.close();
+    ::unlink(tmpPath_.c_str());
+  }
+}
+
+void RibWarmbootFileWriter::startVrf(RouterID vrf) {
+  std::string body;
+  appendLE(body, static_cast<uint32_t>(vrf));
+  addRecord(
+      RecordType::VRF,
+      folly::ByteRange(
+          reinterpret_cast<const uint8_t*>(body.data()), body.size()));
+}
+
+void RibWarmbootFileWriter::addRoute(const Route<folly::IPAddressV4>& route) {
+  addThriftRecord(RecordType::V4_ROUTE, route.toThrift());
+}
+
+void RibWarmbootFileWriter::addRoute(const Route<folly::IPAddressV6>& route) {
+  addThriftRecord(RecordType::V6_ROUTE, route.toThrift());
+}
+
+void RibWarmbootFileWriter::addRoute(const Route<LabelID>& route) {
+  addThriftRecord(RecordType::MPLS_ROUTE, route.toThrift());
+}
+
+template <typename ThriftT>
+void RibWarmbootFileWriter::addThriftRecord(
+    RecordType type,
+    const ThriftT& obj) {
+  auto body = apache::thrift::CompactSerializer::serialize<std::string>(obj);
+  addRecord(
+      type,
+      folly::ByteRange(
+          reinterpret_cast<const uint8_t*>(body.data()), body.size()));
+  ++routesWritten_;
+}
+
+void RibWarmbootFileWriter::addRecord(RecordType type, folly::ByteRange body) {
+  CHECK(!finished_);
+  CHECK_LE(body.size(), std::numeric_limits<uint32_t>::max());
+  if (!chunk_.empty() && chunk_.size() + kRecordHeaderSize + body.size() >
+          chunkSize_ + kChunkHeaderSize) {
+    flushChunk();
+  }
+  if (chunk_.empty()) {
+    // Room for the chunk header, filled in on flush
+    chunk_.append(kChunkHeaderSize, '\0');
+  }
+  appendLE(chunk_, static_cast<uint8_t>(type));
+  appendLE(chunk_, static_cast<uint32_t>(body.size()));
+  chunk_.append(reinterpret_cast<const char*>(body.data()), body.size());
+}
+
+void RibWarmbootFileWriter::flushChunk() {
+  if (chunk_.empty()) {
+    return;
+  }
+  auto payload = reinterpret_cast<const uint8_t*>(chunk_.data()) +
+      kChunkHeaderSize;
+  auto length = chunk_.size() - kChunkHeaderSize;
+  CHECK_LE(length, std::numeric_limits<uint32_t>::max());
+  std::string header;
+  appendLE(header, static_cast<uint32_t>(length));
+  appendLE(header, folly::crc32c(payload, length));
+  std::memcpy(chunk_.data(), header.data(), header.size());
+  writeFully(chunk_);
+  chunk_.clear();
+}
+
+void RibWarmbootFileWriter::writeFully(const std::string& bytes) {
+  if (folly::writeFull(file_.fd(), bytes.data(), bytes.size()) < 0) {
+    throw FbossError("Failed to write RIB warm boot file ", tmpPath_);
+  }
+}
+
+void RibWarmbootFileWriter::finish() {
+  addRecord(RecordType::END, folly::ByteRange());
+  flushChunk();
+  if (::fsync(file_.fd()) != 0) {
+    throw FbossError("Failed to sync RIB warm boot file ", tmpPath_);
+  }
+  file_.close();
+  if (::rename(tmpPath_.c_str(), path_.c_str()) != 0) {
+    throw FbossError("Failed to move RIB warm boot file into ", path_);
+  }
+  finished_ = true;
+  XLOG(DBG2) << "Wrote " << routesWritten_ << " routes to " << path_;
+}
+
+RibWarmbootFileReader::RibWarmbootFileReader(
+    const std::string& path,
+    bool useMmap)
+    : path_(path), file_(path, O_RDONLY | O_CLOEXEC) {
+  struct stat st;
+  folly::checkUnixError(::fstat(file_.fd(), &st), "fstat ", path_);
+  fileSize_ = st.st_size;
+  if (fileSize_ < kHeaderSize) {
+    throw FbossError("RIB warm boot file ", path_, " is truncated");
+  }
+  uint8_t header[kHeaderSize];
+  if (useMmap) {
+    mapping_ = std::make_unique<folly::MemoryMapping>(file_.dup());
+    mapping_->hintLinearScan();
+    std::memcpy(header, mapping_->range().data(), kHeaderSize);
+  } else {
+    readFully(header, kHeaderSize);
+  }
+  folly::ByteRange range(header, kHeaderSize);
+  auto magic = pullLE<uint64_t>(range);
+  auto version = pullLE<uint32_t>(range);
+  if (magic != RibWarmbootFile::kMagic) {
+    throw FbossError(path_, " is not a RIB warm boot file");
+  }
+  if (version != RibWarmbootFile::kVersion) {
+    throw FbossError(
+        "Unsupported RIB warm boot file version ", version, " in ", path_);
+  }
+  offset_ = kHeaderSize;
+}
+
+bool RibWarmbootFileReader::nextChunk() {
+  if (offset_ == fileSize_) {
+    return false;
+  }
+  if (fileSize_ - offset_ < kChunkHeaderSize) {
+    throw FbossError("RIB warm boot file ", path_, " is truncated");
+  }
+  uint8_t header[kChunkHeaderSize];
+  if (mapping_) {
+    std::memcpy(header, mapping_->range().data() + offset_, kChunkHeaderSize);
+  } else {
+    readFully(header, kChunkHeaderSize);
+  }
+  offset_ += kChunkHeaderSize;
+  folly::ByteRange range(header, kChunkHeaderSize);
+  auto length = pullLE<uint32_t>(range);
+  auto crc = pullLE<uint32_t>(range);
+  if (fileSize_ - offset_ < length) {
+    throw FbossError("RIB warm boot file ", path_, " is truncated");
+  }
+  if (mapping_) {
+    chunk_ = mapping_->range().subpiece(offset_, length);
+  } else {
+    buffer_.resize(length);
+    readFully(buffer_.data(), length);
+    chunk_ = folly::ByteRange(buffer_.data(), length);
+  }
+  offset_ += length;
+  if (folly::crc32c(chunk_.data(), chunk_.size()) != crc) {
+    throw FbossError("Checksum mismatch in RIB warm boot file ", path_);
+  }
+  return true;
+}
+
+void RibWarmbootFileReader::readFully(uint8_t* buf, size_t length) {
+  auto bytesRead = folly::readFull(file_.fd(), buf, length);
+  if (bytesRead < 0 || static_cast<size_t>(bytesRead) != length) {
+    throw FbossError("Failed to read RIB warm boot file ", path_);
+  }
+}
+
+std::optional<RibWarmbootFileReader::Record> RibWarmbootFileReader::next() {
+  if (done_) {
+    return std::nullopt;
+  }
+  if (chunk_.empty() && !nextChunk()) {
+    throw FbossError("RIB warm boot file ", path_, " misses its end");
+  }
+  if (chunk_.size() < kRecordHeaderSize) {
+    throw FbossError("Corrupt record in RIB warm boot file ", path_);
+  }
+  auto type = static_cast<RecordType>(pullLE<uint8_t>(chunk_));
+  auto length = pullLE<uint32_t>(chunk_);
+  if (chunk_.size() < length) {
+    throw FbossError("Corrupt record in RIB warm boot file ", path_);
+  }
+  Record record{type, chunk_.subpiece(0, length)};
+  chunk_.advance(length);
+  switch (type) {
+    case RecordType::END:
+      done_ = true;
+      return std::nullopt;
+    case RecordType::VRF:
+    case RecordType::V4_ROUTE:
+    case RecordType::V6_ROUTE:
+    case RecordType::MPLS_ROUTE:
+      return record;
+  }
+  throw FbossError(
+      "Unknown record type ",
+      static_cast<int>(type),
+      " in RIB warm boot file ",
+      path_);
+}
+
+RouterID RibWarmbootFileReader::vrf(const Record& record) {
+  CHECK(record.type == RecordType::VRF);
+  auto body = record.body;
+  if (body.size() != sizeof(uint32_t)) {
+    throw FbossError("Corrupt VRF record in RIB warm boot file");
+  }
+  return RouterID(pullLE<uint32_t>(body));
+}
+
+std::shared_ptr<Route<folly::IPAddressV4>> RibWarmbootFileReader::v4Route(
+    const Record& record) {
+  CHECK(record.type == RecordType::V4_ROUTE);
+  return IPv4NetworkToRouteMap::routeFromThrift(
+      deserialize<state::RouteFields>(record.body));
+}
+
+std::shared_ptr<Route<folly::IPAddressV6>> RibWarmbootFileReader::v6Route(
+    const Record& record) {
+  CHECK(record.type == RecordType::V6_ROUTE);
+  return IPv6NetworkToRouteMap::routeFromThrift(
+      deserialize<state::RouteFields>(record.body));
+}
+
+std::shared_ptr<Route<LabelID>> RibWarmbootFileReader::mplsRoute(
+    const Record& record) {
+  CHECK(record.type == RecordType::MPLS_ROUTE);
+  return LabelToRouteMap::routeFromThrift(
+      deserialize<state::LabelForwardingEntryFields>(record.body));
+}
+
+} // namespace facebook::fboss
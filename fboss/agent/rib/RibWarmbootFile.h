@@ -0,0 +1,140 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/gen-cpp2/switch_state_types.h"
+#include "fboss/agent/state/Route.h"
+#include "fboss/agent/types.h"
+
+#include <folly/File.h>
+#include <folly/Range.h>
+#include <folly/system/MemoryMapping.h>
+#include <gflags/gflags.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+DECLARE_bool(rib_warmboot_file_mmap);
+
+namespace facebook::fboss {
+
+/*
+ * Streaming binary form of the RIB warm boot state. Routes are written and
+ * read back one at a time, so neither graceful exit nor warm boot has to
+ * hold the whole std::map<int32_t, state::RouteTableFields> in memory.
+ *
+ * Layout, integers little endian:
+ *   [magic:u64][version:u32] chunk*
+ *   chunk:  [length:u32][crc32c:u32][records, length bytes]
+ *   record: [type:u8][length:u32][body, length bytes]
+ * Records never straddle chunks. A VRF record (body: router id as u32)
+ * starts the routes of a VRF, route records carry one route each as
+ * compact serialized thrift, and an END record closes a complete file.
+ */
+class RibWarmbootFile {
+ public:
+  enum class RecordType : uint8_t {
+    VRF = 1,
+    V4_ROUTE = 2,
+    V6_ROUTE = 3,
+    MPLS_ROUTE = 4,
+    END = 5,
+  };
+
+  // "FBRIBWB1" once written out little endian
+  static constexpr uint64_t kMagic = 0x3142574249524246ull;
+  static constexpr uint32_t kVersion = 1;
+  static constexpr size_t kDefaultChunkSize = 1 << 20;
+};
+
+/*
+ * Writes the file under a temporary name, renamed into place by finish(),
+ * so a partially written file is never picked up by a warm boot.
+ */
+class RibWarmbootFileWriter {
+ public:
+  explicit RibWarmbootFileWriter(
+      std::string path,
+      size_t chunkSize = RibWarmbootFile::kDefaultChunkSize);
+  ~RibWarmbootFileWriter();
+
+  void startVrf(RouterID vrf);
+  void addRoute(const Route<folly::IPAddressV4>& route);
+  void addRoute(const Route<folly::IPAddressV6>& route);
+  void addRoute(const Route<LabelID>& route);
+  // Write out the END record, sync and move the file into place
+  void finish();
+
+  size_t routesWritten() const {
+    return routesWritten_;
+  }
+
+ private:
+  template <typename ThriftT>
+  void addThriftRecord(RibWarmbootFile::RecordType type, const ThriftT& obj);
+  void addRecord(RibWarmbootFile::RecordType type, folly::ByteRange body);
+  void flushChunk();
+  void writeFully(const std::string& bytes);
+
+  const std::string path_;
+  const std::string tmpPath_;
+  const size_t chunkSize_;
+  folly::File file_;
+  std::string chunk_;
+  size_t routesWritten_{0};
+  bool finished_{false};
+};
+
+/*
+ * Reads a file back record by record, verifying each chunk's checksum.
+ * The file is memory mapped, or with useMmap false read a chunk at a time
+ * into a buffer of the chunk's size. Throws FbossError on a corrupt or
+ * truncated file.
+ */
+class RibWarmbootFileReader {
+ public:
+  struct Record {
+    RibWarmbootFile::RecordType type;
+    folly::ByteRange body;
+  };
+
+  explicit RibWarmbootFileReader(
+      const std::string& path,
+      bool useMmap = FLAGS_rib_warmboot_file_mmap);
+
+  // Next record, std::nullopt once the END record is reached. The body
+  // stays valid until the following call.
+  std::optional<Record> next();
+
+  static RouterID vrf(const Record& record);
+  static std::shared_ptr<Route<folly::IPAddressV4>> v4Route(
+      const Record& record);
+  static std::shared_ptr<Route<folly::IPAddressV6>> v6Route(
+      const Record& record);
+  static std::shared_ptr<Route<LabelID>> mplsRoute(const Record& record);
+
+ private:
+  bool nextChunk();
+  void readFully(uint8_t* buf, size_t length);
+
+  const std::string path_;
+  folly::File file_;
+  std::unique_ptr<folly::MemoryMapping> mapping_;
+  std::vector<uint8_t> buffer_;
+  uint64_t offset_{0};
+  uint64_t fileSize_{0};
+  folly::ByteRange chunk_;
+  bool done_{false};
+};
+
+} // namespace facebook::fboss
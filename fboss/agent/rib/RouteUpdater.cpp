@@ -25,6 +25,7 @@
 #include "fboss/agent/state/Route.h"
 
 #include <algorithm>
+#include <span>
 #include <type_traits>
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/state/RouteNextHopEntry.h"
@@ -50,6 +51,11 @@ DEFINE_bool(
     enable_fpf_capacity_pruning,
     false,
     "Enable FPF (GTSW/STSW) per-STSW path pruning based on capacity");
+DEFINE_bool(
+    incremental_route_resolution,
+    false,
+    "Re-resolve only the routes affected by a RIB update instead of the "
+    "whole route table");
 
 using boost::container::flat_map;
 using boost::container::flat_set;
@@ -78,6 +84,15 @@ std::shared_ptr<Route<AddressT>> writableRoute(
   }
   return route;
 }
+
+template <typename AddressT>
+NextHopDependencyIndex::RouteKey routeKey(const Route<AddressT>& route) {
+  if constexpr (std::is_same_v<AddressT, LabelID>) {
+    return route.prefix().label();
+  } else {
+    return route.prefix().toCidrNetwork();
+  }
+}
 } // namespace
 static const RoutePrefixV6 kIPv6LinkLocalPrefix{
     folly::IPAddressV6("fe80::"),
@@ -111,13 +126,15 @@ RibRouteUpdater::RibRouteUpdater(
     LabelToRouteMap* mplsRoutes,
     NextHopIDManager* nextHopIDManager,
     MySidTable* mySidTable,
-    RouterID routerID)
+    RouterID routerID,
+    NextHopDependencyIndex* nextHopDependencies)
     : v4Routes_(v4Routes),
       v6Routes_(v6Routes),
       mplsRoutes_(mplsRoutes),
       nextHopIDManager_(nextHopIDManager),
       mySidTable_(mySidTable),
       routerID_(routerID),
+      nextHopDependencies_(nextHopDependencies),
       weightNormalizer_(
           FLAGS_nsf_num_racks_per_pod,
           FLAGS_nsf_num_parallel_rack_links,
@@ -273,12 +290,14 @@ void RibRouteUpdater::addOrReplaceRouteImpl(
     if (!existingRouteForClient || *existingRouteForClient != finalEntry) {
       route = writableRoute<AddressT>(it);
       route->update(clientID, finalEntry);
+      recordChangedRoute(routeKey(*route));
     }
     return;
   }
 
   routes->insert(
       prefix, std::make_shared<Route<AddressT>>(prefix, clientID, finalEntry));
+  recordChangedRoute(prefix.toCidrNetwork());
 }
 
 void RibRouteUpdater::addOrReplaceRoute(
@@ -318,11 +337,13 @@ void RibRouteUpdater::addOrReplaceRoute(
             label,
             std::make_shared<Route<LabelID>>(
                 Route<LabelID>::makeThrift(label, clientID, finalEntry))));
+    recordChangedRoute(label);
   } else {
     auto& route = iter->second;
     if (!existingRouteForClient || *existingRouteForClient != finalEntry) {
       route = writableRoute<LabelID>(route);
       route->update(clientID, finalEntry);
+      recordChangedRoute(label);
     }
   }
 }
@@ -370,6 +391,7 @@ void RibRouteUpdater::delRouteImpl(
     }
   }
   maybeRemoveNamedNhgMapping(route, *clientNhopEntry);
+  recordChangedRoute(routeKey(*route));
   if (route->numClientEntries() == 1) {
     // If this client's the only entry, simply erase
     XLOG(DBG3) << "Deleting route: " << route->str();
@@ -420,6 +442,7 @@ void RibRouteUpdater::delRoute(const LabelID& label, const ClientID clientID) {
       nextHopIDManager_->decrOrDeallocRouteNextHopSetID(*clientNhopSetId);
     }
   }
+  recordChangedRoute(label);
   if (route->numClientEntries() == 1) {
     // If this client's the only entry, simply erase
     XLOG(DBG3) << "Deleting route: " << route->str();
@@ -453,6 +476,7 @@ void RibRouteUpdater::removeAllRoutesFromClientImpl(
       }
     }
     maybeRemoveNamedNhgMapping(route, *nhopEntry);
+    recordChangedRoute(routeKey(*route));
     if (route->numClientEntries() == 1) {
       // This client's is the only entry avoid unnecessary cloning
       // we are going to prune the route anyways. Release fwd-side IDs first.
@@ -498,6 +522,7 @@ void RibRouteUpdater::removeAllUnclaimedRoutesFromClientImpl(
       }
     }
     maybeRemoveNamedNhgMapping(route, *nhopEntry);
+    recordChangedRoute(routeKey(*route));
     if (route->numClientEntries() == 1) {
       // This client's is the only entry avoid unnecessary cloning
       // we are going to prune the route anyways. Release fwd-side IDs first.
@@ -853,12 +878,56 @@ Srv6Encap resolveSrv6Encap(
   }
   return {child.srv6SegmentList(), child.tunnelType(), child.tunnelId()};
 }
+
+bool isPopAndLookup(const NextHop& nh) {
+  return nh.labelForwardingAction().has_value() &&
+      nh.labelForwardingAction().value().type() ==
+      MplsActionCode::POP_AND_LOOKUP;
+}
+
+/*
+ * Longest matches of a route's next hops. The next hops of ECMP groups are
+ * looked up in one batch, letting the tree walks overlap their cache misses,
+ * and the matches then handed out in next hop order.
+ */
+template <typename AddressT>
+class NextHopMatches {
+ public:
+  using Iterator = typename NetworkToRouteMap<AddressT>::Iterator;
+
+  explicit NextHopMatches(NetworkToRouteMap<AddressT>* routes)
+      : routes_(routes) {}
+
+  void add(const AddressT& addr) {
+    addrs_.push_back(addr);
+  }
+  void lookup() {
+    matches_.resize(addrs_.size());
+    routes_->longestMatch(
+        std::span<const AddressT>(addrs_), std::span<Iterator>(matches_));
+  }
+  // Match for the next next hop, looked up on the spot if not batched
+  Iterator next(const AddressT& addr) {
+    if (next_ < matches_.size()) {
+      DCHECK_EQ(addrs_[next_], addr);
+      return matches_[next_++];
+    }
+    return routes_->longestMatch(addr, addr.bitCount());
+  }
+
+ private:
+  NetworkToRouteMap<AddressT>* routes_;
+  std::vector<AddressT> addrs_;
+  std::vector<Iterator> matches_;
+  size_t next_{0};
+};
 } // anonymous namespace
 
 template <typename AddressT>
 void RibRouteUpdater::getFwdInfoFromNhop(
     NetworkToRouteMap<AddressT>* routes,
     const AddressT& nh,
+    typename NetworkToRouteMap<AddressT>::Iterator it,
     const std::optional<LabelForwardingAction>& labelAction,
     bool* hasToCpu,
     bool* hasDrop,
@@ -871,7 +940,6 @@ void RibRouteUpdater::getFwdInfoFromNhop(
     NextHopRole role,
     std::optional<RouteCounterID>* inheritedCounterID,
     RouteNextHopSet& fwd) {
-  auto it = routes->longestMatch(nh, nh.bitCount());
   if (it == routes->end()) {
     XLOG(DBG3) << "Could not find subnet for next-hop:  " << nh;
     // Unresolvable next hop
@@ -1000,6 +1068,7 @@ std::shared_ptr<Route<AddressT>> RibRouteUpdater::resolveOne(
   // Starting resolution for this route, remove from resolution queue
   needsResolution_.erase(route.get());
   resolving_.insert(route.get());
+  ++routesResolved_;
   SCOPE_EXIT {
     resolving_.erase(route.get());
   };
@@ -1029,6 +1098,22 @@ std::shared_ptr<Route<AddressT>> RibRouteUpdater::resolveOne(
     auto fwItr = unresolvedToResolvedNhops_.find(bestEntryNhops);
     if (fwItr == unresolvedToResolvedNhops_.end()) {
       NextHopForwardInfos nhToFwds;
+      NextHopMatches<folly::IPAddressV4> v4Matches(v4Routes_);
+      NextHopMatches<folly::IPAddressV6> v6Matches(v6Routes_);
+      if (bestEntryNhops.size() > 1) {
+        for (const auto& nh : bestEntryNhops) {
+          if (nh.intfID().has_value() || isPopAndLookup(nh)) {
+            continue;
+          }
+          if (nh.addr().isV4()) {
+            v4Matches.add(nh.addr().asV4());
+          } else {
+            v6Matches.add(nh.addr().asV6());
+          }
+        }
+        v4Matches.lookup();
+        v6Matches.lookup();
+      }
       // loop through all nexthops to find out the forward info
       for (const auto& nh : bestEntryNhops) {
         const auto& addr = nh.addr();
@@ -1050,9 +1135,7 @@ std::shared_ptr<Route<AddressT>> RibRouteUpdater::resolveOne(
 
         // For pop and lookup, forwarding is based on inner
         // header. There should be only one nhop in this case.
-        if (nh.labelForwardingAction().has_value() &&
-            nh.labelForwardingAction().value().type() ==
-                MplsActionCode::POP_AND_LOOKUP) {
+        if (isPopAndLookup(nh)) {
           if (bestEntryNhops.size() > 1) {
             throw FbossError(
                 "MPLS pop and lookup forwarding action has more than one nexthop");
@@ -1066,6 +1149,7 @@ std::shared_ptr<Route<AddressT>> RibRouteUpdater::resolveOne(
           getFwdInfoFromNhop(
               v4Routes_,
               nh.addr().asV4(),
+              v4Matches.next(nh.addr().asV4()),
               nh.labelForwardingAction(),
               &hasToCpu,
               &hasDrop,
@@ -1083,6 +1167,7 @@ std::shared_ptr<Route<AddressT>> RibRouteUpdater::resolveOne(
           getFwdInfoFromNhop(
               v6Routes_,
               nh.addr().asV6(),
+              v6Matches.next(nh.addr().asV6()),
               nh.labelForwardingAction(),
               &hasToCpu,
               &hasDrop,
@@ -1124,9 +1209,7 @@ std::shared_ptr<Route<AddressT>> RibRouteUpdater::resolveOne(
       const auto& nhSet = bestEntryNhops;
       if (nhSet.size() == 1) {
         const auto& nh = *nhSet.begin();
-        if (nh.labelForwardingAction().has_value() &&
-            nh.labelForwardingAction().value().type() ==
-                MplsActionCode::POP_AND_LOOKUP) {
+        if (isPopAndLookup(nh)) {
           labelPopandLookup = true;
         }
       }
@@ -1149,6 +1232,7 @@ std::shared_ptr<Route<AddressT>> RibRouteUpdater::resolveOne(
                          typename NetworkToRouteMap<AddressT>::Iterator ritr,
                          std::optional<RouteNextHopEntry> nhop) {
     updatedRoute = writableRoute<AddressT>(ritr);
+    logFibChange(routeKey(*updatedRoute));
     auto oldNextHopSetID =
         value<AddressT>(ritr)->getForwardInfo().getResolvedNextHopSetID();
     auto oldNormalizedNextHopSetID = value<AddressT>(ritr)
@@ -1290,6 +1374,16 @@ bool RibRouteUpdater::needResolve(
 }
 
 void RibRouteUpdater::updateDone() {
+  SCOPE_EXIT {
+    needsResolution_.clear();
+    unresolvedToResolvedNhops_.clear();
+    resolving_.clear();
+    changedRoutes_.clear();
+  };
+  if (incrementalResolutionEnabled()) {
+    resolveIncremental();
+    return;
+  }
   // Record all routes as needing resolution
   auto markForResolution = [this](const auto& routes) {
     std::for_each(routes->begin(), routes->end(), [this](auto& route) {
@@ -1301,15 +1395,161 @@ void RibRouteUpdater::updateDone() {
   if (mplsRoutes_) {
     markForResolution(mplsRoutes_);
   }
-  SCOPE_EXIT {
-    needsResolution_.clear();
-    unresolvedToResolvedNhops_.clear();
-    resolving_.clear();
-  };
   resolve(v4Routes_);
   resolve(v6Routes_);
   if (mplsRoutes_) {
     resolve(mplsRoutes_);
   }
+  if (nextHopDependencies_) {
+    if (FLAGS_incremental_route_resolution) {
+      // Full resolution done, subsequent updates can go incremental
+      rebuildNextHopDependencies();
+    } else {
+      nextHopDependencies_->invalidate();
+    }
+  }
+}
+
+bool RibRouteUpdater::incrementalResolutionEnabled() const {
+  return FLAGS_incremental_route_resolution && nextHopDependencies_ &&
+      nextHopDependencies_->isValid();
+}
+
+void RibRouteUpdater::recordChangedRoute(const RouteKey& key) {
+  logFibChange(key);
+  if (incrementalResolutionEnabled()) {
+    changedRoutes_.insert(key);
+  }
+}
+
+void RibRouteUpdater::logFibChange(const RouteKey& key) {
+  // Label FIB updates walk the whole table, only log prefixes
+  const auto* prefix = std::get_if<folly::CIDRNetwork>(&key);
+  if (!prefix) {
+    return;
+  }
+  const auto& [network, mask] = *prefix;
+  if (network.isV4()) {
+    v4Routes_->logFibChange(RoutePrefixV4{network.asV4(), mask});
+  } else {
+    v6Routes_->logFibChange(RoutePrefixV6{network.asV6(), mask});
+  }
+}
+
+template <typename Fn>
+void RibRouteUpdater::forRoute(const RouteKey& key, const Fn& fn) {
+  if (const auto* label = std::get_if<LabelID>(&key)) {
+    if (!mplsRoutes_) {
+      return;
+    }
+    auto it = mplsRoutes_->find(*label);
+    if (it != mplsRoutes_->end()) {
+      fn(mplsRoutes_, it);
+    }
+    return;
+  }
+  const auto& [network, mask] = std::get<folly::CIDRNetwork>(key);
+  if (network.isV4()) {
+    auto it = v4Routes_->exactMatch(network.asV4(), mask);
+    if (it != v4Routes_->end()) {
+      fn(v4Routes_, it);
+    }
+  } else {
+    auto it = v6Routes_->exactMatch(network.asV6(), mask);
+    if (it != v6Routes_->end()) {
+      fn(v6Routes_, it);
+    }
+  }
+}
+
+template <typename AddressT>
+void RibRouteUpdater::updateNextHopDependencies(const Route<AddressT>& route) {
+  NextHopDependencyIndex::NextHopAddresses nexthops;
+  const auto& bestEntry = *route.getBestEntry().second;
+  if (bestEntry.getAction() == RouteForwardAction::NEXTHOPS) {
+    for (const auto& nh :
+         getClientNextHopsFromRib(nextHopIDManager_, bestEntry)) {
+      // Next hops with an interface are already resolved and pop and
+      // lookup forwards on the inner header, neither needs a route lookup.
+      if (nh.intfID().has_value() || isPopAndLookup(nh)) {
+        continue;
+      }
+      nexthops.push_back(nh.addr());
+    }
+  }
+  nextHopDependencies_->setNextHops(routeKey(route), std::move(nexthops));
+}
+
+void RibRouteUpdater::rebuildNextHopDependencies() {
+  nextHopDependencies_->invalidate();
+  auto addDependencies = [this](const auto& routes) {
+    std::for_each(routes->begin(), routes->end(), [this](auto& route) {
+      updateNextHopDependencies(*value(route));
+    });
+  };
+  addDependencies(v4Routes_);
+  addDependencies(v6Routes_);
+  if (mplsRoutes_) {
+    addDependencies(mplsRoutes_);
+  }
+  nextHopDependencies_->markValid();
+}
+
+/*
+ * Re-resolve only the routes this update may have affected:
+ * 1. Routes added, modified or deleted by the update.
+ * 2. Routes with a next hop covered by a prefix from 1. The longest match
+ *    for such a next hop may now land on (or no longer land on) that prefix,
+ *    or the route it lands on may now resolve differently.
+ * 3. Transitively, routes with a next hop covered by a prefix from 2.
+ * Everything else keeps the forwarding info from the previous resolution.
+ */
+void RibRouteUpdater::resolveIncremental() {
+  std::set<RouteKey> toResolve;
+  std::vector<folly::CIDRNetwork> affectedPrefixes;
+  auto addToResolve = [&toResolve, &affectedPrefixes](const RouteKey& key) {
+    if (!toResolve.insert(key).second) {
+      return;
+    }
+    if (const auto* prefix = std::get_if<folly::CIDRNetwork>(&key)) {
+      affectedPrefixes.push_back(*prefix);
+    }
+  };
+  for (const auto& key : changedRoutes_) {
+    // Refresh dependencies first, so that changed routes now resolving
+    // through another changed prefix get picked up below
+    bool exists{false};
+    forRoute(key, [this, &exists](auto* /*routes*/, auto ritr) {
+      exists = true;
+      updateNextHopDependencies(*value(*ritr));
+    });
+    if (!exists) {
+      nextHopDependencies_->removeRoute(key);
+    }
+    addToResolve(key);
+  }
+  while (!affectedPrefixes.empty()) {
+    auto prefix = affectedPrefixes.back();
+    affectedPrefixes.pop_back();
+    nextHopDependencies_->forEachDependent(prefix, addToResolve);
+  }
+  for (const auto& key : toResolve) {
+    forRoute(key, [this](auto* /*routes*/, auto ritr) {
+      needsResolution_.insert(value(*ritr).get());
+    });
+  }
+  XLOG(DBG3) << "Incremental resolution: " << changedRoutes_.size()
+             << " changed routes, " << toResolve.size()
+             << " routes to resolve";
+  for (const auto& key : toResolve) {
+    forRoute(key, [this](auto* routes, auto ritr) {
+      using AddressT =
+          typename std::remove_pointer_t<decltype(routes)>::RouteT::Addr;
+      if (needResolve(value(*ritr))) {
+        resolveOne<AddressT>(ritr);
+        DCHECK(resolving_.empty());
+      }
+    });
+  }
 }
 } // namespace facebook::fboss
@@ -14,6 +14,7 @@
 #include "fboss/agent/types.h"
 
 #include "fboss/agent/rib/NetworkToRouteMap.h"
+#include "fboss/agent/rib/NextHopDependencyIndex.h"
 #include "fboss/agent/rib/RibRouteWeightNormalizer.h"
 #include "fboss/agent/state/MySid.h"
 
@@ -21,6 +22,7 @@
 
 DECLARE_bool(enable_capacity_pruning);
 DECLARE_bool(enable_fpf_capacity_pruning);
+DECLARE_bool(incremental_route_resolution);
 namespace facebook::fboss {
 class NextHopIDManager;
 
@@ -50,6 +52,12 @@ using MySidTable =
  *    only IP nexthops will be in the final ECMP group.
  * 5. If and only if TO_CPU is the only nexthop (directly or indirectly) of
  *    a route, TO_CPU action will be only path in the resolved ECMP group.
+ *
+ * By default every update re-resolves every route in the table. When a
+ * NextHopDependencyIndex is supplied and FLAGS_incremental_route_resolution
+ * is set, only the routes changed by the update and the routes (transitively)
+ * resolving through a changed prefix are re-resolved. All other routes keep
+ * their existing forwarding info.
  */
 class RibRouteUpdater {
  public:
@@ -66,7 +74,8 @@ class RibRouteUpdater {
       LabelToRouteMap* mplsRoutes,
       NextHopIDManager* nextHopIDManager,
       MySidTable* mySidTable,
-      RouterID routerID = RouterID(0));
+      RouterID routerID = RouterID(0),
+      NextHopDependencyIndex* nextHopDependencies = nullptr);
 
   struct RouteEntry {
     folly::CIDRNetwork prefix;
@@ -114,6 +123,9 @@ class RibRouteUpdater {
   std::size_t cyclesDetected() const {
     return cyclesDetected_;
   }
+  std::size_t routesResolved() const {
+    return routesResolved_;
+  }
 
  private:
   void updateImpl(
@@ -190,6 +202,20 @@ class RibRouteUpdater {
   template <typename AddressT>
   void resolve(NetworkToRouteMap<AddressT>* routes);
 
+  using RouteKey = NextHopDependencyIndex::RouteKey;
+
+  bool incrementalResolutionEnabled() const;
+  void resolveIncremental();
+  void rebuildNextHopDependencies();
+  void recordChangedRoute(const RouteKey& key);
+  // Log a route replaced, added or deleted for the next FIB update
+  void logFibChange(const RouteKey& key);
+  template <typename AddressT>
+  void updateNextHopDependencies(const Route<AddressT>& route);
+  // Invoke fn(routes, iterator) for the route identified by key, if present
+  template <typename Fn>
+  void forRoute(const RouteKey& key, const Fn& fn);
+
   template <typename AddressT>
   std::shared_ptr<Route<AddressT>> resolveOne(
       typename NetworkToRouteMap<AddressT>::Iterator ritr);
@@ -198,6 +224,7 @@ class RibRouteUpdater {
   void getFwdInfoFromNhop(
       NetworkToRouteMap<AddressT>* routes,
       const AddressT& nh,
+      typename NetworkToRouteMap<AddressT>::Iterator it,
       const std::optional<LabelForwardingAction>& labelAction,
       bool* hasToCpu,
       bool* hasDrop,
@@ -231,6 +258,11 @@ class RibRouteUpdater {
   std::unordered_set<void*> needsResolution_;
   std::unordered_set<void*> resolving_;
   std::size_t cyclesDetected_{0};
+  std::size_t routesResolved_{0};
+  NextHopDependencyIndex* nextHopDependencies_{nullptr};
+  // Routes added, deleted or modified since the last resolution. Only
+  // tracked when incremental resolution is enabled.
+  std::set<RouteKey> changedRoutes_;
   /*
    * Cache for next hop to FWD information. For our use case
    * its pretty common for the same next hops to repeat, so
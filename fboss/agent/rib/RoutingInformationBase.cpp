@@ -18,6 +18,7 @@
 #include "fboss/agent/if/gen-cpp2/common_types.h"
 #include "fboss/agent/rib/ConfigApplier.h"
 #include "fboss/agent/rib/NetworkToRouteMap.h"
+#include "fboss/agent/rib/RibWarmbootFile.h"
 #include "fboss/agent/state/FibDeltaHelpers.h"
 #include "fboss/agent/state/FibInfo.h"
 #include "fboss/agent/state/FibInfoMap.h"
@@ -27,12 +28,14 @@
 #include "fboss/agent/state/MySidMap.h"
 #include "fboss/agent/state/NodeMap-defs.h"
 #include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/StateUpdateHelpers.h"
 #include "fboss/agent/state/SwitchState.h"
 
 #include "fboss/agent/rib/RibMySidUpdater.h"
 #include "fboss/agent/rib/RouteUpdater.h"
 
 #include <exception>
+#include <map>
 #include <memory>
 #include <optional>
 #include <set>
@@ -40,10 +43,60 @@
 #include <utility>
 
 #include <folly/ScopeGuard.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <folly/futures/Future.h>
 #include <folly/logging/xlog.h>
 
+DEFINE_int32(
+    rib_vrf_update_threads,
+    0,
+    "Number of threads used to resolve VRFs and build their FIBs "
+    "concurrently when a RIB update spans several VRFs. 0 or 1 updates "
+    "VRFs one at a time");
+
+DEFINE_bool(
+    rib_fib_pipeline,
+    false,
+    "Resolve the next route update in the RIB while the FIB of the previous "
+    "one is being programmed to HW, rather than one update after the other");
+
 namespace facebook::fboss {
 
+folly::Executor* getRibVrfUpdateExecutor() {
+  if (FLAGS_rib_vrf_update_threads <= 1) {
+    return nullptr;
+  }
+  // Leaked on purpose, so that RIB updates still in flight during static
+  // destruction do not race with the pool's destructor
+  static auto* executor = new folly::CPUThreadPoolExecutor(
+      FLAGS_rib_vrf_update_threads,
+      std::make_shared<folly::NamedThreadFactory>("RibVrfUpdate"));
+  return executor;
+}
+
+void runRibVrfUpdateTasks(
+    size_t numTasks,
+    const std::function<void(size_t)>& task) {
+  auto executor = getRibVrfUpdateExecutor();
+  if (!executor || numTasks < 2) {
+    for (size_t i = 0; i < numTasks; ++i) {
+      task(i);
+    }
+    return;
+  }
+  std::vector<folly::Future<folly::Unit>> futures;
+  futures.reserve(numTasks);
+  for (size_t i = 0; i < numTasks; ++i) {
+    futures.push_back(folly::via(executor, [&task, i] { task(i); }));
+  }
+  // Wait for every task before rethrowing, they all reference our caller's
+  // stack
+  for (auto& result : folly::collectAll(std::move(futures)).get()) {
+    result.throwUnlessValue();
+  }
+}
+
 namespace {
 
 class RibIpRouteUpdate {
@@ -378,29 +431,110 @@ void reconstructMySidTableFromSwitchState(
 }
 
 template <typename RibUpdateFn>
-void RibRouteTables::updateRib(RouterID vrf, const RibUpdateFn& updateRibFn) {
+void RibRouteTables::updateRib(
+    RouterID vrf,
+    const RibUpdateFn& updateRibFn,
+    bool logsFibChanges) {
   auto lockedRouteTables = synchronizedRouteTables_.wlock();
   auto it = lockedRouteTables->routerIDToRouteTable.find(vrf);
   if (it == lockedRouteTables->routerIDToRouteTable.end()) {
     throw FbossError("VRF ", vrf, " not configured");
   }
   auto& routeTable = it->second;
+  SCOPE_EXIT {
+    routeTable.invalidateLpmSnapshots();
+  };
+  if (logsFibChanges) {
+    // Drop the changes the last FIB build covers, only done under the
+    // write lock as builds run concurrently under the read lock
+    routeTable.restartFibChanges();
+  } else {
+    routeTable.invalidateFibChanges();
+  }
   updateRibFn(
       routeTable,
       &lockedRouteTables->mySidTable,
       lockedRouteTables->nextHopIDManager.get());
-  if (lockedRouteTables->nextHopIDManager &&
-      !lockedRouteTables->mySidTable.empty()) {
-    RibMySidUpdater::VrfRouteTables routeTables;
-    for (auto& [rid, rt] : lockedRouteTables->routerIDToRouteTable) {
-      routeTables.emplace_back(&rt.v4NetworkToRoute, &rt.v6NetworkToRoute);
-    }
-    RibMySidUpdater mySidUpdater(
-        routeTables,
-        lockedRouteTables->nextHopIDManager.get(),
-        &lockedRouteTables->mySidTable);
-    mySidUpdater.resolve();
+  resolveMySids(lockedRouteTables);
+}
+
+template <typename RibUpdateFn>
+void RibRouteTables::updateRib(
+    const std::vector<RouterID>& vrfs,
+    const RibUpdateFn& updateRibFn,
+    bool concurrentRibUpdateSafe) {
+  auto lockedRouteTables = synchronizedRouteTables_.wlock();
+  std::vector<VrfRouteTable*> routeTables;
+  routeTables.reserve(vrfs.size());
+  for (auto vrf : vrfs) {
+    auto it = lockedRouteTables->routerIDToRouteTable.find(vrf);
+    if (it == lockedRouteTables->routerIDToRouteTable.end()) {
+      throw FbossError("VRF ", vrf, " not configured");
+    }
+    routeTables.push_back(&it->second);
+  }
+  SCOPE_EXIT {
+    for (auto* routeTable : routeTables) {
+      routeTable->invalidateLpmSnapshots();
+    }
+  };
+  for (auto* routeTable : routeTables) {
+    routeTable->invalidateFibChanges();
   }
+  auto mySidTable = &lockedRouteTables->mySidTable;
+  auto nextHopIDManager = lockedRouteTables->nextHopIDManager.get();
+  auto updateVrf = [&](size_t idx) {
+    updateRibFn(vrfs[idx], *routeTables[idx], mySidTable, nextHopIDManager);
+  };
+  if (concurrentRibUpdateSafe && !nextHopIDManager && mySidTable->empty()) {
+    runRibVrfUpdateTasks(vrfs.size(), updateVrf);
+  } else {
+    for (size_t idx = 0; idx < vrfs.size(); ++idx) {
+      updateVrf(idx);
+    }
+  }
+  resolveMySids(lockedRouteTables);
+}
+
+template <typename RibUpdateFn>
+void RibRouteTables::updateRibAndFib(
+    const SwitchIdScopeResolver* resolver,
+    const std::vector<RouterID>& vrfs,
+    const RibUpdateFn& updateRibFn,
+    bool concurrentRibUpdateSafe,
+    const RibToSwitchStateFunction& ribToSwitchStateFunc,
+    const MultiVrfRibToSwitchStateFunction& multiVrfRibToSwitchStateFunc,
+    void* cookie) {
+  if (vrfs.size() > 1 && multiVrfRibToSwitchStateFunc &&
+      getRibVrfUpdateExecutor()) {
+    updateRib(vrfs, updateRibFn, concurrentRibUpdateSafe);
+    updateFib(resolver, vrfs, multiVrfRibToSwitchStateFunc, cookie);
+    return;
+  }
+  for (auto vrf : vrfs) {
+    updateRib(
+        vrf, [&](auto& routeTable, auto* mySidTable, auto* nextHopIDManager) {
+          updateRibFn(vrf, routeTable, mySidTable, nextHopIDManager);
+        });
+    updateFib(resolver, vrf, ribToSwitchStateFunc, cookie);
+  }
+}
+
+void RibRouteTables::resolveMySids(
+    const SynchronizedRouteTables::WLockedPtr& lockedRouteTables) {
+  if (!lockedRouteTables->nextHopIDManager ||
+      lockedRouteTables->mySidTable.empty()) {
+    return;
+  }
+  RibMySidUpdater::VrfRouteTables routeTables;
+  for (auto& [rid, rt] : lockedRouteTables->routerIDToRouteTable) {
+    routeTables.emplace_back(&rt.v4NetworkToRoute, &rt.v6NetworkToRoute);
+  }
+  RibMySidUpdater mySidUpdater(
+      routeTables,
+      lockedRouteTables->nextHopIDManager.get(),
+      &lockedRouteTables->mySidTable);
+  mySidUpdater.resolve();
 }
 
 template <typename RibUpdateFn>
@@ -430,7 +564,8 @@ void RibRouteTables::reconfigure(
     const std::vector<cfg::StaticMplsRouteNoNextHops>& staticMplsRoutesToCpu,
     const std::vector<MySidWithNextHops>& staticMySids,
     RibToSwitchStateFunction ribToSwitchStateFunc,
-    void* cookie) {
+    void* cookie,
+    const MultiVrfRibToSwitchStateFunction& multiVrfRibToSwitchStateFunc) {
   // Config application is accomplished in the following sequence of steps:
   // 1. Update the VRFs held in RoutingInformationBase's
   // SynchronizedRouteTables data-structure
@@ -451,77 +586,99 @@ void RibRouteTables::reconfigure(
 
   std::vector<RouterID> existingVrfs = getVrfList();
 
-  auto configureRoutesForVrf =
-      [&](RouterID vrf, const PrefixToInterfaceIDAndIP& interfaceRoutes) {
-        // A ConfigApplier object should be independent of the VRF whose
-        // routes it is processing. However, because interface and static
-        // routes for _all_ VRFs are passed to ConfigApplier, the vrf
-        // argument is needed to identify the subset of those routes which
-        // should be processed.
-
-        // ConfigApplier can be made independent of the VRF whose routes it
-        // is processing by the use of boost::filter_iterator.
-        updateRib(
-            vrf,
-            [&](auto& routeTable, auto* mySidTable, auto* nextHopIDManager) {
-              ConfigApplier configApplier(
-                  vrf,
-                  &(routeTable.v4NetworkToRoute),
-                  &(routeTable.v6NetworkToRoute),
-                  &(routeTable.labelToRoute),
-                  folly::range(
-                      interfaceRoutes.cbegin(), interfaceRoutes.cend()),
-                  folly::range(
-                      staticRoutesToCpu.cbegin(), staticRoutesToCpu.cend()),
-                  folly::range(
-                      staticRoutesToNull.cbegin(), staticRoutesToNull.cend()),
-                  folly::range(
-                      staticRoutesWithNextHops.cbegin(),
-                      staticRoutesWithNextHops.cend()),
-                  folly::range(
-                      staticIp2MplsRoutes.cbegin(), staticIp2MplsRoutes.cend()),
-                  folly::range(
-                      staticMplsRoutesWithNextHops.cbegin(),
-                      staticMplsRoutesWithNextHops.cend()),
-                  folly::range(
-                      staticMplsRoutesToNull.cbegin(),
-                      staticMplsRoutesToNull.cend()),
-                  folly::range(
-                      staticMplsRoutesToCpu.cbegin(),
-                      staticMplsRoutesToCpu.cend()),
-                  folly::range(staticMySids.cbegin(), staticMySids.cend()),
-                  nextHopIDManager,
-                  mySidTable);
-              // Apply config
-              configApplier.apply();
-            });
-        updateFib(resolver, vrf, ribToSwitchStateFunc, cookie);
-      };
-  // Because of this sequential loop over each VRF, config application scales
-  // linearly with the number of VRFs. If FBOSS is run in a multi-VRF routing
-  // architecture in the future, this slow-down can be avoided by
-  // parallelizing this loop. Converting this loop to use task-level
-  // parallelism should be straightfoward because it has been written to avoid
-  // dependencies across different iterations of the loop.
+  auto configureRoutesForVrf = [&](RouterID vrf,
+                                   const PrefixToInterfaceIDAndIP&
+                                       interfaceRoutes,
+                                   auto& routeTable,
+                                   auto* mySidTable,
+                                   auto* nextHopIDManager) {
+    // A ConfigApplier object should be independent of the VRF whose
+    // routes it is processing. However, because interface and static
+    // routes for _all_ VRFs are passed to ConfigApplier, the vrf
+    // argument is needed to identify the subset of those routes which
+    // should be processed.
+
+    // ConfigApplier can be made independent of the VRF whose routes it
+    // is processing by the use of boost::filter_iterator.
+
+    // Config application resets static and interface routes
+    // wholesale and resolves the full table anyway
+    routeTable.nextHopDependencies.invalidate();
+    ConfigApplier configApplier(
+        vrf,
+        &(routeTable.v4NetworkToRoute),
+        &(routeTable.v6NetworkToRoute),
+        &(routeTable.labelToRoute),
+        folly::range(interfaceRoutes.cbegin(), interfaceRoutes.cend()),
+        folly::range(staticRoutesToCpu.cbegin(), staticRoutesToCpu.cend()),
+        folly::range(staticRoutesToNull.cbegin(), staticRoutesToNull.cend()),
+        folly::range(
+            staticRoutesWithNextHops.cbegin(), staticRoutesWithNextHops.cend()),
+        folly::range(staticIp2MplsRoutes.cbegin(), staticIp2MplsRoutes.cend()),
+        folly::range(
+            staticMplsRoutesWithNextHops.cbegin(),
+            staticMplsRoutesWithNextHops.cend()),
+        folly::range(
+            staticMplsRoutesToNull.cbegin(), staticMplsRoutesToNull.cend()),
+        folly::range(
+            staticMplsRoutesToCpu.cbegin(), staticMplsRoutesToCpu.cend()),
+        folly::range(staticMySids.cbegin(), staticMySids.cend()),
+        nextHopIDManager,
+        mySidTable);
+    // Apply config
+    configApplier.apply();
+  };
+  // Configuring a VRF has no dependencies on other VRFs, except through
+  // the MySid table when static MySids are configured. So with
+  // --rib_vrf_update_threads, VRFs are configured concurrently and
+  // programmed in a single FIB update.
+  const bool concurrentRibUpdateSafe = staticMySids.empty();
+  // First handle the VRFs for which no interface routes exist
+  std::vector<RouterID> vrfsWithoutInterfaceRoutes;
   for (const auto& vrf : existingVrfs) {
-    // First handle the VRFs for which no interface routes exist
-    if (configRouterIDToInterfaceRoutes.find(vrf) !=
+    if (configRouterIDToInterfaceRoutes.find(vrf) ==
         configRouterIDToInterfaceRoutes.end()) {
-      continue;
+      vrfsWithoutInterfaceRoutes.push_back(vrf);
     }
-    configureRoutesForVrf(
-        vrf, {} /* No interface routes*/
-    );
   }
+  const PrefixToInterfaceIDAndIP noInterfaceRoutes;
+  updateRibAndFib(
+      resolver,
+      vrfsWithoutInterfaceRoutes,
+      [&](RouterID vrf,
+          auto& routeTable,
+          auto* mySidTable,
+          auto* nextHopIDManager) {
+        configureRoutesForVrf(
+            vrf, noInterfaceRoutes, routeTable, mySidTable, nextHopIDManager);
+      },
+      concurrentRibUpdateSafe,
+      ribToSwitchStateFunc,
+      multiVrfRibToSwitchStateFunc,
+      cookie);
   {
     auto lockedRouteTables = synchronizedRouteTables_.wlock();
     lockedRouteTables->routerIDToRouteTable = constructRouteTables(
         lockedRouteTables, configRouterIDToInterfaceRoutes);
   }
-  for (auto& vrf : getVrfList()) {
-    const auto& interfaceRoutes = configRouterIDToInterfaceRoutes.at(vrf);
-    configureRoutesForVrf(vrf, interfaceRoutes);
-  }
+  updateRibAndFib(
+      resolver,
+      getVrfList(),
+      [&](RouterID vrf,
+          auto& routeTable,
+          auto* mySidTable,
+          auto* nextHopIDManager) {
+        configureRoutesForVrf(
+            vrf,
+            configRouterIDToInterfaceRoutes.at(vrf),
+            routeTable,
+            mySidTable,
+            nextHopIDManager);
+      },
+      concurrentRibUpdateSafe,
+      ribToSwitchStateFunc,
+      multiVrfRibToSwitchStateFunc,
+      cookie);
 }
 
 void RibRouteTables::updateRemoteInterfaceRoutes(
@@ -533,7 +690,8 @@ void RibRouteTables::updateRemoteInterfaceRoutes(
             std::pair<folly::CIDRNetwork, facebook::fboss::InterfaceID>>>&
         toDel,
     const RibToSwitchStateFunction& ribToSwitchStateFunc,
-    void* cookie) {
+    void* cookie,
+    const MultiVrfRibToSwitchStateFunction& multiVrfRibToSwitchStateFunc) {
   auto makeNhop = [](const auto& interfaceIDAndAddr) {
     auto interfaceID = interfaceIDAndAddr.first;
     auto address = interfaceIDAndAddr.second;
@@ -573,56 +731,69 @@ void RibRouteTables::updateRemoteInterfaceRoutes(
                                       network.second);
   };
 
+  std::vector<RouterID> vrfsToUpdate;
+  std::map<RouterID, std::vector<RibRouteUpdater::RouteEntry>> vrfToAddRoutes;
   for (auto& vrf : getVrfList()) {
-    std::vector<RibRouteUpdater::RouteEntry> toAddRoutes;
-    std::vector<folly::CIDRNetwork> toDelRoutes;
+    auto& toAddRoutes = vrfToAddRoutes[vrf];
     const auto& toAddIter = toAdd.find(vrf);
     if (toAddIter != toAdd.end()) {
       for (const auto& [network, interfaceIDAndAddr] : toAddIter->second) {
         toAddRoutes.emplace_back(network, makeNhop(interfaceIDAndAddr));
       }
     }
-    const auto& toDelIter = toDel.find(vrf);
-    if (!toAddRoutes.empty() || toDelIter != toDel.end()) {
-      updateRib(
-          vrf, [&](auto& routeTable, auto* mySidTable, auto* nextHopIDManager) {
-            if (toDelIter != toDel.end()) {
-              for (const auto& [network, intfID] : toDelIter->second) {
-                // Remote interface route deletion is guarded by the
-                // originating interface to avoid removing a prefix that was
-                // already replaced by another remote interface update.
-                auto intfMatches =
-                    routeIntfMatches(routeTable, network, intfID);
-                if (!intfMatches.has_value()) {
-                  continue;
-                }
-                if (*intfMatches) {
-                  toDelRoutes.push_back(network);
-                } else {
-                  XLOG(ERR) << "Skipping remote interface route delete for "
-                            << "interface " << intfID
-                            << " because the existing route does not belong "
-                               "to that interface";
-                }
-              }
-            }
-            if (toAddRoutes.empty() && toDelRoutes.empty()) {
-              return;
-            }
-            RibRouteUpdater updater(
-                &(routeTable.v4NetworkToRoute),
-                &(routeTable.v6NetworkToRoute),
-                &(routeTable.labelToRoute),
-                nextHopIDManager,
-                mySidTable);
-            updater.update(
-                {{ClientID::REMOTE_INTERFACE_ROUTE, toAddRoutes}},
-                {{ClientID::REMOTE_INTERFACE_ROUTE, toDelRoutes}},
-                {});
-          });
-      updateFib(resolver, vrf, ribToSwitchStateFunc, cookie);
+    if (!toAddRoutes.empty() || toDel.find(vrf) != toDel.end()) {
+      vrfsToUpdate.push_back(vrf);
     }
   }
+  updateRibAndFib(
+      resolver,
+      vrfsToUpdate,
+      [&](RouterID vrf,
+          auto& routeTable,
+          auto* mySidTable,
+          auto* nextHopIDManager) {
+        const auto& toAddRoutes = vrfToAddRoutes.at(vrf);
+        std::vector<folly::CIDRNetwork> toDelRoutes;
+        const auto& toDelIter = toDel.find(vrf);
+        if (toDelIter != toDel.end()) {
+          for (const auto& [network, intfID] : toDelIter->second) {
+            // Remote interface route deletion is guarded by the
+            // originating interface to avoid removing a prefix that was
+            // already replaced by another remote interface update.
+            auto intfMatches = routeIntfMatches(routeTable, network, intfID);
+            if (!intfMatches.has_value()) {
+              continue;
+            }
+            if (*intfMatches) {
+              toDelRoutes.push_back(network);
+            } else {
+              XLOG(ERR) << "Skipping remote interface route delete for "
+                        << "interface " << intfID
+                        << " because the existing route does not belong "
+                           "to that interface";
+            }
+          }
+        }
+        if (toAddRoutes.empty() && toDelRoutes.empty()) {
+          return;
+        }
+        RibRouteUpdater updater(
+            &(routeTable.v4NetworkToRoute),
+            &(routeTable.v6NetworkToRoute),
+            &(routeTable.labelToRoute),
+            nextHopIDManager,
+            mySidTable,
+            vrf,
+            &(routeTable.nextHopDependencies));
+        updater.update(
+            {{ClientID::REMOTE_INTERFACE_ROUTE, toAddRoutes}},
+            {{ClientID::REMOTE_INTERFACE_ROUTE, toDelRoutes}},
+            {});
+      },
+      true /* concurrentRibUpdateSafe */,
+      ribToSwitchStateFunc,
+      multiVrfRibToSwitchStateFunc,
+      cookie);
 }
 
 template <typename RouteType, typename RouteIdType>
@@ -638,70 +809,180 @@ void RibRouteTables::update(
     const RibToSwitchStateFunction& ribToSwitchStateFunc,
     void* cookie,
     std::size_t* cyclesDetectedOut) {
-  updateRib(
+  updateRibRoutes(
       routerID,
-      [&](auto& routeTable, auto* mySidTable, auto* nextHopIDManager) {
-        auto resolvedRoutes = toAddRoutes;
-        if constexpr (std::is_same_v<RouteType, RibRouteUpdater::RouteEntry>) {
-          if (nextHopIDManager) {
-            for (auto& routeEntry : resolvedRoutes) {
-              auto nhgName = routeEntry.nhopEntry.getNamedNextHopGroup();
-              if (!nhgName.has_value()) {
-                continue;
-              }
-              auto nhopsOpt = nextHopIDManager->getNextHopsForName(*nhgName);
-              if (!nhopsOpt.has_value()) {
-                throw FbossError(
-                    "Named next-hop group '", *nhgName, "' does not exist");
-              }
-              auto cleanupOldNhg = [&](const auto& existingRoute) {
-                auto oldEntry = existingRoute->getEntryForClient(clientID);
-                if (!oldEntry) {
-                  return;
-                }
-                auto oldNhg = oldEntry->getNamedNextHopGroup();
-                if (!oldNhg.has_value() || *oldNhg == *nhgName) {
-                  return;
-                }
-                if (existingRoute->numClientsForNamedNhg(*oldNhg) <= 1) {
-                  nextHopIDManager->removeRouteForNamedNhg(
-                      *oldNhg, routerID, routeEntry.prefix);
-                }
-              };
-              if (routeEntry.prefix.first.isV4()) {
-                auto it = routeTable.v4NetworkToRoute.exactMatch(
-                    routeEntry.prefix.first.asV4(), routeEntry.prefix.second);
-                if (it != routeTable.v4NetworkToRoute.end()) {
-                  cleanupOldNhg(it->value());
-                }
-              } else {
-                auto it = routeTable.v6NetworkToRoute.exactMatch(
-                    routeEntry.prefix.first.asV6(), routeEntry.prefix.second);
-                if (it != routeTable.v6NetworkToRoute.end()) {
-                  cleanupOldNhg(it->value());
-                }
-              }
+      clientID,
+      toAddRoutes,
+      toDelPrefixes,
+      resetClientsRoutes,
+      cyclesDetectedOut);
+  updateFib(resolver, routerID, ribToSwitchStateFunc, cookie);
+}
 
-              routeEntry.nhopEntry.setNextHops(*nhopsOpt);
-              nextHopIDManager->addRouteForNamedNhg(
-                  *nhgName, routerID, routeEntry.prefix);
-            }
+template <typename RouteType, typename RouteIdType>
+RibRouteTables::PendingFibUpdate RibRouteTables::updatePipelined(
+    const SwitchIdScopeResolver* resolver,
+    RouterID routerID,
+    ClientID clientID,
+    AdminDistance adminDistanceFromClientID,
+    const std::vector<RouteType>& toAddRoutes,
+    const std::vector<RouteIdType>& toDelPrefixes,
+    bool resetClientsRoutes,
+    folly::StringPiece updateType,
+    const PipelinedRibToSwitchStateFunction& pipelinedRibToSwitchStateFunc,
+    void* cookie,
+    std::size_t* cyclesDetectedOut) {
+  // Runs while the FIB update in flight, if any, is still being programmed
+  updateRibRoutes(
+      routerID,
+      clientID,
+      toAddRoutes,
+      toDelPrefixes,
+      resetClientsRoutes,
+      cyclesDetectedOut);
+  return updateFibPipelined(
+      resolver, routerID, pipelinedRibToSwitchStateFunc, cookie);
+}
+
+template <typename RouteType, typename RouteIdType>
+void RibRouteTables::updateRouteTable(
+    VrfRouteTable& routeTable,
+    MySidTable* mySidTable,
+    NextHopIDManager* nextHopIDManager,
+    RouterID routerID,
+    ClientID clientID,
+    const std::vector<RouteType>& toAddRoutes,
+    const std::vector<RouteIdType>& toDelPrefixes,
+    bool resetClientsRoutes,
+    std::size_t* cyclesDetectedOut) {
+  auto resolvedRoutes = toAddRoutes;
+  if constexpr (std::is_same_v<RouteType, RibRouteUpdater::RouteEntry>) {
+    if (nextHopIDManager) {
+      for (auto& routeEntry : resolvedRoutes) {
+        auto nhgName = routeEntry.nhopEntry.getNamedNextHopGroup();
+        if (!nhgName.has_value()) {
+          continue;
+        }
+        auto nhopsOpt = nextHopIDManager->getNextHopsForName(*nhgName);
+        if (!nhopsOpt.has_value()) {
+          throw FbossError(
+              "Named next-hop group '", *nhgName, "' does not exist");
+        }
+        auto cleanupOldNhg = [&](const auto& existingRoute) {
+          auto oldEntry = existingRoute->getEntryForClient(clientID);
+          if (!oldEntry) {
+            return;
+          }
+          auto oldNhg = oldEntry->getNamedNextHopGroup();
+          if (!oldNhg.has_value() || *oldNhg == *nhgName) {
+            return;
+          }
+          if (existingRoute->numClientsForNamedNhg(*oldNhg) <= 1) {
+            nextHopIDManager->removeRouteForNamedNhg(
+                *oldNhg, routerID, routeEntry.prefix);
+          }
+        };
+        if (routeEntry.prefix.first.isV4()) {
+          auto it = routeTable.v4NetworkToRoute.exactMatch(
+              routeEntry.prefix.first.asV4(), routeEntry.prefix.second);
+          if (it != routeTable.v4NetworkToRoute.end()) {
+            cleanupOldNhg(it->value());
+          }
+        } else {
+          auto it = routeTable.v6NetworkToRoute.exactMatch(
+              routeEntry.prefix.first.asV6(), routeEntry.prefix.second);
+          if (it != routeTable.v6NetworkToRoute.end()) {
+            cleanupOldNhg(it->value());
           }
         }
-        RibRouteUpdater updater(
-            &(routeTable.v4NetworkToRoute),
-            &(routeTable.v6NetworkToRoute),
-            &(routeTable.labelToRoute),
-            nextHopIDManager,
+
+        routeEntry.nhopEntry.setNextHops(*nhopsOpt);
+        nextHopIDManager->addRouteForNamedNhg(
+            *nhgName, routerID, routeEntry.prefix);
+      }
+    }
+  }
+  RibRouteUpdater updater(
+      &(routeTable.v4NetworkToRoute),
+      &(routeTable.v6NetworkToRoute),
+      &(routeTable.labelToRoute),
+      nextHopIDManager,
+      mySidTable,
+      routerID,
+      &(routeTable.nextHopDependencies));
+  updater.update(clientID, resolvedRoutes, toDelPrefixes, resetClientsRoutes);
+  if (cyclesDetectedOut) {
+    *cyclesDetectedOut += updater.cyclesDetected();
+  }
+}
+
+template <typename RouteType, typename RouteIdType>
+void RibRouteTables::updateRibRoutes(
+    RouterID routerID,
+    ClientID clientID,
+    const std::vector<RouteType>& toAddRoutes,
+    const std::vector<RouteIdType>& toDelPrefixes,
+    bool resetClientsRoutes,
+    std::size_t* cyclesDetectedOut) {
+  updateRib(
+      routerID,
+      [&](auto& routeTable, auto* mySidTable, auto* nextHopIDManager) {
+        updateRouteTable(
+            routeTable,
             mySidTable,
-            routerID);
-        updater.update(
-            clientID, resolvedRoutes, toDelPrefixes, resetClientsRoutes);
-        if (cyclesDetectedOut) {
-          *cyclesDetectedOut += updater.cyclesDetected();
+            nextHopIDManager,
+            routerID,
+            clientID,
+            toAddRoutes,
+            toDelPrefixes,
+            resetClientsRoutes,
+            cyclesDetectedOut);
+      },
+      true /* logsFibChanges */);
+}
+
+void RibRouteTables::update(
+    const SwitchIdScopeResolver* resolver,
+    const std::vector<VrfClientUpdate>& updates,
+    const RibToSwitchStateFunction& ribToSwitchStateFunc,
+    const MultiVrfRibToSwitchStateFunction& multiVrfRibToSwitchStateFunc,
+    void* cookie) {
+  std::vector<RouterID> vrfs;
+  std::map<RouterID, std::vector<const VrfClientUpdate*>> vrfToUpdates;
+  for (const auto& update : updates) {
+    auto& vrfUpdates = vrfToUpdates[update.vrf];
+    if (vrfUpdates.empty()) {
+      vrfs.push_back(update.vrf);
+    }
+    vrfUpdates.push_back(&update);
+  }
+  updateRibAndFib(
+      resolver,
+      vrfs,
+      [&](RouterID vrf,
+          auto& routeTable,
+          auto* mySidTable,
+          auto* nextHopIDManager) {
+        for (const auto* update : vrfToUpdates.at(vrf)) {
+          updateRouteTable(
+              routeTable,
+              mySidTable,
+              nextHopIDManager,
+              vrf,
+              update->client,
+              *update->toAdd,
+              *update->toDel,
+              update->resetClientsRoutes,
+              update->cyclesDetectedOut);
         }
-      });
-  updateFib(resolver, routerID, ribToSwitchStateFunc, cookie);
+      },
+      // Client updates only share NextHopIDManager and the MySid table
+      // across VRFs, and updateRib() resolves VRFs one at a time when either
+      // is in use
+      true /* concurrentRibUpdateSafe */,
+      ribToSwitchStateFunc,
+      multiVrfRibToSwitchStateFunc,
+      cookie);
 }
 
 void RibRouteTables::updateFib(
@@ -727,53 +1008,104 @@ void RibRouteTables::updateFib(
         StateDelta(gotDelta.oldState(), gotDelta.newState()));
     fibDelta.swap(tmp);
   } catch (const FbossHwUpdateError& hwUpdateError) {
-    {
-      SCOPE_FAIL {
-        XLOG(FATAL) << " RIB Rollback failed, aborting program";
-      };
-      auto fib =
-          hwUpdateError.appliedState->getFibsInfoMap()->getFibContainer(vrf);
-      auto lockedRouteTables = synchronizedRouteTables_.wlock();
-      auto& routeTable =
-          lockedRouteTables->routerIDToRouteTable.find(vrf)->second;
-      reconstructRib(
-          fib->getFibV4(),
-          &routeTable.v4NetworkToRoute,
-          routeTable.unresolvedV4Routes);
-      reconstructRib(
-          fib->getFibV6(),
-          &routeTable.v6NetworkToRoute,
-          routeTable.unresolvedV6Routes);
-      if (FLAGS_mpls_rib) {
-        auto labelFib =
-            hwUpdateError.appliedState->getLabelForwardingInformationBase();
-        reconstructRib(
-            labelFib,
-            &routeTable.labelToRoute,
-            routeTable.unresolvedMplsRoutes);
-      }
-
-      // Reconstruct NextHopIDManager from the applied state's FIB and MySid
-      // table
-      if (lockedRouteTables->nextHopIDManager) {
-        lockedRouteTables->nextHopIDManager->reconstructFromSwitchStateMaps(
-            hwUpdateError.appliedState->getFibsInfoMap(),
-            hwUpdateError.appliedState->getMySids(),
-            hwUpdateError.appliedState->getLabelForwardingInformationBase(),
-            this);
-      }
+    rollbackFib({vrf}, hwUpdateError.appliedState);
+    throw;
+  }
+  refreshUnresolvedIndexes({vrf});
+  CHECK(fibDelta.has_value());
+  updateEcmpOverrides(vrf, *fibDelta);
+}
 
-      // Reconstruct MySidTable from the applied state
-      reconstructMySidTableFromSwitchState(
-          hwUpdateError.appliedState->getMySids(),
-          &lockedRouteTables->mySidTable);
+void RibRouteTables::updateFib(
+    const SwitchIdScopeResolver* resolver,
+    const std::vector<RouterID>& vrfs,
+    const MultiVrfRibToSwitchStateFunction& multiVrfRibToSwitchStateFunc,
+    void* cookie) {
+  std::optional<StateDelta> fibDelta;
+  try {
+    auto lockedRouteTables = synchronizedRouteTables_.rlock();
+    std::vector<VrfNetworkToRouteMaps> vrfRouteMaps;
+    vrfRouteMaps.reserve(vrfs.size());
+    for (auto vrf : vrfs) {
+      const auto& routeTable =
+          lockedRouteTables->routerIDToRouteTable.find(vrf)->second;
+      vrfRouteMaps.push_back(
+          {vrf,
+           &routeTable.v4NetworkToRoute,
+           &routeTable.v6NetworkToRoute,
+           &routeTable.labelToRoute});
     }
+    auto gotDelta = multiVrfRibToSwitchStateFunc(
+        resolver,
+        vrfRouteMaps,
+        lockedRouteTables->nextHopIDManager.get(),
+        lockedRouteTables->mySidTable,
+        cookie);
+    std::optional<StateDelta> tmp(
+        StateDelta(gotDelta.oldState(), gotDelta.newState()));
+    fibDelta.swap(tmp);
+  } catch (const FbossHwUpdateError& hwUpdateError) {
+    rollbackFib(vrfs, hwUpdateError.appliedState);
     throw;
   }
-  // Refresh unresolved-routes index from the post-update RIB.
+  refreshUnresolvedIndexes(vrfs);
+  CHECK(fibDelta.has_value());
+  for (auto vrf : vrfs) {
+    updateEcmpOverrides(vrf, *fibDelta);
+  }
+}
+
+void RibRouteTables::rollbackFib(
+    const std::vector<RouterID>& vrfs,
+    const std::shared_ptr<SwitchState>& appliedState) {
+  SCOPE_FAIL {
+    XLOG(FATAL) << " RIB Rollback failed, aborting program";
+  };
+  auto lockedRouteTables = synchronizedRouteTables_.wlock();
+  for (auto vrf : vrfs) {
+    auto fib = appliedState->getFibsInfoMap()->getFibContainer(vrf);
+    auto& routeTable =
+        lockedRouteTables->routerIDToRouteTable.find(vrf)->second;
+    // Route tables are rebuilt from the applied state, next update must
+    // resolve from scratch
+    routeTable.nextHopDependencies.invalidate();
+    routeTable.invalidateLpmSnapshots();
+    routeTable.invalidateFibChanges();
+    reconstructRib(
+        fib->getFibV4(),
+        &routeTable.v4NetworkToRoute,
+        routeTable.unresolvedV4Routes);
+    reconstructRib(
+        fib->getFibV6(),
+        &routeTable.v6NetworkToRoute,
+        routeTable.unresolvedV6Routes);
+    if (FLAGS_mpls_rib) {
+      auto labelFib = appliedState->getLabelForwardingInformationBase();
+      reconstructRib(
+          labelFib, &routeTable.labelToRoute, routeTable.unresolvedMplsRoutes);
+    }
+  }
+
+  // Reconstruct NextHopIDManager from the applied state's FIB and MySid
+  // table
+  if (lockedRouteTables->nextHopIDManager) {
+    lockedRouteTables->nextHopIDManager->reconstructFromSwitchStateMaps(
+        appliedState->getFibsInfoMap(),
+        appliedState->getMySids(),
+        appliedState->getLabelForwardingInformationBase(),
+        this);
+  }
+
+  // Reconstruct MySidTable from the applied state
+  reconstructMySidTableFromSwitchState(
+      appliedState->getMySids(), &lockedRouteTables->mySidTable);
+}
+
+void RibRouteTables::refreshUnresolvedIndexes(
+    const std::vector<RouterID>& vrfs) {
   // Consumed by the rollback path (wired in the next diff).
-  {
-    auto lockedRouteTables = synchronizedRouteTables_.wlock();
+  auto lockedRouteTables = synchronizedRouteTables_.wlock();
+  for (auto vrf : vrfs) {
     auto& routeTable =
         lockedRouteTables->routerIDToRouteTable.find(vrf)->second;
     refreshUnresolvedIndex(
@@ -785,8 +1117,106 @@ void RibRouteTables::updateFib(
           routeTable.labelToRoute, &routeTable.unresolvedMplsRoutes);
     }
   }
-  CHECK(fibDelta.has_value());
-  updateEcmpOverrides(vrf, *fibDelta);
+}
+
+RibRouteTables::UnresolvedRoutes RibRouteTables::getUnresolvedRoutes(
+    RouterID vrf) {
+  UnresolvedRoutes unresolved;
+  auto lockedRouteTables = synchronizedRouteTables_.wlock();
+  auto& routeTable = lockedRouteTables->routerIDToRouteTable.find(vrf)->second;
+  refreshUnresolvedIndex(routeTable.v4NetworkToRoute, &unresolved.v4);
+  refreshUnresolvedIndex(routeTable.v6NetworkToRoute, &unresolved.v6);
+  if (FLAGS_mpls_rib) {
+    refreshUnresolvedMplsIndex(routeTable.labelToRoute, &unresolved.mpls);
+  }
+  return unresolved;
+}
+
+RibRouteTables::PendingFibUpdate RibRouteTables::updateFibPipelined(
+    const SwitchIdScopeResolver* resolver,
+    RouterID vrf,
+    const PipelinedRibToSwitchStateFunction& pipelinedRibToSwitchStateFunc,
+    void* cookie) {
+  // Unresolved routes as of this update, only installed once it is applied
+  // since rollbackFib() rebuilds the RIB from them
+  auto unresolved = getUnresolvedRoutes(vrf);
+  if (!fibPipeline_) {
+    fibPipeline_ = std::make_shared<StateUpdatePipeline>();
+  }
+  std::optional<PipelinedFibUpdate> fibUpdate;
+  std::exception_ptr fibUpdateError;
+  try {
+    auto lockedRouteTables = synchronizedRouteTables_.rlock();
+    auto& routeTable =
+        lockedRouteTables->routerIDToRouteTable.find(vrf)->second;
+    fibUpdate = pipelinedRibToSwitchStateFunc(
+        resolver,
+        vrf,
+        routeTable.v4NetworkToRoute,
+        routeTable.v6NetworkToRoute,
+        routeTable.labelToRoute,
+        lockedRouteTables->nextHopIDManager.get(),
+        lockedRouteTables->mySidTable,
+        fibPipeline_,
+        cookie);
+  } catch (const std::exception&) {
+    fibUpdateError = std::current_exception();
+  }
+  // The FIB update got computed once the one in flight was programmed. If
+  // that failed, this one failed along with it and gets rolled back too.
+  completeInFlightFibUpdate(vrf);
+  if (fibUpdateError) {
+    std::rethrow_exception(fibUpdateError);
+  }
+  inFlightFibUpdate_ = InFlightFibUpdate{
+      ++lastFibUpdateId_, vrf, std::move(*fibUpdate), std::move(unresolved)};
+  return {lastFibUpdateId_, inFlightFibUpdate_->fibUpdate.appliedState};
+}
+
+void RibRouteTables::completeFibUpdate(uint64_t id) {
+  if (inFlightFibUpdate_ && inFlightFibUpdate_->id == id) {
+    completeInFlightFibUpdate();
+  }
+}
+
+void RibRouteTables::drainFibPipeline() {
+  completeInFlightFibUpdate();
+}
+
+void RibRouteTables::completeInFlightFibUpdate(
+    std::optional<RouterID> updatedSinceVrf) {
+  if (!inFlightFibUpdate_) {
+    return;
+  }
+  auto inFlight = std::move(*inFlightFibUpdate_);
+  inFlightFibUpdate_.reset();
+  std::shared_ptr<SwitchState> appliedState;
+  try {
+    appliedState = inFlight.fibUpdate.appliedState.get();
+  } catch (const FbossHwUpdateError& hwUpdateError) {
+    std::vector<RouterID> vrfs{inFlight.vrf};
+    if (updatedSinceVrf && *updatedSinceVrf != inFlight.vrf) {
+      vrfs.push_back(*updatedSinceVrf);
+    }
+    XLOG(DBG2) << "Pipelined FIB update of vrf " << inFlight.vrf
+               << " failed, rolling back";
+    rollbackFib(vrfs, hwUpdateError.appliedState);
+    // The updates queued behind it failed with it, start over
+    fibPipeline_ = std::make_shared<StateUpdatePipeline>();
+    return;
+  }
+  {
+    auto lockedRouteTables = synchronizedRouteTables_.wlock();
+    auto& routeTable =
+        lockedRouteTables->routerIDToRouteTable.find(inFlight.vrf)->second;
+    routeTable.unresolvedV4Routes = std::move(inFlight.unresolved.v4);
+    routeTable.unresolvedV6Routes = std::move(inFlight.unresolved.v6);
+    if (FLAGS_mpls_rib) {
+      routeTable.unresolvedMplsRoutes = std::move(inFlight.unresolved.mpls);
+    }
+  }
+  updateEcmpOverrides(
+      inFlight.vrf, StateDelta(inFlight.fibUpdate.oldState, appliedState));
 }
 
 void RibRouteTables::updateFib(
@@ -1074,6 +1504,23 @@ std::shared_ptr<Route<AddressT>> RibRouteTables::longestMatch(
   return rt;
 }
 
+template <typename AddressT>
+std::vector<std::shared_ptr<Route<AddressT>>> RibRouteTables::longestMatch(
+    std::span<const AddressT> addresses,
+    RouterID vrf) const {
+  StopWatch lookupTimer(std::nullopt, false);
+  auto ribTables = synchronizedRouteTables_.rlock();
+  auto vrfIt = ribTables->routerIDToRouteTable.find(vrf);
+  auto routes = vrfIt == ribTables->routerIDToRouteTable.end()
+      ? std::vector<std::shared_ptr<Route<AddressT>>>(addresses.size())
+      : vrfIt->second.longestMatch(addresses);
+  if (lookupTimer.msecsElapsed().count() > 1000) {
+    XLOG(WARNING) << " Lookup for : " << addresses.size() << " addresses"
+                  << " took: " << lookupTimer.msecsElapsed().count() << " ms ";
+  }
+  return routes;
+}
+
 RibRouteTables::RouterIDToRouteTable RibRouteTables::constructRouteTables(
     const SynchronizedRouteTables::WLockedPtr& lockedRouteTables,
     const RouterIDAndNetworkToInterfaceRoutes& configRouterIDToInterfaceRoutes)
@@ -1146,9 +1593,11 @@ void RoutingInformationBase::reconfigure(
     const std::vector<cfg::StaticMplsRouteNoNextHops>& staticMplsRoutesToCpu,
     const std::vector<MySidWithNextHops>& staticMySids,
     RibToSwitchStateFunction ribToSwitchStateFunc,
-    void* cookie) {
+    void* cookie,
+    const MultiVrfRibToSwitchStateFunction& multiVrfRibToSwitchStateFunc) {
   ensureRunning();
   auto updateFn = [&] {
+    ribTables_.drainFibPipeline();
     ribTables_.reconfigure(
         resolver,
         configRouterIDToInterfaceRoutes,
@@ -1161,7 +1610,8 @@ void RoutingInformationBase::reconfigure(
         staticMplsRoutesToCpu,
         staticMySids,
         ribToSwitchStateFunc,
-        cookie);
+        cookie,
+        multiVrfRibToSwitchStateFunc);
   };
   ribUpdateEventBase_.runInFbossEventBaseThreadAndWait(updateFn);
 }
@@ -1175,9 +1625,15 @@ void RoutingInformationBase::updateRemoteInterfaceRoutes(
             std::pair<folly::CIDRNetwork, facebook::fboss::InterfaceID>>>&
         toDel,
     const RibToSwitchStateFunction& ribToSwitchStateFunc,
-    void* cookie) {
+    void* cookie,
+    const MultiVrfRibToSwitchStateFunction& multiVrfRibToSwitchStateFunc) {
   ribTables_.updateRemoteInterfaceRoutes(
-      resolver, toAdd, toDel, ribToSwitchStateFunc, cookie);
+      resolver,
+      toAdd,
+      toDel,
+      ribToSwitchStateFunc,
+      cookie,
+      multiVrfRibToSwitchStateFunc);
 }
 
 template <typename TraitsType>
@@ -1191,13 +1647,15 @@ RoutingInformationBase::UpdateStatistics RoutingInformationBase::updateImpl(
     bool resetClientsRoutes,
     folly::StringPiece updateType,
     RibToSwitchStateFunction ribToSwitchStateFunc,
-    void* cookie) {
+    void* cookie,
+    const PipelinedRibToSwitchStateFunction& pipelinedRibToSwitchStateFunc) {
   ensureRunning();
   UpdateStatistics stats;
   std::chrono::microseconds duration;
   std::shared_ptr<SwitchState> appliedState;
   Timer updateTimer(&duration);
   std::exception_ptr updateException;
+  std::optional<RibRouteTables::PendingFibUpdate> pendingFibUpdate;
   auto updateFn = [&]() {
     std::vector<typename TraitsType::RibRoute> toAddRoutes;
     toAddRoutes.reserve(toAdd.size());
@@ -1219,6 +1677,22 @@ RoutingInformationBase::UpdateStatistics RoutingInformationBase::updateImpl(
             toDelPrefixes.push_back(TraitsType::ToDelFn(prefix, stats));
           });
 
+      if (FLAGS_rib_fib_pipeline && pipelinedRibToSwitchStateFunc) {
+        pendingFibUpdate = ribTables_.updatePipelined(
+            resolver,
+            routerID,
+            clientID,
+            adminDistanceFromClientID,
+            toAddRoutes,
+            toDelPrefixes,
+            resetClientsRoutes,
+            updateType,
+            pipelinedRibToSwitchStateFunc,
+            cookie,
+            &stats.resolutionCyclesDetected);
+        return;
+      }
+      ribTables_.drainFibPipeline();
       ribTables_.update(
           resolver,
           routerID,
@@ -1239,6 +1713,15 @@ RoutingInformationBase::UpdateStatistics RoutingInformationBase::updateImpl(
   if (updateException) {
     std::rethrow_exception(updateException);
   }
+  if (pendingFibUpdate) {
+    // Wait for HW programming off the RIB thread, leaving it to resolve the
+    // next update meanwhile
+    pendingFibUpdate->appliedState.wait();
+    ribUpdateEventBase_.runInFbossEventBaseThreadAndWait(
+        [&] { ribTables_.completeFibUpdate(pendingFibUpdate->id); });
+    // Throws FbossHwUpdateError if programming failed
+    pendingFibUpdate->appliedState.get();
+  }
   stats.duration = duration;
   return stats;
 }
@@ -1253,6 +1736,7 @@ void RoutingInformationBase::setClassIDImpl(
     bool async) {
   ensureRunning();
   auto updateFn = [=, this]() {
+    ribTables_.drainFibPipeline();
     ribTables_.setClassID(
         resolver, rid, prefixes, ribToSwitchStateFunc, classId, cookie);
   };
@@ -1266,6 +1750,7 @@ void RoutingInformationBase::setClassIDImpl(
 void RoutingInformationBase::updateEcmpOverrides(const StateDelta& delta) {
   ensureRunning();
   auto updateFn = [=, &delta, this]() {
+    ribTables_.drainFibPipeline();
     ribTables_.updateEcmpOverrides(delta);
   };
   ribUpdateEventBase_.runInFbossEventBaseThreadAndWait(updateFn);
@@ -1370,6 +1855,9 @@ void RibRouteTables::backfillNextHopIds(
   };
 
   for (auto& [_vrf, table] : lockedRouteTables->routerIDToRouteTable) {
+    // Backfilled routes are replaced by clones, without logging them
+    table.invalidateLpmSnapshots();
+    table.invalidateFibChanges();
     backfillIpRoutes(table.v4NetworkToRoute);
     backfillIpRoutes(table.v6NetworkToRoute);
     backfillMplsRoutes(table.labelToRoute);
@@ -1381,14 +1869,73 @@ RibRouteTables RibRouteTables::fromThrift(
     const std::shared_ptr<MultiSwitchFibInfoMap>& fibsInfoMap,
     const std::shared_ptr<MultiLabelForwardingInformationBase>& labelFib,
     const std::shared_ptr<MultiSwitchMySidMap>& mySidMap) {
-  RibRouteTables rib;
-  auto lockedRouteTables = rib.synchronizedRouteTables_.wlock();
-
+  RouterIDToRouteTable routeTables;
   for (const auto& [rid, table] : ribThrift) {
     VrfRouteTable rtable = VrfRouteTable::fromThrift(table);
     auto vrf = RouterID(rid);
-    lockedRouteTables->routerIDToRouteTable.emplace(vrf, std::move(rtable));
+    routeTables.emplace(vrf, std::move(rtable));
   }
+  return fromRouteTables(
+      std::move(routeTables), fibsInfoMap, labelFib, mySidMap);
+}
+
+RibRouteTables RibRouteTables::fromWarmBootStateFile(
+    const std::string& path,
+    const std::shared_ptr<MultiSwitchFibInfoMap>& fibsInfoMap,
+    const std::shared_ptr<MultiLabelForwardingInformationBase>& labelFib,
+    const std::shared_ptr<MultiSwitchMySidMap>& mySidMap) {
+  using RecordType = RibWarmbootFile::RecordType;
+  RouterIDToRouteTable routeTables;
+  RibWarmbootFileReader reader(path);
+  // Routes go to the VRF of the last VRF record
+  std::optional<RouterID> vrf;
+  size_t numRoutes = 0;
+  while (auto record = reader.next()) {
+    if (record->type == RecordType::VRF) {
+      vrf = RibWarmbootFileReader::vrf(*record);
+      routeTables.try_emplace(*vrf);
+      continue;
+    }
+    if (!vrf) {
+      throw FbossError("Route outside of any VRF in ", path);
+    }
+    auto& routeTable = routeTables.find(*vrf)->second;
+    switch (record->type) {
+      case RecordType::V4_ROUTE: {
+        auto route = RibWarmbootFileReader::v4Route(*record);
+        routeTable.v4NetworkToRoute.insert(route->prefix(), route);
+        break;
+      }
+      case RecordType::V6_ROUTE: {
+        auto route = RibWarmbootFileReader::v6Route(*record);
+        routeTable.v6NetworkToRoute.insert(route->prefix(), route);
+        break;
+      }
+      case RecordType::MPLS_ROUTE: {
+        auto route = RibWarmbootFileReader::mplsRoute(*record);
+        routeTable.labelToRoute.insert(route->prefix(), route);
+        break;
+      }
+      case RecordType::VRF:
+      case RecordType::END:
+        break;
+    }
+    ++numRoutes;
+  }
+  XLOG(DBG2) << "Loaded " << numRoutes << " routes of " << routeTables.size()
+             << " VRFs from " << path;
+  return fromRouteTables(
+      std::move(routeTables), fibsInfoMap, labelFib, mySidMap);
+}
+
+RibRouteTables RibRouteTables::fromRouteTables(
+    RouterIDToRouteTable routeTables,
+    const std::shared_ptr<MultiSwitchFibInfoMap>& fibsInfoMap,
+    const std::shared_ptr<MultiLabelForwardingInformationBase>& labelFib,
+    const std::shared_ptr<MultiSwitchMySidMap>& mySidMap) {
+  RibRouteTables rib;
+  auto lockedRouteTables = rib.synchronizedRouteTables_.wlock();
+  lockedRouteTables->routerIDToRouteTable = std::move(routeTables);
 
   if (fibsInfoMap) {
     rib.importFibs(lockedRouteTables, fibsInfoMap, labelFib);
@@ -1478,6 +2025,18 @@ std::unique_ptr<RoutingInformationBase> RoutingInformationBase::fromThrift(
   return rib;
 }
 
+std::unique_ptr<RoutingInformationBase>
+RoutingInformationBase::fromWarmBootStateFile(
+    const std::string& path,
+    const std::shared_ptr<MultiSwitchFibInfoMap>& fibsInfoMap,
+    const std::shared_ptr<MultiLabelForwardingInformationBase>& labelFib,
+    const std::shared_ptr<MultiSwitchMySidMap>& mySidMap) {
+  auto rib = std::make_unique<RoutingInformationBase>();
+  rib->ribTables_ = RibRouteTables::fromWarmBootStateFile(
+      path, fibsInfoMap, labelFib, mySidMap);
+  return rib;
+}
+
 std::vector<MplsRouteDetails> RibRouteTables::getMplsRouteTableDetails() const {
   std::vector<MplsRouteDetails> mplsRouteDetails;
   synchronizedRouteTables_.withRLock([&](const auto& synchronizedRouteTables) {
@@ -1550,7 +2109,8 @@ RoutingInformationBase::UpdateStatistics RoutingInformationBase::update(
     bool resetClientsRoutes,
     folly::StringPiece updateType,
     RibToSwitchStateFunction ribToSwitchStateFunc,
-    void* cookie) {
+    void* cookie,
+    const PipelinedRibToSwitchStateFunction& pipelinedRibToSwitchStateFunc) {
   return updateImpl<RibIpRouteUpdate>(
       resolver,
       routerID,
@@ -1561,7 +2121,97 @@ RoutingInformationBase::UpdateStatistics RoutingInformationBase::update(
       resetClientsRoutes,
       updateType,
       ribToSwitchStateFunc,
-      cookie);
+      cookie,
+      pipelinedRibToSwitchStateFunc);
+}
+
+std::vector<RoutingInformationBase::UpdateStatistics>
+RoutingInformationBase::update(
+    const SwitchIdScopeResolver* resolver,
+    const std::vector<VrfClientUpdate>& updates,
+    folly::StringPiece updateType,
+    RibToSwitchStateFunction ribToSwitchStateFunc,
+    const MultiVrfRibToSwitchStateFunction& multiVrfRibToSwitchStateFunc,
+    void* cookie,
+    const PipelinedRibToSwitchStateFunction& pipelinedRibToSwitchStateFunc) {
+  std::set<RouterID> vrfs;
+  for (const auto& update : updates) {
+    vrfs.insert(update.vrf);
+  }
+  std::vector<UpdateStatistics> stats;
+  stats.reserve(updates.size());
+  if (vrfs.size() < 2 || !multiVrfRibToSwitchStateFunc ||
+      !getRibVrfUpdateExecutor()) {
+    for (const auto& update : updates) {
+      stats.push_back(this->update(
+          resolver,
+          update.vrf,
+          update.client,
+          update.adminDistanceFromClientID,
+          *update.toAdd,
+          *update.toDelete,
+          update.resetClientsRoutes,
+          updateType,
+          ribToSwitchStateFunc,
+          cookie,
+          pipelinedRibToSwitchStateFunc));
+    }
+    return stats;
+  }
+  ensureRunning();
+  stats.resize(updates.size());
+  std::chrono::microseconds duration;
+  std::exception_ptr updateException;
+  {
+    Timer updateTimer(&duration);
+    auto updateFn = [&]() {
+      try {
+        std::vector<std::vector<RibIpRouteUpdate::RibRoute>> toAddRoutes(
+            updates.size());
+        std::vector<std::vector<RibIpRouteUpdate::RibRouteId>> toDelPrefixes(
+            updates.size());
+        std::vector<RibRouteTables::VrfClientUpdate> vrfClientUpdates;
+        vrfClientUpdates.reserve(updates.size());
+        for (size_t idx = 0; idx < updates.size(); ++idx) {
+          const auto& update = updates[idx];
+          toAddRoutes[idx].reserve(update.toAdd->size());
+          for (const auto& route : *update.toAdd) {
+            toAddRoutes[idx].push_back(RibIpRouteUpdate::ToAddFn(
+                route, update.adminDistanceFromClientID, stats[idx]));
+          }
+          toDelPrefixes[idx].reserve(update.toDelete->size());
+          for (const auto& prefix : *update.toDelete) {
+            toDelPrefixes[idx].push_back(
+                RibIpRouteUpdate::ToDelFn(prefix, stats[idx]));
+          }
+          vrfClientUpdates.push_back(
+              {update.vrf,
+               update.client,
+               &toAddRoutes[idx],
+               &toDelPrefixes[idx],
+               update.resetClientsRoutes,
+               &stats[idx].resolutionCyclesDetected});
+        }
+        ribTables_.drainFibPipeline();
+        ribTables_.update(
+            resolver,
+            vrfClientUpdates,
+            ribToSwitchStateFunc,
+            multiVrfRibToSwitchStateFunc,
+            cookie);
+      } catch (const std::exception&) {
+        updateException = std::current_exception();
+      }
+    };
+    ribUpdateEventBase_.runInFbossEventBaseThreadAndWait(updateFn);
+  }
+  if (updateException) {
+    std::rethrow_exception(updateException);
+  }
+  for (auto& updateStats : stats) {
+    updateStats.duration = duration;
+  }
+  return stats;
 }
 
 RoutingInformationBase::UpdateStatistics RoutingInformationBase::update(
@@ -1585,7 +2235,8 @@ RoutingInformationBase::UpdateStatistics RoutingInformationBase::update(
       resetClientsRoutes,
       updateType,
       ribToSwitchStateFunc,
-      cookie);
+      cookie,
+      {} /* pipelinedRibToSwitchStateFunc */);
 }
 
 void RibRouteTables::update(
@@ -1792,6 +2443,7 @@ void RoutingInformationBase::update(
   std::exception_ptr updateException;
   auto updateFn = [&]() {
     try {
+      ribTables_.drainFibPipeline();
       ribTables_.update(
           resolver, toAdd, toDelete, ribMySidToSwitchStateFunc, cookie);
     } catch (const std::exception&) {
@@ -1825,6 +2477,7 @@ void RoutingInformationBase::updateMySidImpl(
                    updateException,
                    this]() {
     try {
+      ribTables_.drainFibPipeline();
       ribTables_.update(
           resolver,
           toAdd,
@@ -1852,7 +2505,10 @@ void RoutingInformationBase::updateMySidImpl(
 void RoutingInformationBase::updateStateInRibThread(
     const std::function<void()>& fn) {
   ensureRunning();
-  ribUpdateEventBase_.runInEventBaseThreadAndWait([fn] { fn(); });
+  ribUpdateEventBase_.runInEventBaseThreadAndWait([this, fn] {
+    ribTables_.drainFibPipeline();
+    fn();
+  });
 }
 
 template <typename RibUpdateFn>
@@ -2064,6 +2720,7 @@ void RoutingInformationBase::addOrUpdateNamedNextHopGroups(
   std::exception_ptr exceptionPtr;
   ribUpdateEventBase_.runInFbossEventBaseThreadAndWait([&]() {
     try {
+      ribTables_.drainFibPipeline();
       ribTables_.addOrUpdateNamedNextHopGroups(
           resolver, groups, ribToSwitchStateFunc, cookie);
     } catch (const std::exception&) {
@@ -2082,6 +2739,7 @@ void RoutingInformationBase::deleteNamedNextHopGroups(
   std::exception_ptr exceptionPtr;
   ribUpdateEventBase_.runInFbossEventBaseThreadAndWait([&]() {
     try {
+      ribTables_.drainFibPipeline();
       ribTables_.deleteNamedNextHopGroups(names, stateUpdateFn);
     } catch (const std::exception&) {
       exceptionPtr = std::current_exception();
@@ -2111,6 +2769,30 @@ std::map<int32_t, state::RouteTableFields> RibRouteTables::warmBootState()
   return obj;
 }
 
+void RibRouteTables::writeWarmBootStateFile(const std::string& path) const {
+  RibWarmbootFileWriter writer(path);
+  // As warmBootState(), only unresolved routes, the rest comes from FIBs
+  auto writeUnresolved = [&writer](const auto& route) {
+    if (!route->isResolved()) {
+      writer.addRoute(*route);
+    }
+  };
+  const auto& routeTables = synchronizedRouteTables_.rlock();
+  for (const auto& [rid, routeTable] : routeTables->routerIDToRouteTable) {
+    writer.startVrf(rid);
+    for (const auto& node : routeTable.v4NetworkToRoute) {
+      writeUnresolved(node.value());
+    }
+    for (const auto& node : routeTable.v6NetworkToRoute) {
+      writeUnresolved(node.value());
+    }
+    for (const auto& [_label, route] : routeTable.labelToRoute) {
+      writeUnresolved(route);
+    }
+  }
+  writer.finish();
+}
+
 RibRouteTables RibRouteTables::fromThrift(
     const std::map<int32_t, state::RouteTableFields>& obj) {
   RibRouteTables ribRouteTables;
@@ -2170,6 +2852,9 @@ void RibRouteTables::importFibs(
       const auto& fibContainer = iter.second;
       auto& routeTables =
           lockedRouteTables->routerIDToRouteTable[fibContainer->getID()];
+      routeTables.nextHopDependencies.invalidate();
+      routeTables.invalidateLpmSnapshots();
+      routeTables.invalidateFibChanges();
       importRoutes(fibContainer->getFibV6(), &routeTables.v6NetworkToRoute);
       importRoutes(fibContainer->getFibV4(), &routeTables.v4NetworkToRoute);
       auto mplsTable = &routeTables.labelToRoute;
@@ -2237,6 +2922,14 @@ RibRouteTables::longestMatch(const folly::IPAddressV4& address, RouterID vrf)
 template std::shared_ptr<Route<folly::IPAddressV6>>
 RibRouteTables::longestMatch(const folly::IPAddressV6& address, RouterID vrf)
     const;
+template std::vector<std::shared_ptr<Route<folly::IPAddressV4>>>
+RibRouteTables::longestMatch(
+    std::span<const folly::IPAddressV4> addresses,
+    RouterID vrf) const;
+template std::vector<std::shared_ptr<Route<folly::IPAddressV6>>>
+RibRouteTables::longestMatch(
+    std::span<const folly::IPAddressV6> addresses,
+    RouterID vrf) const;
 
 template void reconstructRib<
     folly::IPAddressV4,
@@ -24,12 +24,23 @@
 
 #include <folly/Synchronized.h>
 
+#include <cstdint>
 #include <functional>
+#include <future>
 #include <memory>
+#include <optional>
+#include <span>
+#include <string>
 #include <thread>
 #include <vector>
 
 DECLARE_bool(mpls_rib);
+DECLARE_int32(rib_vrf_update_threads);
+DECLARE_bool(rib_fib_pipeline);
+
+namespace folly {
+class Executor;
+} // namespace folly
 
 namespace facebook::fboss {
 class SwitchState;
@@ -37,6 +48,7 @@ class MultiSwitchFibInfoMap;
 class MultiSwitchMySidMap;
 class SwitchIdScopeResolver;
 class StateDelta;
+struct StateUpdatePipeline;
 
 // Rebuilds the RIB from a FIB plus an explicit set of unresolved routes.
 // Used by the rollback path on FbossHwUpdateError.
@@ -60,6 +72,57 @@ using RibToSwitchStateFunction = std::function<StateDelta(
     const MySidTable& mySidTable,
     void* cookie)>;
 
+// Same as RibToSwitchStateFunction, but programs the FIBs of all the given
+// VRFs in a single SwitchState update
+using MultiVrfRibToSwitchStateFunction = std::function<StateDelta(
+    const SwitchIdScopeResolver* resolver,
+    const std::vector<VrfNetworkToRouteMaps>& vrfRouteMaps,
+    const NextHopIDManager* nextHopIDManager,
+    const MySidTable& mySidTable,
+    void* cookie)>;
+
+// FIB update handed over to HW by a PipelinedRibToSwitchStateFunction
+struct PipelinedFibUpdate {
+  // State the update was computed on top of
+  std::shared_ptr<SwitchState> oldState;
+  // State once applied to HW, FbossHwUpdateError if that failed
+  std::shared_future<std::shared_ptr<SwitchState>> appliedState;
+};
+
+/*
+ * Pipelined version of RibToSwitchStateFunction, see --rib_fib_pipeline.
+ * Returns once the FIB update is computed and queued up to be applied to
+ * HW, rather than once it is applied. Must fail the update with
+ * FbossHwUpdateError, without applying it, if an earlier update of the
+ * pipeline failed to apply.
+ */
+using PipelinedRibToSwitchStateFunction = std::function<PipelinedFibUpdate(
+    const SwitchIdScopeResolver* resolver,
+    RouterID vrf,
+    const IPv4NetworkToRouteMap& v4NetworkToRoute,
+    const IPv6NetworkToRouteMap& v6NetworkToRoute,
+    const LabelToRouteMap& labelToRoute,
+    const NextHopIDManager* nextHopIDManager,
+    const MySidTable& mySidTable,
+    const std::shared_ptr<StateUpdatePipeline>& pipeline,
+    void* cookie)>;
+
+/*
+ * Worker pool used to resolve VRFs and build their FIBs concurrently.
+ * Returns null unless --rib_vrf_update_threads asks for more than one
+ * thread.
+ */
+folly::Executor* getRibVrfUpdateExecutor();
+
+/*
+ * Run task(0) ... task(numTasks - 1) on the RIB VRF update worker pool and
+ * wait for all of them, rethrowing the first failure. Tasks run inline, in
+ * order, if there is no worker pool.
+ */
+void runRibVrfUpdateTasks(
+    size_t numTasks,
+    const std::function<void(size_t)>& task);
+
 using RibMySidToSwitchStateFunction = std::function<StateDelta(
     const SwitchIdScopeResolver* resolver,
     const NextHopIDManager* nextHopIDManager,
@@ -162,6 +225,64 @@ class RibRouteTables {
       void* cookie,
       std::size_t* cyclesDetectedOut = nullptr);
 
+  // A client's IP route update for one VRF, see update() below
+  struct VrfClientUpdate {
+    RouterID vrf;
+    ClientID client;
+    const std::vector<RibRouteUpdater::RouteEntry>* toAdd;
+    const std::vector<folly::CIDRNetwork>* toDel;
+    bool resetClientsRoutes;
+    std::size_t* cyclesDetectedOut;
+  };
+
+  /*
+   * Client updates spanning several VRFs. Updates of a VRF are applied in
+   * order, and VRFs are resolved and programmed through updateRibAndFib():
+   * concurrently and in a single SwitchState update with
+   * --rib_vrf_update_threads and a multiVrfRibToSwitchStateFunc.
+   */
+  void update(
+      const SwitchIdScopeResolver* resolver,
+      const std::vector<VrfClientUpdate>& updates,
+      const RibToSwitchStateFunction& ribToSwitchStateFunc,
+      const MultiVrfRibToSwitchStateFunction& multiVrfRibToSwitchStateFunc,
+      void* cookie);
+
+  // Pipelined FIB update, see updatePipelined()
+  struct PendingFibUpdate {
+    uint64_t id;
+    // State once applied to HW, FbossHwUpdateError if that failed
+    std::shared_future<std::shared_ptr<SwitchState>> appliedState;
+  };
+
+  /*
+   * Pipelined version of update(), see --rib_fib_pipeline. Returns once
+   * the FIB update is queued up to be programmed, the RIB being free to
+   * resolve the next update meanwhile. A single FIB update is in flight at
+   * a time: it gets completed by completeFibUpdate(), or by the next
+   * update, whose FIB can only be computed once it is programmed. If
+   * programming it failed, both get rolled back and fail.
+   *
+   * All other RIB updates must drainFibPipeline() first.
+   */
+  template <typename RouteType, typename RouteIdType>
+  PendingFibUpdate updatePipelined(
+      const SwitchIdScopeResolver* resolver,
+      RouterID routerID,
+      ClientID clientID,
+      AdminDistance adminDistanceFromClientID,
+      const std::vector<RouteType>& toAddRoutes,
+      const std::vector<RouteIdType>& toDelPrefixes,
+      bool resetClientsRoutes,
+      folly::StringPiece updateType,
+      const PipelinedRibToSwitchStateFunction& pipelinedRibToSwitchStateFunc,
+      void* cookie,
+      std::size_t* cyclesDetectedOut = nullptr);
+  // Complete FIB update id once programmed, unless completed already
+  void completeFibUpdate(uint64_t id);
+  // Complete the FIB update in flight, if any
+  void drainFibPipeline();
+
   void update(
       const SwitchIdScopeResolver* resolver,
       const std::vector<MySidEntry>& toAdd,
@@ -222,7 +343,9 @@ class RibRouteTables {
       const std::vector<cfg::StaticMplsRouteNoNextHops>& staticMplsRoutesToCpu,
       const std::vector<MySidWithNextHops>& staticMySids,
       RibToSwitchStateFunction ribToSwitchStateFunc,
-      void* cookie);
+      void* cookie,
+      const MultiVrfRibToSwitchStateFunction& multiVrfRibToSwitchStateFunc =
+          {});
 
   void updateRemoteInterfaceRoutes(
       const SwitchIdScopeResolver* resolver,
@@ -233,7 +356,9 @@ class RibRouteTables {
               std::pair<folly::CIDRNetwork, facebook::fboss::InterfaceID>>>&
           toDel,
       const RibToSwitchStateFunction& ribToSwitchStateFunc,
-      void* cookie);
+      void* cookie,
+      const MultiVrfRibToSwitchStateFunction& multiVrfRibToSwitchStateFunc =
+          {});
 
   /*
    * FIB assisted fromThrift. With shared data structure of routes
@@ -246,6 +371,13 @@ class RibRouteTables {
       const std::shared_ptr<MultiSwitchFibInfoMap>& fibsInfoMap,
       const std::shared_ptr<MultiLabelForwardingInformationBase>& labelFib,
       const std::shared_ptr<MultiSwitchMySidMap>& mySidMap);
+  // Same as above, unresolved routes being streamed from a file written
+  // by writeWarmBootStateFile
+  static RibRouteTables fromWarmBootStateFile(
+      const std::string& path,
+      const std::shared_ptr<MultiSwitchFibInfoMap>& fibsInfoMap,
+      const std::shared_ptr<MultiLabelForwardingInformationBase>& labelFib,
+      const std::shared_ptr<MultiSwitchMySidMap>& mySidMap);
 
   void ensureVrf(RouterID rid);
   std::vector<RouterID> getVrfList() const;
@@ -262,6 +394,13 @@ class RibRouteTables {
       const AddressT& address,
       RouterID vrf) const;
 
+  // Longest matches of a batch of addresses under a single lock, the i-th
+  // route returned (nullptr if none) matching addresses[i]
+  template <typename AddressT>
+  std::vector<std::shared_ptr<Route<AddressT>>> longestMatch(
+      std::span<const AddressT> addresses,
+      RouterID vrf) const;
+
   // Atomically perform longestMatch + NextHopSetID resolution under a single
   // rlock on synchronizedRouteTables_. Returns nullopt if no route found.
   // Otherwise returns {route, resolved nexthops}.
@@ -278,19 +417,117 @@ class RibRouteTables {
   static RibRouteTables fromThrift(
       const std::map<int32_t, state::RouteTableFields>&);
   std::map<int32_t, state::RouteTableFields> warmBootState() const;
+  // warmBootState() streamed route by route to a RibWarmbootFile
+  void writeWarmBootStateFile(const std::string& path) const;
 
   void updateEcmpOverrides(const StateDelta& delta);
 
  private:
+  // Apply a client's routes to routeTable and resolve it
+  template <typename RouteType, typename RouteIdType>
+  static void updateRouteTable(
+      VrfRouteTable& routeTable,
+      MySidTable* mySidTable,
+      NextHopIDManager* nextHopIDManager,
+      RouterID routerID,
+      ClientID clientID,
+      const std::vector<RouteType>& toAddRoutes,
+      const std::vector<RouteIdType>& toDelPrefixes,
+      bool resetClientsRoutes,
+      std::size_t* cyclesDetectedOut);
+  template <typename RouteType, typename RouteIdType>
+  void updateRibRoutes(
+      RouterID routerID,
+      ClientID clientID,
+      const std::vector<RouteType>& toAddRoutes,
+      const std::vector<RouteIdType>& toDelPrefixes,
+      bool resetClientsRoutes,
+      std::size_t* cyclesDetectedOut);
   void updateFib(
       const SwitchIdScopeResolver* resolver,
       RouterID vrf,
       const RibToSwitchStateFunction& ribToSwitchStateFunc,
       void* cookie);
+
+  // Unresolved-routes indexes of a VRF, see VrfRouteTable
+  struct UnresolvedRoutes {
+    decltype(VrfRouteTable::unresolvedV4Routes) v4;
+    decltype(VrfRouteTable::unresolvedV6Routes) v6;
+    decltype(VrfRouteTable::unresolvedMplsRoutes) mpls;
+  };
+  struct InFlightFibUpdate {
+    uint64_t id;
+    RouterID vrf;
+    PipelinedFibUpdate fibUpdate;
+    // Installed in the VRF's route table once programmed
+    UnresolvedRoutes unresolved;
+  };
+  UnresolvedRoutes getUnresolvedRoutes(RouterID vrf);
+  PendingFibUpdate updateFibPipelined(
+      const SwitchIdScopeResolver* resolver,
+      RouterID vrf,
+      const PipelinedRibToSwitchStateFunction& pipelinedRibToSwitchStateFunc,
+      void* cookie);
+  /*
+   * Wait for the FIB update in flight to be programmed and complete it. If
+   * programming failed, roll back its VRF, plus updatedSinceVrf if the RIB
+   * of that got updated since.
+   */
+  void completeInFlightFibUpdate(
+      std::optional<RouterID> updatedSinceVrf = std::nullopt);
+  /*
+   * updateRib() must log the routes it changes for the next FIB update
+   * (see NetworkToRouteMap::logFibChange()) if logsFibChanges, the next FIB
+   * update walks the whole RIB otherwise.
+   */
   template <typename RibUpdateFn>
-  void updateRib(RouterID vrf, const RibUpdateFn& updateRib);
+  void updateRib(
+      RouterID vrf,
+      const RibUpdateFn& updateRib,
+      bool logsFibChanges = false);
   void updateEcmpOverrides(RouterID vrf, const StateDelta& delta);
 
+  /*
+   * Multi-VRF updates. updateRibFn is invoked as
+   * updateRibFn(vrf, routeTable, mySidTable, nextHopIDManager) once per VRF.
+   *
+   * When --rib_vrf_update_threads enables the worker pool and the caller
+   * supplied a MultiVrfRibToSwitchStateFunction, VRFs are resolved on the
+   * pool and all their FIBs are programmed in one SwitchState update.
+   * Otherwise each VRF is resolved and programmed in turn.
+   *
+   * NextHopIDManager and the MySid table are shared by all VRFs and are not
+   * thread safe, so VRFs are only resolved concurrently when neither is in
+   * use and the caller vouches (concurrentRibUpdateSafe) that updateRibFn
+   * touches nothing but the VRF's own route table. FIB construction is
+   * always done on the pool in that mode.
+   */
+  template <typename RibUpdateFn>
+  void updateRibAndFib(
+      const SwitchIdScopeResolver* resolver,
+      const std::vector<RouterID>& vrfs,
+      const RibUpdateFn& updateRibFn,
+      bool concurrentRibUpdateSafe,
+      const RibToSwitchStateFunction& ribToSwitchStateFunc,
+      const MultiVrfRibToSwitchStateFunction& multiVrfRibToSwitchStateFunc,
+      void* cookie);
+  template <typename RibUpdateFn>
+  void updateRib(
+      const std::vector<RouterID>& vrfs,
+      const RibUpdateFn& updateRibFn,
+      bool concurrentRibUpdateSafe);
+  void updateFib(
+      const SwitchIdScopeResolver* resolver,
+      const std::vector<RouterID>& vrfs,
+      const MultiVrfRibToSwitchStateFunction& multiVrfRibToSwitchStateFunc,
+      void* cookie);
+  // Roll the route tables of vrfs back to the state that made it to HW
+  void rollbackFib(
+      const std::vector<RouterID>& vrfs,
+      const std::shared_ptr<SwitchState>& appliedState);
+  // Refresh unresolved-routes indexes from the post-update RIB
+  void refreshUnresolvedIndexes(const std::vector<RouterID>& vrfs);
+
   /*
    * MySid updates
    */
@@ -329,6 +566,14 @@ class RibRouteTables {
 
   using SynchronizedRouteTables = folly::Synchronized<RouteTables>;
 
+  // Build RIB from the warm boot route tables, with the FIB and MySid
+  // state of the switch
+  static RibRouteTables fromRouteTables(
+      RouterIDToRouteTable routeTables,
+      const std::shared_ptr<MultiSwitchFibInfoMap>& fibsInfoMap,
+      const std::shared_ptr<MultiLabelForwardingInformationBase>& labelFib,
+      const std::shared_ptr<MultiSwitchMySidMap>& mySidMap);
+
   void importFibs(
       const SynchronizedRouteTables::WLockedPtr& lockedRouteTables,
       const std::shared_ptr<MultiSwitchFibInfoMap>& fibsInfoMap,
@@ -355,7 +600,16 @@ class RibRouteTables {
   static void backfillNextHopIds(
       const SynchronizedRouteTables::WLockedPtr& lockedRouteTables);
 
+  // Re-resolve MySids against the updated route tables
+  static void resolveMySids(
+      const SynchronizedRouteTables::WLockedPtr& lockedRouteTables);
+
   SynchronizedRouteTables synchronizedRouteTables_;
+
+  // FIB pipeline state, only accessed on the RIB thread
+  std::shared_ptr<StateUpdatePipeline> fibPipeline_;
+  std::optional<InFlightFibUpdate> inFlightFibUpdate_;
+  uint64_t lastFibUpdateId_{0};
 };
 
 class RoutingInformationBase {
@@ -400,6 +654,11 @@ class RoutingInformationBase {
    * this mapping is exposed via SwSwitch, which we can't a dependency on here.
    * The adminDistanceFromClientID allows callsites to propagate admin distances
    * per client.
+   *
+   * With --rib_fib_pipeline and a pipelinedRibToSwitchStateFunc, step 3
+   * only hands the FIB update over to HW. The RIB thread moves on to the
+   * next update while update() waits for HW programming to complete, see
+   * RibRouteTables::updatePipelined().
    */
   UpdateStatistics update(
       const SwitchIdScopeResolver* resolver,
@@ -411,7 +670,39 @@ class RoutingInformationBase {
       bool resetClientsRoutes,
       folly::StringPiece updateType,
       RibToSwitchStateFunction ribToSwitchStateFunc,
-      void* cookie);
+      void* cookie,
+      const PipelinedRibToSwitchStateFunction& pipelinedRibToSwitchStateFunc =
+          {});
+
+  // A client's IP route update for one VRF, see update() below
+  struct VrfClientUpdate {
+    RouterID vrf;
+    ClientID client;
+    AdminDistance adminDistanceFromClientID;
+    const std::vector<UnicastRoute>* toAdd;
+    const std::vector<IpPrefix>* toDelete;
+    bool resetClientsRoutes;
+  };
+
+  /*
+   * Client updates spanning several VRFs, e.g. a RouteUpdateWrapper batch.
+   * With --rib_vrf_update_threads and a multiVrfRibToSwitchStateFunc, the
+   * VRFs are resolved concurrently and programmed in a single SwitchState
+   * update, see RibRouteTables::updateRibAndFib(). Otherwise, or for a
+   * single VRF, each update goes through update() above in turn.
+   *
+   * Returns the statistics of each update, in order. Updates done in one go
+   * all get the duration of the whole batch.
+   */
+  std::vector<UpdateStatistics> update(
+      const SwitchIdScopeResolver* resolver,
+      const std::vector<VrfClientUpdate>& updates,
+      folly::StringPiece updateType,
+      RibToSwitchStateFunction ribToSwitchStateFunc,
+      const MultiVrfRibToSwitchStateFunction& multiVrfRibToSwitchStateFunc,
+      void* cookie,
+      const PipelinedRibToSwitchStateFunction& pipelinedRibToSwitchStateFunc =
+          {});
 
   UpdateStatistics update(
       const SwitchIdScopeResolver* resolver,
@@ -511,7 +802,9 @@ class RoutingInformationBase {
       const std::vector<cfg::StaticMplsRouteNoNextHops>& staticMplsRoutesToCpu,
       const std::vector<MySidWithNextHops>& staticMySids,
       RibToSwitchStateFunction ribToSwitchStateFunc,
-      void* cookie);
+      void* cookie,
+      const MultiVrfRibToSwitchStateFunction& multiVrfRibToSwitchStateFunc =
+          {});
 
   void updateRemoteInterfaceRoutes(
       const SwitchIdScopeResolver* resolver,
@@ -522,7 +815,9 @@ class RoutingInformationBase {
               std::pair<folly::CIDRNetwork, facebook::fboss::InterfaceID>>>&
           toDel,
       const RibToSwitchStateFunction& ribToSwitchStateFunc,
-      void* cookie);
+      void* cookie,
+      const MultiVrfRibToSwitchStateFunction& multiVrfRibToSwitchStateFunc =
+          {});
 
   void setClassID(
       const SwitchIdScopeResolver* resolver,
@@ -559,6 +854,11 @@ class RoutingInformationBase {
       const std::shared_ptr<MultiSwitchFibInfoMap>& fibsInfoMap,
       const std::shared_ptr<MultiLabelForwardingInformationBase>& labelFib,
       const std::shared_ptr<MultiSwitchMySidMap>& mySidMap);
+  static std::unique_ptr<RoutingInformationBase> fromWarmBootStateFile(
+      const std::string& path,
+      const std::shared_ptr<MultiSwitchFibInfoMap>& fibsInfoMap,
+      const std::shared_ptr<MultiLabelForwardingInformationBase>& labelFib,
+      const std::shared_ptr<MultiSwitchMySidMap>& mySidMap);
 
   void ensureVrf(RouterID rid) {
     ribTables_.ensureVrf(rid);
@@ -590,6 +890,13 @@ class RoutingInformationBase {
     return ribTables_.longestMatch(address, vrf);
   }
 
+  template <typename AddressT>
+  std::vector<std::shared_ptr<Route<AddressT>>> longestMatch(
+      std::span<const AddressT> addresses,
+      const RouterID& vrf) const {
+    return ribTables_.longestMatch(addresses, vrf);
+  }
+
   template <typename AddressT>
   std::optional<std::pair<std::shared_ptr<Route<AddressT>>, RouteNextHopSet>>
   getRouteAndNextHops(
@@ -603,6 +910,9 @@ class RoutingInformationBase {
   static std::unique_ptr<RoutingInformationBase> fromThrift(
       const std::map<int32_t, state::RouteTableFields>&);
   std::map<int32_t, state::RouteTableFields> warmBootState() const;
+  void writeWarmBootStateFile(const std::string& path) const {
+    ribTables_.writeWarmBootStateFile(path);
+  }
 
   // Returns a deep copy of the NextHopIDManager. This is an expensive
   // operation and is intended only for tests.
@@ -676,7 +986,8 @@ class RoutingInformationBase {
       bool resetClientsRoutes,
       folly::StringPiece updateType,
       RibToSwitchStateFunction ribToSwitchStateFunc,
-      void* cookie);
+      void* cookie,
+      const PipelinedRibToSwitchStateFunction& pipelinedRibToSwitchStateFunc);
 
   std::unique_ptr<std::thread> ribUpdateThread_;
   FbossEventBase ribUpdateEventBase_{"RibUpdateEventBase"};
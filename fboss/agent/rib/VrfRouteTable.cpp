@@ -9,6 +9,12 @@
  */
 #include "fboss/agent/rib/VrfRouteTable.h"
 
+DEFINE_bool(
+    rib_lpm_snapshot,
+    false,
+    "Serve RIB longest prefix match lookups from compressed snapshots of "
+    "the route tables, rebuilt once enough lookups follow a route change");
+
 namespace facebook::fboss {
 
 state::RouteTableFields VrfRouteTable::toThrift() const {
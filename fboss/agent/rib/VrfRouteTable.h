@@ -11,12 +11,19 @@
 
 #include "fboss/agent/gen-cpp2/switch_state_types.h"
 #include "fboss/agent/rib/NetworkToRouteMap.h"
+#include "fboss/agent/rib/NextHopDependencyIndex.h"
 #include "fboss/agent/state/Route.h"
+#include "fboss/lib/LpmSnapshot.h"
 
 #include <folly/IPAddress.h>
+#include <gflags/gflags.h>
 
 #include <memory>
+#include <span>
 #include <unordered_map>
+#include <vector>
+
+DECLARE_bool(rib_lpm_snapshot);
 
 namespace facebook::fboss {
 
@@ -26,6 +33,9 @@ struct VrfRouteTable {
   IPv4NetworkToRouteMap v4NetworkToRoute;
   IPv6NetworkToRouteMap v6NetworkToRoute;
   LabelToRouteMap labelToRoute;
+  // Next hop -> dependent routes index used for incremental resolution.
+  // Starts out invalid and gets built by the first full resolution.
+  NextHopDependencyIndex nextHopDependencies;
 
   std::unordered_map<
       folly::CIDRNetworkV4,
@@ -38,6 +48,17 @@ struct VrfRouteTable {
   std::unordered_map<LabelID, std::shared_ptr<Route<LabelID>>>
       unresolvedMplsRoutes;
 
+  // Compressed lookup tables serving longestMatch(), rebuilt lazily from
+  // the radix trees. Must be invalidated whenever the trees change.
+  network::LpmSnapshotCache<
+      folly::IPAddressV4,
+      std::shared_ptr<Route<folly::IPAddressV4>>>
+      v4LpmSnapshot;
+  network::LpmSnapshotCache<
+      folly::IPAddressV6,
+      std::shared_ptr<Route<folly::IPAddressV6>>>
+      v6LpmSnapshot;
+
   bool operator==(const VrfRouteTable& other) const {
     return v4NetworkToRoute == other.v4NetworkToRoute &&
         v6NetworkToRoute == other.v6NetworkToRoute;
@@ -47,17 +68,74 @@ struct VrfRouteTable {
   }
   std::shared_ptr<Route<folly::IPAddressV4>> longestMatch(
       const folly::IPAddressV4& addr) const {
+    if (FLAGS_rib_lpm_snapshot) {
+      auto route = v4LpmSnapshot.longestMatch(v4NetworkToRoute, addr);
+      return route ? *route : nullptr;
+    }
     auto it = v4NetworkToRoute.longestMatch(addr, addr.bitCount());
     return it == v4NetworkToRoute.end() ? nullptr : it->value();
   }
   std::shared_ptr<Route<folly::IPAddressV6>> longestMatch(
       const folly::IPAddressV6& addr) const {
+    if (FLAGS_rib_lpm_snapshot) {
+      auto route = v6LpmSnapshot.longestMatch(v6NetworkToRoute, addr);
+      return route ? *route : nullptr;
+    }
     auto it = v6NetworkToRoute.longestMatch(addr, addr.bitCount());
     return it == v6NetworkToRoute.end() ? nullptr : it->value();
   }
+  // Batched longestMatch, the i-th route returned matching addrs[i]
+  std::vector<std::shared_ptr<Route<folly::IPAddressV4>>> longestMatch(
+      std::span<const folly::IPAddressV4> addrs) const {
+    return longestMatchBatch(v4NetworkToRoute, v4LpmSnapshot, addrs);
+  }
+  std::vector<std::shared_ptr<Route<folly::IPAddressV6>>> longestMatch(
+      std::span<const folly::IPAddressV6> addrs) const {
+    return longestMatchBatch(v6NetworkToRoute, v6LpmSnapshot, addrs);
+  }
+  void invalidateLpmSnapshots() {
+    v4LpmSnapshot.invalidate();
+    v6LpmSnapshot.invalidate();
+  }
+  // Routes changed without logging them, see NetworkToRouteMap
+  void invalidateFibChanges() {
+    v4NetworkToRoute.invalidateFibChanges();
+    v6NetworkToRoute.invalidateFibChanges();
+  }
+  // Needs the RIB write lock, see NetworkToRouteMap
+  void restartFibChanges() {
+    v4NetworkToRoute.restartFibChanges();
+    v6NetworkToRoute.restartFibChanges();
+  }
   state::RouteTableFields toThrift() const;
   static VrfRouteTable fromThrift(const state::RouteTableFields&);
   state::RouteTableFields warmBootState() const;
+
+ private:
+  template <typename AddressT, typename SnapshotCache>
+  static std::vector<std::shared_ptr<Route<AddressT>>> longestMatchBatch(
+      const NetworkToRouteMap<AddressT>& networkToRoute,
+      const SnapshotCache& lpmSnapshot,
+      std::span<const AddressT> addrs) {
+    std::vector<std::shared_ptr<Route<AddressT>>> routes;
+    routes.reserve(addrs.size());
+    if (FLAGS_rib_lpm_snapshot) {
+      // Snapshot lookups are a couple of loads each, nothing to overlap
+      for (const auto& addr : addrs) {
+        auto route = lpmSnapshot.longestMatch(networkToRoute, addr);
+        routes.push_back(route ? *route : nullptr);
+      }
+      return routes;
+    }
+    std::vector<typename NetworkToRouteMap<AddressT>::ConstIterator> matches(
+        addrs.size());
+    networkToRoute.longestMatch(addrs, std::span(matches));
+    for (const auto& match : matches) {
+      routes.push_back(
+          match == networkToRoute.end() ? nullptr : match->value());
+    }
+    return routes;
+  }
 };
 
 } // namespace facebook::fboss
@@ -14,6 +14,7 @@
 #include "fboss/agent/rib/FibUpdateHelpers.h"
 #include "fboss/agent/rib/NetworkToRouteMap.h"
 #include "fboss/agent/rib/RoutingInformationBase.h"
+#include "fboss/agent/rib/VrfRouteTable.h"
 
 #include "fboss/agent/state/Interface.h"
 #include "fboss/agent/state/Route.h"
@@ -23,9 +24,12 @@
 #include <folly/IPAddress.h>
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 #include <memory>
+#include <span>
 #include <unordered_set>
+#include <vector>
 
 using namespace facebook::fboss;
 
@@ -219,6 +223,40 @@ TEST_F(V6LpmTest, DecreasingLPMSequence) {
   EXPECT_EQ(ribBack->toThrift(), rib.toThrift());
 }
 
+TEST_F(V4LpmTest, BatchedLPM) {
+  std::vector<folly::IPAddressV4> addrs{
+      folly::IPAddressV4("0.0.0.0"),
+      folly::IPAddressV4("192.0.0.0"),
+      folly::IPAddressV4("64.1.0.1"),
+      folly::IPAddressV4("161.16.8.1")};
+  auto routes =
+      rib.longestMatch(std::span<const folly::IPAddressV4>(addrs), kRid0);
+  ASSERT_EQ(addrs.size(), routes.size());
+  for (auto i = 0; i < addrs.size(); ++i) {
+    EXPECT_EQ(longestMatch(addrs[i]), routes[i]) << addrs[i];
+  }
+  EXPECT_EQ(nullptr, routes[1]);
+  // Unknown VRFs match nothing
+  routes = rib.longestMatch(
+      std::span<const folly::IPAddressV4>(addrs), RouterID(42));
+  EXPECT_EQ(std::vector<std::shared_ptr<Route<folly::IPAddressV4>>>(4), routes);
+}
+
+TEST_F(V6LpmTest, BatchedLPM) {
+  std::vector<folly::IPAddressV6> addrs{
+      folly::IPAddressV6("::"),
+      folly::IPAddressV6("C000::"),
+      folly::IPAddressV6("4001:1::"),
+      folly::IPAddressV6("A110:801::")};
+  auto routes =
+      rib.longestMatch(std::span<const folly::IPAddressV6>(addrs), kRid0);
+  ASSERT_EQ(addrs.size(), routes.size());
+  for (auto i = 0; i < addrs.size(); ++i) {
+    EXPECT_EQ(longestMatch(addrs[i]), routes[i]) << addrs[i];
+  }
+  EXPECT_EQ(nullptr, routes[1]);
+}
+
 namespace {
 
 std::map<int64_t, cfg::SwitchInfo> getTestSwitchInfo() {
@@ -541,3 +579,44 @@ TYPED_TEST(GetRouteAndNextHopsTest, ResolvedRouteWithNexthops) {
   EXPECT_FALSE(nhops.empty());
   this->verifyIdPathConsistency(TD::nhopLookup());
 }
+
+// Lookups of the v4/v6 handlers and NextHopResolver, served from LPM
+// snapshots once enough of them follow a route change
+TYPED_TEST(GetRouteAndNextHopsTest, LpmSnapshotLookups) {
+  using TD = typename TestFixture::TD;
+  gflags::FlagSaver flagSaver;
+  FLAGS_rib_lpm_snapshot = true;
+  addRoute(*this->rib_, makeDropUnicastRoute(TD::testPrefix()));
+
+  // enough lookups for the snapshot to get built
+  for (auto i = 0; i < 128; ++i) {
+    auto result = this->rib_->getRouteAndNextHops(
+        TD::nhopLookup(), kRid0, TestFixture::kNormalized);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->first->prefix().network(), TD::nhopRouteNetwork());
+    EXPECT_EQ(result->first->prefix().mask(), TD::nhopRouteMask());
+    EXPECT_FALSE(result->second.empty());
+    EXPECT_NE(nullptr, this->rib_->longestMatch(TD::testLookup(), kRid0));
+    EXPECT_EQ(nullptr, this->rib_->longestMatch(TD::noMatchAddr(), kRid0));
+  }
+
+  // route changes invalidate the snapshot
+  this->rib_->update(
+      nullptr,
+      kRid0,
+      ClientID::BGPD,
+      AdminDistance::EBGP,
+      std::vector<UnicastRoute>{},
+      {toIpPrefix(TD::testPrefix())},
+      false,
+      "delete route",
+      noopFibUpdate,
+      nullptr);
+  for (auto i = 0; i < 128; ++i) {
+    EXPECT_FALSE(this->rib_
+                     ->getRouteAndNextHops(
+                         TD::testLookup(), kRid0, TestFixture::kNormalized)
+                     .has_value());
+    EXPECT_NE(nullptr, this->rib_->longestMatch(TD::nhopLookup(), kRid0));
+  }
+}
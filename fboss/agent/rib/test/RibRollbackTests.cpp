@@ -19,6 +19,7 @@
 #include "fboss/agent/state/Interface.h"
 #include "fboss/agent/state/MySid.h"
 #include "fboss/agent/state/MySidMap.h"
+#include "fboss/agent/state/StateUpdateHelpers.h"
 #include "fboss/agent/test/LabelForwardingUtils.h"
 
 #include "fboss/agent/rib/RoutingInformationBase.h"
@@ -29,6 +30,11 @@
 
 #include <gtest/gtest.h>
 
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+
 using namespace facebook::fboss;
 
 using facebook::network::toBinaryAddress;
@@ -129,6 +135,89 @@ class FailSomeUpdates {
   std::unordered_set<int> toFail_;
 };
 
+/*
+ * Pipelined FIB updates held back from "HW" until program() is called.
+ * Like SwSwitch, an update is only computed once the ones ahead of it are
+ * programmed, and fails if one of them failed.
+ */
+class HeldBackFibUpdates {
+ public:
+  PipelinedFibUpdate operator()(
+      const SwitchIdScopeResolver* resolver,
+      RouterID vrf,
+      const IPv4NetworkToRouteMap& v4NetworkToRoute,
+      const IPv6NetworkToRouteMap& v6NetworkToRoute,
+      const LabelToRouteMap& labelToRoute,
+      const NextHopIDManager* nextHopIDManager,
+      const MySidTable& mySidTable,
+      const std::shared_ptr<StateUpdatePipeline>& pipeline,
+      void* cookie) {
+    auto curSwitchStatePtr =
+        static_cast<std::shared_ptr<facebook::fboss::SwitchState>*>(cookie);
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++waiting_;
+    cond_.notify_all();
+    cond_.wait(lock, [this] { return programmed_ == updates_.size(); });
+    --waiting_;
+    if (pipeline->failed) {
+      throw FbossHwUpdateError(*curSwitchStatePtr, *curSwitchStatePtr);
+    }
+    (*curSwitchStatePtr)->publish();
+    auto desiredState = *curSwitchStatePtr;
+    ribToSwitchStateUpdate(
+        resolver,
+        vrf,
+        v4NetworkToRoute,
+        v6NetworkToRoute,
+        labelToRoute,
+        nextHopIDManager,
+        mySidTable,
+        static_cast<void*>(&desiredState));
+    updates_.push_back({desiredState, pipeline, cookie, {}});
+    cond_.notify_all();
+    return {
+        *curSwitchStatePtr,
+        updates_.back().appliedState.get_future().share()};
+  }
+
+  void waitForUpdates(size_t handedOver, size_t waiting) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [&] {
+      return updates_.size() == handedOver && waiting_ == waiting;
+    });
+  }
+
+  void program(bool succeed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& update = updates_.at(programmed_++);
+    auto curSwitchStatePtr =
+        static_cast<std::shared_ptr<facebook::fboss::SwitchState>*>(
+            update.cookie);
+    if (succeed) {
+      *curSwitchStatePtr = update.desiredState;
+      update.appliedState.set_value(update.desiredState);
+    } else {
+      update.pipeline->failed = true;
+      update.appliedState.set_exception(std::make_exception_ptr(
+          FbossHwUpdateError(update.desiredState, *curSwitchStatePtr)));
+    }
+    cond_.notify_all();
+  }
+
+ private:
+  struct Update {
+    std::shared_ptr<SwitchState> desiredState;
+    std::shared_ptr<StateUpdatePipeline> pipeline;
+    void* cookie;
+    std::promise<std::shared_ptr<SwitchState>> appliedState;
+  };
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::vector<Update> updates_;
+  size_t programmed_{0};
+  size_t waiting_{0};
+};
+
 class RibRollbackTest : public ::testing::Test {
  public:
   void SetUp() override {
@@ -891,3 +980,69 @@ TEST_F(RibRollbackTest, indexHandlesAddUpdateDelete) {
       &switchState_);
   EXPECT_TRUE(rib_.getUnresolvedV4RoutesForTest(kRid).empty());
 }
+
+TEST_F(RibRollbackTest, pipelinedUpdates) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_rib_fib_pipeline = true;
+  HeldBackFibUpdates fibUpdates;
+  auto addRoute = [&](const folly::CIDRNetwork& prefix) {
+    return std::async(std::launch::async, [&, prefix] {
+      rib_.update(
+          scopeResolver(),
+          kRid,
+          kBgpClient,
+          kBgpDistance,
+          {makeDropUnicastRoute(prefix)},
+          {},
+          false,
+          "pipelined add",
+          ribToSwitchStateUpdate,
+          &switchState_,
+          std::ref(fibUpdates));
+    });
+  };
+  auto first = addRoute(kPrefix2);
+  fibUpdates.waitForUpdates(1, 0);
+  // Resolved while the first update is not programmed yet
+  auto second = addRoute(IPAddress::createNetwork("3::3/64"));
+  fibUpdates.waitForUpdates(1, 1);
+  fibUpdates.program(true);
+  fibUpdates.waitForUpdates(2, 0);
+  first.get();
+  fibUpdates.program(true);
+  second.get();
+  assertRouteCount(0, 3, 1);
+}
+
+TEST_F(RibRollbackTest, pipelinedRollbackFailsQueuedUpdate) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_rib_fib_pipeline = true;
+  auto routeTableBeforeFailedUpdate = rib_.getRouteTableDetails(kRid);
+  HeldBackFibUpdates fibUpdates;
+  auto addRoute = [&](const folly::CIDRNetwork& prefix) {
+    return std::async(std::launch::async, [&, prefix] {
+      rib_.update(
+          scopeResolver(),
+          kRid,
+          kBgpClient,
+          kBgpDistance,
+          {makeDropUnicastRoute(prefix)},
+          {},
+          false,
+          "pipelined add",
+          ribToSwitchStateUpdate,
+          &switchState_,
+          std::ref(fibUpdates));
+    });
+  };
+  auto first = addRoute(kPrefix2);
+  fibUpdates.waitForUpdates(1, 0);
+  auto second = addRoute(IPAddress::createNetwork("3::3/64"));
+  fibUpdates.waitForUpdates(1, 1);
+  // Both the failed update and the one queued behind it roll back
+  fibUpdates.program(false);
+  EXPECT_THROW(first.get(), FbossHwUpdateError);
+  EXPECT_THROW(second.get(), FbossHwUpdateError);
+  assertRouteCount(0, 1, 1);
+  EXPECT_EQ(routeTableBeforeFailedUpdate, rib_.getRouteTableDetails(kRid));
+}
@@ -4,12 +4,15 @@
 #include "fboss/agent/rib/NetworkToRouteMap.h"
 #include "fboss/agent/rib/RibToSwitchStateUpdater.h"
 #include "fboss/agent/rib/RouteUpdater.h"
+#include "fboss/agent/rib/RoutingInformationBase.h"
 #include "fboss/agent/state/MySid.h"
 #include "fboss/agent/state/MySidMap.h"
 #include "fboss/agent/state/Route.h"
 #include "fboss/agent/state/RouteTypes.h"
 #include "fboss/agent/state/SwitchState.h"
 
+#include <fmt/format.h>
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
 using namespace facebook::fboss;
@@ -323,3 +326,144 @@ TEST(RibToSwitchStateUpdater, NoChangeOnSecondCallWithSameData) {
   ASSERT_TRUE(delta.has_value());
   EXPECT_EQ(delta->oldState(), delta->newState());
 }
+
+TEST(RibToSwitchStateUpdater, MultipleVrfsInOneUpdate) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_rib_vrf_update_threads = 4;
+  auto state = std::make_shared<SwitchState>();
+  state->publish();
+
+  constexpr auto kNumVrfs = 4;
+  std::vector<IPv4NetworkToRouteMap> v4Maps(kNumVrfs);
+  std::vector<IPv6NetworkToRouteMap> v6Maps(kNumVrfs);
+  LabelToRouteMap labelMap;
+  MySidTable mySidTable;
+  std::vector<VrfNetworkToRouteMaps> vrfRouteMaps;
+  for (auto vrf = 0; vrf < kNumVrfs; ++vrf) {
+    // VRF i has i + 1 routes of each address family
+    for (auto i = 0; i <= vrf; ++i) {
+      addResolvedV4Route(v4Maps[vrf], fmt::format("10.{}.0.0", i), 16);
+      addResolvedV6Route(v6Maps[vrf], fmt::format("2001:db8:{}::", i), 48);
+    }
+    vrfRouteMaps.push_back(
+        {RouterID(vrf), &v4Maps[vrf], &v6Maps[vrf], &labelMap});
+  }
+
+  RibToSwitchStateUpdater updater(
+      scopeResolver(), vrfRouteMaps, nullptr, mySidTable);
+  auto newState = updater(state);
+  newState->publish();
+
+  for (auto vrf = 0; vrf < kNumVrfs; ++vrf) {
+    auto fibContainer =
+        newState->getFibsInfoMap()->getFibContainerIf(RouterID(vrf));
+    ASSERT_NE(fibContainer, nullptr);
+    EXPECT_EQ(fibContainer->getFibV4()->size(), vrf + 1);
+    EXPECT_EQ(fibContainer->getFibV6()->size(), vrf + 1);
+  }
+
+  // Same result as programming one VRF at a time
+  auto serialState = state;
+  for (auto vrf = 0; vrf < kNumVrfs; ++vrf) {
+    RibToSwitchStateUpdater vrfUpdater(
+        scopeResolver(),
+        RouterID(vrf),
+        v4Maps[vrf],
+        v6Maps[vrf],
+        labelMap,
+        nullptr,
+        mySidTable);
+    serialState = vrfUpdater(serialState);
+  }
+  serialState->publish();
+  EXPECT_EQ(
+      serialState->getFibsInfoMap()->toThrift(),
+      newState->getFibsInfoMap()->toThrift());
+
+  // Reprogramming the same routes is a no-op
+  RibToSwitchStateUpdater noopUpdater(
+      scopeResolver(), vrfRouteMaps, nullptr, mySidTable);
+  EXPECT_EQ(noopUpdater(newState), newState);
+}
+
+TEST(RibToSwitchStateUpdater, IncrementalFibUpdate) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_incremental_fib_update = true;
+  auto state = std::make_shared<SwitchState>();
+  state->publish();
+
+  IPv4NetworkToRouteMap v4Map;
+  IPv6NetworkToRouteMap v6Map;
+  LabelToRouteMap labelMap;
+  MySidTable mySidTable;
+  addResolvedV4Route(v4Map, "10.0.0.0", 16);
+  addResolvedV4Route(v4Map, "10.1.0.0", 16);
+  addResolvedV6Route(v6Map, "2001:db8::", 48);
+
+  auto update = [&](const std::shared_ptr<SwitchState>& in) {
+    RibToSwitchStateUpdater updater(
+        scopeResolver(),
+        RouterID(0),
+        v4Map,
+        v6Map,
+        labelMap,
+        nullptr,
+        mySidTable);
+    auto out = updater(in);
+    out->publish();
+    return out;
+  };
+  auto fibV4 = [](const std::shared_ptr<SwitchState>& state) {
+    return state->getFibsInfoMap()->getFibContainerIf(RouterID(0))->getFibV4();
+  };
+  auto state1 = update(state);
+  EXPECT_EQ(fibV4(state1)->size(), 2);
+  EXPECT_TRUE(v4Map.getFibChangesSince(fibV4(state1)).has_value());
+
+  RoutePrefixV4 deleted{folly::IPAddressV4("10.0.0.0"), 16};
+  v4Map.erase(v4Map.exactMatch(deleted.network(), deleted.mask()));
+  v4Map.logFibChange(deleted);
+  addResolvedV4Route(v4Map, "10.2.0.0", 16);
+  v4Map.logFibChange(RoutePrefixV4{folly::IPAddressV4("10.2.0.0"), 16});
+  // Not logged, so not looked at by the incremental update
+  RoutePrefixV4 unlogged{folly::IPAddressV4("10.1.0.0"), 16};
+  auto toCpuRoute = std::make_shared<RouteV4>(RouteV4::makeThrift(unlogged));
+  toCpuRoute->setResolved(RouteNextHopEntry(
+      RouteForwardAction::TO_CPU, AdminDistance::STATIC_ROUTE));
+  toCpuRoute->publish();
+  v4Map.exactMatch(unlogged.network(), unlogged.mask())->value() = toCpuRoute;
+
+  auto state2 = update(state1);
+  auto fib2 = fibV4(state2);
+  EXPECT_EQ(fib2->size(), 2);
+  EXPECT_EQ(fib2->exactMatch(deleted), nullptr);
+  EXPECT_NE(
+      fib2->exactMatch(RoutePrefixV4{folly::IPAddressV4("10.2.0.0"), 16}),
+      nullptr);
+  EXPECT_FALSE(fib2->exactMatch(unlogged)->isToCPU());
+  // v6 routes didn't change, neither did their FIB
+  EXPECT_EQ(
+      state2->getFibsInfoMap()->getFibContainerIf(RouterID(0))->getFibV6(),
+      state1->getFibsInfoMap()->getFibContainerIf(RouterID(0))->getFibV6());
+
+  // The log only holds against the FIB last built
+  EXPECT_FALSE(v4Map.getFibChangesSince(fibV4(state1)).has_value());
+  ASSERT_TRUE(v4Map.getFibChangesSince(fib2).has_value());
+  EXPECT_TRUE(v4Map.getFibChangesSince(fib2)->empty());
+
+  // Restarting the log keeps the changes logged after the build
+  RoutePrefixV4 later{folly::IPAddressV4("10.3.0.0"), 16};
+  addResolvedV4Route(v4Map, "10.3.0.0", 16);
+  v4Map.logFibChange(later);
+  v4Map.restartFibChanges();
+  EXPECT_EQ(
+      std::vector<RoutePrefixV4>{later}, *v4Map.getFibChangesSince(fib2));
+  auto state3 = update(state2);
+  EXPECT_EQ(fibV4(state3)->size(), 3);
+
+  // Without a log the whole RIB gets walked
+  v4Map.invalidateFibChanges();
+  auto state4 = update(state3);
+  EXPECT_EQ(fibV4(state4)->size(), 3);
+  EXPECT_TRUE(fibV4(state4)->exactMatch(unlogged)->isToCPU());
+}
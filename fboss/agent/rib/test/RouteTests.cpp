@@ -12,6 +12,7 @@
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/rib/FibUpdateHelpers.h"
 #include "fboss/agent/rib/NetworkToRouteMap.h"
+#include "fboss/agent/rib/NextHopDependencyIndex.h"
 #include "fboss/agent/rib/NextHopIDManager.h"
 #include "fboss/agent/rib/RoutingInformationBase.h"
 #include "fboss/agent/state/RouteNextHop.h"
@@ -20,8 +21,10 @@
 
 #include <folly/IPAddress.h>
 #include <folly/json/dynamic.h>
+#include <gflags/gflags.h>
 
 #include <gtest/gtest.h>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -2812,6 +2815,78 @@ TEST(Route, noCycleDetectedForNonCyclicRoutes) {
   EXPECT_EQ(stats.resolutionCyclesDetected, 0u);
 }
 
+TEST(Route, multiVrfClientUpdatesProgramAllVrfsAtOnce) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_rib_vrf_update_threads = 4;
+  RoutingInformationBase rib;
+  constexpr auto kNumVrfs = 4;
+  std::vector<std::vector<UnicastRoute>> toAdd(kNumVrfs);
+  const std::vector<IpPrefix> toDelete;
+  std::vector<RoutingInformationBase::VrfClientUpdate> updates;
+  for (auto vrf = 0; vrf < kNumVrfs; ++vrf) {
+    rib.ensureVrf(RouterID(vrf));
+    // One v4 cycle per VRF, see cycleDetectionPopulatesUpdateStatistics
+    toAdd[vrf] = {
+        makeUnicastRoute({IPAddress("10.0.0.0"), 24}, {IPAddress("20.0.0.1")}),
+        makeUnicastRoute({IPAddress("20.0.0.0"), 24}, {IPAddress("10.0.0.1")}),
+    };
+    updates.push_back(
+        {RouterID(vrf),
+         ClientID::BGPD,
+         AdminDistance::EBGP,
+         &toAdd[vrf],
+         &toDelete,
+         false});
+  }
+
+  int singleVrfUpdates{0};
+  std::vector<RouterID> programmedVrfs;
+  auto stats = rib.update(
+      nullptr,
+      updates,
+      "multi vrf test",
+      [&](const SwitchIdScopeResolver* resolver,
+          RouterID vrf,
+          const IPv4NetworkToRouteMap& v4NetworkToRoute,
+          const IPv6NetworkToRouteMap& v6NetworkToRoute,
+          const LabelToRouteMap& labelToRoute,
+          const NextHopIDManager* nextHopIDManager,
+          const MySidTable& mySidTable,
+          void* cookie) {
+        ++singleVrfUpdates;
+        return noopFibUpdate(
+            resolver,
+            vrf,
+            v4NetworkToRoute,
+            v6NetworkToRoute,
+            labelToRoute,
+            nextHopIDManager,
+            mySidTable,
+            cookie);
+      },
+      [&](const SwitchIdScopeResolver* /*resolver*/,
+          const std::vector<VrfNetworkToRouteMaps>& vrfRouteMaps,
+          const NextHopIDManager* /*nextHopIDManager*/,
+          const MySidTable& /*mySidTable*/,
+          void* /*cookie*/) {
+        for (const auto& vrfRouteMap : vrfRouteMaps) {
+          programmedVrfs.push_back(vrfRouteMap.vrf);
+          EXPECT_EQ(vrfRouteMap.v4NetworkToRoute->size(), 2);
+        }
+        return StateDelta(nullptr, nullptr);
+      },
+      nullptr);
+
+  // All the VRFs got resolved, then programmed in one go
+  EXPECT_EQ(singleVrfUpdates, 0);
+  EXPECT_EQ(programmedVrfs.size(), kNumVrfs);
+  ASSERT_EQ(stats.size(), kNumVrfs);
+  for (const auto& vrfStats : stats) {
+    EXPECT_EQ(vrfStats.v4RoutesAdded, 2);
+    EXPECT_EQ(vrfStats.resolutionCyclesDetected, 1);
+  }
+}
+
 // Verify that the RouteUpdater release calls drop the manager refcount
 // when a route carrying a clientNextHopSetID is deleted.
 TEST(Route, clientIdReleasedOnDelete) {
@@ -2867,4 +2942,137 @@ TEST(Route, clientIdReleasedOnResetAllRoutes) {
   EXPECT_FALSE(nhopIds.getNextHopsIf(*setId).has_value());
 }
 
+TEST(Route, incrementalResolution) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_incremental_route_resolution = true;
+  IPv4NetworkToRouteMap v4Routes;
+  IPv6NetworkToRouteMap v6Routes;
+  LabelToRouteMap mplsRoutes;
+  NextHopIDManager nhopIds;
+  NextHopDependencyIndex nextHopDependencies;
+
+  auto intfNhops = [](const std::string& ip, InterfaceID intf) {
+    RouteNextHopSet nhops;
+    nhops.emplace(ResolvedNextHop(IPAddress(ip), intf, UCMP_DEFAULT_WEIGHT));
+    return nhops;
+  };
+  auto expectResolvedVia = [&v6Routes, &nhopIds](
+                               const std::string& prefix, InterfaceID intf) {
+    auto network = IPAddress::createNetwork(prefix);
+    auto it = v6Routes.exactMatch(network.first.asV6(), network.second);
+    ASSERT_NE(v6Routes.end(), it);
+    ASSERT_TRUE(it->value()->isResolved());
+    auto nhops =
+        getResolvedNextHopsFromRib(&nhopIds, it->value()->getForwardInfo());
+    ASSERT_EQ(nhops.size(), 1);
+    EXPECT_EQ(nhops.begin()->intf(), intf);
+  };
+
+  RibRouteUpdater u(
+      &v4Routes,
+      &v6Routes,
+      &mplsRoutes,
+      &nhopIds,
+      nullptr,
+      RouterID(0),
+      &nextHopDependencies);
+  u.update<RibRouteUpdater::RouteEntry, folly::CIDRNetwork>(
+      ClientID::INTERFACE_ROUTE,
+      {
+          {{IPAddress("fc00:1::"), 64},
+           RouteNextHopEntry(
+               intfNhops("fc00:1::1", InterfaceID(1)),
+               AdminDistance::DIRECTLY_CONNECTED)},
+          {{IPAddress("fc00:2::"), 64},
+           RouteNextHopEntry(
+               intfNhops("fc00:2::1", InterfaceID(2)),
+               AdminDistance::DIRECTLY_CONNECTED)},
+      },
+      {},
+      false);
+  // First update resolves the full table and builds the index
+  EXPECT_TRUE(nextHopDependencies.isValid());
+
+  u.update<RibRouteUpdater::RouteEntry, folly::CIDRNetwork>(
+      kClientA,
+      {
+          {{IPAddress("fc00:10::"), 32},
+           RouteNextHopEntry(makeNextHops({"fc00:1::10"}), kDistance)},
+          {{IPAddress("2800:2::"), 64},
+           RouteNextHopEntry(makeNextHops({"fc00:10::10"}), kDistance)},
+          {{IPAddress("2800:3::"), 64},
+           RouteNextHopEntry(makeNextHops({"fc00:2::10"}), kDistance)},
+      },
+      {},
+      false);
+  expectResolvedVia("2800:2::/64", InterfaceID(1));
+  expectResolvedVia("2800:3::/64", InterfaceID(2));
+
+  // Moving the intermediate route re-resolves only it and the route
+  // recursively resolving through it
+  auto resolvedBefore = u.routesResolved();
+  u.update<RibRouteUpdater::RouteEntry, folly::CIDRNetwork>(
+      kClientA,
+      {
+          {{IPAddress("fc00:10::"), 32},
+           RouteNextHopEntry(makeNextHops({"fc00:2::10"}), kDistance)},
+      },
+      {},
+      false);
+  EXPECT_EQ(u.routesResolved() - resolvedBefore, 2);
+  expectResolvedVia("2800:2::/64", InterfaceID(2));
+  expectResolvedVia("2800:3::/64", InterfaceID(2));
+
+  // A more specific route now covers the next hop of 2800:2::/64
+  resolvedBefore = u.routesResolved();
+  u.update<RibRouteUpdater::RouteEntry, folly::CIDRNetwork>(
+      kClientB,
+      {
+          {{IPAddress("fc00:10::"), 64},
+           RouteNextHopEntry(makeNextHops({"fc00:1::20"}), kDistance)},
+      },
+      {},
+      false);
+  EXPECT_EQ(u.routesResolved() - resolvedBefore, 2);
+  expectResolvedVia("2800:2::/64", InterfaceID(1));
+
+  // Deleting it uncovers the less specific route again
+  u.update<RibRouteUpdater::RouteEntry, folly::CIDRNetwork>(
+      kClientB, {}, {{IPAddress("fc00:10::"), 64}}, false);
+  expectResolvedVia("2800:2::/64", InterfaceID(2));
+  EXPECT_EQ(nextHopDependencies.numRoutes(), 3);
+}
+
+TEST(Route, nextHopDependencyIndex) {
+  NextHopDependencyIndex index;
+  folly::CIDRNetwork r1{IPAddress("10.1.1.0"), 24};
+  folly::CIDRNetwork r2{IPAddress("10.1.2.0"), 24};
+  index.setNextHops(r1, {IPAddress("1.1.1.10"), IPAddress("2.2.2.10")});
+  index.setNextHops(r2, {IPAddress("2.2.2.10"), IPAddress("1.1.1.10")});
+  index.setNextHops(LabelID(100), {IPAddress("1.1.1.20")});
+  // Same next hops in a different order are stored once
+  EXPECT_EQ(index.numRoutes(), 3);
+  EXPECT_EQ(index.numNextHopSets(), 2);
+
+  auto dependents = [&index](const std::string& prefix) {
+    std::set<NextHopDependencyIndex::RouteKey> routes;
+    index.forEachDependent(
+        IPAddress::createNetwork(prefix),
+        [&routes](const auto& route) { routes.insert(route); });
+    return routes;
+  };
+  EXPECT_EQ(dependents("1.1.1.0/24").size(), 3);
+  EXPECT_EQ(dependents("2.2.2.0/24").size(), 2);
+  EXPECT_EQ(dependents("1.1.1.20/32").size(), 1);
+  EXPECT_EQ(dependents("0.0.0.0/0").size(), 3);
+  EXPECT_TRUE(dependents("3.0.0.0/8").empty());
+  EXPECT_TRUE(dependents("::/0").empty());
+
+  index.removeRoute(r1);
+  index.setNextHops(r2, {});
+  EXPECT_EQ(index.numRoutes(), 1);
+  EXPECT_EQ(index.numNextHopSets(), 1);
+  EXPECT_TRUE(dependents("2.2.2.0/24").empty());
+}
+
 } // namespace facebook::fboss
@@ -8,17 +8,24 @@
  *
  */
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
+#include "fboss/agent/FbossError.h"
 #include "fboss/agent/hw/mock/MockPlatform.h"
+#include "fboss/agent/rib/NetworkToRouteMap.h"
+#include "fboss/agent/rib/RibWarmbootFile.h"
 #include "fboss/agent/rib/RoutingInformationBase.h"
 #include "fboss/agent/state/LabelForwardingInformationBase.h"
 #include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/test/TestUtils.h"
 
+#include <folly/FileUtil.h>
 #include <folly/IPAddress.h>
 #include <folly/ScopeGuard.h>
+#include <folly/testing/TestUtil.h>
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+#include <filesystem>
+
 DECLARE_bool(enable_nexthop_id_manager);
 DECLARE_bool(resolve_nexthops_from_id);
 
@@ -265,3 +272,105 @@ TEST_F(RibSerializationTest, fromThriftWipesClientIdsWhenFlagOff) {
   }
   EXPECT_EQ(injected, verified);
 }
+
+class RibWarmbootFileTest : public RibSerializationTest {
+ public:
+  std::unique_ptr<RoutingInformationBase> ribFromFile() const {
+    return RoutingInformationBase::fromWarmBootStateFile(
+        path,
+        curState->getFibsInfoMap(),
+        curState->getLabelForwardingInformationBase(),
+        curState->getMySids());
+  }
+
+  folly::test::TemporaryDirectory tmpDir;
+  std::string path{(tmpDir.path() / "rib_warmboot_state").string()};
+};
+
+TEST_F(RibWarmbootFileTest, roundTrip) {
+  rib.writeWarmBootStateFile(path);
+  auto fromFile = ribFromFile();
+  auto fromThrift = RoutingInformationBase::fromThrift(
+      rib.warmBootState(),
+      curState->getFibsInfoMap(),
+      curState->getLabelForwardingInformationBase(),
+      curState->getMySids());
+  EXPECT_TRUE(ribThriftEqual(*fromThrift, *fromFile));
+  EXPECT_TRUE(ribThriftEqual(rib, *fromFile));
+}
+
+TEST_F(RibWarmbootFileTest, roundTripWithoutMmap) {
+  auto savedMmap = FLAGS_rib_warmboot_file_mmap;
+  FLAGS_rib_warmboot_file_mmap = false;
+  SCOPE_EXIT {
+    FLAGS_rib_warmboot_file_mmap = savedMmap;
+  };
+  rib.writeWarmBootStateFile(path);
+  EXPECT_TRUE(ribThriftEqual(rib, *ribFromFile()));
+}
+
+TEST_F(RibWarmbootFileTest, recordsAcrossChunks) {
+  // Chunks too small for more than one record each
+  RibWarmbootFileWriter writer(path, 16);
+  size_t written = 0;
+  for (const auto& [rid, routeTable] : rib.warmBootState()) {
+    writer.startVrf(RouterID(rid));
+    for (const auto& [_, v4Route] : *routeTable.v4NetworkToRoute()) {
+      writer.addRoute(*IPv4NetworkToRouteMap::routeFromThrift(v4Route));
+      ++written;
+    }
+    for (const auto& [_, v6Route] : *routeTable.v6NetworkToRoute()) {
+      writer.addRoute(*IPv6NetworkToRouteMap::routeFromThrift(v6Route));
+      ++written;
+    }
+  }
+  ASSERT_GT(written, 1u);
+  EXPECT_EQ(written, writer.routesWritten());
+  // Nothing in place until finished
+  EXPECT_FALSE(std::filesystem::exists(path));
+  writer.finish();
+
+  for (auto useMmap : {true, false}) {
+    RibWarmbootFileReader reader(path, useMmap);
+    size_t read = 0;
+    while (auto record = reader.next()) {
+      if (record->type == RibWarmbootFile::RecordType::V4_ROUTE) {
+        EXPECT_NE(nullptr, RibWarmbootFileReader::v4Route(*record));
+        ++read;
+      } else if (record->type == RibWarmbootFile::RecordType::V6_ROUTE) {
+        EXPECT_NE(nullptr, RibWarmbootFileReader::v6Route(*record));
+        ++read;
+      }
+    }
+    EXPECT_EQ(written, read);
+  }
+}
+
+TEST_F(RibWarmbootFileTest, abandonedWriteLeavesNoFile) {
+  {
+    RibWarmbootFileWriter writer(path);
+    writer.startVrf(kRid0);
+  }
+  EXPECT_FALSE(std::filesystem::exists(path));
+  EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+}
+
+TEST_F(RibWarmbootFileTest, corruptFile) {
+  rib.writeWarmBootStateFile(path);
+  std::string contents;
+  ASSERT_TRUE(folly::readFile(path.c_str(), contents));
+  contents[contents.size() / 2] ^= 0xff;
+  ASSERT_TRUE(folly::writeFile(contents, path.c_str()));
+  EXPECT_THROW(ribFromFile(), FbossError);
+}
+
+TEST_F(RibWarmbootFileTest, truncatedFile) {
+  rib.writeWarmBootStateFile(path);
+  std::string contents;
+  ASSERT_TRUE(folly::readFile(path.c_str(), contents));
+  contents.resize(contents.size() - 1);
+  ASSERT_TRUE(folly::writeFile(contents, path.c_str()));
+  EXPECT_THROW(ribFromFile(), FbossError);
+  ASSERT_TRUE(folly::writeFile(std::string("FBRIB"), path.c_str()));
+  EXPECT_THROW(ribFromFile(), FbossError);
+}
@@ -65,6 +65,25 @@ invokeFn(const Fn& fn, const Args&... args) {
   return LoopAction::CONTINUE;
 }
 
+/*
+ * Content comparison of changed nodes for the DEEP comparison policy.
+ * Published thrift_cow nodes may have cached a hash of their contents,
+ * equal hashes save converting both nodes to thrift. Hashes are never
+ * computed here, that would cost as much as the comparison. Unequal hashes
+ * are not conclusive, see ContentHash.
+ */
+template <typename NodeWrapper>
+bool contentsEqual(const NodeWrapper& oldNode, const NodeWrapper& newNode) {
+  if constexpr (requires { oldNode->cachedContentHash(); }) {
+    auto oldHash = oldNode->cachedContentHash();
+    auto newHash = newNode->cachedContentHash();
+    if (oldHash && newHash && *oldHash == *newHash) {
+      return true;
+    }
+  }
+  return *oldNode == *newNode;
+}
+
 /*
  * Templates to check if a function is valid for passing to
  * forEachChanged(), forEachAdded(), or forEachRemoved()
@@ -93,7 +93,7 @@ forEachChanged(
     if (oldNode) {
       if (newNode) {
         if (DeltaComparison::policy() == DeltaComparison::Policy::DEEP) {
-          if (*oldNode == *newNode) {
+          if (detail::contentsEqual(oldNode, newNode)) {
             // when delta comparison policy is deep, compare contents
             // this is an expensive operation, and must be used carefully
             continue;
@@ -124,7 +124,7 @@ forEachChanged(const Delta& delta, ChangedFn changedFn, const Args&... args) {
     const auto& newNode = entry.getNew();
     if (oldNode && newNode) {
       if (DeltaComparison::policy() == DeltaComparison::Policy::DEEP) {
-        if (*oldNode == *newNode) {
+        if (detail::contentsEqual(oldNode, newNode)) {
           // when delta comparison policy is deep, compare contents
           // this is an expensive operation, and must be used carefully
           continue;
@@ -28,12 +28,19 @@ using ForwardingInformationBaseType = std::map<std::string, state::RouteFields>;
 template <typename AddrT>
 class ForwardingInformationBase;
 
+// FIBs hold up to millions of routes and change a few routes at a time.
+// Building with ENABLE_PERSISTENT_FIB_STORAGE makes their clones share the
+// routes (see PersistentSortedMap) instead of copying a std::map of them.
 template <typename AddrT>
-using ForwardingInformationBaseTraits = ThriftMapNodeTraits<
-    ForwardingInformationBase<AddrT>,
-    ForwardingInformationBaseClass,
-    ForwardingInformationBaseType,
-    Route<AddrT>>;
+struct ForwardingInformationBaseTraits : ThriftMapNodeTraits<
+                                             ForwardingInformationBase<AddrT>,
+                                             ForwardingInformationBaseClass,
+                                             ForwardingInformationBaseType,
+                                             Route<AddrT>> {
+#ifdef ENABLE_PERSISTENT_FIB_STORAGE
+  static constexpr auto kStorage = thrift_cow::ThriftMapStorage::PERSISTENT;
+#endif
+};
 
 template <typename AddressT>
 class ForwardingInformationBase
@@ -58,6 +58,16 @@ struct ExtractorT {
   }
 };
 
+// Map deltas merge the entries of both maps in key order
+template <typename MAP>
+constexpr bool isSortedMap() {
+  if constexpr (requires { MAP::Fields::kSortedStorage; }) {
+    return MAP::Fields::kSortedStorage;
+  } else {
+    return true;
+  }
+}
+
 template <typename MAP>
 struct MapDeltaTraits {
   using mapped_type = typename MAP::mapped_type;
@@ -79,6 +89,7 @@ class MapDelta {
   using NodeMapExtractor = typename Traits<MAP>::Extractor;
   using Iterator = typename Traits<MAP>::DeltaValueIterator;
   using Impl = MapDeltaImpl<MAP, VALUE, Iterator>;
+  static_assert(isSortedMap<MAP>(), "MapDelta requires sorted map storage");
 
   MapDelta(const MAP* oldMap, const MAP* newMap)
       : impl_(std::move(oldMap), std::move(newMap)) {}
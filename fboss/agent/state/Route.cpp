@@ -16,8 +16,13 @@
 #include "fboss/agent/if/gen-cpp2/common_types.h"
 #include "fboss/agent/state/NodeBase-defs.h"
 #include "fboss/agent/state/RouteNextHopEntry.h"
+#include "fboss/agent/state/RouteNextHopSetPool.h"
 #include "folly/IPAddressV4.h"
 
+#include <thrift/lib/cpp2/op/Get.h>
+
+#include <type_traits>
+
 using facebook::network::toBinaryAddress;
 
 namespace facebook::fboss {
@@ -25,6 +30,57 @@ namespace facebook::fboss {
 using folly::IPAddress;
 using std::string;
 
+namespace {
+
+template <typename NodeT>
+bool isSameStructNode(const NodeT& a, const NodeT& b);
+
+template <typename NodeT>
+bool isSameChildNode(const NodeT& a, const NodeT& b) {
+  if constexpr (std::is_same_v<NodeT, RouteNextHopSetPool::NextHopsNode>) {
+    // distinct pooled lists hold distinct nexthop sets
+    if (RouteNextHopSetPool::asInterned(&a) &&
+        RouteNextHopSetPool::asInterned(&b)) {
+      return false;
+    }
+  }
+  if constexpr (std::is_same_v<
+                    typename NodeT::TC,
+                    apache::thrift::type_class::structure>) {
+    return isSameStructNode(a, b);
+  } else {
+    return a.toThrift() == b.toThrift();
+  }
+}
+
+/*
+ * Field by field equality of two struct nodes. Children shared by both
+ * nodes, through clone() or RouteNextHopSetPool, match by pointer; only
+ * differing children are converted to thrift and compared.
+ */
+template <typename NodeT>
+bool isSameStructNode(const NodeT& a, const NodeT& b) {
+  using Fields = typename NodeT::Fields;
+  bool same = true;
+  apache::thrift::op::for_each_field_id<typename NodeT::ThriftType>(
+      [&]<class Id>(Id) {
+        if (!same) {
+          return;
+        }
+        const auto& fieldA = a.template cref<Id>();
+        const auto& fieldB = b.template cref<Id>();
+        if constexpr (Fields::template IsChildNode<Id>) {
+          same = fieldA == fieldB ||
+              (fieldA && fieldB && isSameChildNode(*fieldA, *fieldB));
+        } else {
+          same = fieldA == fieldB;
+        }
+      });
+  return same;
+}
+
+} // namespace
+
 // RouteFields<> Class
 template <typename AddrT>
 RouteFields<AddrT>::RouteFields(const Prefix& prefix)
@@ -193,7 +249,7 @@ RouteDetails Route<AddrT>::toRouteDetails(
 
 template <typename AddrT>
 bool Route<AddrT>::isSame(const Route<AddrT>* rt) const {
-  return *this == *rt;
+  return this == rt || isSameStructNode(*this, *rt);
 }
 
 template <typename AddrT>
@@ -467,6 +467,12 @@ class Route : public ThriftStructNode<Route<AddrT>, ThriftFieldsT<AddrT>> {
   // THRIFT_COPY
   void setResolved(const RouteNextHopEntry& fwd) {
     this->template set<switch_state_tags::fwd>(fwd.toThrift());
+    const auto& nexthops = fwd.template cref<switch_state_tags::nexthops>();
+    if (nexthops->isPublished()) {
+      // Immutable, typically pooled, so keep sharing it rather than the copy
+      this->template ref<switch_state_tags::fwd>()
+          ->template ref<switch_state_tags::nexthops>() = nexthops;
+    }
     setFlags(flags() | RESOLVED);
     setFlags(flags() & (~(UNRESOLVABLE | PROCESSING)));
   }
@@ -11,7 +11,9 @@
 
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/state/RouteNextHop.h"
+#include "fboss/agent/state/RouteNextHopSetPool.h"
 
+#include <folly/hash/Hash.h>
 #include <folly/logging/xlog.h>
 #include <gflags/gflags.h>
 #include <iterator>
@@ -133,7 +135,7 @@ RouteNextHopEntry::RouteNextHopEntry(
   auto data = getRouteNextHopEntryThrift(
       Action::NEXTHOPS,
       distance,
-      NextHopSet({nhop}),
+      NextHopSet(),
       counterID,
       classID,
       overrideEcmpSwitchingMode,
@@ -142,6 +144,7 @@ RouteNextHopEntry::RouteNextHopEntry(
       resolvedNextHopSetID,
       clientNextHopSetID);
   this->fromThrift(std::move(data));
+  setNextHopsNode(NextHopSet({nhop}));
 }
 
 RouteNextHopEntry::RouteNextHopEntry(
@@ -160,7 +163,7 @@ RouteNextHopEntry::RouteNextHopEntry(
   auto data = getRouteNextHopEntryThrift(
       Action::NEXTHOPS,
       distance,
-      nhopSet,
+      NextHopSet(),
       counterID,
       classID,
       overrideEcmpSwitchingMode,
@@ -169,6 +172,7 @@ RouteNextHopEntry::RouteNextHopEntry(
       resolvedNextHopSetID,
       clientNextHopSetID);
   this->fromThrift(std::move(data));
+  setNextHopsNode(nhopSet);
 }
 
 std::string RouteNextHopEntry::str() const {
@@ -178,8 +182,7 @@ std::string RouteNextHopEntry::str() const {
 }
 
 bool operator==(const RouteNextHopEntry& a, const RouteNextHopEntry& b) {
-  return (a.getAction() == b.getAction() &&
-          a.getNextHopSet() == b.getNextHopSet() &&
+  return (a.getAction() == b.getAction() && a.sameNextHops(b) &&
           a.getAdminDistance() == b.getAdminDistance() &&
           a.getCounterID() == b.getCounterID() &&
           a.getClassID() == b.getClassID() &&
@@ -814,7 +817,44 @@ void RouteNextHopEntry::setNextHops(const NextHopSet& nhops) {
     throw FbossError("Empty nexthop set is passed to setNextHops");
   }
   ref<switch_state_tags::action>() = Action::NEXTHOPS;
-  set<switch_state_tags::nexthops>(util::fromRouteNextHopSet(nhops));
+  setNextHopsNode(nhops);
+}
+
+void RouteNextHopEntry::setNextHopsNode(const NextHopSet& nhops) {
+  if (FLAGS_intern_route_nexthops) {
+    ref<switch_state_tags::nexthops>() =
+        RouteNextHopSetPool::get()->intern(nhops);
+  } else {
+    set<switch_state_tags::nexthops>(util::fromRouteNextHopSet(nhops));
+  }
+}
+
+bool RouteNextHopEntry::sharesNextHops(const RouteNextHopEntry& other) const {
+  return cref<switch_state_tags::nexthops>() ==
+      other.cref<switch_state_tags::nexthops>();
+}
+
+bool RouteNextHopEntry::sameNextHops(const RouteNextHopEntry& other) const {
+  if (sharesNextHops(other)) {
+    return true;
+  }
+  const auto& nhops = cref<switch_state_tags::nexthops>();
+  const auto& otherNhops = other.cref<switch_state_tags::nexthops>();
+  if (RouteNextHopSetPool::asInterned(nhops.get()) &&
+      RouteNextHopSetPool::asInterned(otherNhops.get())) {
+    // distinct pooled lists hold distinct nexthop sets
+    return false;
+  }
+  // a private list, e.g. built from thrift, may still be equal
+  return getNextHopSet() == other.getNextHopSet();
+}
+
+size_t RouteNextHopEntry::nextHopsHash() const {
+  if (auto interned = RouteNextHopSetPool::asInterned(
+          cref<switch_state_tags::nexthops>().get())) {
+    return interned->hash();
+  }
+  return RouteNextHopSetPool::hash(getNextHopSet());
 }
 
 bool RouteNextHopEntry::hasOverrideSwitchingModeOrNhops() const {
@@ -853,3 +893,11 @@ void RouteNextHopEntry::setOverrideNextHops(
   }
 }
 } // namespace facebook::fboss
+
+namespace std {
+size_t hash<facebook::fboss::RouteNextHopEntry>::operator()(
+    const facebook::fboss::RouteNextHopEntry& entry) const {
+  return folly::hash::hash_combine(
+      entry.getAction(), entry.getAdminDistance(), entry.nextHopsHash());
+}
+} // namespace std
@@ -98,6 +98,14 @@ class RouteNextHopEntry
   // nexthops will be removeed in the future
   NextHopSet getNextHopSet() const;
   void setNextHops(const NextHopSet& nhops);
+  // True if both entries hold the very same nexthop list node, as entries
+  // built from equal nexthop sets do, see RouteNextHopSetPool
+  bool sharesNextHops(const RouteNextHopEntry& other) const;
+  // Whether the nexthop sets are equal, in O(1) if both entries hold pooled
+  // nexthop lists, see RouteNextHopSetPool
+  bool sameNextHops(const RouteNextHopEntry& other) const;
+  // Hash of the nexthop set, O(1) for a pooled nexthop list
+  size_t nextHopsHash() const;
 
   const std::optional<RouteCounterID> getCounterID() const {
     if (auto counter = safe_cref<switch_state_tags::counterID>()) {
@@ -268,6 +276,7 @@ class RouteNextHopEntry
 
  private:
   NextHopSet normalizedNextHopsImpl(bool ignoreOverride) const;
+  void setNextHopsNode(const NextHopSet& nhops);
   static state::RouteNextHopEntry getRouteNextHopEntryThrift(
       Action action,
       AdminDistance distance,
@@ -328,3 +337,11 @@ UnicastRoute toUnicastRoute(
 } // namespace util
 
 } // namespace facebook::fboss
+
+namespace std {
+// Consistent with operator==, hashes a subset of the fields it compares
+template <>
+struct hash<facebook::fboss::RouteNextHopEntry> {
+  size_t operator()(const facebook::fboss::RouteNextHopEntry& entry) const;
+};
+} // namespace std
@@ -0,0 +1,84 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/state/RouteNextHopSetPool.h"
+
+#include <folly/hash/Hash.h>
+
+#include <algorithm>
+
+DEFINE_bool(
+    intern_route_nexthops,
+    false,
+    "Share one immutable copy of each distinct route nexthop set between "
+    "all route entries using it");
+
+namespace facebook::fboss {
+
+size_t RouteNextHopSetPool::NextHopSetHash::operator()(
+    const RouteNextHopSet& nhops) const {
+  return folly::hash::hash_range(
+      nhops.begin(), nhops.end(), 0, std::hash<NextHop>());
+}
+
+// Same thrift layout as RouteNextHopEntry::getRouteNextHopEntryThrift
+// produces, so pooled and private lists compare equal
+RouteNextHopSetPool::InternedNode::InternedNode(
+    const RouteNextHopSet& nhops,
+    size_t hash)
+    : NextHopsNode(util::fromRouteNextHopSet(nhops)), hash_(hash) {}
+
+RouteNextHopSetPool* RouteNextHopSetPool::get() {
+  // Leaked on purpose, entries may outlive static destruction
+  static auto* pool = new RouteNextHopSetPool();
+  return pool;
+}
+
+std::shared_ptr<RouteNextHopSetPool::NextHopsNode> RouteNextHopSetPool::intern(
+    const RouteNextHopSet& nhops) {
+  auto hash = NextHopSetHash()(nhops);
+  auto locked = shards_[hash % kNumShards].wlock();
+  auto& slot = locked->nodes[nhops];
+  if (auto node = slot.lock()) {
+    return node;
+  }
+  auto node = std::make_shared<InternedNode>(nhops, hash);
+  node->publish();
+  slot = node;
+  if (locked->nodes.size() >= locked->purgeAtSize) {
+    purgeExpired(*locked);
+  }
+  return node;
+}
+
+size_t RouteNextHopSetPool::size() const {
+  size_t size = 0;
+  for (const auto& shard : shards_) {
+    auto locked = shard.rlock();
+    size += std::count_if(
+        locked->nodes.begin(), locked->nodes.end(), [](const auto& entry) {
+          return !entry.second.expired();
+        });
+  }
+  return size;
+}
+
+void RouteNextHopSetPool::purgeExpired(Pool& pool) {
+  for (auto it = pool.nodes.begin(); it != pool.nodes.end();) {
+    if (it->second.expired()) {
+      it = pool.nodes.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  // Amortize purges over as many inserts as there are live lists
+  pool.purgeAtSize = std::max(kMinPurgeSize, 2 * pool.nodes.size());
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/state/RouteNextHopEntry.h"
+
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+#include <gflags/gflags.h>
+
+#include <array>
+#include <memory>
+
+DECLARE_bool(intern_route_nexthops);
+
+namespace facebook::fboss {
+
+/*
+ * Process wide pool of the nexthop lists held by RouteNextHopEntry.
+ *
+ * Entries built from a nexthop set point at a pooled, published (hence
+ * immutable) list node instead of carrying a private copy. Routes with the
+ * same nexthops then share one node, which cuts the memory held by large
+ * RIBs. There is at most one live pooled node per nexthop set, so entries
+ * whose nodes are both pooled compare and hash their nexthops in O(1). An
+ * entry may also hold a private node, e.g. one built from thrift or with
+ * --intern_route_nexthops off, which gets its nexthop set compared and
+ * hashed by value.
+ *
+ * The pool only holds weak references, a list is freed with the last entry
+ * using it. Expired slots are purged as the pool grows. The pool is sharded
+ * by hash, so that threads building routes with different nexthops rarely
+ * contend.
+ */
+class RouteNextHopSetPool {
+ public:
+  using NextHopsNode = RouteNextHopEntry::BaseT::Fields::TypeFor<
+      switch_state_tags::nexthops>::element_type;
+
+  /*
+   * Pooled nodes, told apart from private ones by their type. Clones made to
+   * modify a pooled node are private.
+   */
+  class InternedNode final : public NextHopsNode {
+   public:
+    InternedNode(const RouteNextHopSet& nhops, size_t hash);
+
+    // Hash of the nexthop set, as RouteNextHopSetPool::hash() computes it
+    size_t hash() const {
+      return hash_;
+    }
+
+   private:
+    size_t hash_;
+  };
+
+  static RouteNextHopSetPool* get();
+
+  static const InternedNode* asInterned(const NextHopsNode* node) {
+    return dynamic_cast<const InternedNode*>(node);
+  }
+
+  static size_t hash(const RouteNextHopSet& nhops) {
+    return NextHopSetHash()(nhops);
+  }
+
+  /*
+   * Returns the published list node holding nhops, creating it if no entry
+   * references such a list yet.
+   */
+  std::shared_ptr<NextHopsNode> intern(const RouteNextHopSet& nhops);
+
+  // Number of live pooled lists
+  size_t size() const;
+
+ private:
+  static constexpr size_t kNumShards{16};
+
+  struct NextHopSetHash {
+    size_t operator()(const RouteNextHopSet& nhops) const;
+  };
+  struct Pool {
+    folly::F14NodeMap<
+        RouteNextHopSet,
+        std::weak_ptr<NextHopsNode>,
+        NextHopSetHash>
+        nodes;
+    size_t purgeAtSize{kMinPurgeSize};
+  };
+  static constexpr size_t kMinPurgeSize{1024};
+
+  static void purgeExpired(Pool& pool);
+
+  std::array<folly::Synchronized<Pool>, kNumShards> shards_;
+};
+
+} // namespace facebook::fboss
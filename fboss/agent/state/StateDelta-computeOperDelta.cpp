@@ -10,6 +10,8 @@ template fsdb::OperDelta fsdb::computeOperDelta<SwitchState>(
     const std::shared_ptr<SwitchState>&,
     const std::shared_ptr<SwitchState>&,
     const std::vector<std::string>&,
+    bool,
+    folly::Executor*,
     bool);
 
 } // namespace facebook::fboss
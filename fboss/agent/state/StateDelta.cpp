@@ -38,6 +38,8 @@
 #include "fboss/agent/state/VlanMapDelta.h"
 #include "fboss/fsdb/common/Utils.h"
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
 #include <folly/json/dynamic.h>
 
 using std::shared_ptr;
@@ -47,6 +49,13 @@ DEFINE_bool(
     true,
     "Generate and process oper delta for state delta processing");
 
+DEFINE_int32(
+    state_oper_delta_threads,
+    0,
+    "Threads computing oper deltas of the switch state, for HwSwitches and "
+    "FSDB, by visiting large maps and lists concurrently. 0 computes them "
+    "serially on the calling thread.");
+
 DEFINE_bool(
     verify_apply_oper_delta,
     false,
@@ -76,8 +85,21 @@ extern template fsdb::OperDelta fsdb::computeOperDelta<SwitchState>(
     const std::shared_ptr<SwitchState>&,
     const std::shared_ptr<SwitchState>&,
     const std::vector<std::string>&,
+    bool,
+    folly::Executor*,
     bool);
 
+folly::Executor* operDeltaExecutor() {
+  if (FLAGS_state_oper_delta_threads <= 0) {
+    return nullptr;
+  }
+  // Leaked on purpose, deltas may be computed during static destruction
+  static auto* executor = new folly::CPUThreadPoolExecutor(
+      FLAGS_state_oper_delta_threads,
+      std::make_shared<folly::NamedThreadFactory>("OperDelta"));
+  return executor;
+}
+
 StateDelta::StateDelta(
     std::shared_ptr<SwitchState> oldState,
     std::shared_ptr<SwitchState> newState)
@@ -325,11 +347,24 @@ const fsdb::OperDelta& StateDelta::getOperDelta() const {
   if (!operDelta_.has_value()) {
     operDelta_.emplace(
         fsdb::computeOperDelta(
-            old_, new_, {}, FLAGS_state_oper_delta_use_id_paths));
+            old_,
+            new_,
+            {},
+            FLAGS_state_oper_delta_use_id_paths,
+            operDeltaExecutor(),
+            pruneEqualContents_));
   }
   return operDelta_.value();
 }
 
+void StateDelta::primeContentHashes() const {
+  for (const auto& state : {old_, new_}) {
+    if (state && state->isPublished()) {
+      state->contentHash();
+    }
+  }
+}
+
 // Explicit instantiations of NodeMapDelta that are used by StateDelta.
 template struct ThriftMapDelta<InterfaceMap>;
 template struct ThriftMapDelta<PortMap>;
@@ -49,9 +49,21 @@
 #include "fboss/thrift_cow/nodes/Types.h"
 
 DECLARE_bool(verify_apply_oper_delta);
+DECLARE_int32(state_oper_delta_threads);
+
+namespace folly {
+class Executor;
+} // namespace folly
 
 namespace facebook::fboss {
 
+/*
+ * Executor computing the agent's oper deltas, visiting the large maps and
+ * lists of a state concurrently (see DeltaVisitOptions::executor). Null,
+ * i.e. serial, unless --state_oper_delta_threads is set.
+ */
+folly::Executor* operDeltaExecutor();
+
 class SwitchState;
 class ControlPlane;
 class MultiControlPlane;
@@ -126,6 +138,24 @@ class StateDelta {
 
   const fsdb::OperDelta& getOperDelta() const;
 
+  /*
+   * For states built independently of each other, e.g. a state rebuilt from
+   * config or on resync and the state it replaces, where equal subtrees are
+   * distinct objects. The oper delta then skips subtrees with equal content
+   * hashes, see DeltaVisitOptions::pruneEqualContents.
+   */
+  void setPruneEqualContents(bool prune) {
+    pruneEqualContents_ = prune;
+  }
+
+  /*
+   * Computes and caches the content hashes of both (published) states, so
+   * that DEEP comparisons (see DeltaComparison) tell equal nodes apart by
+   * their hashes. Costs a pass over both states, only worth it when most
+   * nodes of the states are distinct objects.
+   */
+  void primeContentHashes() const;
+
   // Check if routes or neighbors (ARP/NDP) changed.
   // Shared by MirrorManager and TamManager for next-hop resolution.
   bool hasRouteOrNeighborChanges() const;
@@ -139,6 +169,7 @@ class StateDelta {
   std::shared_ptr<SwitchState> new_;
   // on-demand populate oper delta and keep it cached
   mutable std::optional<fsdb::OperDelta> operDelta_;
+  bool pruneEqualContents_{false};
 };
 
 bool isStateDeltaEmpty(const StateDelta& stateDelta);
@@ -9,6 +9,7 @@
  */
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <optional>
 
@@ -38,9 +39,31 @@ class StateUpdate {
     NONE = 0x0,
     NON_COALESCING = 0x1,
     HW_FAILURE_PROTECTION = 0x2,
+    // The update rebuilds parts of the state rather than modifying them,
+    // e.g. applying config, so its deltas skip subtrees with equal contents
+    PRUNE_EQUAL_CONTENTS = 0x4,
   };
   static constexpr int kDefaultBehaviorFlags =
       static_cast<int>(BehaviorFlags::NONE);
+
+  /*
+   * Pending updates of a higher priority get applied first, and updates of
+   * the same priority in the order they were queued in. An update still
+   * pending past its deadline gets its priority served ahead of the others.
+   * Updates of different priorities may be applied out of queuing order, so
+   * all the updates of an object (e.g. adding and flushing a neighbor) must
+   * use the same priority.
+   */
+  enum class Priority : int {
+    // Updates on the path to data plane convergence, e.g. link state, LACP
+    // and neighbor changes
+    CRITICAL = 0,
+    NORMAL = 1,
+    // Large updates that can wait a bit, e.g. route programming
+    BULK = 2,
+  };
+  static constexpr int kNumPriorities = 3;
+
   StateUpdate(
       folly::StringPiece name,
       int behaviorFlags,
@@ -55,6 +78,21 @@ class StateUpdate {
     return name_;
   }
 
+  Priority getPriority() const {
+    return priority_;
+  }
+  void setPriority(Priority priority) {
+    priority_ = priority;
+  }
+
+  const std::optional<std::chrono::steady_clock::time_point>& getDeadline()
+      const {
+    return deadline_;
+  }
+  void setDeadline(std::chrono::steady_clock::time_point deadline) {
+    deadline_ = deadline;
+  }
+
   bool allowsCoalescing() const {
     return !isNonCoalescing();
   }
@@ -65,6 +103,10 @@ class StateUpdate {
     return behaviorFlags_ &
         static_cast<int>(BehaviorFlags::HW_FAILURE_PROTECTION);
   }
+  bool pruneEqualContents() const {
+    return behaviorFlags_ &
+        static_cast<int>(BehaviorFlags::PRUNE_EQUAL_CONTENTS);
+  }
 
   const std::optional<StateDeltaApplication>& getDeltaApplicationBehavior()
       const {
@@ -114,11 +156,16 @@ class StateUpdate {
   std::string name_;
   int behaviorFlags_{static_cast<int>(BehaviorFlags::NONE)};
   std::optional<StateDeltaApplication> deltaApplicationBehavior_;
+  Priority priority_{Priority::NORMAL};
+  std::optional<std::chrono::steady_clock::time_point> deadline_;
+  // When SwSwitch queued the update, for latency tracing
+  std::chrono::steady_clock::time_point enqueueTime_;
+  std::chrono::system_clock::time_point enqueueWallTime_;
 
   // An intrusive list hook for maintaining the list of pending updates.
   folly::IntrusiveListHook listHook_;
   // The SwSwitch code needs access to our listHook_ member so it can maintain
-  // the update list.
+  // the update list, and to the enqueue times to trace the update.
   friend class SwSwitch;
 };
 
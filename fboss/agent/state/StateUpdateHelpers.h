@@ -11,8 +11,10 @@
 // This file contains helper implementations of StateUpdate.
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -136,4 +138,85 @@ class BlockingStateUpdate : public StateUpdate {
   std::shared_ptr<BlockingUpdateResult> result_;
 };
 
+/*
+ * Updates handed over back to back through PipelinedStateUpdate, each one
+ * computed before the ones ahead of it are applied to hardware. Once one
+ * of them fails to apply, the ones behind it must fail too rather than get
+ * applied without it.
+ */
+struct StateUpdatePipeline {
+  // Set on the update thread when an update fails to apply, may be checked
+  // from other threads, e.g. by fake pipelines in tests
+  std::atomic<bool> failed{false};
+};
+
+/*
+ * Update whose caller only blocks until the new state is computed, leaving
+ * it free to go on while the state gets applied to hardware. The outcome
+ * of that is reported through the future of the applied state. Failing to
+ * apply marks the update's pipeline failed.
+ */
+class PipelinedStateUpdate : public StateUpdate {
+ public:
+  using StateUpdateFn = std::function<std::shared_ptr<SwitchState>(
+      const std::shared_ptr<SwitchState>&)>;
+  using AppliedStateFn = std::function<std::shared_ptr<SwitchState>()>;
+
+  PipelinedStateUpdate(
+      folly::StringPiece name,
+      StateUpdateFn fn,
+      std::shared_ptr<BlockingUpdateResult> prepared,
+      std::shared_ptr<StateUpdatePipeline> pipeline,
+      AppliedStateFn appliedStateFn,
+      int flags = kDefaultBehaviorFlags,
+      std::optional<StateDeltaApplication> deltaApplicationBehavior =
+          std::nullopt)
+      : StateUpdate(name, flags, std::move(deltaApplicationBehavior)),
+        function_(std::move(fn)),
+        prepared_(std::move(prepared)),
+        pipeline_(std::move(pipeline)),
+        appliedStateFn_(std::move(appliedStateFn)),
+        appliedState_(appliedStatePromise_.get_future().share()) {}
+
+  std::shared_future<std::shared_ptr<SwitchState>> getAppliedState() const {
+    return appliedState_;
+  }
+
+  std::shared_ptr<SwitchState> applyUpdate(
+      const std::shared_ptr<SwitchState>& origState) override {
+    std::shared_ptr<SwitchState> newState;
+    try {
+      newState = function_(origState);
+    } catch (const std::exception&) {
+      prepared_->signalError(std::current_exception());
+      throw;
+    }
+    computed_ = true;
+    prepared_->signalSuccess();
+    return newState;
+  }
+
+  void onError(const std::exception& /*ex*/) noexcept override {
+    if (computed_) {
+      // Failed to apply to hardware
+      pipeline_->failed = true;
+    }
+    // See BlockingStateUpdate::onError() on std::current_exception()
+    appliedStatePromise_.set_exception(std::current_exception());
+  }
+
+  void onSuccess() override {
+    appliedStatePromise_.set_value(appliedStateFn_());
+  }
+
+ private:
+  StateUpdateFn function_;
+  std::shared_ptr<BlockingUpdateResult> prepared_;
+  std::shared_ptr<StateUpdatePipeline> pipeline_;
+  AppliedStateFn appliedStateFn_;
+  std::promise<std::shared_ptr<SwitchState>> appliedStatePromise_;
+  std::shared_future<std::shared_ptr<SwitchState>> appliedState_;
+  bool computed_{false};
+};
+
 } // namespace facebook::fboss
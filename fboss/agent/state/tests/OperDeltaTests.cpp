@@ -99,3 +99,28 @@ TEST(OperDeltaTests, DeltaCompare) {
     EXPECT_TRUE(DeltaFunctions::isEmpty(delta3.getPortsDelta()));
   }
 }
+
+TEST(OperDeltaTests, PruneEqualContents) {
+  auto platform = createMockPlatform();
+  auto stateV0 = make_shared<SwitchState>();
+  auto config = testConfigA();
+  auto stateV1 = publishAndApplyConfig(stateV0, &config, platform.get());
+  ASSERT_NE(nullptr, stateV1);
+
+  auto operDelta = fsdb::computeOperDelta(stateV0, stateV1, {}, true);
+  auto delta1 = StateDelta(stateV0, operDelta);
+  auto delta2 = StateDelta(stateV0, operDelta);
+  // equal states, built independently of each other
+  auto delta3 = StateDelta(delta1.newState(), delta2.newState());
+  EXPECT_FALSE(delta3.getOperDelta().changes()->empty());
+
+  auto prunedDelta = StateDelta(delta1.newState(), delta2.newState());
+  prunedDelta.setPruneEqualContents(true);
+  EXPECT_TRUE(prunedDelta.getOperDelta().changes()->empty());
+
+  prunedDelta.primeContentHashes();
+  {
+    DeltaComparison::PolicyRAII policy(DeltaComparison::Policy::DEEP);
+    EXPECT_TRUE(DeltaFunctions::isEmpty(prunedDelta.getPortsDelta()));
+  }
+}
@@ -15,6 +15,7 @@
 
 #include "fboss/agent/state/Route.h"
 #include "fboss/agent/state/RouteNextHopEntry.h"
+#include "fboss/agent/state/RouteNextHopSetPool.h"
 #include "fboss/agent/state/StateUtils.h"
 #include "fboss/agent/state/SwitchState-defs.h"
 #include "fboss/agent/state/SwitchState.h"
@@ -702,3 +703,80 @@ TEST(RouteNextHopEntry, toUnicastRouteWithSrv6Nhops) {
   EXPECT_EQ(thriftNh.tunnelType(), TunnelType::SRV6_ENCAP);
   EXPECT_EQ(thriftNh.tunnelId(), kSrv6Tunnel0);
 }
+
+TEST(Route, pooledNextHops) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_intern_route_nexthops = true;
+
+  auto nhops = newNextHops(3, "1.1.1.");
+  RouteNextHopEntry entryA(nhops, DISTANCE);
+  RouteNextHopEntry entryB(nhops, DISTANCE);
+  EXPECT_TRUE(entryA.sharesNextHops(entryB));
+  EXPECT_EQ(entryA, entryB);
+
+  RouteNextHopEntry entryC(RouteNextHopEntry::Action::DROP, DISTANCE);
+  entryC.setNextHops(nhops);
+  EXPECT_TRUE(entryA.sharesNextHops(entryC));
+
+  RouteNextHopEntry entryD(newNextHops(2, "1.1.1."), DISTANCE);
+  EXPECT_FALSE(entryA.sharesNextHops(entryD));
+  EXPECT_FALSE(entryA.sameNextHops(entryD));
+  EXPECT_NE(entryA, entryD);
+
+  // Pooled and private lists are interchangeable
+  FLAGS_intern_route_nexthops = false;
+  RouteNextHopEntry entryE(nhops, DISTANCE);
+  EXPECT_FALSE(entryA.sharesNextHops(entryE));
+  EXPECT_TRUE(entryA.sameNextHops(entryE));
+  EXPECT_EQ(entryA, entryE);
+  EXPECT_EQ(entryA.toThrift(), entryE.toThrift());
+  EXPECT_EQ(entryA.nextHopsHash(), entryE.nextHopsHash());
+  EXPECT_EQ(
+      std::hash<RouteNextHopEntry>()(entryA),
+      std::hash<RouteNextHopEntry>()(entryE));
+
+  // Pooled and private lists of the same set compare by value
+  RouteNextHopEntry entryF(nhops, DISTANCE);
+  entryF.setNextHops(newNextHops(2, "1.1.1."));
+  EXPECT_EQ(entryD, entryF);
+  EXPECT_NE(entryA, entryF);
+
+  // Pool does not keep unused lists alive
+  std::weak_ptr<RouteNextHopSetPool::NextHopsNode> unused =
+      RouteNextHopSetPool::get()->intern(newNextHops(4, "2.2.2."));
+  EXPECT_TRUE(unused.expired());
+}
+
+TEST(Route, isSameWithPooledNextHops) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_intern_route_nexthops = true;
+
+  auto makeRoute = [](const RouteNextHopSet& nhops) {
+    RouteNextHopEntry nhopEntry(nhops, DISTANCE);
+    auto route = std::make_shared<Route<IPAddressV4>>(
+        Route<IPAddressV4>::makeThrift(
+            makePrefixV4("1.2.3.4/32"), CLIENT_A, nhopEntry));
+    route->setResolved(nhopEntry);
+    route->publish();
+    return route;
+  };
+  auto nhops = newNextHops(3, "1.1.1.");
+  auto route1 = makeRoute(nhops);
+  auto route2 = makeRoute(nhops);
+  EXPECT_TRUE(
+      route1->getForwardInfo().sharesNextHops(route2->getForwardInfo()));
+  EXPECT_TRUE(route1->isSame(route2.get()));
+
+  auto route3 = makeRoute(newNextHops(2, "1.1.1."));
+  EXPECT_FALSE(route1->isSame(route3.get()));
+
+  auto unresolved = route1->cloneForReresolve();
+  EXPECT_FALSE(route1->isSame(unresolved.get()));
+
+  // Routes without shared children still compare by content
+  auto fromThrift = std::make_shared<Route<IPAddressV4>>(route1->toThrift());
+  EXPECT_FALSE(
+      route1->getForwardInfo().sharesNextHops(fromThrift->getForwardInfo()));
+  EXPECT_TRUE(route1->isSame(fromThrift.get()));
+  EXPECT_TRUE(fromThrift->isSame(route1.get()));
+}
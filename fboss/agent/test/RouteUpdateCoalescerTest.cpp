@@ -0,0 +1,144 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/RouteUpdateCoalescer.h"
+#include "fboss/agent/AddressUtil.h"
+#include "fboss/agent/FbossError.h"
+
+#include <folly/IPAddress.h>
+#include <folly/Synchronized.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace facebook::fboss;
+using namespace std::chrono_literals;
+
+namespace {
+const RouterID kVrf(0);
+const ClientID kClient(ClientID::BGPD);
+
+IpPrefix makePrefix(const std::string& ip, int16_t len) {
+  IpPrefix prefix;
+  prefix.ip() = facebook::network::toBinaryAddress(folly::IPAddress(ip));
+  prefix.prefixLength() = len;
+  return prefix;
+}
+
+UnicastRoute makeRoute(const std::string& ip, int16_t len) {
+  UnicastRoute route;
+  route.dest() = makePrefix(ip, len);
+  route.action() = RouteForwardAction::DROP;
+  return route;
+}
+
+class RouteUpdateCoalescerTest : public ::testing::Test {
+ public:
+  // Long enough a window for the calls of a test to land in one batch
+  RouteUpdateCoalescer coalescer{
+      500ms,
+      [this](const RouteUpdateCoalescer::Batch& batch) {
+        if (failPrograms) {
+          throw FbossError("programming failed");
+        }
+        std::this_thread::sleep_for(programDelay);
+        batches.wlock()->push_back(batch);
+      }};
+  folly::Synchronized<std::vector<RouteUpdateCoalescer::Batch>> batches;
+  bool failPrograms{false};
+  std::chrono::milliseconds programDelay{0};
+};
+} // namespace
+
+TEST_F(RouteUpdateCoalescerTest, mergeCallsInWindow) {
+  std::thread first([this] {
+    coalescer.addRoutes(kVrf, kClient, {makeRoute("10.0.0.0", 24)});
+  });
+  std::this_thread::sleep_for(50ms);
+  auto delay = coalescer.addRoutes(
+      kVrf, kClient, {makeRoute("10.0.1.0", 24), makeRoute("2401::", 64)});
+  first.join();
+  // Joined the batch opened by the first call, so waited less
+  EXPECT_LT(delay, 500ms);
+
+  auto programmed = batches.copy();
+  ASSERT_EQ(1, programmed.size());
+  EXPECT_EQ(2, programmed[0].numCalls);
+  EXPECT_EQ(3, programmed[0].toAdd.size());
+  EXPECT_TRUE(programmed[0].toDel.empty());
+}
+
+TEST_F(RouteUpdateCoalescerTest, lastUpdateOfPrefixWins) {
+  std::thread first([this] {
+    coalescer.addRoutes(
+        kVrf, kClient, {makeRoute("10.0.0.0", 24), makeRoute("10.0.1.0", 24)});
+  });
+  std::this_thread::sleep_for(50ms);
+  coalescer.delRoutes(kVrf, kClient, {makePrefix("10.0.0.0", 24)});
+  first.join();
+
+  auto programmed = batches.copy();
+  ASSERT_EQ(1, programmed.size());
+  ASSERT_EQ(1, programmed[0].toAdd.size());
+  EXPECT_EQ(makePrefix("10.0.1.0", 24), *programmed[0].toAdd[0].dest());
+  ASSERT_EQ(1, programmed[0].toDel.size());
+  EXPECT_EQ(makePrefix("10.0.0.0", 24), programmed[0].toDel[0]);
+}
+
+TEST_F(RouteUpdateCoalescerTest, separateBatchPerClient) {
+  std::thread first([this] {
+    coalescer.addRoutes(kVrf, kClient, {makeRoute("10.0.0.0", 24)});
+  });
+  coalescer.addRoutes(kVrf, ClientID::OPENR, {makeRoute("10.0.0.0", 24)});
+  first.join();
+  EXPECT_EQ(2, batches.rlock()->size());
+}
+
+TEST_F(RouteUpdateCoalescerTest, errorReachesEveryCall) {
+  failPrograms = true;
+  std::thread first([this] {
+    EXPECT_THROW(
+        coalescer.addRoutes(kVrf, kClient, {makeRoute("10.0.0.0", 24)}),
+        FbossError);
+  });
+  std::this_thread::sleep_for(50ms);
+  EXPECT_THROW(
+      coalescer.delRoutes(kVrf, kClient, {makePrefix("10.0.1.0", 24)}),
+      FbossError);
+  first.join();
+}
+
+TEST_F(RouteUpdateCoalescerTest, flushProgramsPendingBatch) {
+  std::thread first([this] {
+    coalescer.addRoutes(kVrf, kClient, {makeRoute("10.0.0.0", 24)});
+  });
+  std::this_thread::sleep_for(50ms);
+  coalescer.flush(kVrf, kClient);
+  // Programmed before the window is over
+  EXPECT_EQ(1, batches.rlock()->size());
+  first.join();
+  EXPECT_EQ(1, batches.rlock()->size());
+  // Nothing pending anymore
+  coalescer.flush(kVrf, kClient);
+  EXPECT_EQ(1, batches.rlock()->size());
+}
+
+TEST_F(RouteUpdateCoalescerTest, flushWaitsForBatchBeingProgrammed) {
+  programDelay = 300ms;
+  std::thread first([this] {
+    coalescer.addRoutes(kVrf, kClient, {makeRoute("10.0.0.0", 24)});
+  });
+  // The batch is out of the window and being programmed
+  std::this_thread::sleep_for(650ms);
+  coalescer.flush(kVrf, kClient);
+  EXPECT_EQ(1, batches.rlock()->size());
+  first.join();
+}
@@ -0,0 +1,145 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/StateObserverNotifier.h"
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/StateObserver.h"
+#include "fboss/agent/state/SwitchState.h"
+
+#include <folly/Synchronized.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace facebook::fboss;
+
+namespace {
+using Events = folly::Synchronized<std::vector<std::string>>;
+
+class TestObserver : public StateObserver {
+ public:
+  TestObserver(
+      std::string name,
+      Events* events,
+      bool threadSafe = false,
+      std::vector<std::string> dependencies = {})
+      : name_(std::move(name)),
+        events_(events),
+        threadSafe_(threadSafe),
+        dependencies_(std::move(dependencies)) {}
+
+  void stateUpdated(const StateDelta& /*delta*/) override {
+    events_->wlock()->push_back(name_ + ".start");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    events_->wlock()->push_back(name_ + ".end");
+  }
+  bool isThreadSafe() const override {
+    return threadSafe_;
+  }
+  std::vector<std::string> getDependencies() const override {
+    return dependencies_;
+  }
+
+ private:
+  std::string name_;
+  Events* events_;
+  bool threadSafe_;
+  std::vector<std::string> dependencies_;
+};
+
+size_t indexOf(const std::vector<std::string>& events, const std::string& e) {
+  auto it = std::find(events.begin(), events.end(), e);
+  EXPECT_NE(it, events.end()) << e;
+  return it - events.begin();
+}
+
+StateDelta emptyDelta() {
+  return StateDelta(
+      std::make_shared<SwitchState>(), std::make_shared<SwitchState>());
+}
+} // namespace
+
+TEST(StateObserverNotifierTest, wavesFollowDependencies) {
+  Events events;
+  TestObserver a("a", &events);
+  TestObserver b("b", &events, false, {"a"});
+  TestObserver c("c", &events, false, {"a", "b"});
+  TestObserver d("d", &events, false, {"unregistered"});
+  StateObserverNotifier notifier(0, nullptr);
+  notifier.add(&c, "c");
+  notifier.add(&b, "b");
+  notifier.add(&a, "a");
+  notifier.add(&d, "d");
+
+  auto waves = notifier.getWaves();
+  ASSERT_EQ(3, waves.size());
+  std::sort(waves[0].begin(), waves[0].end());
+  EXPECT_EQ((std::vector<std::string>{"a", "d"}), waves[0]);
+  EXPECT_EQ(std::vector<std::string>{"b"}, waves[1]);
+  EXPECT_EQ(std::vector<std::string>{"c"}, waves[2]);
+
+  notifier.remove(&a);
+  EXPECT_FALSE(notifier.contains(&a));
+  EXPECT_EQ(2, notifier.getWaves().size());
+}
+
+TEST(StateObserverNotifierTest, rejectCycleAndDuplicate) {
+  Events events;
+  TestObserver a("a", &events, false, {"b"});
+  TestObserver b("b", &events, false, {"a"});
+  StateObserverNotifier notifier(0, nullptr);
+  notifier.add(&a, "a");
+  EXPECT_THROW(notifier.add(&a, "a"), FbossError);
+  EXPECT_THROW(notifier.add(&b, "b"), FbossError);
+  EXPECT_FALSE(notifier.contains(&b));
+  EXPECT_THROW(notifier.remove(&b), FbossError);
+  EXPECT_EQ(1, notifier.getWaves().size());
+}
+
+TEST(StateObserverNotifierTest, notifyThreadSafeObserversConcurrently) {
+  Events events;
+  TestObserver a("a", &events, true);
+  TestObserver b("b", &events, true);
+  TestObserver c("c", &events, false);
+  TestObserver d("d", &events, true, {"a", "b", "c"});
+  folly::Synchronized<std::map<std::string, int>> numLatencies;
+  StateObserverNotifier notifier(
+      2, [&](const std::string& name, std::chrono::microseconds) {
+        (*numLatencies.wlock())[name]++;
+      });
+  notifier.add(&a, "a");
+  notifier.add(&b, "b");
+  notifier.add(&c, "c");
+  notifier.add(&d, "d");
+  notifier.notify(emptyDelta());
+
+  auto notified = events.copy();
+  ASSERT_EQ(8, notified.size());
+  // First wave overlaps
+  for (const auto& first : {"a", "b", "c"}) {
+    for (const auto& second : {"a", "b", "c"}) {
+      EXPECT_LT(
+          indexOf(notified, std::string(first) + ".start"),
+          indexOf(notified, std::string(second) + ".end"));
+    }
+  }
+  // Second wave starts once the first is done
+  for (const auto& dependency : {"a", "b", "c"}) {
+    EXPECT_LT(
+        indexOf(notified, std::string(dependency) + ".end"),
+        indexOf(notified, "d.start"));
+  }
+  EXPECT_EQ(
+      (std::map<std::string, int>{{"a", 1}, {"b", 1}, {"c", 1}, {"d", 1}}),
+      numLatencies.copy());
+}
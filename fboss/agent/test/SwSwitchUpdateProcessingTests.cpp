@@ -11,12 +11,17 @@
 #include <gtest/gtest.h>
 
 #include "fboss/agent/FbossHwUpdateError.h"
+#include "fboss/agent/StateUpdateTracer.h"
 #include "fboss/agent/SwitchStats.h"
+#include "fboss/agent/state/StateUpdateHelpers.h"
 #include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/test/CounterCache.h"
 #include "fboss/agent/test/HwTestHandle.h"
 #include "fboss/agent/test/TestUtils.h"
 
+#include <folly/synchronization/Baton.h>
+#include <gflags/gflags.h>
+
 #include <algorithm>
 
 using namespace facebook::fboss;
@@ -339,6 +344,98 @@ TEST_P(SwSwitchUpdateProcessingTest, ProcessDeltaVector) {
   }
 }
 
+TEST_P(SwSwitchUpdateProcessingTest, TraceUpdates) {
+  setStateChangedReturn(front);
+  auto stateUpdateFn = [](const std::shared_ptr<SwitchState>& state) {
+    return bringAllPortsUp(state->clone());
+  };
+  EXPECT_THROW(
+      sw->updateStateWithHwFailureProtection("Reject update", stateUpdateFn),
+      FbossHwUpdateError);
+  setStateChangedReturn(back);
+  sw->updateStateBlocking("Accept update: ports up", stateUpdateFn);
+  waitForStateUpdates(sw);
+
+  auto traces = sw->getStateUpdateTracer()->getTraces(100);
+  auto findTrace = [&traces](const std::string& name) {
+    auto it = std::find_if(traces.begin(), traces.end(), [&](const auto& t) {
+      return *t.name() == name;
+    });
+    EXPECT_NE(it, traces.end()) << name;
+    return it;
+  };
+  auto rejected = findTrace("Reject update");
+  auto accepted = findTrace("Accept update: ports up");
+  // Most recent first
+  EXPECT_LT(accepted, rejected);
+  EXPECT_TRUE(*rejected->failed());
+  EXPECT_FALSE(*accepted->failed());
+  EXPECT_EQ(1, *rejected->batchSize());
+  EXPECT_GE(
+      *accepted->totalUs(),
+      *accepted->queueWaitUs() + *accepted->applyUpdateUs() +
+          *accepted->hwProgrammingUs());
+  EXPECT_EQ(1, sw->getStateUpdateTracer()->getTraces(1).size());
+}
+
+TEST_P(SwSwitchUpdateProcessingTest, ApplyUpdatesByPriority) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_state_update_priority_scheduling = true;
+  folly::Baton<> blocking, unblock;
+  std::vector<std::string> applied;
+  auto recordFn = [&applied](const std::string& name) {
+    return [&applied, name](const std::shared_ptr<SwitchState>&) {
+      applied.push_back(name);
+      return std::shared_ptr<SwitchState>();
+    };
+  };
+  // Hold the update thread while we queue updates
+  sw->updateState("block", [&](const std::shared_ptr<SwitchState>&) {
+    blocking.post();
+    unblock.wait();
+    return std::shared_ptr<SwitchState>();
+  });
+  blocking.wait();
+  sw->updateState("bulk", recordFn("bulk"), StateUpdate::Priority::BULK);
+  sw->updateState("normal 1", recordFn("normal 1"));
+  sw->updateStateNoCoalescing(
+      "critical", recordFn("critical"), StateUpdate::Priority::CRITICAL);
+  sw->updateState("normal 2", recordFn("normal 2"));
+  auto expired = std::make_unique<FunctionStateUpdate>(
+      "expired bulk", recordFn("expired bulk"));
+  expired->setPriority(StateUpdate::Priority::BULK);
+  expired->setDeadline(std::chrono::steady_clock::now());
+  sw->updateState(std::move(expired));
+  unblock.post();
+  waitForStateUpdates(sw);
+
+  // Past its deadline, the expired update gets its priority served first.
+  // The bulk update queued ahead of it inherits its deadline and goes
+  // first. Then the others go by priority
+  EXPECT_EQ(
+      (std::vector<std::string>{
+          "bulk", "expired bulk", "critical", "normal 1", "normal 2"}),
+      applied);
+}
+
+TEST(StateUpdateTracerTest, CounterKeys) {
+  StateUpdateTracer tracer(10);
+  EXPECT_EQ("updating_mirrors", tracer.getCounterKey("Updating mirrors"));
+  EXPECT_EQ(
+      "updateoradd_static_mac",
+      tracer.getCounterKey("updateOrAdd static MAC: 10.0.0.1"));
+  EXPECT_EQ("add_neighbor", tracer.getCounterKey("add neighbor 10.0.0.1"));
+  EXPECT_EQ(
+      "add_pending_entry", tracer.getCounterKey("add pending entry fe80::1"));
+  EXPECT_EQ(
+      "remove_neighbor_entry",
+      tracer.getCounterKey("remove neighbor entry: 2401:db00::1"));
+  EXPECT_EQ("re_enable_port", tracer.getCounterKey("Re-enable port eth1/2/1"));
+  EXPECT_EQ("add_ipv6_route", tracer.getCounterKey("Add ipv6 route"));
+  EXPECT_EQ("other", tracer.getCounterKey(": x"));
+  EXPECT_EQ("other", tracer.getCounterKey("10.0.0.1"));
+}
+
 INSTANTIATE_TEST_CASE_P(
     SwSwitchUpdateProcessingTest,
     SwSwitchUpdateProcessingTest,
@@ -11,6 +11,7 @@
 #include "fboss/fsdb/client/FsdbStreamClient.h"
 #include "fboss/thrift_cow/storage/CowStorageMgr.h"
 
+#include <folly/Executor.h>
 #include <folly/io/async/EventBase.h>
 #include <atomic>
 #include <memory>
@@ -87,6 +88,12 @@ class FsdbSyncManager {
     CHECK(!readyForPublishing_.load());
   }
 
+  // Executor visiting large maps and lists concurrently when computing the
+  // deltas published, null to compute them serially. Set before start().
+  void setOperDeltaExecutor(folly::Executor* executor) {
+    operDeltaExecutor_ = executor;
+  }
+
   // Starts publishing to fsdb. This method should only be called once all state
   // components are ready and the SyncManager's internal storage has be
   // populated to a sane state. Initial sync will follow asyncronously after
@@ -223,7 +230,8 @@ class FsdbSyncManager {
   void publishDelta(
       const std::shared_ptr<CowState>& oldState,
       const std::shared_ptr<CowState>& newState) {
-    publish(computeOperDelta(oldState, newState, basePath_, useIdPaths_));
+    publish(computeOperDelta(
+        oldState, newState, basePath_, useIdPaths_, operDeltaExecutor_));
   }
 
   void publishPath(const std::shared_ptr<CowState>& newState) {
@@ -302,6 +310,7 @@ class FsdbSyncManager {
   CowStorageManager storage_;
   std::atomic_bool readyForPublishing_ = false;
   bool useIdPaths_ = false;
+  folly::Executor* operDeltaExecutor_{nullptr};
 };
 
 } // namespace facebook::fboss::fsdb
@@ -64,7 +64,9 @@ fsdb::OperDelta computeOperDelta(
     const std::shared_ptr<Node>& oldNode,
     const std::shared_ptr<Node>& newNode,
     const std::vector<std::string>& basePath,
-    bool outputIdPaths = false) {
+    bool outputIdPaths = false,
+    folly::Executor* executor = nullptr,
+    bool pruneEqualContents = false) {
   std::vector<fsdb::OperDeltaUnit> operDeltaUnits{};
 
   auto processDelta = [basePath, &operDeltaUnits](
@@ -85,15 +87,16 @@ fsdb::OperDelta computeOperDelta(
         fullPath, emptyOldNode, newNode, fsdb::OperProtocol::BINARY));
   };
 
-  thrift_cow::SimpleTraverseHelper traverser;
+  thrift_cow::DeltaVisitOptions options(
+      thrift_cow::DeltaVisitMode::MINIMAL,
+      thrift_cow::DeltaVisitOrder::PARENTS_FIRST,
+      outputIdPaths);
+  // visits large maps and lists concurrently, deltas keep their order
+  options.executor = executor;
+  // for trees built independently of each other, see DeltaVisitOptions
+  options.pruneEqualContents = pruneEqualContents;
   thrift_cow::RootDeltaVisitor::visit(
-      oldNode,
-      newNode,
-      thrift_cow::DeltaVisitOptions(
-          thrift_cow::DeltaVisitMode::MINIMAL,
-          thrift_cow::DeltaVisitOrder::PARENTS_FIRST,
-          outputIdPaths),
-      std::move(processDelta));
+      oldNode, newNode, options, std::move(processDelta));
   return createDelta(std::move(operDeltaUnits));
 }
 
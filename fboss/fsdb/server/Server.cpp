@@ -12,6 +12,7 @@
 #include "fboss/fsdb/server/ServiceHandler.h"
 #include "fboss/fsdb/server/ThriftAcceptor.h"
 #include "fboss/lib/ThriftServiceUtils.h"
+#include "fboss/thrift_cow/nodes/EncodedBufCache.h"
 
 using namespace std::chrono_literals; // @donotremove
 
@@ -57,6 +58,13 @@ DEFINE_bool(
     false,
     "Convert subscriber paths to id paths and serve only ids");
 
+DEFINE_bool(
+    cacheEncodedSubtrees,
+    false,
+    "Cache the encodings of published state subtrees and reuse them in the "
+    "encodings of their parents, trading memory for re-encoding only the "
+    "subtrees that changed");
+
 DEFINE_int32(
     fsdb_queue_timeout_ms,
     100,
@@ -116,6 +124,7 @@ void initFlagDefaults(
 
 std::shared_ptr<ServiceHandler> createThriftHandler(
     std::shared_ptr<FsdbConfig> fsdbConfig) {
+  thrift_cow::setEncodedBufCaching(FLAGS_cacheEncodedSubtrees);
   return std::make_shared<ServiceHandler>(
       fsdbConfig,
       ServiceHandler::Options().setServeIdPathSubs(FLAGS_useIdPathsForSubs));
@@ -0,0 +1,375 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <glog/logging.h>
+
+#include <folly/IPAddressV4.h>
+#include <folly/IPAddressV6.h>
+#include <folly/lang/Bits.h>
+
+namespace facebook::network {
+
+namespace detail {
+
+template <typename IPADDRTYPE>
+struct LpmKeyTraits;
+
+template <>
+struct LpmKeyTraits<folly::IPAddressV4> {
+  using Key = uint32_t;
+  static constexpr uint32_t kBits = 32;
+  static Key key(const folly::IPAddressV4& addr) {
+    return addr.toLongHBO();
+  }
+};
+
+template <>
+struct LpmKeyTraits<folly::IPAddressV6> {
+  using Key = unsigned __int128;
+  static constexpr uint32_t kBits = 128;
+  static Key key(const folly::IPAddressV6& addr) {
+    Key key = 0;
+    for (auto byte : addr.toByteArray()) {
+      key = (key << 8) | byte;
+    }
+    return key;
+  }
+};
+
+} // namespace detail
+
+/*
+ * Immutable longest prefix match structure built from a RadixTree.
+ *
+ * Lookups walk a Poptrie (Asai & Ohara, SIGCOMM'15): the first kDirectBits
+ * of the address index a flat table, the remaining bits are consumed 6 at a
+ * time by nodes that keep their children and leaves in contiguous arrays
+ * indexed through popcounts of two 64 bit masks. A v4 lookup touches at
+ * most 4 cache lines and a v6 one at most 20, against one heap node per
+ * matched bit for the RadixTree, and the whole table takes a few bytes per
+ * route.
+ *
+ * The snapshot holds copies of the tree's values and does not follow later
+ * changes to the tree, see LpmSnapshotCache.
+ */
+template <typename IPADDRTYPE, typename T>
+class LpmSnapshot {
+  using Traits = detail::LpmKeyTraits<IPADDRTYPE>;
+  using Key = typename Traits::Key;
+
+ public:
+  static constexpr uint32_t kDirectBits = 16;
+  static constexpr uint32_t kStride = 6;
+
+  template <typename Tree>
+  explicit LpmSnapshot(const Tree& tree) {
+    std::vector<Prefix> prefixes;
+    prefixes.reserve(tree.size());
+    values_.reserve(tree.size());
+    for (const auto& node : tree) {
+      values_.push_back(node.value());
+      prefixes.push_back(
+          {mask(Traits::key(node.ipAddress()), node.masklen()),
+           node.masklen(),
+           static_cast<uint32_t>(values_.size())});
+    }
+    // Covering prefixes sort ahead of the prefixes they cover
+    std::sort(
+        prefixes.begin(), prefixes.end(), [](const auto& a, const auto& b) {
+          return std::tie(a.key, a.len) < std::tie(b.key, b.len);
+        });
+    buildRoot(prefixes);
+  }
+
+  // Value of the longest prefix covering addr, nullptr if there is none
+  const T* longestMatch(const IPADDRTYPE& addr) const {
+    auto key = Traits::key(addr);
+    auto entry = direct_[chunk(key, 0, kDirectBits)];
+    if (!(entry & kNodeFlag)) {
+      return leafValue(entry);
+    }
+    auto index = entry & ~kNodeFlag;
+    for (uint32_t offset = kDirectBits;; offset += kStride) {
+      const auto& node = nodes_[index];
+      auto slot = chunk(key, offset, kStride);
+      uint64_t bit = uint64_t(1) << slot;
+      // Slots at or before this one, wraps to all ones for the last slot
+      uint64_t upTo = (bit << 1) - 1;
+      if (node.vector & bit) {
+        index = node.base1 + folly::popcount(node.vector & upTo) - 1;
+        continue;
+      }
+      return leafValue(
+          leaves_[node.base0 + folly::popcount(node.leafvec & upTo) - 1]);
+    }
+  }
+
+  size_t size() const {
+    return values_.size();
+  }
+
+  // Bytes taken by the lookup structure, the values themselves excluded
+  size_t memoryUsage() const {
+    return direct_.capacity() * sizeof(uint32_t) +
+        nodes_.capacity() * sizeof(Node) +
+        leaves_.capacity() * sizeof(uint32_t) +
+        values_.capacity() * sizeof(T);
+  }
+
+ private:
+  // Leaves are 1 based indices into values_, 0 stands for no match
+  static constexpr uint32_t kNoLeaf = 0;
+  static constexpr uint32_t kNodeFlag = uint32_t(1) << 31;
+
+  struct Prefix {
+    Key key;
+    uint32_t len;
+    uint32_t leaf;
+  };
+
+  struct Node {
+    // Slots descending into a child node
+    uint64_t vector{0};
+    // Slots starting a new run of identical leaves
+    uint64_t leafvec{0};
+    // Index of the first leaf in leaves_
+    uint32_t base0{0};
+    // Index of the first child in nodes_
+    uint32_t base1{0};
+  };
+
+  struct SubTree {
+    uint32_t slot;
+    const Prefix* begin;
+    const Prefix* end;
+  };
+
+  static Key mask(Key key, uint32_t len) {
+    return len == 0 ? 0 : key & (~Key(0) << (Traits::kBits - len));
+  }
+
+  // Bits [offset, offset + len) of key, zero filled past the address width
+  static uint32_t chunk(Key key, uint32_t offset, uint32_t len) {
+    if (offset >= Traits::kBits) {
+      return 0;
+    }
+    return static_cast<uint32_t>((key << offset) >> (Traits::kBits - len));
+  }
+
+  const T* leafValue(uint32_t leaf) const {
+    return leaf == kNoLeaf ? nullptr : &values_[leaf - 1];
+  }
+
+  /*
+   * Spreads [begin, end), prefixes sharing the first offset bits and no
+   * shorter than offset, over the 1 << stride slots that follow. Fills in
+   * the best leaf of every slot and returns the prefixes that are too long
+   * to end at this level, grouped by slot.
+   */
+  static std::vector<SubTree> split(
+      const Prefix* begin,
+      const Prefix* end,
+      uint32_t offset,
+      uint32_t stride,
+      uint32_t inheritedLeaf,
+      std::vector<uint32_t>& slotLeaves) {
+    slotLeaves.assign(size_t(1) << stride, inheritedLeaf);
+    std::vector<const Prefix*> shallow;
+    std::vector<SubTree> deeper;
+    for (auto prefix = begin; prefix != end; ++prefix) {
+      if (prefix->len <= offset + stride) {
+        shallow.push_back(prefix);
+        continue;
+      }
+      auto slot = chunk(prefix->key, offset, stride);
+      if (deeper.empty() || deeper.back().slot != slot) {
+        deeper.push_back({slot, prefix, prefix});
+      }
+      deeper.back().end = prefix + 1;
+    }
+    // Longer prefixes override the slots of the shorter ones covering them
+    std::stable_sort(
+        shallow.begin(), shallow.end(), [](const auto* a, const auto* b) {
+          return a->len < b->len;
+        });
+    for (const auto* prefix : shallow) {
+      auto first = chunk(prefix->key, offset, stride);
+      auto count = size_t(1) << (offset + stride - prefix->len);
+      std::fill_n(slotLeaves.begin() + first, count, prefix->leaf);
+    }
+    return deeper;
+  }
+
+  void buildRoot(const std::vector<Prefix>& prefixes) {
+    std::vector<uint32_t> slotLeaves;
+    auto deeper = split(
+        prefixes.data(),
+        prefixes.data() + prefixes.size(),
+        0,
+        kDirectBits,
+        kNoLeaf,
+        slotLeaves);
+    direct_ = slotLeaves;
+    auto base = static_cast<uint32_t>(nodes_.size());
+    nodes_.resize(nodes_.size() + deeper.size());
+    for (size_t i = 0; i < deeper.size(); ++i) {
+      const auto& subTree = deeper[i];
+      CHECK_LT(base + i, kNodeFlag);
+      direct_[subTree.slot] = kNodeFlag | (base + i);
+      buildNode(
+          base + i,
+          subTree.begin,
+          subTree.end,
+          kDirectBits,
+          slotLeaves[subTree.slot]);
+    }
+  }
+
+  void buildNode(
+      uint32_t index,
+      const Prefix* begin,
+      const Prefix* end,
+      uint32_t offset,
+      uint32_t inheritedLeaf) {
+    std::vector<uint32_t> slotLeaves;
+    auto deeper =
+        split(begin, end, offset, kStride, inheritedLeaf, slotLeaves);
+    Node node;
+    for (const auto& subTree : deeper) {
+      node.vector |= uint64_t(1) << subTree.slot;
+    }
+    node.base0 = static_cast<uint32_t>(leaves_.size());
+    std::optional<uint32_t> lastLeaf;
+    for (uint32_t slot = 0; slot < slotLeaves.size(); ++slot) {
+      if (node.vector & (uint64_t(1) << slot)) {
+        continue;
+      }
+      if (lastLeaf != slotLeaves[slot]) {
+        node.leafvec |= uint64_t(1) << slot;
+        leaves_.push_back(slotLeaves[slot]);
+        lastLeaf = slotLeaves[slot];
+      }
+    }
+    // Children of a node are laid out next to each other
+    node.base1 = static_cast<uint32_t>(nodes_.size());
+    nodes_.resize(nodes_.size() + deeper.size());
+    for (size_t i = 0; i < deeper.size(); ++i) {
+      const auto& subTree = deeper[i];
+      buildNode(
+          node.base1 + i,
+          subTree.begin,
+          subTree.end,
+          offset + kStride,
+          slotLeaves[subTree.slot]);
+    }
+    nodes_[index] = node;
+  }
+
+  std::vector<uint32_t> direct_;
+  std::vector<Node> nodes_;
+  std::vector<uint32_t> leaves_;
+  std::vector<T> values_;
+};
+
+/*
+ * Keeps an LpmSnapshot of a tree current enough to serve lookups.
+ *
+ * The snapshot is dropped whenever the tree changes and only rebuilt once
+ * enough lookups ran against the tree since, so that trees under churn do
+ * not pay for a rebuild per change. Until then lookups go to the tree.
+ *
+ * longestMatch() may run concurrently with itself. invalidate() must be
+ * called on every change to the tree, with no lookup in flight, e.g. under
+ * the same write lock that guards the tree.
+ */
+template <typename IPADDRTYPE, typename T>
+class LpmSnapshotCache {
+ public:
+  using Snapshot = LpmSnapshot<IPADDRTYPE, T>;
+
+  LpmSnapshotCache() = default;
+  // Copies start out without a snapshot
+  LpmSnapshotCache(const LpmSnapshotCache& /*other*/) {}
+  LpmSnapshotCache& operator=(const LpmSnapshotCache& other) {
+    if (this != &other) {
+      invalidate();
+    }
+    return *this;
+  }
+  LpmSnapshotCache(LpmSnapshotCache&& other) noexcept {
+    *this = std::move(other);
+  }
+  LpmSnapshotCache& operator=(LpmSnapshotCache&& other) noexcept {
+    if (this != &other) {
+      snapshot_ = std::move(other.snapshot_);
+      current_.store(snapshot_.get(), std::memory_order_relaxed);
+      staleLookups_.store(0, std::memory_order_relaxed);
+      other.invalidate();
+    }
+    return *this;
+  }
+
+  void invalidate() {
+    current_.store(nullptr, std::memory_order_relaxed);
+    snapshot_.reset();
+    staleLookups_.store(0, std::memory_order_relaxed);
+  }
+
+  template <typename Tree>
+  const T* longestMatch(const Tree& tree, const IPADDRTYPE& addr) const {
+    if (auto snapshot = current_.load(std::memory_order_acquire)) {
+      return snapshot->longestMatch(addr);
+    }
+    if (staleLookups_.fetch_add(1, std::memory_order_relaxed) + 1 >=
+        rebuildThreshold(tree.size())) {
+      if (auto snapshot = rebuild(tree)) {
+        return snapshot->longestMatch(addr);
+      }
+    }
+    auto it = tree.longestMatch(addr, addr.bitCount());
+    return it == tree.end() ? nullptr : &it->value();
+  }
+
+  const Snapshot* snapshot() const {
+    return current_.load(std::memory_order_acquire);
+  }
+
+ private:
+  // Lookups a stale snapshot must see before an O(routes) rebuild pays off
+  static size_t rebuildThreshold(size_t routes) {
+    return kMinStaleLookups + routes / kRoutesPerStaleLookup;
+  }
+
+  template <typename Tree>
+  const Snapshot* rebuild(const Tree& tree) const {
+    std::lock_guard<std::mutex> guard(rebuildLock_);
+    if (!current_.load(std::memory_order_relaxed)) {
+      snapshot_ = std::make_unique<const Snapshot>(tree);
+      current_.store(snapshot_.get(), std::memory_order_release);
+    }
+    return current_.load(std::memory_order_relaxed);
+  }
+
+  static constexpr size_t kMinStaleLookups = 64;
+  static constexpr size_t kRoutesPerStaleLookup = 16;
+
+  // Owned snapshot, only replaced under rebuildLock_ or by invalidate()
+  mutable std::unique_ptr<const Snapshot> snapshot_;
+  // What lookups read, null while stale
+  mutable std::atomic<const Snapshot*> current_{nullptr};
+  mutable std::atomic<size_t> staleLookups_{0};
+  mutable std::mutex rebuildLock_;
+};
+
+} // namespace facebook::network
@@ -34,9 +34,13 @@ RadixTreeNode<IPADDRTYPE, T>::searchDirection(
   return TreeDirection::PARENT;
 }
 
-template <typename IPADDRTYPE, typename T, typename TreeTraits>
-const typename RadixTree<IPADDRTYPE, T, TreeTraits>::TreeNode*
-RadixTree<IPADDRTYPE, T, TreeTraits>::longestMatchImpl(
+template <
+    typename IPADDRTYPE,
+    typename T,
+    typename TreeTraits,
+    typename NodeAllocator>
+const typename RadixTree<IPADDRTYPE, T, TreeTraits, NodeAllocator>::TreeNode*
+RadixTree<IPADDRTYPE, T, TreeTraits, NodeAllocator>::longestMatchImpl(
     const IPADDRTYPE& ipaddr,
     uint8_t masklen,
     bool& foundExact,
@@ -51,7 +55,7 @@ RadixTree<IPADDRTYPE, T, TreeTraits>::longestMatchImpl(
   // have a parent pointer
   TreeNode* parent = nullptr;
   TreeNode* lastValueNodeSeen = nullptr;
-  auto curNode = root_.get();
+  auto curNode = root_;
   auto done = false;
   while (curNode && !done) {
     auto searchDirection = curNode->searchDirection(toMatch, masklen);
@@ -96,8 +100,75 @@ RadixTree<IPADDRTYPE, T, TreeTraits>::longestMatchImpl(
   return includeNonValueNodes ? curNode : lastValueNodeSeen;
 }
 
-template <typename IPADDRTYPE, typename T, typename TreeTraits>
-inline void RadixTree<IPADDRTYPE, T, TreeTraits>::trailAppend(
+template <
+    typename IPADDRTYPE,
+    typename T,
+    typename TreeTraits,
+    typename NodeAllocator>
+template <typename OnMatch>
+void RadixTree<IPADDRTYPE, T, TreeTraits, NodeAllocator>::longestMatchBatchImpl(
+    std::span<const IPADDRTYPE> addrs,
+    const OnMatch& onMatch) const {
+  struct Lookup {
+    size_t index;
+    const TreeNode* curNode;
+    const TreeNode* lastValueNodeSeen;
+  };
+  // Take one step of lookup down the tree, same as longestMatchImpl
+  // does for full length masks. Returns false once the lookup is done.
+  auto step = [](const IPADDRTYPE& toMatch, Lookup& lookup) {
+    auto curNode = lookup.curNode;
+    if (!curNode) {
+      return false;
+    }
+    auto searchDirection =
+        curNode->searchDirection(toMatch, IPADDRTYPE::bitCount());
+    if (searchDirection == TreeDirection::PARENT) {
+      return false;
+    }
+    if (curNode->isValueNode()) {
+      lookup.lastValueNodeSeen = curNode;
+    }
+    if (searchDirection == TreeDirection::THIS_NODE) {
+      return false;
+    }
+    lookup.curNode = searchDirection == TreeDirection::LEFT ? curNode->left()
+                                                            : curNode->right();
+    if (!lookup.curNode) {
+      return false;
+    }
+    // Start bringing the child in, it is only read on the next round
+    __builtin_prefetch(lookup.curNode);
+    return true;
+  };
+
+  std::array<Lookup, kLookupBatchWidth> inFlight;
+  size_t numInFlight = 0;
+  size_t next = 0;
+  while (next < addrs.size() || numInFlight) {
+    // Top up the batch with new lookups
+    while (numInFlight < kLookupBatchWidth && next < addrs.size()) {
+      inFlight[numInFlight++] = Lookup{next++, root_, nullptr};
+    }
+    for (size_t i = 0; i < numInFlight;) {
+      auto& lookup = inFlight[i];
+      if (step(addrs[lookup.index], lookup)) {
+        ++i;
+        continue;
+      }
+      onMatch(lookup.index, lookup.lastValueNodeSeen);
+      // Done, the last lookup in flight takes this slot over
+      lookup = inFlight[--numInFlight];
+    }
+  }
+}
+
+template <
+    typename IPADDRTYPE,
+    typename T,
+    typename TreeTraits,
+    typename NodeAllocator>
+inline void RadixTree<IPADDRTYPE, T, TreeTraits, NodeAllocator>::trailAppend(
     VecConstIterators* trail,
     bool includeNonValueNodes,
     const TreeNode* node) const {
@@ -108,10 +179,16 @@ inline void RadixTree<IPADDRTYPE, T, TreeTraits>::trailAppend(
   }
 }
 
-template <typename IPADDRTYPE, typename T, typename TreeTraits>
+template <
+    typename IPADDRTYPE,
+    typename T,
+    typename TreeTraits,
+    typename NodeAllocator>
 template <typename VALUE>
-std::pair<typename RadixTree<IPADDRTYPE, T, TreeTraits>::Iterator, bool>
-RadixTree<IPADDRTYPE, T, TreeTraits>::insert(
+std::pair<
+    typename RadixTree<IPADDRTYPE, T, TreeTraits, NodeAllocator>::Iterator,
+    bool>
+RadixTree<IPADDRTYPE, T, TreeTraits, NodeAllocator>::insert(
     const IPADDRTYPE& ipaddr,
     uint8_t mask,
     VALUE&& value) {
@@ -133,44 +210,50 @@ RadixTree<IPADDRTYPE, T, TreeTraits>::insert(
     }
   }
   auto newNode = makeNode(toAdd, mask, std::forward<VALUE>(value));
-  // Cache new node pointer since the unique_ptr maybe moved
-  auto newNodeRaw = newNode.get();
+  // Cache new node pointer since newNode is reset once linked in the tree
+  auto newNodeRaw = newNode;
+  // Free the new node if allocating an internal node for it throws
+  SCOPE_FAIL {
+    if (newNode) {
+      freeNode(newNode);
+    }
+  };
   if (!bestMatch) {
     // No match found
     if (!root_) {
       // Empty tree, make this the root
-      makeRoot(std::move(newNode));
+      makeRoot(std::exchange(newNode, nullptr));
     } else {
       // The root exists but this ipaddr, mask failed to
       // match even the root->ipaddr/mask. We need a less
       // specific root.
       auto prefix = IPADDRTYPE::longestCommonPrefix(
           {root_->ipAddress(), root_->masklen()}, {toAdd, mask});
-      std::unique_ptr<TreeNode> newRoot = nullptr;
+      TreeNode* newRoot = nullptr;
       if (prefix.first == toAdd && prefix.second == mask) {
         // To be added node is the new root
-        newRoot = std::move(newNode);
+        newRoot = std::exchange(newNode, nullptr);
       } else {
         // Add new root as a non value internal node
         newRoot = makeNode(prefix.first, prefix.second);
       }
-      auto oldRootDirection = newRoot->searchDirection(root_.get());
+      auto oldRootDirection = newRoot->searchDirection(root_);
       CHECK(
           oldRootDirection == TreeDirection::LEFT ||
           oldRootDirection == TreeDirection::RIGHT);
       if (oldRootDirection == TreeDirection::LEFT) {
-        newRoot->resetLeft(std::move(root_));
+        newRoot->resetLeft(std::exchange(root_, nullptr));
         if (newNode) {
-          // new node was not moved to be the new root
-          newRoot->resetRight(std::move(newNode));
+          // new node was not made the new root
+          newRoot->resetRight(std::exchange(newNode, nullptr));
         }
       } else {
-        newRoot->resetRight(std::move(root_));
+        newRoot->resetRight(std::exchange(root_, nullptr));
         if (newNode) {
-          newRoot->resetLeft(std::move(newNode));
+          newRoot->resetLeft(std::exchange(newNode, nullptr));
         }
       }
-      makeRoot(std::move(newRoot));
+      makeRoot(newRoot);
     }
   } else {
     auto toAddDirection = bestMatch->searchDirection(toAdd, mask);
@@ -180,12 +263,12 @@ RadixTree<IPADDRTYPE, T, TreeTraits>::insert(
         toAddDirection == TreeDirection::RIGHT);
     if (toAddDirection == TreeDirection::LEFT) {
       if (!bestMatch->left()) {
-        bestMatch->resetLeft(std::move(newNode));
+        bestMatch->resetLeft(std::exchange(newNode, nullptr));
         done = true;
       }
     } else {
       if (!bestMatch->right()) {
-        bestMatch->resetRight(std::move(newNode));
+        bestMatch->resetRight(std::exchange(newNode, nullptr));
         done = true;
       }
     }
@@ -216,42 +299,42 @@ RadixTree<IPADDRTYPE, T, TreeTraits>::insert(
         // We need to insert a non value internal node as a parent of
         // bestMatchChild and new node.
         auto internalNode = makeNode(prefix.first, prefix.second);
-        auto internalNodeRaw = internalNode.get();
-        std::unique_ptr<TreeNode> oldBestMatchChild = nullptr;
+        TreeNode* oldBestMatchChild = nullptr;
         if (toAddDirection == TreeDirection::LEFT) {
-          oldBestMatchChild = bestMatch->resetLeft(std::move(internalNode));
+          oldBestMatchChild = bestMatch->resetLeft(internalNode);
         } else {
-          oldBestMatchChild = bestMatch->resetRight(std::move(internalNode));
+          oldBestMatchChild = bestMatch->resetRight(internalNode);
         }
-        auto newNodeDirection = internalNodeRaw->searchDirection(newNode.get());
+        auto newNodeDirection = internalNode->searchDirection(newNode);
         CHECK(
             newNodeDirection == TreeDirection::LEFT ||
             newNodeDirection == TreeDirection::RIGHT);
         if (newNodeDirection == TreeDirection::LEFT) {
-          internalNodeRaw->resetLeft(std::move(newNode));
-          internalNodeRaw->resetRight(std::move(oldBestMatchChild));
+          internalNode->resetLeft(std::exchange(newNode, nullptr));
+          internalNode->resetRight(oldBestMatchChild);
         } else {
-          internalNodeRaw->resetRight(std::move(newNode));
-          internalNodeRaw->resetLeft(std::move(oldBestMatchChild));
+          internalNode->resetRight(std::exchange(newNode, nullptr));
+          internalNode->resetLeft(oldBestMatchChild);
         }
-        CHECK(internalNode == nullptr);
       } else {
         // New node needs to be inserted  b/w bestMatch and bestMatchChild
-        std::unique_ptr<TreeNode> oldBestMatchChild = nullptr;
+        TreeNode* oldBestMatchChild = nullptr;
         if (toAddDirection == TreeDirection::LEFT) {
-          oldBestMatchChild = bestMatch->resetLeft(std::move(newNode));
+          oldBestMatchChild =
+              bestMatch->resetLeft(std::exchange(newNode, nullptr));
         } else {
-          oldBestMatchChild = bestMatch->resetRight(std::move(newNode));
+          oldBestMatchChild =
+              bestMatch->resetRight(std::exchange(newNode, nullptr));
         }
         auto bestMatchChildDirection =
-            newNodeRaw->searchDirection(oldBestMatchChild.get());
+            newNodeRaw->searchDirection(oldBestMatchChild);
         DCHECK(
             bestMatchChildDirection == TreeDirection::LEFT ||
             bestMatchChildDirection == TreeDirection::RIGHT);
         if (bestMatchChildDirection == TreeDirection::LEFT) {
-          newNodeRaw->resetLeft(std::move(oldBestMatchChild));
+          newNodeRaw->resetLeft(oldBestMatchChild);
         } else {
-          newNodeRaw->resetRight(std::move(oldBestMatchChild));
+          newNodeRaw->resetRight(oldBestMatchChild);
         }
       }
     }
@@ -272,8 +355,13 @@ RadixTree<IPADDRTYPE, T, TreeTraits>::insert(
  * as well. Why this is true is explained below for each of the
  * different cases of erase.
  */
-template <typename IPADDRTYPE, typename T, typename TreeTraits>
-bool RadixTree<IPADDRTYPE, T, TreeTraits>::erase(TreeNode* toDelete) {
+template <
+    typename IPADDRTYPE,
+    typename T,
+    typename TreeTraits,
+    typename NodeAllocator>
+bool RadixTree<IPADDRTYPE, T, TreeTraits, NodeAllocator>::erase(
+    TreeNode* toDelete) {
   if (!toDelete) {
     return false;
   }
@@ -297,7 +385,6 @@ bool RadixTree<IPADDRTYPE, T, TreeTraits>::erase(TreeNode* toDelete) {
     // toDelete has just one child, let the child's grandparent
     // adopt it since toDelete is about to got away.
     if (parent) {
-      // Note - toDelete gets freed here.
       if (parent->left() == toDelete) {
         parent->resetLeft(
             left ? toDelete->resetLeft(nullptr)
@@ -308,11 +395,12 @@ bool RadixTree<IPADDRTYPE, T, TreeTraits>::erase(TreeNode* toDelete) {
                  : toDelete->resetRight(nullptr));
       }
     } else {
-      CHECK(root_.get() == toDelete);
-      // Update root, toDelete (old root) gets deleted as a result
+      CHECK(root_ == toDelete);
+      // Update root
       makeRoot(
           left ? toDelete->resetLeft(nullptr) : toDelete->resetRight(nullptr));
     }
+    freeNode(toDelete);
     // We just made toDelete's parent the parent of toDelete's only
     // child. There are 2 possibilities with regard to toDelete's parent
     // a) The parent is a value node - In this case there is no bearing
@@ -329,6 +417,7 @@ bool RadixTree<IPADDRTYPE, T, TreeTraits>::erase(TreeNode* toDelete) {
       // Free toDelete
       parent->left() == toDelete ? parent->resetLeft(nullptr)
                                  : parent->resetRight(nullptr);
+      freeNode(toDelete);
       if (parent->isNonValueNode()) {
         // toDelete's parent is a non value node. Since we removed
         // toDelete, toDelete's parent needs to be deleted as well
@@ -343,8 +432,9 @@ bool RadixTree<IPADDRTYPE, T, TreeTraits>::erase(TreeNode* toDelete) {
         if (grandParent) {
           // Free toDelete's parent
           grandParent->left() == parent
-              ? grandParent->resetLeft(std::move(toDeleteSibling))
-              : grandParent->resetRight(std::move(toDeleteSibling));
+              ? grandParent->resetLeft(toDeleteSibling)
+              : grandParent->resetRight(toDeleteSibling);
+          freeNode(parent);
           // Here we replaced one of grandparent's children with
           // another and removed parent, toDelete nodes. There are
           // 2 possibilities with regards to grand parent
@@ -363,9 +453,10 @@ bool RadixTree<IPADDRTYPE, T, TreeTraits>::erase(TreeNode* toDelete) {
           // 2 children), each subtree of such a tree is also valid.
           // Since the tree under toDeleteSibling is one such tree,
           // our post condition is held.
-          CHECK(root_.get() == parent);
+          CHECK(root_ == parent);
           CHECK(parent->isLeaf()); // Both children should be set to null
-          makeRoot(std::move(toDeleteSibling));
+          makeRoot(toDeleteSibling);
+          freeNode(parent);
         }
       } else {
         // toDelete's parent is a value node.
@@ -377,17 +468,22 @@ bool RadixTree<IPADDRTYPE, T, TreeTraits>::erase(TreeNode* toDelete) {
     } else {
       // To be deleted node has no parent and no children.
       // Its thus the root (and only node) in the tree.
-      CHECK_EQ(root_.get(), toDelete);
+      CHECK_EQ(root_, toDelete);
       // Empty tree, post condition trivially held.
-      root_.reset(nullptr);
+      root_ = nullptr;
+      freeNode(toDelete);
     }
   }
   --size_;
   return true;
 }
 
-template <typename IPADDRTYPE, typename T, typename TreeTraits>
-bool RadixTree<IPADDRTYPE, T, TreeTraits>::radixSubTreesEqual(
+template <
+    typename IPADDRTYPE,
+    typename T,
+    typename TreeTraits,
+    typename NodeAllocator>
+bool RadixTree<IPADDRTYPE, T, TreeTraits, NodeAllocator>::radixSubTreesEqual(
     const TreeNode* nodeA,
     const TreeNode* nodeB) {
   if (nodeA && nodeB) {
@@ -401,23 +497,27 @@ bool RadixTree<IPADDRTYPE, T, TreeTraits>::radixSubTreesEqual(
   return !nodeA && !nodeB;
 }
 
-template <typename IPADDRTYPE, typename T, typename TreeTraits>
-std::unique_ptr<typename RadixTree<IPADDRTYPE, T, TreeTraits>::TreeNode>
-RadixTree<IPADDRTYPE, T, TreeTraits>::cloneSubTree(const TreeNode* node) {
+template <
+    typename IPADDRTYPE,
+    typename T,
+    typename TreeTraits,
+    typename NodeAllocator>
+typename RadixTree<IPADDRTYPE, T, TreeTraits, NodeAllocator>::TreeNode*
+RadixTree<IPADDRTYPE, T, TreeTraits, NodeAllocator>::cloneSubTree(
+    const TreeNode* node) {
   if (!node) {
     return nullptr;
   }
-  std::unique_ptr<TreeNode> copy;
+  TreeNode* copy = nullptr;
   if (node->isValueNode()) {
-    copy = std::make_unique<TreeNode>(
-        node->ipAddress(),
-        node->masklen(),
-        node->value(),
-        node->nodeDeleteCallback());
+    copy = makeNode(node->ipAddress(), node->masklen(), node->value());
   } else {
-    copy = std::make_unique<TreeNode>(
-        node->ipAddress(), node->masklen(), node->nodeDeleteCallback());
+    copy = makeNode(node->ipAddress(), node->masklen());
   }
+  // Free the partial copy if copying a value throws
+  SCOPE_FAIL {
+    freeSubTree(copy);
+  };
   copy->resetLeft(cloneSubTree(node->left()));
   copy->resetRight(cloneSubTree(node->right()));
   return copy;
@@ -5,9 +5,11 @@
 
 #include <sys/socket.h>
 #include <algorithm>
+#include <array>
 #include <exception>
 #include <functional>
 #include <memory>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
@@ -19,6 +21,7 @@
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
 #include <folly/Memory.h>
+#include <folly/ScopeGuard.h>
 #include <optional>
 
 namespace facebook::network {
@@ -28,36 +31,25 @@ namespace facebook::network {
  * ones created by the radix tree implementation, which will
  * hold no values. All non value nodes will have 2 children,
  * this invariant must be maintained at all times.
+ * Nodes are allocated and freed by the RadixTree holding them, which
+ * owns the children links below.
  */
 template <typename IPADDRTYPE, typename T>
 class RadixTreeNode {
  public:
-  // Optional function parameter to call from destructor
+  // Optional function the owning tree calls before freeing a node
   using NodeDeleteCallback =
       std::function<void(const RadixTreeNode<IPADDRTYPE, T>&)>;
 
-  RadixTreeNode(
-      const IPADDRTYPE& ipAddr,
-      uint8_t mlen,
-      NodeDeleteCallback deleteCallback)
-      : ipAddress_(ipAddr), masklen_(mlen), deleteCallback_(deleteCallback) {}
+  RadixTreeNode(const IPADDRTYPE& ipAddr, uint8_t mlen)
+      : ipAddress_(ipAddr), masklen_(mlen) {}
 
   template <typename VALUE>
-  RadixTreeNode(
-      const IPADDRTYPE& ipAddr,
-      uint8_t mlen,
-      VALUE&& val,
-      NodeDeleteCallback deleteCallback)
-      : ipAddress_(ipAddr),
-        masklen_(mlen),
-        value_(std::forward<VALUE>(val)),
-        deleteCallback_(deleteCallback) {}
-
-  ~RadixTreeNode() {
-    if (deleteCallback_) {
-      deleteCallback_(*this);
-    }
-  }
+  RadixTreeNode(const IPADDRTYPE& ipAddr, uint8_t mlen, VALUE&& val)
+      : ipAddress_(ipAddr), masklen_(mlen), value_(std::forward<VALUE>(val)) {}
+
+  RadixTreeNode(const RadixTreeNode&) = delete;
+  RadixTreeNode& operator=(const RadixTreeNode&) = delete;
 
   enum class TreeDirection { LEFT, RIGHT, PARENT, THIS_NODE };
 
@@ -74,16 +66,16 @@ class RadixTreeNode {
     return masklen_;
   }
   const RadixTreeNode* left() const {
-    return left_.get();
+    return left_;
   }
   RadixTreeNode* left() {
-    return left_.get();
+    return left_;
   }
   const RadixTreeNode* right() const {
-    return right_.get();
+    return right_;
   }
   RadixTreeNode* right() {
-    return right_.get();
+    return right_;
   }
   RadixTreeNode* parent() {
     return parent_;
@@ -100,9 +92,6 @@ class RadixTreeNode {
   T& value() {
     return value_.value();
   }
-  NodeDeleteCallback nodeDeleteCallback() const {
-    return deleteCallback_;
-  }
   std::string str(bool printValue = true) const {
     auto nodeStr = folly::to<std::string>(ipAddress_.str(), "/", masklen_);
     if (printValue) {
@@ -129,20 +118,18 @@ class RadixTreeNode {
         (!isValueNode() || this->value() == r.value());
   }
 
-  std::unique_ptr<RadixTreeNode> resetLeft(
-      std::unique_ptr<RadixTreeNode> newLeft) {
-    auto old = std::move(left_);
-    left_ = std::move(newLeft);
+  // Replace the left child, returns the detached old one
+  RadixTreeNode* resetLeft(RadixTreeNode* newLeft) {
+    auto old = std::exchange(left_, newLeft);
     if (left_) {
       left_->setParent(this);
     }
     return old;
   }
 
-  std::unique_ptr<RadixTreeNode> resetRight(
-      std::unique_ptr<RadixTreeNode> newRight) {
-    auto old = std::move(right_);
-    right_ = std::move(newRight);
+  // Replace the right child, returns the detached old one
+  RadixTreeNode* resetRight(RadixTreeNode* newRight) {
+    auto old = std::exchange(right_, newRight);
     if (right_) {
       right_->setParent(this);
     }
@@ -166,10 +153,9 @@ class RadixTreeNode {
   IPADDRTYPE ipAddress_;
   uint32_t masklen_{0}; // Number of bits to match.
   std::optional<T> value_;
-  std::unique_ptr<RadixTreeNode> left_{nullptr};
-  std::unique_ptr<RadixTreeNode> right_{nullptr};
+  RadixTreeNode* left_{nullptr};
+  RadixTreeNode* right_{nullptr};
   RadixTreeNode* parent_{nullptr};
-  NodeDeleteCallback deleteCallback_;
 };
 
 /*
@@ -367,10 +353,16 @@ struct RadixTreeTraits {
   }
 };
 
+/*
+ * NodeAllocator is rebound to allocate tree nodes, one at a time. The
+ * tree takes the allocator of the tree it is move assigned from, see
+ * RadixTreeSlabAllocator for a node pool suited to large trees.
+ */
 template <
     typename IPADDRTYPE,
     typename T,
-    typename TreeTraits = RadixTreeTraits<IPADDRTYPE, T>>
+    typename TreeTraits = RadixTreeTraits<IPADDRTYPE, T>,
+    typename NodeAllocator = std::allocator<RadixTreeNode<IPADDRTYPE, T>>>
 class RadixTree {
  public:
   using TreeNode = RadixTreeNode<IPADDRTYPE, T>;
@@ -379,23 +371,36 @@ class RadixTree {
   using Iterator = typename TreeTraits::Iterator;
   using ConstIterator = typename TreeTraits::ConstIterator;
   using VecConstIterators = typename std::vector<ConstIterator>;
+  using AllocatorTraits = typename std::allocator_traits<
+      NodeAllocator>::template rebind_traits<TreeNode>;
+  using Allocator = typename AllocatorTraits::allocator_type;
+
+  // Lookups in flight at once in batched longestMatch
+  static constexpr size_t kLookupBatchWidth = 8;
 
   explicit RadixTree(
       NodeDeleteCallback nodeDelCallback = NodeDeleteCallback(),
-      const TreeTraits& treeTraits = TreeTraits())
-      : nodeDeleteCallback_(nodeDelCallback), traits_(treeTraits) {}
+      const TreeTraits& treeTraits = TreeTraits(),
+      const NodeAllocator& allocator = NodeAllocator())
+      : nodeDeleteCallback_(nodeDelCallback),
+        traits_(treeTraits),
+        allocator_(allocator) {}
+
+  ~RadixTree() {
+    freeSubTree(root_);
+  }
 
   RadixTree(const RadixTree& r) = delete;
   RadixTree& operator=(const RadixTree& r) = delete;
 
   Iterator begin() {
-    return traits_.makeItr(root_.get());
+    return traits_.makeItr(root_);
   }
   Iterator end() {
     return traits_.makeItr(nullptr);
   }
   ConstIterator begin() const {
-    return traits_.makeCItr(root_.get());
+    return traits_.makeCItr(root_);
   }
   ConstIterator end() const {
     return traits_.makeCItr(nullptr);
@@ -403,20 +408,32 @@ class RadixTree {
 
   // Free all nodes and clear the tree.
   void clear() {
-    root_.reset(nullptr);
+    freeSubTree(std::exchange(root_, nullptr));
     size_ = 0;
   }
   RadixTree(RadixTree&& r) noexcept
-      : nodeDeleteCallback_(r.nodeDeleteCallback_), traits_(r.traits_) {
+      : nodeDeleteCallback_(r.nodeDeleteCallback_),
+        traits_(r.traits_),
+        allocator_(
+            AllocatorTraits::select_on_container_copy_construction(
+                r.allocator_)) {
     *this = std::move(r);
   }
   // Move radix tree onto this
   RadixTree& operator=(RadixTree&& r) noexcept {
     // Don't copy the traits and delete callback, use
     // ones with which this Radix tree was created
-    size_ = r.size_;
-    makeRoot(std::move(r.root_));
-    r.size_ = 0;
+    if (this == &r) {
+      return *this;
+    }
+    clear();
+    // Nodes must go back to the allocator they came from. Swap rather
+    // than share allocators, so that the two trees never allocate from
+    // the same pool afterwards.
+    using std::swap;
+    swap(allocator_, r.allocator_);
+    size_ = std::exchange(r.size_, 0);
+    makeRoot(std::exchange(r.root_, nullptr));
     return *this;
   }
   // Clone this radix tree onto another
@@ -426,9 +443,12 @@ class RadixTree {
     static_assert(
         std::is_same<T, U>::value,
         "clone template type must be the same as Radix tree value type");
-    RadixTree copy(nodeDeleteCallback_, traits_);
+    RadixTree copy(
+        nodeDeleteCallback_,
+        traits_,
+        AllocatorTraits::select_on_container_copy_construction(allocator_));
+    copy.makeRoot(copy.cloneSubTree(root_));
     copy.size_ = size_;
-    copy.root_ = cloneSubTree(root_.get());
     return copy;
   }
   /*
@@ -472,6 +492,33 @@ class RadixTree {
         const_cast<const RadixTree*>(this)->longestMatch(ipaddr, mask));
   }
 
+  /*
+   * Batched longest match of full length addresses (masklen == bitCount),
+   * matches[i] being set to the longest match of addrs[i]. The lookups are
+   * walked down the tree in lockstep, kLookupBatchWidth at a time, and the
+   * next node of each is prefetched while the others take their step, so
+   * cache misses of different lookups overlap rather than add up.
+   * matches must be as long as addrs.
+   */
+  void longestMatch(
+      std::span<const IPADDRTYPE> addrs,
+      std::span<ConstIterator> matches) const {
+    CHECK_EQ(addrs.size(), matches.size());
+    longestMatchBatchImpl(addrs, [&](size_t index, const TreeNode* node) {
+      matches[index] = traits_.makeCItr(node);
+    });
+  }
+
+  // Non const batched longest match
+  void longestMatch(
+      std::span<const IPADDRTYPE> addrs,
+      std::span<Iterator> matches) {
+    CHECK_EQ(addrs.size(), matches.size());
+    longestMatchBatchImpl(addrs, [&](size_t index, const TreeNode* node) {
+      matches[index] = traits_.makeItr(const_cast<TreeNode*>(node));
+    });
+  }
+
   /*
    * Given a IP, mask return node whose IP, mask which matches this prefix
    * exactly
@@ -575,10 +622,10 @@ class RadixTree {
     return size_;
   }
   const TreeNode* root() const {
-    return root_.get();
+    return root_;
   }
   TreeNode* root() {
-    return root_.get();
+    return root_;
   }
   NodeDeleteCallback nodeDeleteCallback() const {
     return nodeDeleteCallback_;
@@ -586,9 +633,13 @@ class RadixTree {
   const TreeTraits& traits() const {
     return traits_;
   }
+  const Allocator& allocator() const {
+    return allocator_;
+  }
 
  private:
-  static std::unique_ptr<TreeNode> cloneSubTree(const TreeNode* node);
+  // Copy of the subtree under node, allocated from this tree
+  TreeNode* cloneSubTree(const TreeNode* node);
   // Worker function to do the actual longest match lookup.
   const TreeNode* longestMatchImpl(
       const IPADDRTYPE& ipaddr,
@@ -609,23 +660,52 @@ class RadixTree {
             ipaddr, masklen, foundExact, includeNonValueNodes, trail));
   }
 
-  std::unique_ptr<TreeNode> makeNode(const IPADDRTYPE& ip, uint8_t masklen) {
-    return std::make_unique<TreeNode>(ip, masklen, nodeDeleteCallback_);
+  // Worker function of batched longest match, calling
+  // onMatch(index, node) with the match of each addrs[index]
+  template <typename OnMatch>
+  void longestMatchBatchImpl(
+      std::span<const IPADDRTYPE> addrs,
+      const OnMatch& onMatch) const;
+
+  template <typename... Args>
+  TreeNode* makeNode(Args&&... args) {
+    auto node = AllocatorTraits::allocate(allocator_, 1);
+    try {
+      AllocatorTraits::construct(allocator_, node, std::forward<Args>(args)...);
+    } catch (...) {
+      AllocatorTraits::deallocate(allocator_, node, 1);
+      throw;
+    }
+    return node;
   }
 
-  template <typename VALUE>
-  std::unique_ptr<TreeNode>
-  makeNode(const IPADDRTYPE& ip, uint8_t masklen, VALUE&& value) {
-    return std::make_unique<TreeNode>(
-        ip, masklen, std::forward<VALUE>(value), nodeDeleteCallback_);
+  // Free a node, detached from the tree or not, but not its children
+  void freeNode(TreeNode* node) {
+    if (nodeDeleteCallback_) {
+      nodeDeleteCallback_(*node);
+    }
+    AllocatorTraits::destroy(allocator_, node);
+    AllocatorTraits::deallocate(allocator_, node, 1);
+  }
+
+  void freeSubTree(TreeNode* node) {
+    if (!node) {
+      return;
+    }
+    auto left = node->left();
+    auto right = node->right();
+    freeNode(node);
+    freeSubTree(left);
+    freeSubTree(right);
   }
 
-  void makeRoot(std::unique_ptr<TreeNode> newRoot) {
+  // Callers free the old root unless they re-parented it
+  void makeRoot(TreeNode* newRoot) {
     CHECK(root_ != newRoot || root_ == nullptr);
     if (newRoot) {
       newRoot->setParent(nullptr);
     }
-    root_ = std::move(newRoot);
+    root_ = newRoot;
   }
 
   inline void trailAppend(
@@ -633,10 +713,11 @@ class RadixTree {
       bool includeNonValueNodes,
       const TreeNode* node) const;
 
-  std::unique_ptr<TreeNode> root_{nullptr};
+  TreeNode* root_{nullptr};
   size_t size_{0};
   NodeDeleteCallback nodeDeleteCallback_;
   TreeTraits traits_;
+  Allocator allocator_;
 };
 
 // RadixTreeIteratorImpl for IPAddress
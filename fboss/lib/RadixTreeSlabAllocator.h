@@ -0,0 +1,258 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <glog/logging.h>
+
+namespace facebook::network {
+
+/*
+ * Allocator carving RadixTree nodes out of slabs of nodesPerSlab nodes.
+ *
+ * A tree of a million routes then takes a few thousand allocations rather
+ * than two million (value and internal nodes), its nodes sit next to each
+ * other in memory and freed nodes are reused by later inserts through the
+ * free lists of their slabs. Slabs go back to the heap as they empty, but
+ * for one kept to absorb churn, which goes too once the pool is empty.
+ * Allocations fill the slabs that most recently got free slots first.
+ *
+ * Copies and rebinds of an allocator share its pool, while the copy made
+ * for a cloned tree gets a pool of its own. As RadixTree itself, a pool
+ * is not thread safe.
+ *
+ * Usage:
+ *   using Alloc = RadixTreeSlabAllocator<RadixTreeNode<IPAddressV4, int>>;
+ *   RadixTree<IPAddressV4, int, RadixTreeTraits<IPAddressV4, int>, Alloc>
+ *       tree;
+ */
+template <typename T>
+class RadixTreeSlabAllocator {
+ public:
+  using value_type = T;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+  using is_always_equal = std::false_type;
+
+  static constexpr size_t kDefaultNodesPerSlab = 1024;
+
+  explicit RadixTreeSlabAllocator(size_t nodesPerSlab = kDefaultNodesPerSlab)
+      : pool_(std::make_shared<Pool>(nodesPerSlab)) {}
+
+  template <typename U>
+  /* implicit */ RadixTreeSlabAllocator(const RadixTreeSlabAllocator<U>& other)
+      : pool_(other.pool_) {}
+
+  RadixTreeSlabAllocator select_on_container_copy_construction() const {
+    return RadixTreeSlabAllocator(pool_->nodesPerSlab());
+  }
+
+  T* allocate(size_t n) {
+    if (n != 1) {
+      return std::allocator<T>().allocate(n);
+    }
+    return static_cast<T*>(pool_->allocate(sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* p, size_t n) {
+    if (n != 1) {
+      std::allocator<T>().deallocate(p, n);
+      return;
+    }
+    pool_->deallocate(p);
+  }
+
+  // Bytes held by the pool's slabs, in use or not
+  size_t bytesReserved() const {
+    return pool_->bytesReserved();
+  }
+
+  // Nodes currently allocated from the pool
+  size_t allocatedNodes() const {
+    return pool_->allocatedNodes();
+  }
+
+  template <typename U>
+  bool operator==(const RadixTreeSlabAllocator<U>& other) const {
+    return pool_ == other.pool_;
+  }
+  template <typename U>
+  bool operator!=(const RadixTreeSlabAllocator<U>& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  template <typename U>
+  friend class RadixTreeSlabAllocator;
+
+  class Pool {
+   public:
+    explicit Pool(size_t nodesPerSlab) : nodesPerSlab_(nodesPerSlab) {
+      CHECK_GT(nodesPerSlab_, 0);
+    }
+    ~Pool() {
+      // Nodes still allocated outlive their tree, keep their slabs
+      if (!allocated_ && spare_) {
+        freeSlab(spare_);
+      }
+    }
+
+    void* allocate(size_t size, size_t align) {
+      CHECK_LE(align, alignof(std::max_align_t));
+      // Slots are sized by the first allocation, i.e. the tree's node type
+      if (!slotSize_) {
+        align = std::max(align, alignof(FreeSlot));
+        slotSize_ = (std::max(size, sizeof(FreeSlot)) + align - 1) / align *
+            align;
+        slabBytes_ = std::bit_ceil(kSlotsOffset + nodesPerSlab_ * slotSize_);
+        slotsPerSlab_ = (slabBytes_ - kSlotsOffset) / slotSize_;
+      }
+      CHECK_LE(size, slotSize_);
+      auto slab = available_ ? available_ : newSlab();
+      void* p;
+      if (slab->freeList) {
+        p = std::exchange(slab->freeList, slab->freeList->next);
+      } else {
+        p = slab->slot(slab->carved++, slotSize_);
+      }
+      if (++slab->used == slotsPerSlab_) {
+        unlink(slab);
+      }
+      ++allocated_;
+      return p;
+    }
+
+    void deallocate(void* p) {
+      CHECK_GT(allocated_, 0);
+      --allocated_;
+      auto slab = slabOf(p);
+      slab->freeList = new (p) FreeSlot{slab->freeList};
+      if (slab->used-- == slotsPerSlab_) {
+        link(slab);
+      }
+      if (!slab->used) {
+        releaseSlab(slab);
+      }
+    }
+
+    size_t nodesPerSlab() const {
+      return nodesPerSlab_;
+    }
+    size_t bytesReserved() const {
+      return numSlabs_ * slabBytes_;
+    }
+    size_t allocatedNodes() const {
+      return allocated_;
+    }
+
+   private:
+    struct FreeSlot {
+      FreeSlot* next;
+    };
+
+    // Header at the start of each slab, followed by its slots. Slabs are
+    // aligned to their size, so a slot finds its slab by masking its address
+    struct Slab {
+      std::byte* slot(size_t index, size_t slotSize) {
+        return reinterpret_cast<std::byte*>(this) + kSlotsOffset +
+            index * slotSize;
+      }
+
+      // Neighbors in the list of slabs with free slots
+      Slab* prev{nullptr};
+      Slab* next{nullptr};
+      FreeSlot* freeList{nullptr};
+      // Slots in use, and slots handed out at least once
+      size_t used{0};
+      size_t carved{0};
+    };
+    static constexpr size_t kSlotsOffset =
+        (sizeof(Slab) + alignof(std::max_align_t) - 1) /
+        alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    Slab* slabOf(void* p) const {
+      return reinterpret_cast<Slab*>(
+          reinterpret_cast<uintptr_t>(p) & ~(slabBytes_ - 1));
+    }
+
+    Slab* newSlab() {
+      Slab* slab;
+      if (spare_) {
+        slab = std::exchange(spare_, nullptr);
+      } else {
+        // Slots are left uninitialized, they get constructed as used
+        slab = new (::operator new(slabBytes_, std::align_val_t(slabBytes_)))
+            Slab();
+        ++numSlabs_;
+      }
+      link(slab);
+      return slab;
+    }
+
+    void releaseSlab(Slab* slab) {
+      unlink(slab);
+      // One empty slab is kept, so that a tree growing and shrinking
+      // around a slab boundary doesn't allocate a slab per insert. All of
+      // them go once nothing is left in use, e.g. when the tree is cleared.
+      if (spare_ || !allocated_) {
+        freeSlab(slab);
+      } else {
+        *slab = Slab();
+        spare_ = slab;
+      }
+      if (!allocated_ && spare_) {
+        freeSlab(std::exchange(spare_, nullptr));
+      }
+    }
+
+    void freeSlab(Slab* slab) {
+      slab->~Slab();
+      ::operator delete(slab, slabBytes_, std::align_val_t(slabBytes_));
+      --numSlabs_;
+    }
+
+    // Slabs with free slots form a list, allocations come from its head
+    void link(Slab* slab) {
+      slab->prev = nullptr;
+      slab->next = available_;
+      if (available_) {
+        available_->prev = slab;
+      }
+      available_ = slab;
+    }
+
+    void unlink(Slab* slab) {
+      if (slab->prev) {
+        slab->prev->next = slab->next;
+      } else {
+        available_ = slab->next;
+      }
+      if (slab->next) {
+        slab->next->prev = slab->prev;
+      }
+      slab->prev = slab->next = nullptr;
+    }
+
+    const size_t nodesPerSlab_;
+    size_t slotSize_{0};
+    size_t slabBytes_{0};
+    size_t slotsPerSlab_{0};
+    size_t allocated_{0};
+    size_t numSlabs_{0};
+    Slab* available_{nullptr};
+    Slab* spare_{nullptr};
+  };
+
+  std::shared_ptr<Pool> pool_;
+};
+
+} // namespace facebook::network
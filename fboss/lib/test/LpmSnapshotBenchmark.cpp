@@ -0,0 +1,148 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <folly/Benchmark.h>
+#include <folly/IPAddressV4.h>
+#include <folly/IPAddressV6.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+#include <folly/memory/Malloc.h>
+#include <iostream>
+#include <vector>
+#include "fboss/lib/LpmSnapshot.h"
+#include "fboss/lib/RadixTree.h"
+
+using namespace std;
+using namespace folly;
+using namespace facebook::network;
+
+DEFINE_int32(
+    v4_route_count,
+    1000000,
+    "The number of v4 prefixes in the table, full DFZ size by default");
+DEFINE_int32(
+    v6_route_count,
+    200000,
+    "The number of v6 prefixes in the table, full DFZ size by default");
+DEFINE_int32(
+    lookup_count,
+    100000,
+    "The number of addresses to look up on each lookup iteration");
+
+namespace {
+RadixTree<IPAddressV4, int> tree4;
+RadixTree<IPAddressV6, int> tree6;
+unique_ptr<LpmSnapshot<IPAddressV4, int>> snapshot4;
+unique_ptr<LpmSnapshot<IPAddressV6, int>> snapshot6;
+vector<IPAddressV4> lookups4;
+vector<IPAddressV6> lookups6;
+
+// Prefix lengths roughly following the distribution of internet tables,
+// most v4 routes being /24s and most v6 ones /48s
+uint8_t randomMasklen(const vector<pair<uint8_t, uint32_t>>& weights) {
+  uint32_t total = 0;
+  for (const auto& [masklen, weight] : weights) {
+    total += weight;
+  }
+  auto pick = folly::Random::rand32(total);
+  for (const auto& [masklen, weight] : weights) {
+    if (pick < weight) {
+      return masklen;
+    }
+    pick -= weight;
+  }
+  return weights.back().first;
+}
+
+IPAddressV6 randomV6() {
+  ByteArray16 ba;
+  *(uint64_t*)(ba.data()) = folly::Random::rand64();
+  *(uint64_t*)(&ba[8]) = folly::Random::rand64();
+  // Global unicast space only, as in real tables
+  ba[0] = 0x20 | (ba[0] & 0x0f);
+  return IPAddressV6(ba);
+}
+
+// Addresses of the table's own prefixes, so lookups hit routes the way
+// forwarded traffic does
+template <typename TREE, typename ADDR>
+void pickLookups(const TREE& tree, vector<ADDR>& lookups) {
+  vector<ADDR> prefixes;
+  for (const auto& node : tree) {
+    prefixes.push_back(node.ipAddress());
+  }
+  while (lookups.size() < FLAGS_lookup_count) {
+    lookups.push_back(prefixes[folly::Random::rand32(prefixes.size())]);
+  }
+}
+
+template <typename ADDR>
+size_t radixTreeMemory(const RadixTree<ADDR, int>& tree) {
+  // Value nodes plus at most as many non value nodes joining them
+  return 2 * tree.size() * goodMallocSize(sizeof(RadixTreeNode<ADDR, int>));
+}
+
+BENCHMARK(RadixTreeLongestMatch4) {
+  for (const auto& addr : lookups4) {
+    doNotOptimizeAway(tree4.longestMatch(addr, addr.bitCount()));
+  }
+}
+
+BENCHMARK_RELATIVE(LpmSnapshotLongestMatch4) {
+  for (const auto& addr : lookups4) {
+    doNotOptimizeAway(snapshot4->longestMatch(addr));
+  }
+}
+
+BENCHMARK(RadixTreeLongestMatch6) {
+  for (const auto& addr : lookups6) {
+    doNotOptimizeAway(tree6.longestMatch(addr, addr.bitCount()));
+  }
+}
+
+BENCHMARK_RELATIVE(LpmSnapshotLongestMatch6) {
+  for (const auto& addr : lookups6) {
+    doNotOptimizeAway(snapshot6->longestMatch(addr));
+  }
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(LpmSnapshotBuild4) {
+  LpmSnapshot<IPAddressV4, int> snapshot(tree4);
+  doNotOptimizeAway(snapshot.size());
+}
+
+BENCHMARK(LpmSnapshotBuild6) {
+  LpmSnapshot<IPAddressV6, int> snapshot(tree6);
+  doNotOptimizeAway(snapshot.size());
+}
+} // namespace
+
+int main(int argc, char* argv[]) {
+  folly::Init init(&argc, &argv);
+  const vector<pair<uint8_t, uint32_t>> weights4 = {
+      {8, 1}, {16, 20}, {20, 60}, {22, 120}, {23, 100}, {24, 600}, {32, 5}};
+  while (tree4.size() < FLAGS_v4_route_count) {
+    auto masklen = randomMasklen(weights4);
+    auto ip = IPAddressV4::fromLongHBO(folly::Random::rand32()).mask(masklen);
+    tree4.insert(ip, masklen, tree4.size());
+  }
+  const vector<pair<uint8_t, uint32_t>> weights6 = {
+      {29, 20}, {32, 150}, {40, 60}, {44, 80}, {48, 600}, {64, 40}, {128, 5}};
+  while (tree6.size() < FLAGS_v6_route_count) {
+    auto masklen = randomMasklen(weights6);
+    tree6.insert(randomV6().mask(masklen), masklen, tree6.size());
+  }
+  snapshot4 = make_unique<LpmSnapshot<IPAddressV4, int>>(tree4);
+  snapshot6 = make_unique<LpmSnapshot<IPAddressV6, int>>(tree6);
+  pickLookups(tree4, lookups4);
+  pickLookups(tree6, lookups6);
+
+  cout << "v4 routes: " << tree4.size()
+       << " radix tree bytes: " << radixTreeMemory(tree4)
+       << " snapshot bytes: " << snapshot4->memoryUsage() << endl;
+  cout << "v6 routes: " << tree6.size()
+       << " radix tree bytes: " << radixTreeMemory(tree6)
+       << " snapshot bytes: " << snapshot6->memoryUsage() << endl;
+  runBenchmarks();
+}
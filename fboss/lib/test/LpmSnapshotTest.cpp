@@ -0,0 +1,171 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <gtest/gtest.h>
+
+#include <folly/IPAddressV4.h>
+#include <folly/IPAddressV6.h>
+#include <folly/Random.h>
+
+#include "fboss/lib/LpmSnapshot.h"
+#include "fboss/lib/RadixTree.h"
+
+using namespace facebook::network;
+
+namespace {
+using IPAddressV4 = folly::IPAddressV4;
+using IPAddressV6 = folly::IPAddressV6;
+
+IPAddressV4 randomV4() {
+  return IPAddressV4::fromLongHBO(folly::Random::rand32());
+}
+
+IPAddressV6 randomV6() {
+  folly::ByteArray16 bytes;
+  for (auto& byte : bytes) {
+    byte = folly::Random::rand32(256);
+  }
+  return IPAddressV6(bytes);
+}
+
+// Random prefixes, clustered under a few short prefixes so that lookups
+// go several levels deep
+template <typename IPAddrType, typename RandomFn>
+RadixTree<IPAddrType, int> randomTree(
+    size_t count,
+    uint8_t clusterLen,
+    RandomFn randomAddr) {
+  auto bitCount = IPAddrType::bitCount();
+  std::vector<IPAddrType> clusters;
+  for (int i = 0; i < 4; ++i) {
+    clusters.push_back(randomAddr().mask(clusterLen));
+  }
+  RadixTree<IPAddrType, int> tree;
+  for (int i = 0; tree.size() < count; ++i) {
+    auto addr = randomAddr();
+    if (folly::Random::oneIn(2)) {
+      auto cluster = clusters[folly::Random::rand32(clusters.size())];
+      auto bytes = addr.toByteArray();
+      auto clusterBytes = cluster.toByteArray();
+      for (int byte = 0; byte < clusterLen / 8; ++byte) {
+        bytes[byte] = clusterBytes[byte];
+      }
+      addr = IPAddrType(bytes);
+    }
+    uint8_t masklen = folly::Random::rand32(bitCount + 1);
+    tree.insert(addr.mask(masklen), masklen, i);
+  }
+  return tree;
+}
+
+template <typename IPAddrType>
+void verifyLookup(
+    const RadixTree<IPAddrType, int>& tree,
+    const LpmSnapshot<IPAddrType, int>& snapshot,
+    const IPAddrType& addr) {
+  auto expected = tree.longestMatch(addr, addr.bitCount());
+  auto actual = snapshot.longestMatch(addr);
+  if (expected == tree.end()) {
+    EXPECT_EQ(nullptr, actual) << addr;
+  } else {
+    ASSERT_NE(nullptr, actual) << addr;
+    EXPECT_EQ(expected->value(), *actual) << addr;
+  }
+}
+
+template <typename IPAddrType, typename RandomFn>
+void verifySnapshot(
+    const RadixTree<IPAddrType, int>& tree,
+    RandomFn randomAddr) {
+  LpmSnapshot<IPAddrType, int> snapshot(tree);
+  EXPECT_EQ(tree.size(), snapshot.size());
+  for (const auto& node : tree) {
+    // Prefix itself, its last address and a neighbour of it
+    auto addr = node.ipAddress();
+    verifyLookup(tree, snapshot, addr);
+    auto bytes = addr.toByteArray();
+    for (auto bit = node.masklen(); bit < addr.bitCount(); ++bit) {
+      bytes[bit / 8] |= 0x80 >> (bit % 8);
+    }
+    verifyLookup(tree, snapshot, IPAddrType(bytes));
+    if (node.masklen() > 0) {
+      auto bit = folly::Random::rand32(node.masklen());
+      bytes[bit / 8] ^= 0x80 >> (bit % 8);
+      verifyLookup(tree, snapshot, IPAddrType(bytes));
+    }
+  }
+  for (int i = 0; i < 10000; ++i) {
+    verifyLookup(tree, snapshot, randomAddr());
+  }
+}
+} // namespace
+
+TEST(LpmSnapshot, emptyTree) {
+  RadixTree<IPAddressV4, int> tree;
+  LpmSnapshot<IPAddressV4, int> snapshot(tree);
+  EXPECT_EQ(0, snapshot.size());
+  EXPECT_EQ(nullptr, snapshot.longestMatch(IPAddressV4("10.0.0.1")));
+}
+
+TEST(LpmSnapshot, nestedPrefixes) {
+  RadixTree<IPAddressV4, int> tree;
+  tree.insert(IPAddressV4("0.0.0.0"), 0, 0);
+  tree.insert(IPAddressV4("10.0.0.0"), 8, 8);
+  tree.insert(IPAddressV4("10.1.0.0"), 16, 16);
+  tree.insert(IPAddressV4("10.1.1.0"), 24, 24);
+  tree.insert(IPAddressV4("10.1.1.1"), 32, 32);
+  tree.insert(IPAddressV4("10.1.1.128"), 25, 25);
+  LpmSnapshot<IPAddressV4, int> snapshot(tree);
+  EXPECT_EQ(0, *snapshot.longestMatch(IPAddressV4("11.0.0.1")));
+  EXPECT_EQ(8, *snapshot.longestMatch(IPAddressV4("10.2.0.1")));
+  EXPECT_EQ(16, *snapshot.longestMatch(IPAddressV4("10.1.2.1")));
+  EXPECT_EQ(24, *snapshot.longestMatch(IPAddressV4("10.1.1.2")));
+  EXPECT_EQ(32, *snapshot.longestMatch(IPAddressV4("10.1.1.1")));
+  EXPECT_EQ(25, *snapshot.longestMatch(IPAddressV4("10.1.1.255")));
+}
+
+TEST(LpmSnapshot, randomV4) {
+  verifySnapshot(randomTree<IPAddressV4>(20000, 8, randomV4), randomV4);
+}
+
+TEST(LpmSnapshot, randomV6) {
+  verifySnapshot(randomTree<IPAddressV6>(20000, 32, randomV6), randomV6);
+}
+
+TEST(LpmSnapshot, hostRoutes) {
+  RadixTree<IPAddressV6, int> tree;
+  tree.insert(IPAddressV6("::"), 0, 0);
+  tree.insert(IPAddressV6("2401:db00::1"), 128, 128);
+  tree.insert(IPAddressV6("2401:db00::"), 127, 127);
+  tree.insert(IPAddressV6("2401:db00::"), 64, 64);
+  LpmSnapshot<IPAddressV6, int> snapshot(tree);
+  EXPECT_EQ(128, *snapshot.longestMatch(IPAddressV6("2401:db00::1")));
+  EXPECT_EQ(127, *snapshot.longestMatch(IPAddressV6("2401:db00::")));
+  EXPECT_EQ(64, *snapshot.longestMatch(IPAddressV6("2401:db00::2")));
+  EXPECT_EQ(0, *snapshot.longestMatch(IPAddressV6("2401:db01::1")));
+}
+
+TEST(LpmSnapshotCache, rebuildAndInvalidate) {
+  RadixTree<IPAddressV4, int> tree;
+  tree.insert(IPAddressV4("10.0.0.0"), 8, 8);
+  LpmSnapshotCache<IPAddressV4, int> cache;
+  // Lookups are served by the tree until the snapshot gets built
+  EXPECT_EQ(nullptr, cache.snapshot());
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(8, *cache.longestMatch(tree, IPAddressV4("10.0.0.1")));
+  }
+  EXPECT_NE(nullptr, cache.snapshot());
+
+  tree.insert(IPAddressV4("10.0.0.0"), 24, 24);
+  cache.invalidate();
+  EXPECT_EQ(nullptr, cache.snapshot());
+  EXPECT_EQ(24, *cache.longestMatch(tree, IPAddressV4("10.0.0.1")));
+  EXPECT_EQ(nullptr, cache.longestMatch(tree, IPAddressV4("11.0.0.1")));
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(24, *cache.longestMatch(tree, IPAddressV4("10.0.0.1")));
+  }
+  EXPECT_NE(nullptr, cache.snapshot());
+
+  // Copies must not share a snapshot built for another tree
+  auto copy = cache;
+  EXPECT_EQ(nullptr, copy.snapshot());
+}
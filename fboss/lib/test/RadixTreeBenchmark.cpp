@@ -3,11 +3,16 @@
 #include <folly/Benchmark.h>
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
+#include <folly/memory/Malloc.h>
+#include <iostream>
 #include <set>
+#include <span>
+#include <utility>
 #include <vector>
 #include "common/base/Random.h"
 #include "common/init/Init.h"
 #include "fboss/lib/RadixTree.h"
+#include "fboss/lib/RadixTreeSlabAllocator.h"
 #include "fboss/lib/test/PyRadixWrapper.h"
 
 using namespace std;
@@ -38,6 +43,13 @@ set<Prefix6> exactMatchSet6;
 set<Prefix6> longestMatchSet6;
 vector<int> valueSet;
 
+template <typename IPADDRTYPE>
+using SlabRadixTree = RadixTree<
+    IPADDRTYPE,
+    int,
+    RadixTreeTraits<IPADDRTYPE, int>,
+    RadixTreeSlabAllocator<RadixTreeNode<IPADDRTYPE, int>>>;
+
 // V4 Benchmarks
 template <typename TREE>
 void setupTree4(TREE& tree) {
@@ -57,6 +69,11 @@ BENCHMARK_RELATIVE(RadixTreeInsert4) {
   setupTree4(rtree);
 }
 
+BENCHMARK_RELATIVE(SlabRadixTreeInsert4) {
+  SlabRadixTree<IPAddressV4> rtree;
+  setupTree4(rtree);
+}
+
 BENCHMARK(PyRadixErase4) {
   PyRadixWrapper<IPAddressV4, int> pyrtree;
   BENCHMARK_SUSPEND {
@@ -77,6 +94,40 @@ BENCHMARK_RELATIVE(RadixTreeErase4) {
   }
 }
 
+BENCHMARK_RELATIVE(SlabRadixTreeErase4) {
+  SlabRadixTree<IPAddressV4> rtree;
+  BENCHMARK_SUSPEND {
+    setupTree4(rtree);
+  }
+  for (auto pfx : eraseSet4) {
+    rtree.erase(pfx.ip, pfx.mask);
+  }
+}
+
+BENCHMARK(RadixTreeClone4) {
+  RadixTree<IPAddressV4, int> rtree;
+  BENCHMARK_SUSPEND {
+    setupTree4(rtree);
+  }
+  auto copy = rtree.clone();
+  BENCHMARK_SUSPEND {
+    copy.clear();
+    rtree.clear();
+  }
+}
+
+BENCHMARK_RELATIVE(SlabRadixTreeClone4) {
+  SlabRadixTree<IPAddressV4> rtree;
+  BENCHMARK_SUSPEND {
+    setupTree4(rtree);
+  }
+  auto copy = rtree.clone();
+  BENCHMARK_SUSPEND {
+    copy.clear();
+    rtree.clear();
+  }
+}
+
 BENCHMARK(PyRadixExactMatch4) {
   PyRadixWrapper<IPAddressV4, int> pyrtree;
   BENCHMARK_SUSPEND {
@@ -117,6 +168,22 @@ BENCHMARK_RELATIVE(RadixTreeLongestMatch4) {
   }
 }
 
+// Host lookups of the same addresses, batched
+BENCHMARK_RELATIVE(RadixTreeBatchedLongestMatch4) {
+  RadixTree<IPAddressV4, int> rtree;
+  vector<IPAddressV4> addrs;
+  vector<RadixTree<IPAddressV4, int>::ConstIterator> matches;
+  BENCHMARK_SUSPEND {
+    setupTree4(rtree);
+    for (auto pfx : longestMatchSet4) {
+      addrs.push_back(pfx.ip);
+    }
+    matches.resize(addrs.size());
+  }
+  std::as_const(rtree).longestMatch(
+      span<const IPAddressV4>(addrs), span(matches));
+}
+
 // V6 benchmarks
 
 template <typename TREE>
@@ -137,6 +204,11 @@ BENCHMARK_RELATIVE(RadixTreeInsert6) {
   setupTree6(rtree);
 }
 
+BENCHMARK_RELATIVE(SlabRadixTreeInsert6) {
+  SlabRadixTree<IPAddressV6> rtree;
+  setupTree6(rtree);
+}
+
 BENCHMARK(PyRadixErase6) {
   PyRadixWrapper<IPAddressV6, int> pyrtree;
   BENCHMARK_SUSPEND {
@@ -157,6 +229,40 @@ BENCHMARK_RELATIVE(RadixTreeErase6) {
   }
 }
 
+BENCHMARK_RELATIVE(SlabRadixTreeErase6) {
+  SlabRadixTree<IPAddressV6> rtree;
+  BENCHMARK_SUSPEND {
+    setupTree6(rtree);
+  }
+  for (auto pfx : eraseSet6) {
+    rtree.erase(pfx.ip, pfx.mask);
+  }
+}
+
+BENCHMARK(RadixTreeClone6) {
+  RadixTree<IPAddressV6, int> rtree;
+  BENCHMARK_SUSPEND {
+    setupTree6(rtree);
+  }
+  auto copy = rtree.clone();
+  BENCHMARK_SUSPEND {
+    copy.clear();
+    rtree.clear();
+  }
+}
+
+BENCHMARK_RELATIVE(SlabRadixTreeClone6) {
+  SlabRadixTree<IPAddressV6> rtree;
+  BENCHMARK_SUSPEND {
+    setupTree6(rtree);
+  }
+  auto copy = rtree.clone();
+  BENCHMARK_SUSPEND {
+    copy.clear();
+    rtree.clear();
+  }
+}
+
 BENCHMARK(PyRadixExactMatch6) {
   PyRadixWrapper<IPAddressV6, int> pyrtree;
   BENCHMARK_SUSPEND {
@@ -197,6 +303,34 @@ BENCHMARK_RELATIVE(RadixTreeLongestMatch6) {
   }
 }
 
+// Host lookups of the same addresses, batched
+BENCHMARK_RELATIVE(RadixTreeBatchedLongestMatch6) {
+  RadixTree<IPAddressV6, int> rtree;
+  vector<IPAddressV6> addrs;
+  vector<RadixTree<IPAddressV6, int>::ConstIterator> matches;
+  BENCHMARK_SUSPEND {
+    setupTree6(rtree);
+    for (auto pfx : longestMatchSet6) {
+      addrs.push_back(pfx.ip);
+    }
+    matches.resize(addrs.size());
+  }
+  std::as_const(rtree).longestMatch(
+      span<const IPAddressV6>(addrs), span(matches));
+}
+
+// Bytes taken by the nodes of a tree of insert_count prefixes
+template <typename IPADDRTYPE, typename SETUPFN>
+void printMemoryUsage(const char* name, SETUPFN setupTree) {
+  SlabRadixTree<IPADDRTYPE> rtree;
+  setupTree(rtree);
+  auto nodes = rtree.allocator().allocatedNodes();
+  auto heapBytes =
+      nodes * goodMallocSize(sizeof(RadixTreeNode<IPADDRTYPE, int>));
+  cout << name << ": " << nodes << " nodes, heap allocated " << heapBytes
+       << " bytes, slab allocated " << rtree.allocator().bytesReserved()
+       << " bytes" << endl;
+}
 } // namespace
 
 int main(int /*argc*/, char* /*argv*/[]) {
@@ -252,5 +386,9 @@ int main(int /*argc*/, char* /*argv*/[]) {
     auto newIp = pfx.ip.mask(newMask);
     longestMatchSet6.insert(Prefix6(newIp, newMask));
   }
+  printMemoryUsage<IPAddressV4>(
+      "V4", [](auto& rtree) { setupTree4(rtree); });
+  printMemoryUsage<IPAddressV6>(
+      "V6", [](auto& rtree) { setupTree6(rtree); });
   runBenchmarks();
 }
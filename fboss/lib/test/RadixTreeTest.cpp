@@ -2,12 +2,15 @@
 
 #include <gtest/gtest.h>
 #include <memory>
+#include <span>
+#include <utility>
 
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
 #include "common/base/Random.h"
 
 #include "fboss/lib/RadixTree.h"
+#include "fboss/lib/RadixTreeSlabAllocator.h"
 #include "fboss/lib/test/PyRadixWrapper.h"
 
 using namespace facebook;
@@ -1380,6 +1383,146 @@ TEST(RadixTree, Clone) {
   EXPECT_TRUE(v6Tree == v6TreeCopy);
   EXPECT_TRUE(ipTree == ipTreeCopy);
 }
+
+TEST(RadixTree, SlabAllocator) {
+  using TreeNode = RadixTreeNode<IPAddressV4, int>;
+  using SlabTree = RadixTree<
+      IPAddressV4,
+      int,
+      RadixTreeTraits<IPAddressV4, int>,
+      RadixTreeSlabAllocator<TreeNode>>;
+  auto deleteCount = 0;
+  auto deleteCallback = [&](const TreeNode& /*node*/) { ++deleteCount; };
+  RadixTree<IPAddressV4, int> rtree;
+  SlabTree slabTree(
+      deleteCallback,
+      RadixTreeTraits<IPAddressV4, int>(),
+      RadixTreeSlabAllocator<TreeNode>(16 /* nodes per slab */));
+  vector<Prefix4> inserted;
+  // Enough prefixes to span several slabs
+  while (inserted.size() < 1000) {
+    auto mask = folly::Random::rand32(33);
+    auto ip = IPAddressV4::fromLongHBO(folly::Random::rand32()).mask(mask);
+    int value = inserted.size();
+    if (rtree.insert(ip, mask, value).second) {
+      EXPECT_TRUE(slabTree.insert(ip, mask, value).second);
+      inserted.emplace_back(ip, mask);
+    }
+  }
+  EXPECT_TRUE(
+      RadixTree<IPAddressV4, int>::radixSubTreesEqual(
+          rtree.root(), slabTree.root()));
+  for (auto i = 0; i < inserted.size(); i += 2) {
+    EXPECT_TRUE(rtree.erase(inserted[i].ip, inserted[i].mask));
+    EXPECT_TRUE(slabTree.erase(inserted[i].ip, inserted[i].mask));
+  }
+  EXPECT_TRUE(
+      RadixTree<IPAddressV4, int>::radixSubTreesEqual(
+          rtree.root(), slabTree.root()));
+  EXPECT_EQ(rtree.size(), slabTree.size());
+  EXPECT_GE(deleteCount, inserted.size() / 2);
+
+  // Clones allocate from a pool of their own
+  auto allocatedNodes = slabTree.allocator().allocatedNodes();
+  auto copy = slabTree.clone();
+  EXPECT_TRUE(copy == slabTree);
+  EXPECT_FALSE(copy.allocator() == slabTree.allocator());
+  EXPECT_EQ(allocatedNodes, copy.allocator().allocatedNodes());
+  EXPECT_EQ(allocatedNodes, slabTree.allocator().allocatedNodes());
+
+  // Moved nodes keep being freed by the pool they came from
+  SlabTree moved(std::move(copy));
+  EXPECT_TRUE(moved == slabTree);
+  EXPECT_EQ(0, copy.size());
+  EXPECT_EQ(0, copy.allocator().allocatedNodes());
+  EXPECT_EQ(allocatedNodes, moved.allocator().allocatedNodes());
+
+  // Clearing a tree frees every node through the tree's callback and
+  // hands the slabs back
+  deleteCount = 0;
+  slabTree.clear();
+  EXPECT_EQ(allocatedNodes, deleteCount);
+  EXPECT_EQ(0, slabTree.allocator().allocatedNodes());
+  EXPECT_EQ(0, slabTree.allocator().bytesReserved());
+}
+
+TEST(RadixTree, SlabAllocatorFreesEmptySlabs) {
+  using TreeNode = RadixTreeNode<IPAddressV4, int>;
+  RadixTree<
+      IPAddressV4,
+      int,
+      RadixTreeTraits<IPAddressV4, int>,
+      RadixTreeSlabAllocator<TreeNode>>
+      slabTree(
+          [](const TreeNode& /*node*/) {},
+          RadixTreeTraits<IPAddressV4, int>(),
+          RadixTreeSlabAllocator<TreeNode>(16 /* nodes per slab */));
+  vector<Prefix4> inserted;
+  while (inserted.size() < 1000) {
+    auto mask = folly::Random::rand32(33);
+    auto ip = IPAddressV4::fromLongHBO(folly::Random::rand32()).mask(mask);
+    if (slabTree.insert(ip, mask, inserted.size()).second) {
+      inserted.emplace_back(ip, mask);
+    }
+  }
+  auto bytesReserved = slabTree.allocator().bytesReserved();
+  // Slabs go back to the heap as they empty, not only once all do
+  for (auto i = 0; i < inserted.size() - 10; ++i) {
+    EXPECT_TRUE(slabTree.erase(inserted[i].ip, inserted[i].mask));
+  }
+  EXPECT_EQ(10, slabTree.size());
+  EXPECT_LT(slabTree.allocator().bytesReserved(), bytesReserved / 2);
+
+  slabTree.clear();
+  EXPECT_EQ(0, slabTree.allocator().bytesReserved());
+}
+
+TEST(RadixTree, BatchedLongestMatch) {
+  RadixTree<IPAddressV6, int> rtree;
+  vector<IPAddressV6> addrs;
+  // Batched lookups on an empty tree match nothing
+  addrs.emplace_back("2401:db00::1");
+  vector<RadixTree<IPAddressV6, int>::ConstIterator> matches(addrs.size());
+  std::as_const(rtree).longestMatch(
+      std::span<const IPAddressV6>(addrs), std::span(matches));
+  EXPECT_TRUE(matches[0] == rtree.end());
+
+  rtree.insert(IPAddressV6("::"), 0, 0);
+  while (rtree.size() < 1000) {
+    folly::ByteArray16 bytes{};
+    // Prefixes under a common /16 so that lookups go deep
+    bytes[0] = 0x24;
+    bytes[1] = 0x01;
+    for (auto i = 2; i < 8; ++i) {
+      bytes[i] = folly::Random::rand32(4);
+    }
+    auto mask = 16 + folly::Random::rand32(113);
+    rtree.insert(IPAddressV6(bytes).mask(mask), mask, rtree.size());
+  }
+  // Addresses of the prefixes themselves, neighbours of them and
+  // addresses only matching the default route, more than a batch's worth
+  addrs.clear();
+  for (const auto& node : rtree) {
+    addrs.push_back(node.ipAddress());
+    auto bytes = node.ipAddress().toByteArray();
+    bytes[15] ^= 1;
+    addrs.emplace_back(bytes);
+  }
+  addrs.emplace_back("2402::1");
+  matches.resize(addrs.size());
+  std::as_const(rtree).longestMatch(
+      std::span<const IPAddressV6>(addrs), std::span(matches));
+  vector<RadixTree<IPAddressV6, int>::Iterator> mutableMatches(addrs.size());
+  rtree.longestMatch(
+      std::span<const IPAddressV6>(addrs), std::span(mutableMatches));
+  for (auto i = 0; i < addrs.size(); ++i) {
+    auto expected = rtree.longestMatch(addrs[i], addrs[i].bitCount());
+    ASSERT_TRUE(expected != rtree.end()) << addrs[i];
+    EXPECT_TRUE(matches[i] == expected) << addrs[i];
+    EXPECT_TRUE(mutableMatches[i] == expected) << addrs[i];
+  }
+  EXPECT_EQ(0, matches.back()->value());
+}
 /*
  * Compare with py-radix
  * Insert a set of random prefixes on both py-radix and our radix tree
@@ -0,0 +1,147 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include <folly/Range.h>
+#include <folly/hash/SpookyHashV2.h>
+#include <folly/io/IOBuf.h>
+#include "fboss/fsdb/if/gen-cpp2/fsdb_oper_types.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace facebook::fboss::thrift_cow {
+
+/*
+ * Hash of the contents of a thrift_cow node, equal for nodes with equal
+ * contents whether or not they are the same object, e.g. a subtree rebuilt
+ * by warm boot or config reapply.
+ *
+ * Struct and map nodes hash the hashes of their children, so that they can
+ * reuse the hashes cached by published children. Other nodes hash their
+ * serialized contents.
+ *
+ * At 128 bits accidental collisions are negligible, so nodes with equal
+ * hashes are treated as having equal contents. The converse doesn't hold:
+ * set nodes hash their elements in iteration order, which for unordered sets
+ * depends on their history, so unequal hashes only mean "maybe unequal".
+ */
+struct ContentHash {
+  uint64_t high{0};
+  uint64_t low{0};
+
+  void combine(const void* data, size_t length) {
+    folly::hash::SpookyHashV2::Hash128(data, length, &high, &low);
+  }
+
+  void combine(std::string_view bytes) {
+    combine(bytes.data(), bytes.size());
+  }
+
+  void combine(const ContentHash& other) {
+    uint64_t words[] = {other.high, other.low};
+    combine(words, sizeof(words));
+  }
+
+  // Order independent counterpart of combine(), for unordered entries
+  void accumulate(const ContentHash& other) {
+    high += other.high;
+    low += other.low;
+  }
+
+  bool operator==(const ContentHash& other) const = default;
+};
+
+/*
+ * Content hash of a published node. Published nodes can't change, a
+ * modification clones the node and the clone starts without a hash, so the
+ * cached hash never needs invalidating.
+ *
+ * Published nodes are shared between threads, which may all compute and set
+ * the (same) hash concurrently.
+ */
+class ContentHashCache {
+ public:
+  ContentHashCache() = default;
+  // Copies are clones about to be modified, so they start without a hash
+  ContentHashCache(const ContentHashCache& /* other */) {}
+  ContentHashCache& operator=(const ContentHashCache& /* other */) {
+    valid_.store(false, std::memory_order_release);
+    return *this;
+  }
+
+  std::optional<ContentHash> get() const {
+    if (!valid_.load(std::memory_order_acquire)) {
+      return std::nullopt;
+    }
+    return ContentHash{
+        high_.load(std::memory_order_relaxed),
+        low_.load(std::memory_order_relaxed)};
+  }
+
+  void set(const ContentHash& hash) const {
+    high_.store(hash.high, std::memory_order_relaxed);
+    low_.store(hash.low, std::memory_order_relaxed);
+    valid_.store(true, std::memory_order_release);
+  }
+
+ private:
+  mutable std::atomic<uint64_t> high_{0};
+  mutable std::atomic<uint64_t> low_{0};
+  mutable std::atomic<bool> valid_{false};
+};
+
+namespace content_hash_detail {
+
+inline void combinePresence(ContentHash& hash, bool present) {
+  uint8_t tag = present ? 1 : 0;
+  hash.combine(&tag, sizeof(tag));
+}
+
+inline void combineEncoded(ContentHash& hash, folly::IOBuf&& encoded) {
+  auto bytes = encoded.coalesce();
+  hash.combine(bytes.data(), bytes.size());
+}
+
+} // namespace content_hash_detail
+
+// Hash of a child node stored in the fields of a struct or map node
+template <typename Node>
+ContentHash contentHashOf(const std::shared_ptr<Node>& node) {
+  ContentHash hash;
+  content_hash_detail::combinePresence(hash, bool(node));
+  if (node) {
+    if constexpr (requires { node->contentHash(); }) {
+      hash.combine(node->contentHash());
+    } else {
+      content_hash_detail::combineEncoded(
+          hash, node->encodeBuf(fsdb::OperProtocol::COMPACT));
+    }
+  }
+  return hash;
+}
+
+// Hash of a primitive member
+template <typename Primitive>
+ContentHash contentHashOf(const std::optional<Primitive>& primitive) {
+  ContentHash hash;
+  content_hash_detail::combinePresence(hash, primitive.has_value());
+  if (primitive) {
+    content_hash_detail::combineEncoded(
+        hash, primitive->encodeBuf(fsdb::OperProtocol::COMPACT));
+  }
+  return hash;
+}
+
+} // namespace facebook::fboss::thrift_cow
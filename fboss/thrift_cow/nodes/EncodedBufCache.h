@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include <folly/io/IOBuf.h>
+#include <folly/io/IOBufQueue.h>
+#include "fboss/fsdb/if/gen-cpp2/fsdb_oper_types.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+namespace facebook::fboss::thrift_cow {
+
+namespace encoded_buf_cache_detail {
+inline std::atomic<bool> enabled{false};
+} // namespace encoded_buf_cache_detail
+
+/*
+ * Process wide switch for caching the encodings of published nodes, off by
+ * default as cached encodings live as long as their node. Meant for
+ * processes encoding the same state repeatedly, e.g. FSDB serving several
+ * subscribers.
+ */
+inline void setEncodedBufCaching(bool enabled) {
+  encoded_buf_cache_detail::enabled.store(enabled, std::memory_order_relaxed);
+}
+
+inline bool encodedBufCachingEnabled() {
+  return encoded_buf_cache_detail::enabled.load(std::memory_order_relaxed);
+}
+
+/*
+ * Encodings of a published struct or map node, one per protocol.
+ *
+ * With caching enabled, struct and map nodes write their own field and
+ * entry framing and splice in the encodings of their children, which
+ * published children return from their cache. So encoding a new state
+ * that only changed a few leaves re-encodes the path from the root down to
+ * those leaves, and shares the bytes of everything else with the encoding
+ * of the previous state.
+ *
+ * Only BINARY and COMPACT encodings are spliced and cached. Their framing
+ * of a nested value doesn't depend on what surrounds it, unlike
+ * SIMPLE_JSON, which is always encoded through toThrift().
+ *
+ * Published nodes can't change and a modification clones the node, the
+ * clone starting without an encoding, so cached encodings never need
+ * invalidating. Published nodes are shared between threads, which may all
+ * encode and cache the node concurrently. The first encoding cached wins.
+ */
+class EncodedBufCache {
+ public:
+  EncodedBufCache() = default;
+  // Copies are clones about to be modified, so they start without encodings
+  EncodedBufCache(const EncodedBufCache& /* other */) {}
+  EncodedBufCache& operator=(const EncodedBufCache& /* other */) {
+    // only unpublished nodes are assigned to, which nobody else encodes
+    delete entries_.exchange(nullptr, std::memory_order_acq_rel);
+    return *this;
+  }
+  ~EncodedBufCache() {
+    delete entries_.load(std::memory_order_acquire);
+  }
+
+  static bool cacheable(fsdb::OperProtocol proto) {
+    return encodedBufCachingEnabled() &&
+        (proto == fsdb::OperProtocol::BINARY ||
+         proto == fsdb::OperProtocol::COMPACT);
+  }
+
+  /*
+   * Returns the cached encoding of a published node, or encodes it with
+   * encodeFn and caches the result. Only for cacheable() protocols.
+   */
+  template <typename EncodeFn>
+  folly::IOBuf
+  encode(bool published, fsdb::OperProtocol proto, EncodeFn&& encodeFn) const {
+    if (!published) {
+      return encodeFn();
+    }
+    auto& slot = getEntries()->bufs[slotIndex(proto)];
+    if (auto cached = slot.load(std::memory_order_acquire)) {
+      return cached->cloneAsValue();
+    }
+    auto encoded = std::make_unique<folly::IOBuf>(encodeFn());
+    auto result = encoded->cloneAsValue();
+    const folly::IOBuf* expected = nullptr;
+    if (slot.compare_exchange_strong(
+            expected, encoded.get(), std::memory_order_acq_rel)) {
+      encoded.release();
+    }
+    return result;
+  }
+
+ private:
+  // BINARY and COMPACT
+  static constexpr size_t kNumProtocols = 2;
+
+  static size_t slotIndex(fsdb::OperProtocol proto) {
+    return proto == fsdb::OperProtocol::BINARY ? 0 : 1;
+  }
+
+  struct Entries {
+    ~Entries() {
+      for (auto& buf : bufs) {
+        delete buf.load(std::memory_order_acquire);
+      }
+    }
+    std::array<std::atomic<const folly::IOBuf*>, kNumProtocols> bufs{};
+  };
+
+  Entries* getEntries() const {
+    if (auto entries = entries_.load(std::memory_order_acquire)) {
+      return entries;
+    }
+    auto entries = std::make_unique<Entries>();
+    Entries* expected = nullptr;
+    if (entries_.compare_exchange_strong(
+            expected, entries.get(), std::memory_order_acq_rel)) {
+      return entries.release();
+    }
+    return expected;
+  }
+
+  // allocated on first use, keeping the cost of the cache to a pointer on
+  // nodes that are never encoded
+  mutable std::atomic<Entries*> entries_{nullptr};
+};
+
+/*
+ * Output of a node encoding that splices in the encodings of its children,
+ * see EncodedBufCache. Framing and primitive values go through the protocol
+ * writer, child encodings are appended to the queue as they are.
+ */
+template <typename Writer>
+class SplicingEncoder {
+ public:
+  // small writes, as in Serializer::maxGrowth
+  static constexpr size_t kMaxGrowth = 1024;
+
+  SplicingEncoder() {
+    writer_.setOutput(&queue_, kMaxGrowth);
+  }
+
+  Writer& writer() {
+    return writer_;
+  }
+
+  void splice(folly::IOBuf&& encoded) {
+    // small encodings are copied into the tail buffer rather than chained,
+    // keeping chains short for nodes with many small children
+    queue_.append(
+        std::make_unique<folly::IOBuf>(std::move(encoded)), true /* pack */);
+    // the writer appends after the spliced buffers
+    writer_.setOutput(&queue_, kMaxGrowth);
+  }
+
+  folly::IOBuf finish() {
+    return queue_.moveAsValue();
+  }
+
+ private:
+  folly::IOBufQueue queue_{folly::IOBufQueue::cacheChainLength()};
+  Writer writer_;
+};
+
+} // namespace facebook::fboss::thrift_cow
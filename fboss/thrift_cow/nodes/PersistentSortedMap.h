@@ -0,0 +1,555 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace facebook::fboss::thrift_cow {
+
+/*
+ * Sorted map whose copies share their entries, backing map nodes with
+ * ThriftMapStorage::PERSISTENT.
+ *
+ * Entries live in a treap whose nodes are reference counted. Copying the map
+ * copies the root pointer only, and a modification copies the tree nodes on
+ * the way to the modified entry (O(log n) of them) that other copies still
+ * share. Tree nodes owned by a single map are modified in place. Priorities
+ * are hashes of the keys, which keeps the tree balanced whatever the order
+ * entries are added in.
+ *
+ * Iterators are a tree node and the map, as tree nodes shared between maps
+ * can't point to their parents. Stepping to an entry outside the subtree of
+ * the current one looks it up from the root, so a full iteration is
+ * O(n log n) rather than O(n).
+ *
+ * Mutable accesses (non-const at(), operator[], dereferencing a non-const
+ * iterator) copy the shared tree nodes on the way to the entry accessed.
+ * Non-const find() and begin() only copy them once the iterator returned is
+ * dereferenced. Any modification, including dereferencing a non-const
+ * iterator, invalidates the other iterators.
+ */
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class PersistentSortedMap {
+  struct Node;
+  using NodePtr = std::shared_ptr<Node>;
+
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<const Key, Value>;
+  using size_type = size_t;
+  using key_compare = Compare;
+
+  template <bool IsConst>
+  class Iterator {
+    using MapPtr = std::conditional_t<
+        IsConst,
+        const PersistentSortedMap*,
+        PersistentSortedMap*>;
+
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = PersistentSortedMap::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference =
+        std::conditional_t<IsConst, const value_type&, value_type&>;
+    using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+
+    Iterator() = default;
+
+    template <bool OtherIsConst>
+    /* implicit */ Iterator(const Iterator<OtherIsConst>& other)
+      requires(IsConst && !OtherIsConst)
+        : map_(other.map_), node_(other.node_) {}
+
+    reference operator*() const {
+      return entry();
+    }
+
+    pointer operator->() const {
+      return &entry();
+    }
+
+    Iterator& operator++() {
+      node_ = map_->successor(node_);
+      owned_ = false;
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      auto copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    Iterator& operator--() {
+      node_ = node_ ? map_->predecessor(node_) : map_->rightmost();
+      owned_ = false;
+      return *this;
+    }
+
+    Iterator operator--(int) {
+      auto copy = *this;
+      --*this;
+      return copy;
+    }
+
+    friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+      return lhs.equals(rhs);
+    }
+
+   private:
+    friend class PersistentSortedMap;
+    template <bool>
+    friend class Iterator;
+
+    Iterator(MapPtr map, Node* node, bool owned = false)
+        : map_(map), node_(node), owned_(owned) {}
+
+    bool equals(const Iterator& other) const {
+      if (node_ == other.node_) {
+        return true;
+      }
+      if (!node_ || !other.node_) {
+        return false;
+      }
+      // dereferencing a non-const iterator may have replaced its tree node
+      // by a copy
+      const auto& compare = map_->compare_;
+      return !compare(node_->entry.first, other.node_->entry.first) &&
+          !compare(other.node_->entry.first, node_->entry.first);
+    }
+
+    reference entry() const {
+      if constexpr (!IsConst) {
+        if (!owned_) {
+          node_ = map_->unsharePath(node_->entry.first);
+          owned_ = true;
+        }
+      }
+      return node_->entry;
+    }
+
+    MapPtr map_{nullptr};
+    mutable Node* node_{nullptr};
+    // whether node_ was unshared for mutable access already
+    mutable bool owned_{false};
+  };
+
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  PersistentSortedMap() = default;
+
+  size_t size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  void clear() {
+    root_.reset();
+    size_ = 0;
+  }
+
+  const_iterator begin() const {
+    return const_iterator(this, leftmost(root_.get()));
+  }
+
+  const_iterator end() const {
+    return const_iterator(this, nullptr);
+  }
+
+  const_iterator cbegin() const {
+    return begin();
+  }
+
+  const_iterator cend() const {
+    return end();
+  }
+
+  iterator begin() {
+    return iterator(this, leftmost(root_.get()));
+  }
+
+  iterator end() {
+    return iterator(this, nullptr);
+  }
+
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  reverse_iterator rbegin() {
+    return reverse_iterator(end());
+  }
+
+  reverse_iterator rend() {
+    return reverse_iterator(begin());
+  }
+
+  const_iterator find(const Key& key) const {
+    return const_iterator(this, findNode(key));
+  }
+
+  iterator find(const Key& key) {
+    return iterator(this, findNode(key));
+  }
+
+  // first entry not before key
+  const_iterator lower_bound(const Key& key) const {
+    return const_iterator(this, lowerBoundNode(key));
+  }
+
+  iterator lower_bound(const Key& key) {
+    return iterator(this, lowerBoundNode(key));
+  }
+
+  // first entry after key
+  const_iterator upper_bound(const Key& key) const {
+    return const_iterator(this, upperBoundNode(key));
+  }
+
+  iterator upper_bound(const Key& key) {
+    return iterator(this, upperBoundNode(key));
+  }
+
+  size_t count(const Key& key) const {
+    return findNode(key) ? 1 : 0;
+  }
+
+  const Value& at(const Key& key) const {
+    if (auto node = findNode(key)) {
+      return node->entry.second;
+    }
+    throw std::out_of_range("PersistentSortedMap::at: missing key");
+  }
+
+  Value& at(const Key& key) {
+    if (auto node = unsharePath(key)) {
+      return node->entry.second;
+    }
+    throw std::out_of_range("PersistentSortedMap::at: missing key");
+  }
+
+  Value& operator[](const Key& key) {
+    // a missing key is inserted below the tree nodes unshared on the way
+    if (auto node = unsharePath(key)) {
+      return node->entry.second;
+    }
+    return insertNode(key, Value())->entry.second;
+  }
+
+  std::pair<iterator, bool> emplace(const Key& key, Value value) {
+    if (auto node = findNode(key)) {
+      return {iterator(this, node), false};
+    }
+    // inserting unshared the way to the new entry
+    return {
+        iterator(this, insertNode(key, std::move(value)), true /* owned */),
+        true};
+  }
+
+  std::pair<iterator, bool> try_emplace(const Key& key, Value value) {
+    return emplace(key, std::move(value));
+  }
+
+  std::pair<iterator, bool> insert(value_type entry) {
+    return emplace(entry.first, std::move(entry.second));
+  }
+
+  iterator emplace_hint(const_iterator /*hint*/, const Key& key, Value value) {
+    return emplace(key, std::move(value)).first;
+  }
+
+  size_t erase(const Key& key) {
+    if (!findNode(key)) {
+      return 0;
+    }
+    eraseNode(root_, key, compare_);
+    --size_;
+    return 1;
+  }
+
+  iterator erase(const_iterator pos) {
+    Key key = pos->first;
+    erase(key);
+    return upper_bound(key);
+  }
+
+  /*
+   * Calls fn on the values added or accessed mutably since the previous
+   * call, skipping the subtrees shared with maps that were already frozen.
+   * Used to publish the children of a map node without visiting the
+   * children it shares with the node it was cloned from.
+   */
+  template <typename Fn>
+  void freeze(Fn&& fn) {
+    freezeNode(root_.get(), fn);
+  }
+
+  friend bool operator==(
+      const PersistentSortedMap& lhs,
+      const PersistentSortedMap& rhs) {
+    if (lhs.size_ != rhs.size_) {
+      return false;
+    }
+    return lhs.root_ == rhs.root_ ||
+        std::equal(lhs.begin(), lhs.end(), rhs.begin());
+  }
+
+ private:
+  struct Node {
+    Node(value_type entry, uint64_t priority)
+        : entry(std::move(entry)), priority(priority) {}
+
+    // copies start unfrozen
+    Node(const Node& other)
+        : entry(other.entry),
+          priority(other.priority),
+          left(other.left),
+          right(other.right) {}
+
+    value_type entry;
+    uint64_t priority;
+    NodePtr left;
+    NodePtr right;
+    // Set by freeze() once it visited the subtree. Modifying an entry
+    // unfreezes the tree nodes on the way to it.
+    bool frozen{false};
+  };
+
+  static uint64_t priorityOf(const Key& key) {
+    // splitmix64 finalizer, as std::hash of integral keys is the identity
+    uint64_t x = std::hash<Key>()(key);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  // Makes the tree node owned by this map only, for modification
+  static Node* unshare(NodePtr& node) {
+    if (node.use_count() > 1) {
+      node = std::make_shared<Node>(*node);
+    }
+    node->frozen = false;
+    return node.get();
+  }
+
+  static Node* leftmost(Node* node) {
+    while (node && node->left) {
+      node = node->left.get();
+    }
+    return node;
+  }
+
+  Node* rightmost() const {
+    auto node = root_.get();
+    while (node && node->right) {
+      node = node->right.get();
+    }
+    return node;
+  }
+
+  Node* findNode(const Key& key) const {
+    auto node = root_.get();
+    while (node) {
+      if (compare_(key, node->entry.first)) {
+        node = node->left.get();
+      } else if (compare_(node->entry.first, key)) {
+        node = node->right.get();
+      } else {
+        return node;
+      }
+    }
+    return nullptr;
+  }
+
+  Node* lowerBoundNode(const Key& key) const {
+    Node* bound = nullptr;
+    for (auto node = root_.get(); node;) {
+      if (compare_(node->entry.first, key)) {
+        node = node->right.get();
+      } else {
+        bound = node;
+        node = node->left.get();
+      }
+    }
+    return bound;
+  }
+
+  Node* upperBoundNode(const Key& key) const {
+    Node* bound = nullptr;
+    for (auto node = root_.get(); node;) {
+      if (compare_(key, node->entry.first)) {
+        bound = node;
+        node = node->left.get();
+      } else {
+        node = node->right.get();
+      }
+    }
+    return bound;
+  }
+
+  Node* successor(const Node* node) const {
+    if (node->right) {
+      return leftmost(node->right.get());
+    }
+    return upperBoundNode(node->entry.first);
+  }
+
+  Node* predecessor(const Node* node) const {
+    if (node->left) {
+      auto pred = node->left.get();
+      while (pred->right) {
+        pred = pred->right.get();
+      }
+      return pred;
+    }
+    Node* bound = nullptr;
+    for (auto cur = root_.get(); cur;) {
+      if (compare_(cur->entry.first, node->entry.first)) {
+        bound = cur;
+        cur = cur->right.get();
+      } else {
+        cur = cur->left.get();
+      }
+    }
+    return bound;
+  }
+
+  // Unshares the tree nodes down to the entry for key, if there is one
+  Node* unsharePath(const Key& key) {
+    auto link = &root_;
+    while (*link) {
+      auto node = unshare(*link);
+      if (compare_(key, node->entry.first)) {
+        link = &node->left;
+      } else if (compare_(node->entry.first, key)) {
+        link = &node->right;
+      } else {
+        return node;
+      }
+    }
+    return nullptr;
+  }
+
+  // key must be missing, returns the new tree node
+  Node* insertNode(const Key& key, Value value) {
+    auto priority = priorityOf(key);
+    auto newNode =
+        std::make_shared<Node>(value_type(key, std::move(value)), priority);
+    auto inserted = newNode.get();
+    insertNode(root_, std::move(newNode), compare_);
+    ++size_;
+    return inserted;
+  }
+
+  static void
+  insertNode(NodePtr& link, NodePtr newNode, const Compare& compare) {
+    if (!link) {
+      link = std::move(newNode);
+      return;
+    }
+    auto node = unshare(link);
+    if (compare(newNode->entry.first, node->entry.first)) {
+      insertNode(node->left, std::move(newNode), compare);
+      if (node->left->priority > node->priority) {
+        rotateRight(link);
+      }
+    } else {
+      insertNode(node->right, std::move(newNode), compare);
+      if (node->right->priority > node->priority) {
+        rotateLeft(link);
+      }
+    }
+  }
+
+  // link and its left child must be unshared
+  static void rotateRight(NodePtr& link) {
+    auto left = std::move(link->left);
+    link->left = std::move(left->right);
+    left->right = std::move(link);
+    link = std::move(left);
+  }
+
+  // link and its right child must be unshared
+  static void rotateLeft(NodePtr& link) {
+    auto right = std::move(link->right);
+    link->right = std::move(right->left);
+    right->left = std::move(link);
+    link = std::move(right);
+  }
+
+  // key must be present
+  static void eraseNode(NodePtr& link, const Key& key, const Compare& compare) {
+    if (compare(key, link->entry.first)) {
+      eraseNode(unshare(link)->left, key, compare);
+    } else if (compare(link->entry.first, key)) {
+      eraseNode(unshare(link)->right, key, compare);
+    } else if (link.use_count() > 1) {
+      link = merge(link->left, link->right);
+    } else {
+      link = merge(std::move(link->left), std::move(link->right));
+    }
+  }
+
+  // all keys of left must be smaller than the keys of right
+  static NodePtr merge(NodePtr left, NodePtr right) {
+    if (!left) {
+      return right;
+    }
+    if (!right) {
+      return left;
+    }
+    if (left->priority > right->priority) {
+      auto node = unshare(left);
+      node->right = merge(std::move(node->right), std::move(right));
+      return left;
+    }
+    auto node = unshare(right);
+    node->left = merge(std::move(left), std::move(node->left));
+    return right;
+  }
+
+  template <typename Fn>
+  static void freezeNode(Node* node, Fn& fn) {
+    if (!node || node->frozen) {
+      return;
+    }
+    freezeNode(node->left.get(), fn);
+    freezeNode(node->right.get(), fn);
+    fn(node->entry.second);
+    node->frozen = true;
+  }
+
+  NodePtr root_;
+  size_t size_{0};
+  [[no_unique_address]] Compare compare_;
+};
+
+} // namespace facebook::fboss::thrift_cow
@@ -10,11 +10,16 @@
 
 #pragma once
 
+#include <folly/container/F14Map.h>
 #include <folly/json/dynamic.h>
+#include <folly/sorted_vector_types.h>
 #include <thrift/lib/cpp2/folly_dynamic/folly_dynamic.h>
 #include <thrift/lib/cpp2/protocol/detail/protocol_methods.h>
 #include "fboss/agent/state/NodeBase-defs.h"
+#include "fboss/thrift_cow/nodes/ContentHash.h"
+#include "fboss/thrift_cow/nodes/EncodedBufCache.h"
 #include "fboss/thrift_cow/nodes/NodeUtils.h"
+#include "fboss/thrift_cow/nodes/PersistentSortedMap.h"
 #include "fboss/thrift_cow/nodes/Serializer.h"
 #include "fboss/thrift_cow/nodes/Types.h"
 
@@ -36,6 +41,26 @@ struct ExtractTypeClass<
   using value_type = ValueTypeClass;
 };
 
+template <ThriftMapStorage Storage, typename Key, typename Value, typename Cmp>
+struct StorageSelector {
+  using type = std::map<Key, Value, Cmp>;
+};
+
+template <typename Key, typename Value, typename Cmp>
+struct StorageSelector<ThriftMapStorage::FLAT_SORTED, Key, Value, Cmp> {
+  using type = folly::sorted_vector_map<Key, Value, Cmp>;
+};
+
+template <typename Key, typename Value, typename Cmp>
+struct StorageSelector<ThriftMapStorage::F14, Key, Value, Cmp> {
+  using type = folly::F14FastMap<Key, Value>;
+};
+
+template <typename Key, typename Value, typename Cmp>
+struct StorageSelector<ThriftMapStorage::PERSISTENT, Key, Value, Cmp> {
+  using type = PersistentSortedMap<Key, Value, Cmp>;
+};
+
 } // namespace map_helpers
 
 template <typename Traits, bool EnableHybridStorage = false>
@@ -56,13 +81,21 @@ struct ThriftMapFields : public FieldBaseType {
       ValueTType>;
   using key_type = typename TType::key_type;
   using value_type = typename ValueTraits::type;
-  using StorageType =
-      std::map<key_type, value_type, typename Traits::KeyCompare>;
+  static constexpr auto kStorage = getThriftMapStorage<Traits>();
+  using StorageType = typename map_helpers::StorageSelector<
+      kStorage,
+      key_type,
+      value_type,
+      typename Traits::KeyCompare>::type;
+  // whether iteration visits keys in KeyCompare order
+  static constexpr bool kSortedStorage = kStorage != ThriftMapStorage::F14;
   using iterator = typename StorageType::iterator;
   using const_iterator = typename StorageType::const_iterator;
-  using Tag = apache::thrift::type::map<
-      apache::thrift::type::infer_tag<key_type, true /* GuessStringTag */>,
-      apache::thrift::type::infer_tag<ValueTType, true /* GuessStringTag */>>;
+  using KeyTag =
+      apache::thrift::type::infer_tag<key_type, true /* GuessStringTag */>;
+  using ValueTag =
+      apache::thrift::type::infer_tag<ValueTType, true /* GuessStringTag */>;
+  using Tag = apache::thrift::type::map<KeyTag, ValueTag>;
 
   // whether the contained type is another Cow node, or a primitive node
   static constexpr bool HasChildNodes = ValueTraits::isChild::value;
@@ -122,6 +155,23 @@ struct ThriftMapFields : public FieldBaseType {
   }
 #endif
 
+  ContentHash contentHash() const {
+    // Entries are hashed independently of the storage order, which for
+    // unordered maps can differ between maps with equal contents
+    ContentHash entries;
+    for (const auto& [key, value] : storage_) {
+      ContentHash entry;
+      entry.combine(folly::to<std::string>(key));
+      entry.combine(contentHashOf(value));
+      entries.accumulate(entry);
+    }
+    ContentHash hash;
+    uint64_t size = storage_.size();
+    hash.combine(&size, sizeof(size));
+    hash.combine(entries);
+    return hash;
+  }
+
   folly::fbstring encode(fsdb::OperProtocol proto) const {
     return serialize<TypeClass>(proto, toThrift());
   }
@@ -138,6 +188,19 @@ struct ThriftMapFields : public FieldBaseType {
     fromThrift(deserializeBuf<TypeClass, TType>(proto, std::move(encoded)));
   }
 
+  /*
+   * BINARY or COMPACT encoding with the encodings of the child nodes
+   * spliced in, see EncodedBufCache. Entries are written in storage order.
+   */
+  folly::IOBuf encodeBufSpliced(fsdb::OperProtocol proto) const {
+    if (proto == fsdb::OperProtocol::BINARY) {
+      return encodeSpliced<
+          ProtocolSerializers<fsdb::OperProtocol::BINARY>::Writer>(proto);
+    }
+    return encodeSpliced<
+        ProtocolSerializers<fsdb::OperProtocol::COMPACT>::Writer>(proto);
+  }
+
   value_type at(key_type key) const {
     return storage_.at(key);
   }
@@ -242,8 +305,14 @@ struct ThriftMapFields : public FieldBaseType {
   template <typename Fn>
   void forEachChild(Fn fn) {
     if constexpr (HasChildNodes) {
-      for (auto&& [key, value] : storage_) {
-        fn(value.get());
+      if constexpr (kStorage == ThriftMapStorage::PERSISTENT) {
+        // only used to publish, children shared with the published node
+        // this one was cloned from are published already
+        storage_.freeze([&](const value_type& value) { fn(value.get()); });
+      } else {
+        for (auto&& [key, value] : storage_) {
+          fn(value.get());
+        }
       }
     }
   }
@@ -261,6 +330,27 @@ struct ThriftMapFields : public FieldBaseType {
   }
 
  private:
+  template <typename Writer>
+  folly::IOBuf encodeSpliced(fsdb::OperProtocol proto) const {
+    namespace op = apache::thrift::op;
+    SplicingEncoder<Writer> encoder;
+    auto& writer = encoder.writer();
+    writer.writeMapBegin(
+        op::typeTagToTType<KeyTag>,
+        op::typeTagToTType<ValueTag>,
+        static_cast<uint32_t>(storage_.size()));
+    for (const auto& [key, value] : storage_) {
+      op::encode<KeyTag>(writer, key);
+      if constexpr (HasChildNodes) {
+        encoder.splice(value->encodeBuf(proto));
+      } else {
+        op::encode<ValueTag>(writer, value->cref());
+      }
+    }
+    writer.writeMapEnd();
+    return encoder.finish();
+  }
+
   template <typename... Args>
   value_type childFactory(Args&&... args) {
     if constexpr (HasChildNodes) {
@@ -324,7 +414,12 @@ class ThriftMapNode : public NodeBaseT<
 #endif
 
   folly::IOBuf encodeBuf(fsdb::OperProtocol proto) const override {
-    return this->getFields()->encodeBuf(proto);
+    if (!EncodedBufCache::cacheable(proto)) {
+      return this->getFields()->encodeBuf(proto);
+    }
+    return encodedBufCache_.encode(this->isPublished(), proto, [&] {
+      return this->getFields()->encodeBufSpliced(proto);
+    });
   }
 
   void fromEncodedBuf(fsdb::OperProtocol proto, folly::IOBuf&& encoded)
@@ -484,6 +579,26 @@ class ThriftMapNode : public NodeBaseT<
     node->swap(newNode);
   }
 
+  /*
+   * Hash of the node contents, see ContentHash. Computed on demand and
+   * cached once the node is published.
+   */
+  ContentHash contentHash() const {
+    if (auto cached = contentHashCache_.get()) {
+      return *cached;
+    }
+    auto hash = this->getFields()->contentHash();
+    if (this->isPublished()) {
+      contentHashCache_.set(hash);
+    }
+    return hash;
+  }
+
+  // Hash of the node contents if already computed, never computes it
+  std::optional<ContentHash> cachedContentHash() const {
+    return contentHashCache_.get();
+  }
+
   bool operator==(const Self& that) const {
     return *this->getFields() == *that.getFields();
   }
@@ -497,6 +612,9 @@ class ThriftMapNode : public NodeBaseT<
 
  private:
   friend class CloneAllocator;
+
+  ContentHashCache contentHashCache_;
+  EncodedBufCache encodedBufCache_;
 };
 
 } // namespace facebook::fboss::thrift_cow
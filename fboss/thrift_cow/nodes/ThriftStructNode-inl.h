@@ -18,6 +18,8 @@
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 #include "fboss/agent/state/NodeBase-defs.h"
 #include "fboss/fsdb/if/gen-cpp2/fsdb_oper_types.h"
+#include "fboss/thrift_cow/nodes/ContentHash.h"
+#include "fboss/thrift_cow/nodes/EncodedBufCache.h"
 #include "fboss/thrift_cow/nodes/Serializer.h"
 #include "fboss/thrift_cow/nodes/Types.h"
 #include "fboss/thrift_cow/visitors/PathVisitor.h"
@@ -300,6 +302,16 @@ struct ThriftStructFields : public FieldBaseType {
     });
   }
 
+  ContentHash contentHash() const {
+    ContentHash hash;
+    op::for_each_field_id<TType>([&]<class Id>(Id) {
+      constexpr size_t pos =
+          static_cast<size_t>(op::get_ordinal_v<TType, Id>) - 1;
+      hash.combine(contentHashOf(std::get<pos>(storage_)));
+    });
+    return hash;
+  }
+
   folly::fbstring encode(fsdb::OperProtocol proto) const {
     return serialize<TC>(proto, toThrift());
   }
@@ -316,7 +328,52 @@ struct ThriftStructFields : public FieldBaseType {
     fromThrift(deserializeBuf<TC, TType>(proto, std::move(encoded)));
   }
 
+  /*
+   * BINARY or COMPACT encoding with the encodings of the child nodes
+   * spliced in, see EncodedBufCache.
+   */
+  folly::IOBuf encodeBufSpliced(fsdb::OperProtocol proto) const {
+    if (proto == fsdb::OperProtocol::BINARY) {
+      return encodeSpliced<
+          ProtocolSerializers<fsdb::OperProtocol::BINARY>::Writer>(proto);
+    }
+    return encodeSpliced<
+        ProtocolSerializers<fsdb::OperProtocol::COMPACT>::Writer>(proto);
+  }
+
  private:
+  template <typename Writer>
+  folly::IOBuf encodeSpliced(fsdb::OperProtocol proto) const {
+    SplicingEncoder<Writer> encoder;
+    auto& writer = encoder.writer();
+    // names aren't part of the BINARY and COMPACT encodings
+    writer.writeStructBegin("");
+    op::for_each_field_id<TType>([&]<class Id>(Id) {
+      constexpr size_t pos =
+          static_cast<size_t>(op::get_ordinal_v<TType, Id>) - 1;
+      auto& stored = std::get<pos>(storage_);
+      if (!stored) {
+        return;
+      }
+      using Tag = op::get_type_tag<TType, Id>;
+      writer.writeFieldBegin(
+          "",
+          op::typeTagToTType<Tag>,
+          static_cast<int16_t>(op::get_field_id_v<TType, Id>));
+      if constexpr (
+          FieldTraits<Id>::isChild::value ||
+          FieldTraits<Id>::allowSkipThriftCow) {
+        encoder.splice(stored->encodeBuf(proto));
+      } else {
+        op::encode<Tag>(writer, stored->cref());
+      }
+      writer.writeFieldEnd();
+    });
+    writer.writeFieldStop();
+    writer.writeStructEnd();
+    return encoder.finish();
+  }
+
   Storage storage_;
 };
 
@@ -373,7 +430,12 @@ class ThriftStructNode : public NodeBaseT<
 #endif
 
   folly::IOBuf encodeBuf(fsdb::OperProtocol proto) const override {
-    return this->getFields()->encodeBuf(proto);
+    if (!EncodedBufCache::cacheable(proto)) {
+      return this->getFields()->encodeBuf(proto);
+    }
+    return encodedBufCache_.encode(this->isPublished(), proto, [&] {
+      return this->getFields()->encodeBufSpliced(proto);
+    });
   }
 
   void fromEncodedBuf(fsdb::OperProtocol proto, folly::IOBuf&& encoded)
@@ -538,6 +600,26 @@ class ThriftStructNode : public NodeBaseT<
     return result;
   }
 
+  /*
+   * Hash of the node contents, see ContentHash. Computed on demand and
+   * cached once the node is published.
+   */
+  ContentHash contentHash() const {
+    if (auto cached = contentHashCache_.get()) {
+      return *cached;
+    }
+    auto hash = this->getFields()->contentHash();
+    if (this->isPublished()) {
+      contentHashCache_.set(hash);
+    }
+    return hash;
+  }
+
+  // Hash of the node contents if already computed, never computes it
+  std::optional<ContentHash> cachedContentHash() const {
+    return contentHashCache_.get();
+  }
+
   bool operator==(const Self& that) const {
     return this->toThrift() == that.toThrift();
   }
@@ -548,6 +630,9 @@ class ThriftStructNode : public NodeBaseT<
 
  private:
   friend class CloneAllocator;
+
+  ContentHashCache contentHashCache_;
+  EncodedBufCache encodedBufCache_;
 };
 
 } // namespace facebook::fboss::thrift_cow
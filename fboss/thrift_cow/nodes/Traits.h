@@ -147,18 +147,48 @@ struct ConvertToNodeTraits<
 template <bool EnableHybridStorage>
 using bool_constant = std::integral_constant<bool, EnableHybridStorage>;
 
+/*
+ * Container holding the children of a map node, picked per map type through
+ * its traits (see ThriftMapTraits::kStorage):
+ * - TREE: std::map, the default.
+ * - FLAT_SORTED: sorted vector, for small maps that are mostly read.
+ *   Inserts and removals are linear in the map size.
+ * - F14: open addressing hash table, for large maps. Entries are unordered,
+ *   so these maps can't be walked by MapDelta, which merges sorted maps.
+ * - PERSISTENT: sorted tree shared between clones of the node, for huge maps
+ *   updated a few entries at a time (see PersistentSortedMap). Cloning is
+ *   O(1) and modifying an entry copies O(log n) tree nodes.
+ */
+enum class ThriftMapStorage {
+  TREE,
+  FLAT_SORTED,
+  F14,
+  PERSISTENT,
+};
+
+template <typename Traits>
+constexpr ThriftMapStorage getThriftMapStorage() {
+  if constexpr (requires { Traits::kStorage; }) {
+    return Traits::kStorage;
+  } else {
+    return ThriftMapStorage::TREE;
+  }
+}
+
 template <
     bool EnableHybridStorage,
     typename TypeClass,
     typename TType,
     template <bool, typename...> typename ConvertToNodeTraitsT =
-        ConvertToNodeTraits>
+        ConvertToNodeTraits,
+    ThriftMapStorage Storage = ThriftMapStorage::TREE>
 struct ThriftMapTraits {
   using TC = TypeClass;
   using Type = TType;
   using KeyType = typename TType::key_type;
   using KeyCompare = std::less<KeyType>;
   using EnableHybridStorageT = bool_constant<EnableHybridStorage>;
+  static constexpr auto kStorage = Storage;
   template <typename EnableHybridStorageT, typename... T>
   using ConvertToNodeTraits = ConvertToNodeTraitsT<EnableHybridStorage, T...>;
 };
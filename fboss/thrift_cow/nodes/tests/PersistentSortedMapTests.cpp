@@ -0,0 +1,191 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/thrift_cow/nodes/PersistentSortedMap.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace facebook::fboss::thrift_cow;
+
+namespace {
+
+using TestMap = PersistentSortedMap<int, std::shared_ptr<int>>;
+using ReferenceMap = std::map<int, int>;
+
+void checkContents(const TestMap& map, const ReferenceMap& expected) {
+  ASSERT_EQ(map.size(), expected.size());
+  auto it = expected.begin();
+  for (const auto& [key, value] : map) {
+    ASSERT_EQ(key, it->first);
+    ASSERT_EQ(*value, it->second);
+    ++it;
+  }
+  for (const auto& [key, value] : expected) {
+    ASSERT_EQ(map.count(key), 1);
+    ASSERT_EQ(*map.at(key), value);
+  }
+}
+
+size_t numFrozen(TestMap& map) {
+  size_t visited = 0;
+  map.freeze([&](const auto& /*value*/) { ++visited; });
+  return visited;
+}
+
+} // namespace
+
+TEST(PersistentSortedMapTests, Basic) {
+  TestMap map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_TRUE(map.emplace(2, std::make_shared<int>(20)).second);
+  EXPECT_TRUE(map.emplace(1, std::make_shared<int>(10)).second);
+  EXPECT_FALSE(map.emplace(1, std::make_shared<int>(11)).second);
+  EXPECT_TRUE(map.insert({3, std::make_shared<int>(30)}).second);
+  map[4] = std::make_shared<int>(40);
+  checkContents(map, {{1, 10}, {2, 20}, {3, 30}, {4, 40}});
+
+  EXPECT_EQ(map.find(5), map.end());
+  EXPECT_THROW(map.at(5), std::out_of_range);
+
+  auto next = map.erase(map.find(2));
+  ASSERT_NE(next, map.end());
+  EXPECT_EQ(next->first, 3);
+  EXPECT_EQ(map.erase(4), 1);
+  EXPECT_EQ(map.erase(4), 0);
+  checkContents(map, {{1, 10}, {3, 30}});
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.begin(), map.end());
+}
+
+TEST(PersistentSortedMapTests, CopiesAreIndependent) {
+  // random modifications of a map, checking all its earlier copies
+  std::mt19937 rng(1);
+  TestMap map;
+  ReferenceMap expected;
+  std::vector<std::pair<TestMap, ReferenceMap>> copies;
+  for (int step = 0; step < 10000; ++step) {
+    int key = rng() % 500;
+    switch (rng() % 4) {
+      case 0:
+        map.erase(key);
+        expected.erase(key);
+        break;
+      case 1:
+        map.emplace(key, std::make_shared<int>(step));
+        expected.emplace(key, step);
+        break;
+      case 2:
+        map[key] = std::make_shared<int>(step);
+        expected[key] = step;
+        break;
+      case 3:
+        if (auto it = map.find(key); it != map.end()) {
+          it->second = std::make_shared<int>(-step);
+          expected[key] = -step;
+        }
+        break;
+    }
+    if (step % 100 == 0) {
+      copies.emplace_back(map, expected);
+    }
+  }
+  checkContents(map, expected);
+  for (const auto& [copy, copyExpected] : copies) {
+    checkContents(copy, copyExpected);
+  }
+}
+
+TEST(PersistentSortedMapTests, Equality) {
+  TestMap map;
+  for (int i = 0; i < 100; ++i) {
+    map.emplace(i, std::make_shared<int>(i));
+  }
+  auto copy = map;
+  EXPECT_EQ(map, copy);
+  copy.at(50) = std::make_shared<int>(50);
+  // values are compared as shared_ptrs
+  EXPECT_NE(map, copy);
+  copy.at(50) = map.at(50);
+  EXPECT_EQ(map, copy);
+}
+
+TEST(PersistentSortedMapTests, FreezeSkipsSharedEntries) {
+  TestMap map;
+  for (int i = 0; i < 100000; ++i) {
+    map.emplace(i, std::make_shared<int>(i));
+  }
+  EXPECT_EQ(numFrozen(map), 100000);
+  EXPECT_EQ(numFrozen(map), 0);
+
+  // only the entries on the way to the modified one are visited again
+  auto copy = map;
+  copy.at(500) = std::make_shared<int>(0);
+  auto visited = numFrozen(copy);
+  EXPECT_GT(visited, 0);
+  EXPECT_LT(visited, 100);
+  EXPECT_EQ(numFrozen(map), 0);
+}
+
+TEST(PersistentSortedMapTests, BoundsAndReverseIteration) {
+  TestMap map;
+  for (int i = 0; i < 100; i += 10) {
+    map.emplace(i, std::make_shared<int>(i));
+  }
+  const auto& constMap = map;
+  EXPECT_EQ(map.lower_bound(20)->first, 20);
+  EXPECT_EQ(map.lower_bound(21)->first, 30);
+  EXPECT_EQ(constMap.upper_bound(20)->first, 30);
+  EXPECT_EQ(map.lower_bound(91), map.end());
+  EXPECT_EQ(constMap.upper_bound(90), constMap.end());
+
+  std::vector<int> keys;
+  for (auto it = constMap.rbegin(); it != constMap.rend(); ++it) {
+    keys.push_back(it->first);
+  }
+  EXPECT_EQ(keys, std::vector<int>({90, 80, 70, 60, 50, 40, 30, 20, 10, 0}));
+  auto last = map.end();
+  --last;
+  EXPECT_EQ(last->first, 90);
+  EXPECT_EQ((--last)->first, 80);
+}
+
+TEST(PersistentSortedMapTests, MutableIteratorsUnshareLazily) {
+  TestMap map;
+  for (int i = 0; i < 100000; ++i) {
+    map.emplace(i, std::make_shared<int>(i));
+  }
+  numFrozen(map);
+
+  // walking a copy with mutable iterators copies no tree nodes
+  auto copy = map;
+  size_t count = 0;
+  for (auto it = copy.begin(); it != copy.end(); ++it) {
+    ++count;
+  }
+  EXPECT_EQ(count, 100000);
+  EXPECT_NE(copy.find(500), copy.end());
+  EXPECT_EQ(numFrozen(copy), 0);
+
+  // dereferencing one copies the tree nodes on the way to its entry only
+  copy.find(500)->second = std::make_shared<int>(0);
+  auto visited = numFrozen(copy);
+  EXPECT_GT(visited, 0);
+  EXPECT_LT(visited, 100);
+  EXPECT_EQ(*map.at(500), 500);
+  EXPECT_EQ(*copy.at(500), 0);
+}
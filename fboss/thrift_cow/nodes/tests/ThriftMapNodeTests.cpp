@@ -301,6 +301,44 @@ TEST(ThriftMapNodeTests, ThriftMapNodePrimitivesModify) {
   ASSERT_NE(node->find(6), node->end());
 }
 
+TEST(ThriftMapNodeTests, ThriftMapNodePrimitivesContentHash) {
+  using TestNodeType = ThriftMapNode<ThriftMapTraits<
+      false,
+      apache::thrift::type_class::map<
+          apache::thrift::type_class::integral,
+          apache::thrift::type_class::integral>,
+      std::unordered_map<int, int>>>;
+
+  std::unordered_map<int, int> data;
+  for (int i = 0; i < 100; ++i) {
+    data.emplace(i, i * 2);
+  }
+  // same contents, inserted in the opposite order
+  std::unordered_map<int, int> reversed;
+  for (int i = 99; i >= 0; --i) {
+    reversed.emplace(i, i * 2);
+  }
+
+  auto node = std::make_shared<TestNodeType>(data);
+  ASSERT_EQ(
+      node->contentHash(),
+      std::make_shared<TestNodeType>(reversed)->contentHash());
+
+  data[5] = 11;
+  auto otherNode = std::make_shared<TestNodeType>(data);
+  ASSERT_NE(node->contentHash(), otherNode->contentHash());
+  data.erase(5);
+  auto smallerNode = std::make_shared<TestNodeType>(data);
+  ASSERT_NE(node->contentHash(), smallerNode->contentHash());
+
+  auto hash = node->contentHash();
+  node->publish();
+  ASSERT_EQ(hash, node->contentHash());
+  TestNodeType::modify(&node, "5");
+  node->ref(5) = 11;
+  ASSERT_EQ(otherNode->contentHash(), node->contentHash());
+}
+
 TEST(ThriftMapNodeTests, ThriftMapNodePrimitivesRemove) {
   using TestNodeType = ThriftMapNode<ThriftMapTraits<
       false,
@@ -658,3 +696,63 @@ TEST(ThriftMapNodeTests, MapDelta) {
     EXPECT_EQ(newNode->toThrift(), buildPortRange(1001, 1999));
   });
 }
+
+template <ThriftMapStorage Storage>
+struct StorageParam {
+  static constexpr auto storage = Storage;
+};
+
+template <typename Param>
+class ThriftMapNodeStorageTests : public ::testing::Test {
+ public:
+  using Map = ThriftMapNode<ThriftMapTraits<
+      false,
+      apache::thrift::type_class::map<
+          apache::thrift::type_class::integral,
+          apache::thrift::type_class::structure>,
+      std::map<int, cfg::L4PortRange>,
+      ConvertToNodeTraits,
+      Param::storage>>;
+};
+
+using MapStorageTypes = ::testing::Types<
+    StorageParam<ThriftMapStorage::TREE>,
+    StorageParam<ThriftMapStorage::FLAT_SORTED>,
+    StorageParam<ThriftMapStorage::F14>,
+    StorageParam<ThriftMapStorage::PERSISTENT>>;
+
+TYPED_TEST_SUITE(ThriftMapNodeStorageTests, MapStorageTypes);
+
+TYPED_TEST(ThriftMapNodeStorageTests, CopyOnWrite) {
+  using Map = typename TestFixture::Map;
+
+  std::map<int, cfg::L4PortRange> data;
+  for (int i = 0; i < 100; ++i) {
+    data.emplace(i, buildPortRange(i, i + 1));
+  }
+
+  auto node = std::make_shared<Map>(data);
+  ASSERT_EQ(node->toThrift(), data);
+  node->publish();
+
+  auto newNode = node->clone();
+  newNode->remove(5);
+  newNode->emplace(100, buildPortRange(100, 101));
+  Map::modify(&newNode, "7");
+  newNode->ref(7)->template set<sk::min>(700);
+
+  // the published node is untouched, unchanged children are shared
+  ASSERT_EQ(node->toThrift(), data);
+  ASSERT_EQ(newNode->size(), 100);
+  ASSERT_EQ(newNode->find(5), newNode->end());
+  ASSERT_EQ(newNode->cref(100)->toThrift(), buildPortRange(100, 101));
+  ASSERT_EQ(newNode->cref(7)->template get<sk::min>(), 700);
+  ASSERT_EQ(node->cref(7)->template get<sk::min>(), 7);
+  ASSERT_EQ(node->cref(8), newNode->cref(8));
+
+  data.erase(5);
+  data.emplace(100, buildPortRange(100, 101));
+  data[7].min() = 700;
+  ASSERT_EQ(newNode->toThrift(), data);
+  ASSERT_EQ(std::make_shared<Map>(data)->contentHash(), newNode->contentHash());
+}
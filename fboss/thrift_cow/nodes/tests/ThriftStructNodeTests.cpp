@@ -9,9 +9,11 @@
  */
 
 #include <fboss/thrift_cow/visitors/tests/VisitorTestUtils.h>
+#include <folly/ScopeGuard.h>
 #include <thrift/lib/cpp2/folly_dynamic/folly_dynamic.h>
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 #include "fboss/fsdb/if/gen-cpp2/fsdb_oper_types.h"
+#include "fboss/thrift_cow/nodes/EncodedBufCache.h"
 #include "fboss/thrift_cow/nodes/Serializer.h"
 #include "fboss/thrift_cow/nodes/Types.h"
 
@@ -337,6 +339,89 @@ TEST(ThriftStructNodeTests, ThriftStructNodeClone) {
   ASSERT_TRUE(newNode->template cref<k::inlineStruct>()->isPublished());
 }
 
+TEST(ThriftStructNodeTests, ThriftStructNodeContentHash) {
+  TestStruct data;
+  data.inlineInt() = 123;
+  data.inlineString() = "HelloThere";
+  data.inlineStruct() = buildPortRange(100, 999);
+
+  auto node = std::make_shared<ThriftStructNode<TestStruct>>(data);
+  auto sameNode = std::make_shared<ThriftStructNode<TestStruct>>(data);
+  ASSERT_EQ(node->contentHash(), sameNode->contentHash());
+
+  data.inlineStruct() = buildPortRange(100, 1000);
+  auto otherNode = std::make_shared<ThriftStructNode<TestStruct>>(data);
+  ASSERT_NE(node->contentHash(), otherNode->contentHash());
+
+  // unpublished nodes hash their current contents
+  auto hash = node->contentHash();
+  node->template set<k::inlineInt>(124);
+  ASSERT_NE(hash, node->contentHash());
+  node->template set<k::inlineInt>(123);
+  ASSERT_EQ(hash, node->contentHash());
+
+  // modifying a published node clones it, the clone is hashed anew
+  node->publish();
+  ASSERT_EQ(hash, node->contentHash());
+  auto newNode = node->clone();
+  newNode->template set<k::inlineInt>(124);
+  ASSERT_NE(hash, newNode->contentHash());
+  ASSERT_EQ(hash, node->contentHash());
+}
+
+TEST(ThriftStructNodeTests, ThriftStructNodeEncodedBufCache) {
+  setEncodedBufCaching(true);
+  SCOPE_EXIT {
+    setEncodedBufCaching(false);
+  };
+  auto data = createSimpleTestStruct();
+  data.mapOfStringToStruct() = {
+      {"a", buildPortRange(1, 2)}, {"b", buildPortRange(3, 4)}};
+  data.optionalStruct() = buildPortRange(5, 6);
+  auto node = std::make_shared<ThriftStructNode<TestStruct>>(data);
+  node->publish();
+  using TC = apache::thrift::type_class::structure;
+
+  for (auto proto : {fsdb::OperProtocol::BINARY, fsdb::OperProtocol::COMPACT}) {
+    // spliced encodings decode to the same contents
+    auto encoded = node->encodeBuf(proto);
+    EXPECT_EQ(
+        data, (deserializeBuf<TC, TestStruct>(proto, encoded.clone())));
+    // published nodes return their cached encoding
+    EXPECT_EQ(encoded.data(), node->encodeBuf(proto).data());
+  }
+
+  // modifying a leaf re-encodes its ancestors only, unchanged siblings are
+  // spliced in from their cached encodings
+  auto inlineStruct = node->template cref<k::inlineStruct>();
+  auto inlineStructBuf = inlineStruct->encodeBuf(fsdb::OperProtocol::BINARY);
+  auto newNode = node;
+  auto& mapNode = ThriftStructNode<TestStruct>::template modify<
+      k::mapOfStringToStruct>(&newNode);
+  mapNode->modify("a");
+  mapNode->ref("a")->fromThrift(buildPortRange(1, 10));
+  newNode->publish();
+  data.mapOfStringToStruct()["a"] = buildPortRange(1, 10);
+  for (auto proto : {fsdb::OperProtocol::BINARY, fsdb::OperProtocol::COMPACT}) {
+    EXPECT_EQ(
+        data,
+        (deserializeBuf<TC, TestStruct>(proto, newNode->encodeBuf(proto))));
+  }
+  EXPECT_EQ(inlineStruct, newNode->template cref<k::inlineStruct>());
+  EXPECT_EQ(
+      inlineStructBuf.data(),
+      newNode->template cref<k::inlineStruct>()
+          ->encodeBuf(fsdb::OperProtocol::BINARY)
+          .data());
+
+  // SIMPLE_JSON isn't spliced
+  EXPECT_EQ(
+      data,
+      (deserializeBuf<TC, TestStruct>(
+          fsdb::OperProtocol::SIMPLE_JSON,
+          newNode->encodeBuf(fsdb::OperProtocol::SIMPLE_JSON))));
+}
+
 template <bool EnableHybridStorage>
 struct TestParams {
   static constexpr auto hybridStorage = EnableHybridStorage;
@@ -1,6 +1,11 @@
 // (c) Meta Platforms, Inc. and affiliates. Confidential and proprietary.
 
 #include "fboss/thrift_cow/storage/tests/CowStorageBenchHelper.h"
+#include "fboss/thrift_cow/nodes/Types.h"
+
+#include <deque>
+#include <random>
+#include <utility>
 
 namespace facebook::fboss::thrift_cow::test {
 
@@ -55,6 +60,184 @@ BENCHMARK_COUNTERS_NAME_PARAM(
     test_data::RoleSelector::MaxScale,
     true);
 
+// Map node storage backends, see ThriftMapStorage
+namespace {
+
+template <ThriftMapStorage Storage>
+using BenchMap = ThriftMapNode<ThriftMapTraits<
+    false,
+    apache::thrift::type_class::map<
+        apache::thrift::type_class::integral,
+        apache::thrift::type_class::structure>,
+    std::map<int32_t, fsdb::TestStructSimple>,
+    ConvertToNodeTraits,
+    Storage>>;
+
+std::map<int32_t, fsdb::TestStructSimple> mapData(int size) {
+  std::map<int32_t, fsdb::TestStructSimple> data;
+  for (int i = 0; i < size; ++i) {
+    fsdb::TestStructSimple entry;
+    entry.min() = i;
+    entry.max() = i + 1;
+    data.emplace(i, std::move(entry));
+  }
+  return data;
+}
+
+template <typename Fn>
+void withMapStorage(ThriftMapStorage storage, Fn&& fn) {
+  switch (storage) {
+    case ThriftMapStorage::TREE:
+      fn.template operator()<ThriftMapStorage::TREE>();
+      break;
+    case ThriftMapStorage::FLAT_SORTED:
+      fn.template operator()<ThriftMapStorage::FLAT_SORTED>();
+      break;
+    case ThriftMapStorage::F14:
+      fn.template operator()<ThriftMapStorage::F14>();
+      break;
+    case ThriftMapStorage::PERSISTENT:
+      fn.template operator()<ThriftMapStorage::PERSISTENT>();
+      break;
+  }
+}
+
+void bm_map_build(unsigned iters, ThriftMapStorage storage, int size) {
+  folly::BenchmarkSuspender suspender;
+  auto data = mapData(size);
+  withMapStorage(storage, [&]<ThriftMapStorage Storage>() {
+    suspender.dismiss();
+    for (unsigned i = 0; i < iters; ++i) {
+      auto node = std::make_shared<BenchMap<Storage>>(data);
+      folly::doNotOptimizeAway(node);
+    }
+    suspender.rehire();
+  });
+}
+
+void bm_map_lookup(unsigned iters, ThriftMapStorage storage, int size) {
+  folly::BenchmarkSuspender suspender;
+  withMapStorage(storage, [&]<ThriftMapStorage Storage>() {
+    const auto node = std::make_shared<BenchMap<Storage>>(mapData(size));
+    node->publish();
+    suspender.dismiss();
+    for (unsigned i = 0; i < iters; ++i) {
+      for (int key = 0; key < size; ++key) {
+        folly::doNotOptimizeAway(node->cref(key));
+      }
+    }
+    suspender.rehire();
+  });
+}
+
+// Copy on write update of a single entry of a published map
+void bm_map_update(unsigned iters, ThriftMapStorage storage, int size) {
+  folly::BenchmarkSuspender suspender;
+  withMapStorage(storage, [&]<ThriftMapStorage Storage>() {
+    auto node = std::make_shared<BenchMap<Storage>>(mapData(size));
+    node->publish();
+    suspender.dismiss();
+    for (unsigned i = 0; i < iters; ++i) {
+      auto key = static_cast<int32_t>(i % size);
+      auto newNode = node;
+      BenchMap<Storage>::modify(&newNode, folly::to<std::string>(key));
+      newNode->ref(key)->template set<apache::thrift::ident::min>(-1);
+      folly::doNotOptimizeAway(newNode);
+    }
+    suspender.rehire();
+  });
+}
+
+void bm_map_iterate(unsigned iters, ThriftMapStorage storage, int size) {
+  folly::BenchmarkSuspender suspender;
+  withMapStorage(storage, [&]<ThriftMapStorage Storage>() {
+    const auto node = std::make_shared<BenchMap<Storage>>(mapData(size));
+    node->publish();
+    suspender.dismiss();
+    for (unsigned i = 0; i < iters; ++i) {
+      int64_t sum = 0;
+      for (const auto& [key, value] : std::as_const(*node)) {
+        sum += value->template get<apache::thrift::ident::max>();
+      }
+      folly::doNotOptimizeAway(sum);
+    }
+    suspender.rehire();
+  });
+}
+
+// Single entry updates of a 1M entry map, each published as a new version
+// of the map. The last versions stay alive, as old switch states would.
+void bm_map_churn(
+    folly::UserCounters& counters,
+    unsigned iters,
+    ThriftMapStorage storage) {
+  constexpr int kSize = 1000000;
+  constexpr size_t kRetainedVersions = 16;
+  folly::BenchmarkSuspender suspender;
+  withMapStorage(storage, [&]<ThriftMapStorage Storage>() {
+    using Map = BenchMap<Storage>;
+    auto node = std::make_shared<Map>(mapData(kSize));
+    node->publish();
+    std::deque<std::shared_ptr<Map>> versions;
+    std::mt19937 rng(1);
+    auto startAllocated = getJemallocAllocatedBytes();
+    suspender.dismiss();
+    for (unsigned i = 0; i < iters; ++i) {
+      auto key = static_cast<int32_t>(rng() % kSize);
+      auto newNode = node;
+      Map::modify(&newNode, folly::to<std::string>(key));
+      newNode->ref(key)->template set<apache::thrift::ident::min>(-1);
+      newNode->publish();
+      versions.push_back(std::exchange(node, std::move(newNode)));
+      if (versions.size() > kRetainedVersions) {
+        versions.pop_front();
+      }
+    }
+    suspender.rehire();
+    auto endAllocated = getJemallocAllocatedBytes();
+    if (startAllocated > 0 && endAllocated > 0) {
+      // memory held by the retained versions, on top of the latest one
+      counters["retained_KB"] = folly::UserMetric(
+          static_cast<double>(endAllocated - startAllocated) / 1024.0);
+    }
+  });
+}
+
+} // namespace
+
+#define MAP_STORAGE_BENCHMARKS(bm)                                      \
+  BENCHMARK_NAMED_PARAM(bm, tree_16, ThriftMapStorage::TREE, 16)        \
+  BENCHMARK_RELATIVE_NAMED_PARAM(                                       \
+      bm, flat_sorted_16, ThriftMapStorage::FLAT_SORTED, 16)            \
+  BENCHMARK_RELATIVE_NAMED_PARAM(bm, f14_16, ThriftMapStorage::F14, 16) \
+  BENCHMARK_RELATIVE_NAMED_PARAM(                                       \
+      bm, persistent_16, ThriftMapStorage::PERSISTENT, 16)              \
+  BENCHMARK_NAMED_PARAM(bm, tree_100k, ThriftMapStorage::TREE, 100000)  \
+  BENCHMARK_RELATIVE_NAMED_PARAM(                                       \
+      bm, flat_sorted_100k, ThriftMapStorage::FLAT_SORTED, 100000)      \
+  BENCHMARK_RELATIVE_NAMED_PARAM(                                       \
+      bm, f14_100k, ThriftMapStorage::F14, 100000)                      \
+  BENCHMARK_RELATIVE_NAMED_PARAM(                                       \
+      bm, persistent_100k, ThriftMapStorage::PERSISTENT, 100000)        \
+  BENCHMARK_DRAW_LINE();
+
+MAP_STORAGE_BENCHMARKS(bm_map_build)
+MAP_STORAGE_BENCHMARKS(bm_map_lookup)
+MAP_STORAGE_BENCHMARKS(bm_map_update)
+MAP_STORAGE_BENCHMARKS(bm_map_iterate)
+
+BENCHMARK_COUNTERS_NAME_PARAM(
+    bm_map_churn,
+    counters,
+    tree_1m,
+    ThriftMapStorage::TREE);
+
+BENCHMARK_COUNTERS_NAME_PARAM(
+    bm_map_churn,
+    counters,
+    persistent_1m,
+    ThriftMapStorage::PERSISTENT);
+
 } // namespace facebook::fboss::thrift_cow::test
 
 int main(int argc, char* argv[]) {
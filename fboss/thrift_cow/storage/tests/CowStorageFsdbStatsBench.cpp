@@ -1,9 +1,16 @@
 // (c) Meta Platforms, Inc. and affiliates. Confidential and proprietary.
 
 #include "fboss/thrift_cow/storage/tests/CowStorageBenchHelper.h"
+#include "fboss/thrift_cow/visitors/DeltaVisitor.h"
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
 
 namespace facebook::fboss::thrift_cow::test {
 
+namespace {
+constexpr auto kDeltaThreads = 8;
+} // namespace
+
 void fsdb_stats_storage(
     folly::UserCounters& counters,
     unsigned iters,
@@ -210,6 +217,85 @@ BENCHMARK_COUNTERS_NAME_PARAM(
     test_data::RoleSelector::RGSW,
     true);
 
+/*
+ * Delta between two successive collections of the stats, as computed to
+ * serve subscriptions. Every stats entry changes between collections, so the
+ * whole tree is walked. With parallel, the entries of large maps and lists
+ * are visited on kDeltaThreads threads.
+ */
+void fsdb_stats_delta(
+    unsigned iters,
+    test_data::RoleSelector selector,
+    bool parallel) {
+  folly::BenchmarkSuspender suspender;
+  using RootT = test_data::FsdbStatsDataFactory::RootT;
+  auto factory = test_data::FsdbStatsDataFactory(selector);
+  auto oldState = factory.getStateUpdate(0, false);
+  auto newState = factory.getStateUpdate(1, false);
+  StorageBenchmarkHelper<false> helper;
+  auto oldStorage = helper.initStorage<RootT>(oldState);
+  auto newStorage = helper.initStorage<RootT>(newState);
+  oldStorage.publish();
+  newStorage.publish();
+
+  folly::CPUThreadPoolExecutor executor(kDeltaThreads);
+  DeltaVisitOptions options(DeltaVisitMode::MINIMAL);
+  if (parallel) {
+    options.executor = &executor;
+  }
+  size_t numDeltas = 0;
+  auto processDelta = [&](SimpleTraverseHelper& /*traverser*/,
+                          auto&& /*oldNode*/,
+                          auto&& /*newNode*/,
+                          DeltaElemTag /*tag*/) { ++numDeltas; };
+
+  suspender.dismiss();
+  for (unsigned i = 0; i < iters; ++i) {
+    RootDeltaVisitor::visit(
+        oldStorage.root(), newStorage.root(), options, processDelta);
+  }
+  suspender.rehire();
+  folly::doNotOptimizeAway(numDeltas);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_NAMED_PARAM(
+    fsdb_stats_delta,
+    RDSW_serial,
+    test_data::RoleSelector::RDSW,
+    false);
+
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    fsdb_stats_delta,
+    RDSW_parallel,
+    test_data::RoleSelector::RDSW,
+    true);
+
+BENCHMARK_NAMED_PARAM(
+    fsdb_stats_delta,
+    EDSW_serial,
+    test_data::RoleSelector::EDSW,
+    false);
+
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    fsdb_stats_delta,
+    EDSW_parallel,
+    test_data::RoleSelector::EDSW,
+    true);
+
+BENCHMARK_NAMED_PARAM(
+    fsdb_stats_delta,
+    FDSW_serial,
+    test_data::RoleSelector::FDSW,
+    false);
+
+BENCHMARK_RELATIVE_NAMED_PARAM(
+    fsdb_stats_delta,
+    FDSW_parallel,
+    test_data::RoleSelector::FDSW,
+    true);
+
 } // namespace facebook::fboss::thrift_cow::test
 
 int main(int argc, char* argv[]) {
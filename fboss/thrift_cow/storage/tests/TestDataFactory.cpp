@@ -892,14 +892,14 @@ SwitchStateScale FsdbStateDataFactory::getRoleScale(RoleSelector role) {
 
 // AgentStatsDataFactory Implementation
 TaggedOperState FsdbStatsDataFactory::getStateUpdate(
-    int /* unused */,
+    int version,
     bool /* unused */) {
   TaggedOperState state;
   OperState chunk;
   std::vector<std::string> basePath;
   chunk.protocol() = protocol_;
 
-  auto fsdbRoot = buildFsdbOperStatsRoot();
+  auto fsdbRoot = buildFsdbOperStatsRoot(version);
 
   chunk.contents() = facebook::fboss::thrift_cow::serialize<
       apache::thrift::type_class::structure>(protocol_, fsdbRoot);
@@ -909,18 +909,20 @@ TaggedOperState FsdbStatsDataFactory::getStateUpdate(
   return state;
 }
 
-fsdb::FsdbOperStatsRoot FsdbStatsDataFactory::buildFsdbOperStatsRoot() {
+fsdb::FsdbOperStatsRoot FsdbStatsDataFactory::buildFsdbOperStatsRoot(
+    int version) {
   fsdb::FsdbOperStatsRoot root;
 
   // Build agent stats data
-  root.agent() = buildAgentStats();
+  root.agent() = buildAgentStats(version);
   return root;
 }
 
-AgentStats FsdbStatsDataFactory::buildAgentStats() {
+AgentStats FsdbStatsDataFactory::buildAgentStats(int version) {
   AgentStats agentStats;
   AgentStatsScale scale = getRoleScale(selector_);
-  int64_t baseTimestamp = 1755207740; // Pick a random timestamp
+  // Pick a random timestamp, each version being a later stats collection
+  int64_t baseTimestamp = 1755207740 + version;
 
   // Determine which AgentStats field to populate.
   // Path format: /agent/<field>
@@ -969,22 +971,30 @@ AgentStats FsdbStatsDataFactory::buildAgentStats() {
     agentStats.sysPortStatsMap()[0] = *agentStats.sysPortStats();
   }
 
-  facebook::fboss::fsdb::test::populateHwResourceStatsMap(agentStats, scale);
-  facebook::fboss::fsdb::test::populateHwAsicErrorsMap(agentStats, scale);
-  facebook::fboss::fsdb::test::populateCpuPortStatsMap(agentStats, scale);
-  facebook::fboss::fsdb::test::populateSwitchDropStatsMap(agentStats, scale);
+  facebook::fboss::fsdb::test::populateHwResourceStatsMap(
+      agentStats, scale, version);
+  facebook::fboss::fsdb::test::populateHwAsicErrorsMap(
+      agentStats, scale, version);
+  facebook::fboss::fsdb::test::populateCpuPortStatsMap(
+      agentStats, scale, version);
+  facebook::fboss::fsdb::test::populateSwitchDropStatsMap(
+      agentStats, scale, version);
   facebook::fboss::fsdb::test::populateSwitchWatermarkStatsMap(
-      agentStats, scale);
+      agentStats, scale, version);
   facebook::fboss::fsdb::test::populateFabricReachabilityStatsMap(
-      agentStats, scale);
+      agentStats, scale, version);
   facebook::fboss::fsdb::test::populateSwitchPipelineStatsMap(
-      agentStats, scale);
-  facebook::fboss::fsdb::test::populateSysPortShelStateMap(agentStats, scale);
-  facebook::fboss::fsdb::test::populateAsicTemp(agentStats, scale);
-  facebook::fboss::fsdb::test::populateFlowletStats(agentStats, scale);
-  facebook::fboss::fsdb::test::populateSimpleCounters(agentStats, scale);
-  facebook::fboss::fsdb::test::populateHwAgentStatus(agentStats, scale);
-  facebook::fboss::fsdb::test::populateFabricOverdrainPct(agentStats, scale);
+      agentStats, scale, version);
+  facebook::fboss::fsdb::test::populateSysPortShelStateMap(
+      agentStats, scale, version);
+  facebook::fboss::fsdb::test::populateAsicTemp(agentStats, scale, version);
+  facebook::fboss::fsdb::test::populateFlowletStats(agentStats, scale, version);
+  facebook::fboss::fsdb::test::populateSimpleCounters(
+      agentStats, scale, version);
+  facebook::fboss::fsdb::test::populateHwAgentStatus(
+      agentStats, scale, version);
+  facebook::fboss::fsdb::test::populateFabricOverdrainPct(
+      agentStats, scale, version);
 
   return agentStats;
 }
@@ -197,8 +197,8 @@ class FsdbStatsDataFactory : public IDataGenerator {
   TaggedOperState getStateUpdate(int version, bool minimal) override;
 
  protected:
-  fsdb::FsdbOperStatsRoot buildFsdbOperStatsRoot();
-  AgentStats buildAgentStats();
+  fsdb::FsdbOperStatsRoot buildFsdbOperStatsRoot(int version);
+  AgentStats buildAgentStats(int version);
   AgentStatsScale getRoleScale(RoleSelector role);
 
   // Helper methods to create AgentStats structures
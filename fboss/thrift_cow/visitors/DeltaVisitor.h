@@ -4,8 +4,12 @@
 
 #include <glog/logging.h>
 #include <type_traits>
+#include <vector>
 #include "folly/Conv.h"
+#include "folly/Executor.h"
+#include "folly/Function.h"
 #include "folly/ScopeGuard.h"
+#include "folly/futures/Future.h"
 
 #include <boost/iterator/function_output_iterator.hpp>
 
@@ -100,6 +104,17 @@ struct DeltaVisitOptions {
   DeltaVisitOrder order;
   bool outputIdPaths;
   bool hybridNodeShallowTraversal;
+  // Skip published subtrees that are distinct objects with equal contents,
+  // as found by comparing their content hashes (see ContentHash). Pays off
+  // when comparing against a rebuilt tree, e.g. after warm boot.
+  bool pruneEqualContents{false};
+  // If set, the entries of maps and lists larger than parallelChunkSize are
+  // visited in chunks running concurrently on executor. Deltas are still
+  // passed to the visitor function on the calling thread, in the same order
+  // as visiting serially. Only supported with SimpleTraverseHelper, other
+  // traverse helpers keep per path state that chunks can't share.
+  folly::Executor* executor{nullptr};
+  size_t parallelChunkSize{1024};
 };
 
 namespace dv_detail {
@@ -119,6 +134,114 @@ auto invokeVisitorFnHelper(
   return f(traverser, oldNode, newNode, deltaElemTag);
 }
 
+/*
+ * Visitor function used while visiting a chunk of entries on an executor
+ * thread. Records the deltas, to replay them to the actual visitor function
+ * on the calling thread. Copies record into the same deltas, as visitors
+ * may copy the function they are given.
+ */
+template <typename Func>
+class DeltaRecorder {
+ public:
+  using Delta = folly::Function<void(Func&)>;
+
+  explicit DeltaRecorder(std::vector<Delta>* deltas) : deltas_(deltas) {}
+
+  template <typename Node>
+  void operator()(
+      const SimpleTraverseHelper& traverser,
+      const Node& oldNode,
+      const Node& newNode,
+      DeltaElemTag deltaElemTag) {
+    deltas_->emplace_back(
+        [path = traverser.path(), oldNode, newNode, deltaElemTag](
+            Func& f) mutable {
+          SimpleTraverseHelper replayTraverser;
+          for (auto& tok : path) {
+            // type class only matters to stateful traverse helpers
+            replayTraverser.push(std::move(tok), ThriftTCType::PRIMITIVE);
+          }
+          invokeVisitorFnHelper(
+              replayTraverser, oldNode, newNode, deltaElemTag, f);
+        });
+  }
+
+ private:
+  std::vector<Delta>* deltas_;
+};
+
+template <typename TraverseHelper>
+constexpr bool kCanVisitConcurrently =
+    std::is_same_v<TraverseHelper, SimpleTraverseHelper>;
+
+inline bool shouldVisitConcurrently(
+    const DeltaVisitOptions& options,
+    size_t size) {
+  return options.executor && size > options.parallelChunkSize;
+}
+
+/*
+ * Runs visitChunk(chunkTraverser, chunkOptions, recorder, chunk) for chunks
+ * [0, numChunks) concurrently, then replays the recorded deltas to f in
+ * chunk order. Chunks are visited serially within, as nested parallel
+ * visits could wait on executor threads they occupy.
+ *
+ * Returns whether any chunk has differences.
+ */
+template <typename Func, typename VisitChunk>
+bool visitChunksConcurrently(
+    SimpleTraverseHelper& traverser,
+    const DeltaVisitOptions& options,
+    size_t numChunks,
+    VisitChunk&& visitChunk,
+    Func&& f) {
+  using Recorder = DeltaRecorder<std::remove_reference_t<Func>>;
+  std::vector<std::vector<typename Recorder::Delta>> deltas(numChunks);
+  auto chunkOptions = options;
+  chunkOptions.executor = nullptr;
+
+  std::vector<folly::Future<bool>> futures;
+  futures.reserve(numChunks);
+  for (size_t chunk = 0; chunk < numChunks; ++chunk) {
+    futures.push_back(folly::via(options.executor, [&, chunk] {
+      auto chunkTraverser = traverser;
+      return visitChunk(
+          chunkTraverser, chunkOptions, Recorder(&deltas[chunk]), chunk);
+    }));
+  }
+  auto results = folly::collectAll(std::move(futures)).get();
+
+  bool hasDifferences{false};
+  for (auto& result : results) {
+    // rethrows exceptions from the chunks
+    if (result.value()) {
+      hasDifferences = true;
+    }
+  }
+  for (auto& chunkDeltas : deltas) {
+    for (auto& delta : chunkDeltas) {
+      delta(f);
+    }
+  }
+  return hasDifferences;
+}
+
+// Splits a container in chunks of chunkSize entries, returning the first
+// entry of each chunk
+template <typename Container>
+std::vector<typename Container::const_iterator> chunkBegins(
+    const Container& container,
+    size_t chunkSize) {
+  std::vector<typename Container::const_iterator> begins;
+  size_t index = 0;
+  for (auto it = container.begin(); it != container.end(); ++it, ++index) {
+    if (index % chunkSize == 0) {
+      begins.push_back(it);
+    }
+  }
+  return begins;
+}
+
 template <typename TC, typename Node, typename TraverseHelper, typename Func>
 bool visitNode(
     TraverseHelper& traverser,
@@ -139,6 +262,16 @@ bool visitNode(
     return false;
   }
 
+  if constexpr (requires { oldNode->contentHash(); }) {
+    // Hashes of unpublished nodes aren't cached, computing them would cost
+    // as much as the recursion
+    if (options.pruneEqualContents && oldNode && newNode &&
+        oldNode->isPublished() && newNode->isPublished() &&
+        oldNode->contentHash() == newNode->contentHash()) {
+      return false;
+    }
+  }
+
   auto hasDifferences = DeltaVisitor<TC>::visit(
       traverser,
       *oldNode->getFields(),
@@ -454,19 +587,47 @@ struct DeltaVisitor<apache::thrift::type_class::list<ValueTypeClass>> {
       }
     }
 
-    for (int i = 0; i < minSize; ++i) {
-      const auto& oldRef = oldFields.at(i);
-      const auto& newRef = newFields.at(i);
-      if (oldRef != newRef) {
-        traverser.push(folly::to<std::string>(i), TCType<ValueTypeClass>);
-        if (DeltaVisitor<ValueTypeClass>::visit(
-                traverser, oldRef, newRef, options, std::forward<Func>(f))) {
+    if constexpr (dv_detail::kCanVisitConcurrently<TraverseHelper>) {
+      if (dv_detail::shouldVisitConcurrently(options, minSize)) {
+        int chunkSize = options.parallelChunkSize;
+        auto numChunks = (minSize + chunkSize - 1) / chunkSize;
+        if (dv_detail::visitChunksConcurrently(
+                traverser,
+                options,
+                numChunks,
+                [&](auto& chunkTraverser,
+                    const DeltaVisitOptions& chunkOptions,
+                    auto recorder,
+                    size_t chunk) {
+                  int begin = static_cast<int>(chunk) * chunkSize;
+                  int end = std::min(begin + chunkSize, minSize);
+                  return visitChanged(
+                      chunkTraverser,
+                      oldFields,
+                      newFields,
+                      begin,
+                      end,
+                      chunkOptions,
+                      recorder);
+                },
+                std::forward<Func>(f))) {
           hasDifferences = true;
         }
-        traverser.pop(TCType<ValueTypeClass>);
+        return hasDifferences;
       }
     }
 
+    if (visitChanged(
+            traverser,
+            oldFields,
+            newFields,
+            0,
+            minSize,
+            options,
+            std::forward<Func>(f))) {
+      hasDifferences = true;
+    }
+
     return hasDifferences;
   }
 
@@ -511,6 +672,33 @@ struct DeltaVisitor<apache::thrift::type_class::list<ValueTypeClass>> {
     }
     return hasDifferences;
   }
+
+ private:
+  // Visits the elements in [begin, end) present in both lists
+  template <typename Fields, typename TraverseHelper, typename Func>
+  static bool visitChanged(
+      TraverseHelper& traverser,
+      const Fields& oldFields,
+      const Fields& newFields,
+      int begin,
+      int end,
+      const DeltaVisitOptions& options,
+      Func&& f) {
+    bool hasDifferences{false};
+    for (int i = begin; i < end; ++i) {
+      const auto& oldRef = oldFields.at(i);
+      const auto& newRef = newFields.at(i);
+      if (oldRef != newRef) {
+        traverser.push(folly::to<std::string>(i), TCType<ValueTypeClass>);
+        if (DeltaVisitor<ValueTypeClass>::visit(
+                traverser, oldRef, newRef, options, std::forward<Func>(f))) {
+          hasDifferences = true;
+        }
+        traverser.pop(TCType<ValueTypeClass>);
+      }
+    }
+    return hasDifferences;
+  }
 };
 
 /**
@@ -544,38 +732,33 @@ struct DeltaVisitor<
       // only enable for Fields types
     requires(std::is_same_v<typename Fields::CowType, FieldsType>)
   {
-    bool hasDifferences{false};
-
-    // changed fields
-    for (const auto& [key, val] : oldFields) {
-      traverser.push(folly::to<std::string>(key), TCType<MappedTypeClass>);
-      if (auto it = newFields.find(key); it != newFields.end()) {
-        if (DeltaVisitor<MappedTypeClass>::visit(
-                traverser, val, it->second, options, std::forward<Func>(f))) {
-          hasDifferences = true;
-        }
-      } else {
-        hasDifferences = true;
-        dv_detail::visitAddedOrRemovedNode<MappedTypeClass>(
-            traverser, val, decltype(val){}, options, std::forward<Func>(f));
+    if constexpr (dv_detail::kCanVisitConcurrently<TraverseHelper>) {
+      if (dv_detail::shouldVisitConcurrently(
+              options, std::max(oldFields.size(), newFields.size()))) {
+        return visitConcurrently(
+            traverser, oldFields, newFields, options, std::forward<Func>(f));
       }
-      traverser.pop(TCType<MappedTypeClass>);
     }
 
-    for (const auto& [key, val] : newFields) {
-      if (oldFields.find(key) == oldFields.end()) {
-        // only look at keys that didn't exist. First loop should handle all
-        // replacement deltas
-        hasDifferences = true;
-        traverser.push(folly::to<std::string>(key), TCType<MappedTypeClass>);
-
-        dv_detail::visitAddedOrRemovedNode<MappedTypeClass>(
-            traverser, decltype(val){}, val, options, std::forward<Func>(f));
-
-        traverser.pop(TCType<MappedTypeClass>);
-      }
+    bool hasDifferences{false};
+    if (visitChangedOrRemoved(
+            traverser,
+            oldFields.begin(),
+            oldFields.end(),
+            newFields,
+            options,
+            std::forward<Func>(f))) {
+      hasDifferences = true;
+    }
+    if (visitAdded(
+            traverser,
+            newFields.begin(),
+            newFields.end(),
+            oldFields,
+            options,
+            std::forward<Func>(f))) {
+      hasDifferences = true;
     }
-
     return hasDifferences;
   }
 
@@ -671,6 +854,116 @@ struct DeltaVisitor<
 
     return hasDifferences;
   }
+
+ private:
+  // Visits chunks of old entries, then chunks of new entries, as visited
+  // serially
+  template <typename Fields, typename Func>
+  static bool visitConcurrently(
+      SimpleTraverseHelper& traverser,
+      const Fields& oldFields,
+      const Fields& newFields,
+      const DeltaVisitOptions& options,
+      Func&& f) {
+    auto oldBegins =
+        dv_detail::chunkBegins(oldFields, options.parallelChunkSize);
+    auto newBegins =
+        dv_detail::chunkBegins(newFields, options.parallelChunkSize);
+    return dv_detail::visitChunksConcurrently(
+        traverser,
+        options,
+        oldBegins.size() + newBegins.size(),
+        [&](auto& chunkTraverser,
+            const DeltaVisitOptions& chunkOptions,
+            auto recorder,
+            size_t chunk) {
+          if (chunk < oldBegins.size()) {
+            auto end = chunk + 1 < oldBegins.size() ? oldBegins[chunk + 1]
+                                                    : oldFields.end();
+            return visitChangedOrRemoved(
+                chunkTraverser,
+                oldBegins[chunk],
+                end,
+                newFields,
+                chunkOptions,
+                recorder);
+          }
+          chunk -= oldBegins.size();
+          auto end = chunk + 1 < newBegins.size() ? newBegins[chunk + 1]
+                                                  : newFields.end();
+          return visitAdded(
+              chunkTraverser,
+              newBegins[chunk],
+              end,
+              oldFields,
+              chunkOptions,
+              recorder);
+        },
+        std::forward<Func>(f));
+  }
+
+  // Visits the old entries in [begin, end), changed or removed in newFields
+  template <
+      typename Iterator,
+      typename Fields,
+      typename TraverseHelper,
+      typename Func>
+  static bool visitChangedOrRemoved(
+      TraverseHelper& traverser,
+      Iterator begin,
+      Iterator end,
+      const Fields& newFields,
+      const DeltaVisitOptions& options,
+      Func&& f) {
+    bool hasDifferences{false};
+    for (auto entry = begin; entry != end; ++entry) {
+      const auto& [key, val] = *entry;
+      traverser.push(folly::to<std::string>(key), TCType<MappedTypeClass>);
+      if (auto it = newFields.find(key); it != newFields.end()) {
+        if (DeltaVisitor<MappedTypeClass>::visit(
+                traverser, val, it->second, options, std::forward<Func>(f))) {
+          hasDifferences = true;
+        }
+      } else {
+        hasDifferences = true;
+        dv_detail::visitAddedOrRemovedNode<MappedTypeClass>(
+            traverser, val, decltype(val){}, options, std::forward<Func>(f));
+      }
+      traverser.pop(TCType<MappedTypeClass>);
+    }
+    return hasDifferences;
+  }
+
+  // Visits the new entries in [begin, end) missing from oldFields
+  template <
+      typename Iterator,
+      typename Fields,
+      typename TraverseHelper,
+      typename Func>
+  static bool visitAdded(
+      TraverseHelper& traverser,
+      Iterator begin,
+      Iterator end,
+      const Fields& oldFields,
+      const DeltaVisitOptions& options,
+      Func&& f) {
+    bool hasDifferences{false};
+    for (auto entry = begin; entry != end; ++entry) {
+      const auto& [key, val] = *entry;
+      if (oldFields.find(key) == oldFields.end()) {
+        // only look at keys that didn't exist. Changed and removed entries
+        // are visited with the old entries
+        hasDifferences = true;
+        traverser.push(folly::to<std::string>(key), TCType<MappedTypeClass>);
+
+        dv_detail::visitAddedOrRemovedNode<MappedTypeClass>(
+            traverser, decltype(val){}, val, options, std::forward<Func>(f));
+
+        traverser.pop(TCType<MappedTypeClass>);
+      }
+    }
+    return hasDifferences;
+  }
 };
 
 /**
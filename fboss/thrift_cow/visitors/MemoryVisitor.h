@@ -0,0 +1,341 @@
+// (c) Facebook, Inc. and its affiliates. Confidential and proprietary.
+
+#pragma once
+
+#include <fboss/thrift_cow/visitors/RecurseVisitor.h>
+#include <fboss/thrift_cow/visitors/TraverseHelper.h>
+#include <folly/String.h>
+#include <folly/container/F14Map.h>
+#include <folly/container/F14Set.h>
+#include <folly/logging/xlog.h>
+#include <folly/lang/Pretty.h>
+
+#include <iterator>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+namespace facebook::fboss::thrift_cow {
+
+/*
+ * Estimated memory held by thrift_cow nodes, see MemoryAccountant.
+ *
+ * bytes and nodes count whole subtrees, while uniqueBytes and uniqueNodes
+ * leave out the subtrees already counted, either earlier in the same tree or
+ * in the trees accounted before by the same MemoryAccountant.
+ */
+struct MemoryUsageEntry {
+  size_t bytes{0};
+  size_t uniqueBytes{0};
+  size_t nodes{0};
+  size_t uniqueNodes{0};
+
+  MemoryUsageEntry& operator+=(const MemoryUsageEntry& other) {
+    bytes += other.bytes;
+    uniqueBytes += other.uniqueBytes;
+    nodes += other.nodes;
+    uniqueNodes += other.uniqueNodes;
+    return *this;
+  }
+};
+
+struct MemoryUsage {
+  MemoryUsageEntry total;
+  // Subtrees at most pathDepth levels below the root, keyed by path, e.g.
+  // "/portMaps" or "/portMaps/id=0"
+  std::map<std::string, MemoryUsageEntry> byPath;
+  // Counted nodes, keyed by node type. Only counts unique nodes, as shared
+  // subtrees are not walked again.
+  std::map<std::string, MemoryUsageEntry> byType;
+};
+
+namespace memory_detail {
+
+// std::make_shared and clone() allocate the reference counts with the node
+constexpr size_t kControlBlockBytes = 16;
+// Per entry bookkeeping of node based containers (std::map, std::set...)
+constexpr size_t kEntryOverheadBytes = 32;
+
+// Bytes allocated by the container of map, list and set nodes. Struct fields
+// are stored inline, and counted with their node.
+template <typename Fields>
+size_t fieldsHeapBytes(const Fields& fields) {
+  if constexpr (requires {
+                  typename Fields::StorageType::value_type;
+                  fields.size();
+                }) {
+    using Storage = typename Fields::StorageType;
+    size_t entryBytes = sizeof(typename Storage::value_type);
+    if constexpr (!std::contiguous_iterator<typename Storage::const_iterator>) {
+      entryBytes += kEntryOverheadBytes;
+    }
+    return fields.size() * entryBytes;
+  } else {
+    return 0;
+  }
+}
+
+/*
+ * Estimated bytes of a node, excluding its children nodes. Strings and the
+ * contents of hybrid nodes are counted at their inline size.
+ */
+template <typename Node>
+size_t nodeBytes(const Node& node) {
+  size_t bytes = sizeof(Node) + kControlBlockBytes;
+  if constexpr (requires { node.getFields(); }) {
+    bytes += fieldsHeapBytes(*node.getFields());
+  }
+  return bytes;
+}
+
+template <typename T>
+constexpr bool kIsSharedPtr = false;
+
+template <typename T>
+constexpr bool kIsSharedPtr<std::shared_ptr<T>> = true;
+
+} // namespace memory_detail
+
+/*
+ * Estimates the memory held by thrift_cow trees (SwitchState, CowStorage
+ * roots...), by path and node type.
+ *
+ * Nodes reachable from several places, within a tree or across the trees
+ * accounted by the same MemoryAccountant (e.g. successive versions of a
+ * state sharing their unchanged subtrees), are walked once: later
+ * occurrences count towards bytes, but not uniqueBytes. Accounting an old
+ * state after the current one thus tells how much memory retaining the old
+ * state costs.
+ *
+ * Sizes are estimated from the node types and container sizes, without
+ * walking primitive values or encoding anything, so accounting costs about
+ * as much as a RecurseVisitor walk of the unique nodes.
+ *
+ * Not thread safe. The accounted trees must be published, or at least not
+ * modified while accounted, and stay alive while the accountant is used, as
+ * their nodes are remembered by address. accountUpdate() lifts the latter
+ * for successive versions of a tree.
+ */
+class MemoryAccountant {
+ public:
+  explicit MemoryAccountant(size_t pathDepth = 1) : pathDepth_(pathDepth) {}
+
+  template <typename Root>
+  MemoryUsage account(const std::shared_ptr<Root>& root) {
+    Traverser traverser(this);
+    if (root) {
+      RecurseVisitor<typename Root::TC>::visit(
+          traverser,
+          root,
+          RecurseVisitOptions(
+              RecurseVisitMode::FULL,
+              RecurseVisitOrder::PARENTS_FIRST,
+              false /* outputIdPaths */,
+              true /* hybridNodeShallowTraversal */),
+          [](Traverser& nodeTraverser, auto&& node) {
+            using NodePtr = std::remove_cvref_t<decltype(node)>;
+            if constexpr (memory_detail::kIsSharedPtr<NodePtr>) {
+              nodeTraverser.countNode(node);
+            }
+          });
+    }
+    return traverser.finish();
+  }
+
+  /*
+   * Accounts root, a newer version of the tree passed to the previous
+   * accountUpdate() call, walking only the nodes added since. The nodes of
+   * the previous version that root doesn't hold are then forgotten, by
+   * walking the parts of the previous version that changed, and the
+   * previous version is released. So periodically accounting the current
+   * version of a tree costs about as much as the changes in between.
+   *
+   * uniqueBytes, uniqueNodes and byType only cover the nodes added since
+   * the previous version. All calls must pass the same Root type.
+   */
+  template <typename Root>
+  MemoryUsage accountUpdate(const std::shared_ptr<Root>& root) {
+    CHECK(!lastRoot_ || *lastRootType_ == typeid(Root));
+    reached_.emplace();
+    auto usage = account(root);
+    if (auto lastRoot = std::static_pointer_cast<Root>(lastRoot_)) {
+      Forgetter forgetter(this);
+      RecurseVisitor<typename Root::TC>::visit(
+          forgetter,
+          lastRoot,
+          RecurseVisitOptions(
+              RecurseVisitMode::FULL,
+              RecurseVisitOrder::PARENTS_FIRST,
+              false /* outputIdPaths */,
+              true /* hybridNodeShallowTraversal */),
+          [](Forgetter& nodeForgetter, auto&& node) {
+            using NodePtr = std::remove_cvref_t<decltype(node)>;
+            if constexpr (memory_detail::kIsSharedPtr<NodePtr>) {
+              nodeForgetter.forgetNode(node);
+            }
+          });
+    }
+    reached_.reset();
+    lastRoot_ = root;
+    lastRootType_ = &typeid(Root);
+    return usage;
+  }
+
+ private:
+  struct SubtreeUsage {
+    size_t bytes{0};
+    size_t nodes{0};
+  };
+
+  /*
+   * Sums up the usage of subtrees while the RecurseVisitor walks the tree,
+   * with one frame per path token, and short circuits the walk below nodes
+   * already counted.
+   */
+  class Traverser : public TraverseHelper<Traverser> {
+   public:
+    using Base = TraverseHelper<Traverser>;
+
+    explicit Traverser(MemoryAccountant* accountant)
+        : accountant_(accountant), frames_(1) {}
+
+    bool shouldShortCircuitImpl(VisitorType /* visitorType */) const {
+      return skipDepth_ && path().size() >= *skipDepth_;
+    }
+
+    void onPushImpl(ThriftTCType /* tc */) {
+      frames_.emplace_back();
+    }
+
+    void onPopImpl(std::string&& popped, ThriftTCType /* tc */) {
+      if (skipDepth_ && path().size() < *skipDepth_) {
+        skipDepth_.reset();
+      }
+      auto frame = frames_.back();
+      frames_.pop_back();
+      finishFrame(frame);
+      frames_.back().usage += frame.usage;
+      if (frame.usage.nodes && path().size() < accountant_->pathDepth_) {
+        std::string framePath = "/";
+        if (!path().empty()) {
+          framePath += folly::join('/', path()) + "/";
+        }
+        usage_.byPath[framePath + popped] += frame.usage;
+      }
+    }
+
+    template <typename Node>
+    void countNode(const std::shared_ptr<Node>& node) {
+      if (!node) {
+        return;
+      }
+      auto& frame = frames_.back();
+      auto& seen = accountant_->seen_;
+      if (accountant_->reached_) {
+        accountant_->reached_->insert(node.get());
+      }
+      if (auto it = seen.find(node.get()); it != seen.end()) {
+        frame.usage.bytes += it->second.bytes;
+        frame.usage.nodes += it->second.nodes;
+        // counted already, skip its subtree
+        skipDepth_ = path().size();
+        return;
+      }
+      auto bytes = memory_detail::nodeBytes(*node);
+      frame.node = node.get();
+      frame.usage += MemoryUsageEntry{bytes, bytes, 1, 1};
+      typeUsage_[folly::pretty_name<Node>()] +=
+          MemoryUsageEntry{bytes, bytes, 1, 1};
+    }
+
+    MemoryUsage finish() {
+      finishFrame(frames_.back());
+      usage_.total = frames_.back().usage;
+      for (const auto& [type, usage] : typeUsage_) {
+        usage_.byType[std::string(type)] = usage;
+      }
+      return std::move(usage_);
+    }
+
+   private:
+    struct Frame {
+      // node counted at this path, if any
+      const void* node{nullptr};
+      MemoryUsageEntry usage;
+    };
+
+    void finishFrame(const Frame& frame) {
+      if (frame.node) {
+        accountant_->seen_.emplace(
+            frame.node, SubtreeUsage{frame.usage.bytes, frame.usage.nodes});
+      }
+    }
+
+    MemoryAccountant* accountant_;
+    std::vector<Frame> frames_;
+    // path depth of the shared subtree being skipped, if any
+    std::optional<size_t> skipDepth_;
+    MemoryUsage usage_;
+    // keyed by the static strings of folly::pretty_name
+    folly::F14FastMap<std::string_view, MemoryUsageEntry> typeUsage_;
+  };
+
+  /*
+   * Walks the previous version of a tree after accounting the new one,
+   * forgetting its nodes that the new version doesn't hold. Nodes reached
+   * while accounting the new version are held by it, as are their subtrees,
+   * which are skipped.
+   */
+  class Forgetter : public TraverseHelper<Forgetter> {
+   public:
+    using Base = TraverseHelper<Forgetter>;
+
+    explicit Forgetter(MemoryAccountant* accountant)
+        : accountant_(accountant) {}
+
+    bool shouldShortCircuitImpl(VisitorType /* visitorType */) const {
+      return skipDepth_ && path().size() >= *skipDepth_;
+    }
+
+    void onPushImpl(ThriftTCType /* tc */) {}
+
+    void onPopImpl(std::string&& /* popped */, ThriftTCType /* tc */) {
+      if (skipDepth_ && path().size() < *skipDepth_) {
+        skipDepth_.reset();
+      }
+    }
+
+    template <typename Node>
+    void forgetNode(const std::shared_ptr<Node>& node) {
+      if (!node) {
+        return;
+      }
+      if (accountant_->reached_->contains(node.get())) {
+        skipDepth_ = path().size();
+        return;
+      }
+      accountant_->seen_.erase(node.get());
+    }
+
+   private:
+    MemoryAccountant* accountant_;
+    // path depth of the subtree held by the new version, if any
+    std::optional<size_t> skipDepth_;
+  };
+
+  size_t pathDepth_;
+  // usage of the subtrees already counted, by root node address
+  folly::F14FastMap<const void*, SubtreeUsage> seen_;
+  // nodes reached while accounting an update, see accountUpdate()
+  std::optional<folly::F14FastSet<const void*>> reached_;
+  // version accounted by the previous accountUpdate() call
+  std::shared_ptr<void> lastRoot_;
+  const std::type_info* lastRootType_{nullptr};
+};
+
+} // namespace facebook::fboss::thrift_cow
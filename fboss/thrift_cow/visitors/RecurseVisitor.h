@@ -125,6 +125,11 @@ void visitNode(
       options.mode == RecurseVisitMode::UNPUBLISHED;
   if (visitIntermediate && options.order == RecurseVisitOrder::PARENTS_FIRST) {
     invokeVisitorFnHelper(options, traverser, node, std::forward<Func>(f));
+    // the visitor may have told the traverse helper to skip the children,
+    // e.g. MemoryAccountant for subtrees it already counted
+    if (traverser.shouldShortCircuit(VisitorType::RECURSE)) {
+      return;
+    }
   }
 
   if constexpr (std::is_const_v<NodePtr>) {
@@ -1,6 +1,7 @@
 // (c) Facebook, Inc. and its affiliates. Confidential and proprietary.
 
 #include <folly/String.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/json/dynamic.h>
 #include <folly/logging/xlog.h>
 #include <gmock/gmock.h>
@@ -116,6 +117,46 @@ TYPED_TEST(DeltaVisitorTests, ChangeOneField) {
               std::make_pair("/inlineInt", DeltaElemTag::MINIMAL)}));
 }
 
+TYPED_TEST(DeltaVisitorTests, PruneEqualContents) {
+  auto structA = createSimpleTestStruct();
+  auto structB = structA;
+  structB.inlineStruct()->min() = 11;
+
+  // distinct trees, some with equal contents
+  auto nodeA = this->initNode(structA);
+  auto nodeSameAsA = this->initNode(structA);
+  auto nodeB = this->initNode(structB);
+  nodeA->publish();
+  nodeSameAsA->publish();
+  nodeB->publish();
+
+  PathTagSet differingPaths;
+  auto processChange = [&](SimpleTraverseHelper& traverser,
+                           auto&& /*oldValue*/,
+                           auto&& /*newValue*/,
+                           auto&& tag) {
+    differingPaths.emplace(
+        std::make_pair("/" + folly::join('/', traverser.path()), tag));
+  };
+
+  DeltaVisitOptions options(DeltaVisitMode::MINIMAL);
+  options.pruneEqualContents = true;
+
+  auto result =
+      RootDeltaVisitor::visit(nodeA, nodeSameAsA, options, processChange);
+  EXPECT_EQ(result, false);
+  EXPECT_TRUE(differingPaths.empty());
+
+  // changes are still found, below subtrees that differ
+  result = RootDeltaVisitor::visit(nodeA, nodeB, options, processChange);
+  EXPECT_EQ(result, true);
+  EXPECT_THAT(
+      differingPaths,
+      ::testing::ContainerEq(
+          PathTagSet{
+              std::make_pair("/inlineStruct/min", DeltaElemTag::MINIMAL)}));
+}
+
 TYPED_TEST(DeltaVisitorTests, ChangeOneFieldInContainer) {
   auto structA = createSimpleTestStruct();
   auto structB = structA;
@@ -1059,4 +1100,62 @@ TYPED_TEST(DeltaVisitorTests, RemoveFromRecursiveList) {
       }));
 }
 
+TYPED_TEST(DeltaVisitorTests, ConcurrentVisitMatchesSerial) {
+  auto structA = createSimpleTestStruct();
+  for (int i = 0; i < 1000; ++i) {
+    cfg::L4PortRange range;
+    range.min() = i;
+    range.max() = i + 10;
+    structA.mapOfI32ToStruct()[i] = range;
+    structA.listOfStructs()->push_back(range);
+    structA.mapOfStringToI32()[folly::to<std::string>("key", i)] = i;
+  }
+  auto structB = structA;
+  for (int i = 0; i < 1000; i += 7) {
+    structB.mapOfI32ToStruct()->at(i).max() = 0;
+    structB.listOfStructs()->at(i).min() = -1;
+  }
+  for (int i = 0; i < 1000; i += 11) {
+    structB.mapOfI32ToStruct()->erase(i);
+    structB.mapOfStringToI32()->erase(folly::to<std::string>("key", i));
+  }
+  for (int i = 1000; i < 1100; ++i) {
+    structB.mapOfI32ToStruct()[i] = cfg::L4PortRange();
+    structB.mapOfStringToI32()[folly::to<std::string>("key", i)] = i;
+  }
+
+  auto nodeA = this->initNode(structA);
+  auto nodeB = this->initNode(structB);
+
+  using Deltas = std::vector<std::pair<std::string, DeltaElemTag>>;
+  auto visit = [&](DeltaVisitOptions options) {
+    Deltas deltas;
+    auto processChange = [&](SimpleTraverseHelper& traverser,
+                             auto&& /*oldValue*/,
+                             auto&& /*newValue*/,
+                             auto&& tag) {
+      deltas.emplace_back("/" + folly::join('/', traverser.path()), tag);
+    };
+    EXPECT_TRUE(RootDeltaVisitor::visit(nodeA, nodeB, options, processChange));
+    return deltas;
+  };
+
+  folly::CPUThreadPoolExecutor executor(4);
+  for (auto mode :
+       {DeltaVisitMode::PARENTS,
+        DeltaVisitMode::MINIMAL,
+        DeltaVisitMode::FULL}) {
+    for (auto order :
+         {DeltaVisitOrder::PARENTS_FIRST, DeltaVisitOrder::CHILDREN_FIRST}) {
+      DeltaVisitOptions options(mode, order);
+      auto serialDeltas = visit(options);
+      EXPECT_FALSE(serialDeltas.empty());
+
+      options.executor = &executor;
+      options.parallelChunkSize = 64;
+      EXPECT_EQ(visit(options), serialDeltas);
+    }
+  }
+}
+
 } // namespace facebook::fboss::thrift_cow::test
@@ -0,0 +1,129 @@
+// (c) Facebook, Inc. and its affiliates. Confidential and proprietary.
+
+#include <gtest/gtest.h>
+
+#include <fboss/thrift_cow/visitors/MemoryVisitor.h>
+#include "fboss/thrift_cow/nodes/Types.h"
+#include "fboss/thrift_cow/nodes/tests/gen-cpp2/test_types.h"
+
+using namespace facebook::fboss;
+using namespace facebook::fboss::thrift_cow;
+namespace k = apache::thrift::ident;
+
+namespace {
+
+using TestNode = ThriftStructNode<TestStruct>;
+
+std::shared_ptr<TestNode> createTestNode() {
+  TestStruct data;
+  data.inlineInt() = 54;
+  data.inlineString() = "testname";
+  for (int i = 0; i < 100; ++i) {
+    cfg::L4PortRange range;
+    range.min() = i;
+    range.max() = i + 10;
+    data.mapOfI32ToStruct()[i] = range;
+  }
+  auto node = std::make_shared<TestNode>(data);
+  node->publish();
+  return node;
+}
+
+} // namespace
+
+TEST(MemoryVisitorTests, AccountByPath) {
+  auto node = createTestNode();
+
+  MemoryAccountant accountant;
+  auto usage = accountant.account(node);
+  EXPECT_GT(usage.total.bytes, 0);
+  EXPECT_EQ(usage.total.bytes, usage.total.uniqueBytes);
+  EXPECT_EQ(usage.total.nodes, usage.total.uniqueNodes);
+  EXPECT_FALSE(usage.byType.empty());
+
+  ASSERT_EQ(usage.byPath.count("/mapOfI32ToStruct"), 1);
+  const auto& mapUsage = usage.byPath.at("/mapOfI32ToStruct");
+  // the map node and its 100 entries, with their members
+  EXPECT_GT(mapUsage.nodes, 100);
+  EXPECT_LT(mapUsage.bytes, usage.total.bytes);
+  ASSERT_EQ(usage.byPath.count("/inlineInt"), 1);
+  EXPECT_LT(usage.byPath.at("/inlineInt").bytes, mapUsage.bytes);
+  // deeper paths need a larger pathDepth
+  EXPECT_EQ(usage.byPath.count("/mapOfI32ToStruct/5"), 0);
+
+  MemoryAccountant deepAccountant(2);
+  auto deepUsage = deepAccountant.account(node);
+  EXPECT_EQ(deepUsage.total.bytes, usage.total.bytes);
+  EXPECT_EQ(deepUsage.byPath.count("/mapOfI32ToStruct/5"), 1);
+}
+
+TEST(MemoryVisitorTests, SharedSubtreesCountedOnce) {
+  auto node = createTestNode();
+
+  MemoryAccountant accountant;
+  auto usage = accountant.account(node);
+
+  // accounting the same tree again finds every node counted already
+  auto againUsage = accountant.account(node);
+  EXPECT_EQ(againUsage.total.bytes, usage.total.bytes);
+  EXPECT_EQ(againUsage.total.nodes, usage.total.nodes);
+  EXPECT_EQ(againUsage.total.uniqueBytes, 0);
+  EXPECT_EQ(againUsage.total.uniqueNodes, 0);
+  EXPECT_TRUE(againUsage.byType.empty());
+
+  // a modified clone only adds its root and the replaced member
+  auto newNode = node->clone();
+  newNode->template set<k::inlineInt>(55);
+  newNode->publish();
+  auto newUsage = accountant.account(newNode);
+  EXPECT_EQ(newUsage.total.nodes, usage.total.nodes);
+  EXPECT_GT(newUsage.total.uniqueNodes, 0);
+  EXPECT_LE(newUsage.total.uniqueNodes, 2);
+  EXPECT_LT(newUsage.total.uniqueBytes, usage.total.bytes / 10);
+  EXPECT_EQ(newUsage.byPath.at("/mapOfI32ToStruct").uniqueBytes, 0);
+  EXPECT_EQ(
+      newUsage.byPath.at("/mapOfI32ToStruct").bytes,
+      usage.byPath.at("/mapOfI32ToStruct").bytes);
+
+  // a fresh accountant counts the clone as a whole
+  MemoryAccountant freshAccountant;
+  auto freshUsage = freshAccountant.account(newNode);
+  EXPECT_EQ(freshUsage.total.uniqueBytes, freshUsage.total.bytes);
+  EXPECT_EQ(freshUsage.total.bytes, newUsage.total.bytes);
+}
+
+TEST(MemoryVisitorTests, AccountUpdates) {
+  auto node = createTestNode();
+
+  MemoryAccountant accountant;
+  auto usage = accountant.accountUpdate(node);
+  EXPECT_EQ(usage.total.bytes, usage.total.uniqueBytes);
+
+  // only the nodes added by the update are walked, totals still cover the
+  // whole tree
+  auto newNode = node->clone();
+  newNode->template set<k::inlineInt>(55);
+  newNode->template modify<k::mapOfI32ToStruct>()->remove(0);
+  newNode->publish();
+  auto newUsage = accountant.accountUpdate(newNode);
+  MemoryAccountant freshAccountant;
+  auto freshUsage = freshAccountant.account(newNode);
+  EXPECT_EQ(newUsage.total.bytes, freshUsage.total.bytes);
+  EXPECT_EQ(newUsage.total.nodes, freshUsage.total.nodes);
+  EXPECT_LT(newUsage.total.nodes, usage.total.nodes);
+  EXPECT_GT(newUsage.total.uniqueNodes, 0);
+  EXPECT_LE(newUsage.total.uniqueNodes, 3);
+
+  // the previous version is released, the update is still accounted right
+  node.reset();
+  auto lastNode = newNode->clone();
+  lastNode->template modify<k::mapOfI32ToStruct>()->remove(1);
+  lastNode->publish();
+  newNode.reset();
+  auto lastUsage = accountant.accountUpdate(lastNode);
+  MemoryAccountant lastFreshAccountant;
+  auto lastFreshUsage = lastFreshAccountant.account(lastNode);
+  EXPECT_EQ(lastUsage.total.bytes, lastFreshUsage.total.bytes);
+  EXPECT_EQ(lastUsage.total.nodes, lastFreshUsage.total.nodes);
+  EXPECT_LE(lastUsage.total.uniqueNodes, 2);
+}